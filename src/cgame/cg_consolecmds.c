@@ -139,19 +139,20 @@ void CG_ScoresDown_f( void ) {
 		// so request new ones
 		cg.scoresRequestTime = cg.time;
 
-		// OSP - we get periodic score updates if we are merging clients
-		if ( !cg.demoPlayback && cg.mvTotalClients < 1 ) {
-			trap_SendClientCommand( "score" );
-		}
-
 		// leave the current scores up if they were already
 		// displayed, but if this is the first hit, clear them out
 		if ( !cg.showScores ) {
 			cg.showScores = qtrue;
 			if ( !cg.demoPlayback && cg.mvTotalClients < 1 ) {
 				cg.numScores = 0;
+				cg.scoreSequence = 0;
 			}
 		}
+
+		// OSP - we get periodic score updates if we are merging clients
+		if ( !cg.demoPlayback && cg.mvTotalClients < 1 ) {
+			CG_RequestScores();
+		}
 	} else {
 		// show the cached contents even if they just pressed if it
 		// is within two seconds
@@ -1304,7 +1304,7 @@ void CG_Debriefing_InfoRequests( void ) {
 	// if nothing else is pending, ask for scores
 	if ( !cgs.dbLastScoreRequest || ( cg.time - cgs.dbLastScoreRequest ) > 1000 ) {
 		cgs.dbLastScoreRequest = cg.time;
-		trap_SendClientCommand( "score" );
+		CG_RequestScores();
 	}
 }
 
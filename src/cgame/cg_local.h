@@ -858,6 +858,8 @@ typedef struct {
 	// scoreboard
 	int scoresRequestTime;
 	int numScores;
+	int scoreSequence;                  // last scd applied, 0 when there is nothing to apply one to
+	qboolean scoreResync;               // asked for a full scoreboard, ignore scd until it comes
 	int selectedScore;
 	int teamScores[2];
 	int teamPlayers[TEAM_NUM_TEAMS];         // JPW NERVE for scoreboard
@@ -2759,6 +2761,7 @@ void CG_toggleSwing_f( void );
 // cg_servercmds.c
 //
 void CG_ExecuteNewServerCommands( int latestSequence );
+void CG_RequestScores( void );
 void CG_ParseServerinfo( void );
 void CG_ParseSysteminfo( void );
 void CG_ParseWolfinfo( void );          // NERVE - SMF
@@ -51,6 +51,7 @@ static void CG_ParseScore( team_t team ) {
 
 	if ( team == TEAM_AXIS ) {
 		cg.numScores = 0;
+		cg.scoreSequence = 0;
 
 		cg.teamScores[0] = atoi( CG_Argv( 1 ) );
 		cg.teamScores[1] = atoi( CG_Argv( 2 ) );
@@ -80,6 +81,7 @@ static void CG_ParseScore( team_t team ) {
 
 		cgs.clientinfo[ cg.scores[i].client ].score = cg.scores[i].score;
 		cgs.clientinfo[ cg.scores[i].client ].powerups = powerups;
+		cg.scores[i].powerUps = powerups;
 
 		cg.scores[i].team = cgs.clientinfo[cg.scores[i].client].team;
 
@@ -87,6 +89,88 @@ static void CG_ParseScore( team_t team ) {
 	}
 }
 
+/*
+=================
+CG_RequestScores
+
+The sequence tells the server this cgame takes scd deltas, 0 asks for a
+full scoreboard
+=================
+*/
+void CG_RequestScores( void ) {
+	if ( !cg.scoreSequence ) {
+		cg.scoreResync = qtrue;
+	}
+	trap_SendClientCommand( va( "score %i", cg.scoreSequence ) );
+}
+
+/*
+=================
+CG_ParseScoreDelta
+
+scd <base> <sequence> <axis score> <allies score> <numScores> <count>
+followed by count rows of position and the seven sc0 fields, for the rows
+that changed since base
+=================
+*/
+static void CG_ParseScoreDelta( void ) {
+	int i, j, count, base;
+	int offset;
+
+	base = atoi( CG_Argv( 1 ) );
+
+	// a base of 0 starts from an empty scoreboard
+	if ( !base ) {
+		cg.numScores = 0;
+		cg.scoreResync = qfalse;
+	} else if ( base != cg.scoreSequence || cg.scoreResync ) {
+		// missed the start of the chain, the cgame restarted or a demo
+		// began in the middle of it
+		if ( !cg.demoPlayback && !cg.scoreResync ) {
+			cg.scoreSequence = 0;
+			CG_RequestScores();
+		}
+		return;
+	}
+
+	cg.scoreSequence = atoi( CG_Argv( 2 ) );
+	cg.teamScores[0] = atoi( CG_Argv( 3 ) );
+	cg.teamScores[1] = atoi( CG_Argv( 4 ) );
+	cg.numScores = atoi( CG_Argv( 5 ) );
+	if ( cg.numScores < 0 || cg.numScores > MAX_CLIENTS ) {
+		cg.numScores = 0;
+	}
+	count = atoi( CG_Argv( 6 ) );
+
+	for ( j = 0, offset = 7; j < count && offset + 7 < trap_Argc(); j++, offset += 8 ) {
+		i = atoi( CG_Argv( offset ) );
+		if ( i < 0 || i >= MAX_CLIENTS ) {
+			continue;
+		}
+
+		cg.scores[i].client = atoi(         CG_Argv( offset + 1 ) );
+		cg.scores[i].score = atoi(          CG_Argv( offset + 2 ) );
+		cg.scores[i].ping = atoi(           CG_Argv( offset + 3 ) );
+		cg.scores[i].time = atoi(           CG_Argv( offset + 4 ) );
+		cg.scores[i].powerUps = atoi(       CG_Argv( offset + 5 ) );
+		cg.scores[i].playerClass = atoi(    CG_Argv( offset + 6 ) );
+		cg.scores[i].respawnsLeft = atoi(   CG_Argv( offset + 7 ) );
+
+		if ( cg.scores[i].client < 0 || cg.scores[i].client >= MAX_CLIENTS ) {
+			cg.scores[i].client = 0;
+		}
+	}
+
+	// rows that didn't change can still have switched team, and a new
+	// configstring for the player clears the score and powerups in its
+	// clientinfo, which a full scoreboard used to put back
+	for ( i = 0; i < cg.numScores; i++ ) {
+		cgs.clientinfo[ cg.scores[i].client ].score = cg.scores[i].score;
+		cgs.clientinfo[ cg.scores[i].client ].powerups = cg.scores[i].powerUps;
+		cg.scores[i].team = cgs.clientinfo[cg.scores[i].client].team;
+	}
+}
+
 /*
 =================
 CG_ParseTeamInfo
@@ -2038,6 +2122,9 @@ static void CG_ServerCommand( void ) {
 	} else if ( !strcmp( cmd, "sc1" ) ) {
 		CG_ParseScore( TEAM_ALLIES );
 		return;
+	} else if ( !strcmp( cmd, "scd" ) ) {
+		CG_ParseScoreDelta();
+		return;
 	}
 
 	if ( !strcmp( cmd, "WeaponStats" ) ) {
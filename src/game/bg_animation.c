@@ -678,6 +678,45 @@ static void BG_ParseConditionBits( const char **text_pp, animStringItem_t *strin
 	}
 }
 
+/*
+=================
+BG_CompileConditions
+
+  turns the condition values into bits, so that BG_FirstValidItem can test
+  a condition of any type with one AND against the client's condition bits
+=================
+*/
+static void BG_CompileConditions( animScriptItem_t *scriptItem ) {
+	animScriptCondition_t *cond;
+	int i;
+
+	scriptItem->compiled = qtrue;
+
+	for ( i = 0, cond = scriptItem->conditions; i < scriptItem->numConditions; i++, cond++ )
+	{
+		cond->bits[0] = 0;
+		cond->bits[1] = 0;
+
+		switch ( animConditionsTable[cond->index].type ) {
+		case ANIM_CONDTYPE_BITFLAGS:
+			cond->bits[0] = cond->value[0];
+			cond->bits[1] = cond->value[1];
+			break;
+		case ANIM_CONDTYPE_VALUE:
+			if ( cond->value[0] >= 0 && cond->value[0] < 64 ) {
+				COM_BitSet( cond->bits, cond->value[0] );
+				break;
+			}
+			// no bit for it, leave the item to BG_EvaluateConditions
+			scriptItem->compiled = qfalse;
+			break;
+		default:
+			scriptItem->compiled = qfalse;
+			break;
+		}
+	}
+}
+
 /*
 =================
 BG_ParseConditions
@@ -701,6 +740,7 @@ static qboolean BG_ParseConditions( const char **text_pp, animScriptItem_t *scri
 
 		// special case, "default" has no conditions
 		if ( !Q_stricmp( token, "default" ) ) {
+			scriptItem->compiled = qtrue;
 			return qtrue;
 		}
 
@@ -740,6 +780,8 @@ static qboolean BG_ParseConditions( const char **text_pp, animScriptItem_t *scri
 		BG_AnimParseError( "BG_ParseConditions: no conditions found" );  // RF mod
 	}
 
+	BG_CompileConditions( scriptItem );
+
 	return qtrue;
 }
 
@@ -1263,6 +1305,52 @@ qboolean BG_EvaluateConditions( int client, animScriptItem_t *scriptItem ) {
 	return qtrue;
 }
 
+/*
+===============
+BG_UpdateConditionBits
+
+  keeps the client's condition bits in step with a changed condition
+===============
+*/
+static void BG_UpdateConditionBits( int client, int condition ) {
+	const int *value = globalScriptData->clientConditions[client][condition];
+	int *bits = globalScriptData->clientConditionBits[client][condition];
+
+	if ( animConditionsTable[condition].type == ANIM_CONDTYPE_BITFLAGS ) {
+		bits[0] = value[0];
+		bits[1] = value[1];
+		return;
+	}
+
+	bits[0] = 0;
+	bits[1] = 0;
+	// a value without a bit can't equal any compiled condition value
+	if ( value[0] >= 0 && value[0] < 64 ) {
+		COM_BitSet( bits, value[0] );
+	}
+}
+
+/*
+===============
+BG_MatchConditionBits
+
+  same as BG_EvaluateConditions for a compiled item
+===============
+*/
+static ID_INLINE qboolean BG_MatchConditionBits( int clientBits[NUM_ANIM_CONDITIONS][2], const animScriptItem_t *scriptItem ) {
+	const animScriptCondition_t *cond;
+	int i;
+
+	for ( i = 0, cond = scriptItem->conditions; i < scriptItem->numConditions; i++, cond++ )
+	{
+		if ( !( ( clientBits[cond->index][0] & cond->bits[0] ) | ( clientBits[cond->index][1] & cond->bits[1] ) ) ) {
+			return qfalse;
+		}
+	}
+
+	return qtrue;
+}
+
 /*
 ===============
 BG_FirstValidItem
@@ -1274,12 +1362,25 @@ BG_FirstValidItem
 */
 animScriptItem_t *BG_FirstValidItem( int client, animScript_t *script ) {
 	animScriptItem_t **ppScriptItem;
-
+	int ( *clientBits )[2];
 	int i;
 
+	// the bits start out zeroed along with the conditions, build them once
+	if ( !globalScriptData->clientConditionBitsValid[client] ) {
+		for ( i = 0; i < NUM_ANIM_CONDITIONS; i++ ) {
+			BG_UpdateConditionBits( client, i );
+		}
+		globalScriptData->clientConditionBitsValid[client] = qtrue;
+	}
+	clientBits = globalScriptData->clientConditionBits[client];
+
 	for ( i = 0, ppScriptItem = script->items; i < script->numItems; i++, ppScriptItem++ )
 	{
-		if ( BG_EvaluateConditions( client, *ppScriptItem ) ) {
+		if ( ( *ppScriptItem )->compiled ) {
+			if ( BG_MatchConditionBits( clientBits, *ppScriptItem ) ) {
+				return *ppScriptItem;
+			}
+		} else if ( BG_EvaluateConditions( client, *ppScriptItem ) ) {
 			return *ppScriptItem;
 		}
 	}
@@ -1631,12 +1732,14 @@ void BG_UpdateConditionValue( int client, int condition, int value, qboolean che
 			// dhm - end
 
 			COM_BitSet( globalScriptData->clientConditions[client][condition], value );
+			BG_UpdateConditionBits( client, condition );
 			return;
 		}
 		// rain - we must fall through here because a bunch of non-bitflag
 		// conditions are set with checkConversion == qtrue
 	}
 	globalScriptData->clientConditions[client][condition][0] = value;
+	BG_UpdateConditionBits( client, condition );
 }
 
 /*
@@ -1683,10 +1786,12 @@ qboolean BG_GetConditionBitFlag( int client, int condition, int bitNumber ) {
 
 void BG_SetConditionBitFlag( int client, int condition, int bitNumber ) {
 	COM_BitSet( globalScriptData->clientConditions[client][condition], bitNumber );
+	BG_UpdateConditionBits( client, condition );
 }
 
 void BG_ClearConditionBitFlag( int client, int condition, int bitNumber ) {
 	COM_BitClear( globalScriptData->clientConditions[client][condition], bitNumber );
+	BG_UpdateConditionBits( client, condition );
 }
 
 /*
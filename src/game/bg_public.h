@@ -1755,6 +1755,7 @@ typedef struct
 {
 	int index;      // reference into the table of possible conditionals
 	int value[2];       // can store anything from weapon bits, to position enums, etc
+	int bits[2];        // value as bit flags, tested against clientConditionBits
 } animScriptCondition_t;
 
 typedef struct
@@ -1769,6 +1770,7 @@ typedef struct
 {
 	int numConditions;
 	animScriptCondition_t conditions[NUM_ANIM_CONDITIONS];
+	qboolean compiled;          // every condition has its bits set
 	int numCommands;
 	animScriptCommand_t commands[MAX_ANIMSCRIPT_ANIMCOMMANDS];
 } animScriptItem_t;
@@ -1813,6 +1815,10 @@ typedef struct
 //	int					clientModels[MAX_CLIENTS];		// so we know which model each client is using
 	animModelInfo_t modelInfo[MAX_ANIMSCRIPT_MODELS];
 	int clientConditions[MAX_CLIENTS][NUM_ANIM_CONDITIONS][2];
+	// clientConditions with each value turned into a single bit, so one AND
+	// tests a condition of any type
+	int clientConditionBits[MAX_CLIENTS][NUM_ANIM_CONDITIONS][2];
+	qboolean clientConditionBitsValid[MAX_CLIENTS];
 	//
 	// pointers to functions from the owning module
 	//
@@ -1987,6 +1993,8 @@ int BG_GetConditionValue( int client, int condition, qboolean checkConversion );
 qboolean BG_GetConditionBitFlag( int client, int condition, int bitNumber );
 void BG_SetConditionBitFlag( int client, int condition, int bitNumber );
 void BG_ClearConditionBitFlag( int client, int condition, int bitNumber );
+qboolean BG_EvaluateConditions( int client, animScriptItem_t *scriptItem );
+animScriptItem_t *BG_FirstValidItem( int client, animScript_t *script );
 int BG_GetAnimScriptAnimation( int client, animModelInfo_t* animModelInfo, aistateEnum_t aistate, scriptAnimMoveTypes_t movetype );
 void BG_AnimUpdatePlayerStateConditions( pmove_t *pmove );
 animation_t *BG_AnimationForString( const char *string, animModelInfo_t *animModelInfo );
@@ -349,6 +349,7 @@ void ClientImpacts( gentity_t *ent, pmove_t *pm ) {
 			continue;
 		}
 
+		G_WakeEntity( other );
 		other->touch( other, ent, &trace );
 	}
 
@@ -432,6 +433,7 @@ void    G_TouchTriggers( gentity_t *ent ) {
 		memset( &trace, 0, sizeof( trace ) );
 
 		if ( hit->touch ) {
+			G_WakeEntity( hit );
 			hit->touch( hit, ent, &trace );
 		}
 
@@ -54,7 +54,15 @@ void G_StoreClientPosition( gentity_t* ent ) {
 	ent->client->clientMarkers[top].time = level.time;
 }
 
-static void G_AdjustSingleClientPosition( gentity_t* ent, int time ) {
+/*
+==============
+G_ClientMarkerPosition
+
+Interpolates the stored markers of a client to time, returns qfalse when
+no pair of markers bounds it
+==============
+*/
+static qboolean G_ClientMarkerPosition( gentity_t* ent, int time, vec3_t origin, vec3_t mins, vec3_t maxs ) {
 	int i, j;
 
 	if ( time > level.time ) {
@@ -76,6 +84,29 @@ static void G_AdjustSingleClientPosition( gentity_t* ent, int time ) {
 	} while ( i != ent->client->topMarker );
 
 	if ( i == j ) { // oops, no valid stored markers
+		return qfalse;
+	}
+
+	if ( i != ent->client->topMarker ) {
+		float frac = (float)( time - ent->client->clientMarkers[i].time ) /
+					 (float)( ent->client->clientMarkers[j].time - ent->client->clientMarkers[i].time );
+
+		LerpPosition( ent->client->clientMarkers[i].origin, ent->client->clientMarkers[j].origin, frac, origin );
+		LerpPosition( ent->client->clientMarkers[i].mins, ent->client->clientMarkers[j].mins, frac, mins );
+		LerpPosition( ent->client->clientMarkers[i].maxs, ent->client->clientMarkers[j].maxs, frac, maxs );
+	} else {
+		VectorCopy( ent->client->clientMarkers[j].origin, origin );
+		VectorCopy( ent->client->clientMarkers[j].mins, mins );
+		VectorCopy( ent->client->clientMarkers[j].maxs, maxs );
+	}
+
+	return qtrue;
+}
+
+static void G_AdjustSingleClientPosition( gentity_t* ent, int time ) {
+	vec3_t origin, mins, maxs;
+
+	if ( !G_ClientMarkerPosition( ent, time, origin, mins, maxs ) ) {
 		return;
 	}
 
@@ -87,18 +118,9 @@ static void G_AdjustSingleClientPosition( gentity_t* ent, int time ) {
 		ent->client->backupMarker.time = level.time;
 	}
 
-	if ( i != ent->client->topMarker ) {
-		float frac = (float)( time - ent->client->clientMarkers[i].time ) /
-					 (float)( ent->client->clientMarkers[j].time - ent->client->clientMarkers[i].time );
-
-		LerpPosition( ent->client->clientMarkers[i].origin, ent->client->clientMarkers[j].origin, frac, ent->r.currentOrigin );
-		LerpPosition( ent->client->clientMarkers[i].mins, ent->client->clientMarkers[j].mins, frac, ent->r.mins );
-		LerpPosition( ent->client->clientMarkers[i].maxs, ent->client->clientMarkers[j].maxs, frac, ent->r.maxs );
-	} else {
-		VectorCopy( ent->client->clientMarkers[j].origin, ent->r.currentOrigin );
-		VectorCopy( ent->client->clientMarkers[j].mins, ent->r.mins );
-		VectorCopy( ent->client->clientMarkers[j].maxs, ent->r.maxs );
-	}
+	VectorCopy( origin, ent->r.currentOrigin );
+	VectorCopy( mins, ent->r.mins );
+	VectorCopy( maxs, ent->r.maxs );
 
 	trap_LinkEntity( ent );
 }
@@ -119,22 +141,32 @@ static void G_ReAdjustSingleClientPosition( gentity_t* ent ) {
 	}
 }
 
-void G_AdjustClientPositions( gentity_t* ent, int time, qboolean forward ) {
-	int i;
-	gentity_t   *list;
+/*
+==============
+G_AntilagTarget
 
-	for ( i = 0; i < level.numConnectedClients; i++, list++ ) {
-		list = g_entities + level.sortedClients[i];
-		// Gordon: ok lets test everything under the sun
-		if ( list->client &&
+Players that are moved back in time and get head and leg boxes when ent shoots
+==============
+*/
+static qboolean G_AntilagTarget( gentity_t* list, gentity_t* ent ) {
+	// Gordon: ok lets test everything under the sun
+	return ( list->client &&
 			 list->inuse &&
 			 ( list->client->sess.sessionTeam == TEAM_AXIS || list->client->sess.sessionTeam == TEAM_ALLIES ) &&
 			 ( list != ent ) &&
 			 list->r.linked &&
 			 ( list->health > 0 ) &&
 			 !( list->client->ps.pm_flags & PMF_LIMBO ) &&
-			 ( list->client->ps.pm_type == PM_NORMAL )
-			 ) {
+			 ( list->client->ps.pm_type == PM_NORMAL ) );
+}
+
+void G_AdjustClientPositions( gentity_t* ent, int time, qboolean forward ) {
+	int i;
+	gentity_t   *list;
+
+	for ( i = 0; i < level.numConnectedClients; i++ ) {
+		list = g_entities + level.sortedClients[i];
+		if ( G_AntilagTarget( list, ent ) ) {
 			if ( forward ) {
 				G_AdjustSingleClientPosition( list, time );
 			} else {
@@ -167,21 +199,13 @@ void G_ResetMarkers( gentity_t* ent ) {
 	}
 }
 
-void G_AttachBodyParts( gentity_t* ent ) {
+static void G_AttachBodyParts( gentity_t* ent ) {
 	int i;
 	gentity_t   *list;
 
-	for ( i = 0; i < level.numConnectedClients; i++, list++ ) {
+	for ( i = 0; i < level.numConnectedClients; i++ ) {
 		list = g_entities + level.sortedClients[i];
-		// Gordon: ok lets test everything under the sun
-		if ( list->inuse &&
-			 ( list->client->sess.sessionTeam == TEAM_AXIS || list->client->sess.sessionTeam == TEAM_ALLIES ) &&
-			 ( list != ent ) &&
-			 list->r.linked &&
-			 ( list->health > 0 ) &&
-			 !( list->client->ps.pm_flags & PMF_LIMBO ) &&
-			 ( list->client->ps.pm_type == PM_NORMAL )
-			 ) {
+		if ( G_AntilagTarget( list, ent ) ) {
 			list->client->tempHead = G_BuildHead( list );
 			list->client->tempLeg = G_BuildLeg( list );
 		} else {
@@ -191,11 +215,11 @@ void G_AttachBodyParts( gentity_t* ent ) {
 	}
 }
 
-void G_DettachBodyParts() {
+static void G_DettachBodyParts( void ) {
 	int i;
 	gentity_t   *list;
 
-	for ( i = 0; i < level.numConnectedClients; i++, list++ ) {
+	for ( i = 0; i < level.numConnectedClients; i++ ) {
 		list = g_entities + level.sortedClients[i];
 		if ( list->client->tempHead ) {
 			G_FreeEntity( list->client->tempHead );
@@ -206,7 +230,7 @@ void G_DettachBodyParts() {
 	}
 }
 
-int G_SwitchBodyPartEntity( gentity_t* ent ) {
+static int G_SwitchBodyPartEntity( gentity_t* ent ) {
 	if ( ent->s.eType == ET_TEMPHEAD ) {
 		return ent->parent - g_entities;
 	}
@@ -225,56 +249,653 @@ int G_SwitchBodyPartEntity( gentity_t* ent ) {
 		results->entityNum = res;				\
 	}
 
-// Run a trace with players in historical positions.
-void G_HistoricalTrace( gentity_t* ent, trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask ) {
+// trace with the temporary head and leg entities linked, the players are
+// wherever they are linked at the moment
+static void G_BodyPartTrace( gentity_t* ent, trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask ) {
 	int res;
 	vec3_t dir;
 
-	if ( !g_antilag.integer || !ent->client ) {
-		G_AttachBodyParts( ent );
+	G_AttachBodyParts( ent );
 
-		trap_Trace( results, start, mins, maxs, end, passEntityNum, contentmask );
+	trap_Trace( results, start, mins, maxs, end, passEntityNum, contentmask );
 
-		res = G_SwitchBodyPartEntity( &g_entities[ results->entityNum ] );
-		POSITION_READJUST
+	res = G_SwitchBodyPartEntity( &g_entities[ results->entityNum ] );
+	POSITION_READJUST
+
+	G_DettachBodyParts();
+}
+
+/*
+===============================================================================
+
+ANTILAG HIT BOXES
+
+Instead of moving every player back in time and linking temporary head and
+leg entities for each shot, the positions at the shooter's command time are
+kept here and shots are clipped against them directly. The engine trace only
+sees the world and entities that are not bodies. Nothing in the game gives
+CONTENTS_BODY to anything but clients, so that split leaves no entity out.
 
-		G_DettachBodyParts();
+The clipping repeats the collision code's arithmetic for bounding boxes,
+including the bounds pre-reject it does while cm_optimize is set, so
+fractions, end positions and planes come out the same as with the entities
+linked. The only possible difference is which of two entities hit at exactly
+the same fraction is reported, which depends on the world sector link order
+in the engine as well.
+
+===============================================================================
+*/
+
+// boxes are entered this far in front of a face, SURFACE_CLIP_EPSILON
+#define ANTILAG_CLIP_EPSILON    ( 0.125 )
+
+typedef struct {
+	vec3_t origin;
+	vec3_t mins;
+	vec3_t maxs;
+	vec3_t absmin;              // what linking the box would set
+	vec3_t absmax;
+	int contents;
+	int entityNum;              // reported on a hit
+	qboolean bodyPart;          // head or leg, hits are pulled back like G_SwitchBodyPartEntity ones
+} antilagBox_t;
+
+// players as rewound by G_HistoricalTraceBegin
+static struct {
+	gentity_t   *ent;           // shooter, NULL when nothing is rewound
+	int time;
+	qboolean relinked;          // the players have been moved for real
+	qboolean rewound[MAX_CLIENTS];
+	vec3_t origin[MAX_CLIENTS];
+	vec3_t mins[MAX_CLIENTS];
+	vec3_t maxs[MAX_CLIENTS];
+} antilag;
+
+/*
+==============
+G_AntilagRewind
+
+Records where every target was at time, like G_AdjustClientPositions but
+without moving anyone
+==============
+*/
+static void G_AntilagRewind( gentity_t* ent, int time ) {
+	int i, num;
+	gentity_t   *list;
+
+	antilag.ent = ent;
+	antilag.time = time;
+	antilag.relinked = qfalse;
+	memset( antilag.rewound, 0, sizeof( antilag.rewound ) );
+
+	for ( i = 0; i < level.numConnectedClients; i++ ) {
+		num = level.sortedClients[i];
+		list = g_entities + num;
+		if ( G_AntilagTarget( list, ent ) ) {
+			antilag.rewound[num] = G_ClientMarkerPosition( list, time, antilag.origin[num], antilag.mins[num], antilag.maxs[num] );
+		}
+	}
+}
+
+/*
+==============
+G_AntilagRelink
+
+Moves the rewound players for real, once something else than a trace
+needs to see them where they were
+==============
+*/
+static void G_AntilagRelink( void ) {
+	if ( !antilag.ent || antilag.relinked ) {
 		return;
 	}
 
-	G_AdjustClientPositions( ent, ent->client->pers.cmd.serverTime, qtrue );
+	G_AdjustClientPositions( antilag.ent, antilag.time, qtrue );
+	antilag.relinked = qtrue;
+}
 
-	G_AttachBodyParts( ent ) ;
+static void G_AntilagSetBox( antilagBox_t *box, int contents, int entityNum, qboolean bodyPart ) {
+	// same as SV_LinkEntity for boxes
+	VectorAdd( box->origin, box->mins, box->absmin );
+	VectorAdd( box->origin, box->maxs, box->absmax );
+	box->absmin[0] -= 1;
+	box->absmin[1] -= 1;
+	box->absmin[2] -= 1;
+	box->absmax[0] += 1;
+	box->absmax[1] += 1;
+	box->absmax[2] += 1;
+
+	box->contents = contents;
+	box->entityNum = entityNum;
+	box->bodyPart = bodyPart;
+}
 
-	trap_Trace( results, start, mins, maxs, end, passEntityNum, contentmask );
+/*
+==============
+G_AntilagClipBrush
 
-	res = G_SwitchBodyPartEntity( &g_entities[ results->entityNum ] );
-	POSITION_READJUST
+CM_TraceThroughBrush for the six sided brush of a temporary box model, with
+start and end relative to the box origin
+==============
+*/
+static void G_AntilagClipBrush( trace_t *tr, const vec3_t start, const vec3_t end, const antilagBox_t *box ) {
+	vec3_t normal;
+	double dist, d1, d2;
+	float f, enterFrac, leaveFrac;
+	qboolean getout, startout;
+	int i, axis, clipSide;
+
+	enterFrac = -1.0;
+	leaveFrac = 1.0;
+	clipSide = -1;
+
+	getout = qfalse;
+	startout = qfalse;
+
+	// the brush sides are +x -x +y -y +z -z
+	for ( i = 0; i < 6; i++ ) {
+		axis = i >> 1;
+		VectorClear( normal );
+		if ( i & 1 ) {
+			normal[axis] = -1;
+			dist = -box->mins[axis];
+		} else {
+			normal[axis] = 1;
+			dist = box->maxs[axis];
+		}
 
-	G_DettachBodyParts();
+		d1 = (double)start[0] * normal[0] + (double)start[1] * normal[1] + (double)start[2] * normal[2] - dist;
+		d2 = (double)end[0] * normal[0] + (double)end[1] * normal[1] + (double)end[2] * normal[2] - dist;
 
-	G_AdjustClientPositions( ent, 0, qfalse );
+		if ( d2 > 0 ) {
+			getout = qtrue; // endpoint is not in solid
+		}
+		if ( d1 > 0 ) {
+			startout = qtrue;
+		}
+
+		// if completely in front of face, no intersection with the entire brush
+		if ( d1 > 0 && ( d2 >= ANTILAG_CLIP_EPSILON || d2 >= d1 ) ) {
+			return;
+		}
+
+		// if it doesn't cross the plane, the plane isn't relevant
+		if ( d1 <= 0 && d2 <= 0 ) {
+			continue;
+		}
+
+		// crosses face
+		if ( d1 > d2 ) {    // enter
+			f = ( d1 - ANTILAG_CLIP_EPSILON ) / ( d1 - d2 );
+			if ( f < 0 ) {
+				f = 0;
+			}
+			if ( f > enterFrac ) {
+				enterFrac = f;
+				clipSide = i;
+			}
+		} else {    // leave
+			f = ( d1 + ANTILAG_CLIP_EPSILON ) / ( d1 - d2 );
+			if ( f > 1 ) {
+				f = 1;
+			}
+			if ( f < leaveFrac ) {
+				leaveFrac = f;
+			}
+		}
+	}
+
+	if ( !startout ) {  // original point was inside brush
+		tr->startsolid = qtrue;
+		if ( !getout ) {
+			tr->allsolid = qtrue;
+			tr->fraction = 0;
+			tr->contents = box->contents;
+		}
+		return;
+	}
+
+	if ( enterFrac < leaveFrac ) {
+		if ( enterFrac > -1 && enterFrac < tr->fraction ) {
+			if ( enterFrac < 0 ) {
+				enterFrac = 0;
+			}
+			tr->fraction = enterFrac;
+			if ( clipSide >= 0 ) {
+				// the temporary box model's planes
+				axis = clipSide >> 1;
+				if ( clipSide & 1 ) {
+					tr->plane.normal[axis] = -1;
+					tr->plane.dist = -box->mins[axis];
+					tr->plane.type = 3 + axis;
+					tr->plane.signbits = 1 << axis;
+				} else {
+					tr->plane.normal[axis] = 1;
+					tr->plane.dist = box->maxs[axis];
+					tr->plane.type = axis;
+				}
+			}
+			tr->contents = box->contents;
+		}
+	}
+}
+
+/*
+==============
+G_AntilagTraceThroughBounds
+
+CM_TraceThroughBounds for a point trace against the box brush, which skips
+boxes the move can't touch before they are clipped. It doesn't know about
+SURFACE_CLIP_EPSILON, so it has to be repeated for grazing traces to come
+out the same.
+==============
+*/
+static qboolean G_AntilagTraceThroughBounds( const vec3_t start, const vec3_t end, const antilagBox_t *box ) {
+	vec3_t dir, normal, planes[2], center, extents;
+	float lo, hi, d1, d2;
+	int i;
+
+	// CM_CalcTraceBounds, expanded for epsilon
+	VectorSubtract( end, start, dir );
+	for ( i = 0; i < 3; i++ ) {
+		if ( start[i] < end[i] ) {
+			lo = start[i];
+			hi = start[i] + 1.0f * dir[i];
+		} else {
+			lo = start[i] + 1.0f * dir[i];
+			hi = start[i];
+		}
+		if ( box->mins[i] > hi + 1.0f || box->maxs[i] < lo - 1.0f ) {
+			return qfalse;
+		}
+	}
+
+	// distance from the two planes along the move, which are a point
+	// trace's width plus epsilon apart
+	VectorCopy( dir, normal );
+	VectorNormalize( normal );
+	MakeNormalVectors( normal, planes[0], planes[1] );
+
+	VectorAdd( box->mins, box->maxs, center );
+	VectorScale( center, 0.5f, center );
+	VectorSubtract( box->maxs, center, extents );
+
+	for ( i = 0; i < 2; i++ ) {
+		// CM_BoxDistanceFromPlane
+		d1 = DotProduct( center, planes[i] ) - DotProduct( planes[i], start );
+		d2 = fabs( extents[0] * planes[i][0] ) + fabs( extents[1] * planes[i][1] ) + fabs( extents[2] * planes[i][2] );
+		if ( d1 - d2 > 0.0f ) {
+			d1 = d1 - d2;
+		} else if ( d1 + d2 < 0.0f ) {
+			d1 = d1 + d2;
+		} else {
+			d1 = 0.0f;
+		}
+		if ( fabs( d1 ) > 1.0f ) {
+			return qfalse;
+		}
+	}
+
+	return qtrue;
+}
+
+/*
+==============
+G_AntilagClipBox
+
+Point trace against a box, CM_TransformedBoxTrace with a temporary box model
+==============
+*/
+static void G_AntilagClipBox( trace_t *tr, const vec3_t start, const vec3_t end, const antilagBox_t *box ) {
+	vec3_t start_l, end_l;
+
+	memset( tr, 0, sizeof( *tr ) );
+	tr->fraction = 1.0f;
+
+	VectorSubtract( start, box->origin, start_l );
+	VectorSubtract( end, box->origin, end_l );
+
+	if ( !g_cmOptimize.integer || G_AntilagTraceThroughBounds( start_l, end_l, box ) ) {
+		G_AntilagClipBrush( tr, start_l, end_l, box );
+	}
+
+	tr->endpos[0] = start[0] + tr->fraction * ( end[0] - start[0] );
+	tr->endpos[1] = start[1] + tr->fraction * ( end[1] - start[1] );
+	tr->endpos[2] = start[2] + tr->fraction * ( end[2] - start[2] );
+}
+
+/*
+==============
+G_AntilagTrace
+
+trap_Trace with the players at their antilag positions and head and leg boxes
+attached, without linking anything. Returns qfalse if the trace can not be
+done this way, the players then have to be moved for real.
+==============
+*/
+static qboolean G_AntilagTrace( gentity_t* ent, trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask ) {
+	static antilagBox_t boxes[MAX_CLIENTS * 3];
+	antilagBox_t *box;
+	gentity_t   *list;
+	trace_t trace;
+	vec3_t boxmins, boxmaxs, dir;
+	const float *origin;
+	int passOwnerNum, numBoxes, num, i;
+	qboolean rewound, bodyPart;
+
+	// only point traces, position tests take another path in the engine
+	if ( ( mins && !VectorCompare( mins, vec3_origin ) ) || ( maxs && !VectorCompare( maxs, vec3_origin ) ) ||
+		 VectorCompare( start, end ) ) {
+		return qfalse;
+	}
+
+	if ( passEntityNum != ENTITYNUM_NONE ) {
+		passOwnerNum = g_entities[passEntityNum].r.ownerNum;
+		if ( passOwnerNum == ENTITYNUM_NONE ) {
+			passOwnerNum = -1;
+		}
+	} else {
+		passOwnerNum = -1;
+	}
+
+	numBoxes = 0;
+
+	// bodies
+	for ( num = 0; num < level.maxclients; num++ ) {
+		list = g_entities + num;
+		if ( !list->r.linked || !( list->r.contents & contentmask ) ) {
+			continue;
+		}
+
+		rewound = antilag.ent && !antilag.relinked && antilag.rewound[num];
+
+		if ( list->r.contents & contentmask & ~CONTENTS_BODY ) {
+			if ( rewound ) {
+				return qfalse;  // the engine trace would find it where it stands
+			}
+			continue;
+		}
+
+		if ( passEntityNum != ENTITYNUM_NONE &&
+			 ( num == passEntityNum || list->r.ownerNum == passEntityNum || list->r.ownerNum == passOwnerNum ) ) {
+			continue;
+		}
+
+		if ( list->r.bmodel || ( list->r.svFlags & SVF_CAPSULE ) ) {
+			return qfalse;
+		}
+
+		box = &boxes[numBoxes++];
+		if ( rewound ) {
+			VectorCopy( antilag.origin[num], box->origin );
+			VectorCopy( antilag.mins[num], box->mins );
+			VectorCopy( antilag.maxs[num], box->maxs );
+			G_AntilagSetBox( box, list->r.contents, num, qfalse );
+		} else {
+			VectorCopy( list->r.currentOrigin, box->origin );
+			VectorCopy( list->r.mins, box->mins );
+			VectorCopy( list->r.maxs, box->maxs );
+			G_AntilagSetBox( box, list->r.contents, num, qfalse );
+			// where it was last linked, which is what the engine goes by
+			VectorCopy( list->r.absmin, box->absmin );
+			VectorCopy( list->r.absmax, box->absmax );
+		}
+	}
+
+	// heads and legs, G_AttachBodyParts
+	if ( contentmask & CONTENTS_SOLID ) {
+		for ( i = 0; i < level.numConnectedClients; i++ ) {
+			num = level.sortedClients[i];
+			list = g_entities + num;
+			if ( !G_AntilagTarget( list, ent ) ) {
+				continue;
+			}
+
+			if ( antilag.ent && !antilag.relinked && antilag.rewound[num] ) {
+				origin = antilag.origin[num];
+			} else {
+				origin = list->r.currentOrigin;
+			}
+
+			box = &boxes[numBoxes++];
+			G_HeadBox( list, origin, box->origin, box->mins, box->maxs );
+			G_AntilagSetBox( box, CONTENTS_SOLID, num, qtrue );
+
+			box = &boxes[numBoxes];
+			if ( G_LegBox( list, origin, box->origin, box->mins, box->maxs ) ) {
+				G_AntilagSetBox( box, CONTENTS_SOLID, num, qtrue );
+				numBoxes++;
+			}
+		}
+	}
+
+	trap_Trace( results, start, NULL, NULL, end, passEntityNum, contentmask & ~CONTENTS_BODY );
+
+	if ( results->fraction == 0 && results->entityNum == ENTITYNUM_WORLD ) {
+		return qtrue;   // blocked immediately by the world
+	}
+
+	// SV_Trace only looks at entities linked in the box of the entire move
+	for ( i = 0; i < 3; i++ ) {
+		if ( end[i] > start[i] ) {
+			boxmins[i] = start[i] - 1;
+			boxmaxs[i] = end[i] + 1;
+		} else {
+			boxmins[i] = end[i] - 1;
+			boxmaxs[i] = start[i] + 1;
+		}
+	}
+
+	// SV_ClipMoveToEntities
+	bodyPart = qfalse;
+	for ( i = 0, box = boxes; i < numBoxes; i++, box++ ) {
+		if ( results->allsolid ) {
+			break;
+		}
+
+		if ( box->absmin[0] > boxmaxs[0] || box->absmin[1] > boxmaxs[1] || box->absmin[2] > boxmaxs[2] ||
+			 box->absmax[0] < boxmins[0] || box->absmax[1] < boxmins[1] || box->absmax[2] < boxmins[2] ) {
+			continue;
+		}
+
+		G_AntilagClipBox( &trace, start, end, box );
+
+		if ( trace.allsolid ) {
+			results->allsolid = qtrue;
+		} else if ( trace.startsolid ) {
+			results->startsolid = qtrue;
+		}
+
+		if ( trace.fraction < results->fraction ) {
+			qboolean oldStart;
+
+			// make sure we keep a startsolid from a previous trace
+			oldStart = results->startsolid;
+
+			trace.entityNum = box->entityNum;
+			*results = trace;
+			results->startsolid |= oldStart;
+
+			bodyPart = box->bodyPart;
+		}
+	}
+
+	if ( bodyPart ) {
+		VectorSubtract( end, start, dir );
+		VectorNormalizeFast( dir );
+
+		VectorMA( results->endpos, -1, dir, results->endpos );
+	}
+
+	return qtrue;
+}
+
+// trace against the players at the positions of the open rewind, if any
+static void G_RewoundTrace( gentity_t* ent, trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask ) {
+	if ( !G_AntilagTrace( ent, results, start, mins, maxs, end, passEntityNum, contentmask ) ) {
+		G_AntilagRelink();
+		G_BodyPartTrace( ent, results, start, mins, maxs, end, passEntityNum, contentmask );
+	}
+}
+
+// Run a trace with players in historical positions.
+void G_HistoricalTrace( gentity_t* ent, trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask ) {
+	if ( !g_antilag.integer || !ent->client ) {
+		G_RewoundTrace( ent, results, start, mins, maxs, end, passEntityNum, contentmask );
+		return;
+	}
+
+	G_HistoricalTraceBegin( ent );
+
+	G_RewoundTrace( ent, results, start, mins, maxs, end, passEntityNum, contentmask );
+
+	G_HistoricalTraceEnd( ent );
 }
 
 void G_HistoricalTraceBegin( gentity_t *ent ) {
-	G_AdjustClientPositions( ent, ent->client->pers.cmd.serverTime, qtrue );
+	G_AntilagRewind( ent, ent->client->pers.cmd.serverTime );
 }
 
 void G_HistoricalTraceEnd( gentity_t *ent ) {
-	G_AdjustClientPositions( ent, 0, qfalse );
+	if ( antilag.relinked ) {
+		G_AdjustClientPositions( ent, 0, qfalse );
+	}
+	antilag.ent = NULL;
 }
 
 //bani - Run a trace without fixups (historical fixups will be done externally)
 void G_Trace( gentity_t* ent, trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask ) {
-	int res;
-	vec3_t dir;
+	gentity_t *traceEnt;
 
-	G_AttachBodyParts( ent );
+	G_RewoundTrace( ent, results, start, mins, maxs, end, passEntityNum, contentmask );
 
-	trap_Trace( results, start, mins, maxs, end, passEntityNum, contentmask );
+	// damage code looks at where the victim and everyone around it are
+	if ( results->entityNum < ENTITYNUM_MAX_NORMAL ) {
+		traceEnt = &g_entities[ results->entityNum ];
+		if ( traceEnt->takedamage || traceEnt->client ) {
+			G_AntilagRelink();
+		}
+	}
+}
 
-	res = G_SwitchBodyPartEntity( &g_entities[ results->entityNum ] );
-	POSITION_READJUST
+/*
+==============
+G_AntilagBench_f
 
-	G_DettachBodyParts();
+antilagbench [shots]
+
+Fires shots from every player at the heads of the others, once with the
+players moved and the head and leg entities linked and once against the
+antilag hit boxes, then reports shots per millisecond of both and how many
+traces came out different
+==============
+*/
+#define ANTILAG_BENCH_SHOTS     1024
+
+void G_AntilagBench_f( void ) {
+	static vec3_t starts[ANTILAG_BENCH_SHOTS], ends[ANTILAG_BENCH_SHOTS];
+	static int shooters[ANTILAG_BENCH_SHOTS], times[ANTILAG_BENCH_SHOTS];
+	static trace_t linked[ANTILAG_BENCH_SHOTS], boxed[ANTILAG_BENCH_SHOTS];
+	int players[MAX_CLIENTS];
+	char arg[MAX_TOKEN_CHARS];
+	gentity_t   *shooter, *target;
+	vec3_t origin, mins, maxs, dir;
+	int numPlayers, shots, rounds, round, fallbacks, differ, i, j;
+	int linkedMsec, boxedMsec, t;
+
+	shots = 100000;
+	if ( trap_Argc() > 1 ) {
+		trap_Argv( 1, arg, sizeof( arg ) );
+		shots = atoi( arg );
+	}
+	rounds = ( shots + ANTILAG_BENCH_SHOTS - 1 ) / ANTILAG_BENCH_SHOTS;
+	if ( rounds < 1 ) {
+		rounds = 1;
+	}
+
+	numPlayers = 0;
+	for ( i = 0; i < level.numConnectedClients; i++ ) {
+		if ( G_AntilagTarget( g_entities + level.sortedClients[i], NULL ) ) {
+			players[numPlayers++] = level.sortedClients[i];
+		}
+	}
+
+	if ( numPlayers < 2 ) {
+		G_Printf( "antilagbench: needs at least two players in the game\n" );
+		return;
+	}
+
+	for ( i = 0; i < ANTILAG_BENCH_SHOTS; i++ ) {
+		shooter = g_entities + players[i % numPlayers];
+		target = g_entities + players[( i / numPlayers + 1 + i ) % numPlayers];
+		if ( target == shooter ) {
+			target = g_entities + players[( i + 1 ) % numPlayers];
+		}
+
+		VectorCopy( shooter->r.currentOrigin, starts[i] );
+		starts[i][2] += shooter->client->ps.viewheight;
+
+		// around the head, so shots hit heads, bodies and nothing
+		G_HeadBox( target, target->r.currentOrigin, origin, mins, maxs );
+		origin[0] += crandom() * 16;
+		origin[1] += crandom() * 16;
+		origin[2] += crandom() * 24;
+
+		VectorSubtract( origin, starts[i], dir );
+		VectorNormalize( dir );
+		VectorMA( starts[i], 8192, dir, ends[i] );
+
+		shooters[i] = shooter - g_entities;
+		times[i] = level.time - ( i * 37 ) % 250;
+	}
+
+	// players moved and relinked, head and leg entities spawned for each shot
+	t = trap_Milliseconds();
+	for ( round = 0; round < rounds; round++ ) {
+		for ( i = 0; i < ANTILAG_BENCH_SHOTS; i++ ) {
+			shooter = g_entities + shooters[i];
+			G_AdjustClientPositions( shooter, times[i], qtrue );
+			G_BodyPartTrace( shooter, &linked[i], starts[i], NULL, NULL, ends[i], shooters[i], MASK_SHOT );
+			G_AdjustClientPositions( shooter, 0, qfalse );
+		}
+	}
+	linkedMsec = trap_Milliseconds() - t;
+
+	// hit boxes
+	fallbacks = 0;
+	t = trap_Milliseconds();
+	for ( round = 0; round < rounds; round++ ) {
+		for ( i = 0; i < ANTILAG_BENCH_SHOTS; i++ ) {
+			shooter = g_entities + shooters[i];
+			G_AntilagRewind( shooter, times[i] );
+			if ( !G_AntilagTrace( shooter, &boxed[i], starts[i], NULL, NULL, ends[i], shooters[i], MASK_SHOT ) ) {
+				G_AntilagRelink();
+				G_BodyPartTrace( shooter, &boxed[i], starts[i], NULL, NULL, ends[i], shooters[i], MASK_SHOT );
+				fallbacks++;
+			}
+			G_HistoricalTraceEnd( shooter );
+		}
+	}
+	boxedMsec = trap_Milliseconds() - t;
+
+	differ = 0;
+	for ( i = 0, j = 0; i < ANTILAG_BENCH_SHOTS; i++ ) {
+		if ( linked[i].entityNum != ENTITYNUM_WORLD && linked[i].entityNum != ENTITYNUM_NONE ) {
+			j++;
+		}
+		if ( memcmp( &linked[i], &boxed[i], sizeof( trace_t ) ) ) {
+			if ( !differ ) {
+				G_Printf( "antilagbench: shot %i: linked %i %f (%f %f %f), boxes %i %f (%f %f %f)\n", i,
+						  linked[i].entityNum, linked[i].fraction, linked[i].endpos[0], linked[i].endpos[1], linked[i].endpos[2],
+						  boxed[i].entityNum, boxed[i].fraction, boxed[i].endpos[0], boxed[i].endpos[1], boxed[i].endpos[2] );
+			}
+			differ++;
+		}
+	}
+
+	shots = rounds * ANTILAG_BENCH_SHOTS;
+	G_Printf( "antilagbench: %i players, %i shots, %i of %i distinct shots hit an entity\n", numPlayers, shots, j, ANTILAG_BENCH_SHOTS );
+	G_Printf( "  relinking: %i msec, %.1f shots/msec\n", linkedMsec, linkedMsec ? (float)shots / linkedMsec : 0.0f );
+	G_Printf( "  hit boxes: %i msec, %.1f shots/msec, %i fell back\n", boxedMsec, boxedMsec ? (float)shots / boxedMsec : 0.0f, fallbacks );
+	G_Printf( "  %i of %i traces differ\n", differ, ANTILAG_BENCH_SHOTS );
 }
@@ -37,11 +37,11 @@ If you have questions concerning this license or the applicable additional terms
 void waypoint_think( gentity_t *ent ) {
 
 	if( level.time - ent->lastHintCheckTime < WAYPOINTSET_POSTDELAY_TIME ) {
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 		return;
 	}
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 }
 
@@ -72,7 +72,7 @@ void G_SetWayPoint( gentity_t *ent, wayPointType_t wayPointType, vec3_t loc ) {
 		wp->s.clientNum = ent->s.number;
 
 		wp->think = waypoint_think;
-		wp->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( wp, level.time + FRAMETIME );
 
 		// Set location
 		VectorCopy( loc, wp->s.pos.trBase );
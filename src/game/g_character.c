@@ -227,3 +227,164 @@ set_default_character:
 		client->ps.torsoTimer = 0;
 	}
 }
+
+/*
+=================
+G_AnimBench_f
+
+animbench [ticks]
+
+Replays movement ticks for every client slot against the loaded animation
+scripts, picking a locomotion and an event item per tick once with
+BG_EvaluateConditions on each item like BG_FirstValidItem used to and once
+with the compiled condition bits, then reports the time of both and how many
+picks came out different
+=================
+*/
+typedef animScriptItem_t *( *animBenchPick_t )( int client, animScript_t *script );
+
+static int animBenchDiffer;
+
+static animScriptItem_t *G_AnimBenchScan( int client, animScript_t *script ) {
+	int i;
+
+	for ( i = 0; i < script->numItems; i++ ) {
+		if ( BG_EvaluateConditions( client, script->items[i] ) ) {
+			return script->items[i];
+		}
+	}
+
+	return NULL;
+}
+
+static animScriptItem_t *G_AnimBenchCompare( int client, animScript_t *script ) {
+	animScriptItem_t *item = BG_FirstValidItem( client, script );
+
+	if ( item != G_AnimBenchScan( client, script ) ) {
+		animBenchDiffer++;
+	}
+
+	return item;
+}
+
+static int G_AnimBenchRun( animModelInfo_t **models, int numModels, int ticks, animBenchPick_t pick ) {
+	static playerState_t states[MAX_CLIENTS];
+	playerState_t   *ps;
+	animModelInfo_t *animModelInfo;
+	pmove_t pm;
+	int movetypes[MAX_CLIENTS];
+	int seed, picks, tick, client, state, r;
+
+	memset( states, 0, sizeof( states ) );
+	memset( &pm, 0, sizeof( pm ) );
+	seed = 0x2a;
+	picks = 0;
+
+	for ( client = 0; client < MAX_CLIENTS; client++ ) {
+		states[client].clientNum = client;
+		states[client].weapon = WP_MP40;
+		movetypes[client] = ANIM_MT_IDLE;
+	}
+
+	for ( tick = 0; tick < ticks; tick++ ) {
+		for ( client = 0, ps = states; client < MAX_CLIENTS; client++, ps++ ) {
+			animModelInfo = models[client % numModels];
+
+			// weapon switches are rare, movement and firing change all the time
+			r = Q_rand( &seed );
+			if ( !( r & 63 ) ) {
+				ps->weapon = Q_rand( &seed ) % WP_NUM_WEAPONS;
+			}
+			if ( !( r & 7 ) ) {
+				movetypes[client] = 1 + Q_rand( &seed ) % ( NUM_ANIM_MOVETYPES - 1 );
+			}
+			ps->eFlags = ( r & 0x300 ) ? 0 : EF_ZOOMING;
+			ps->viewangles[0] = ( r & 0x400 ) ? 10 : -10;
+			pm.ps = ps;
+			pm.cmd.buttons = ( r & 0x800 ) ? BUTTON_ATTACK : 0;
+
+			BG_AnimUpdatePlayerStateConditions( &pm );
+			BG_UpdateConditionValue( client, ANIM_COND_CROUCHING, ( r & 0x3000 ) == 0x3000, qtrue );
+			BG_UpdateConditionValue( client, ANIM_COND_UNDERWATER, ( r & 0xc000 ) == 0xc000, qtrue );
+
+			// the same search as BG_AnimScriptAnimation
+			for ( state = ps->aiState; state < MAX_AISTATES; state++ ) {
+				if ( !animModelInfo->scriptAnims[state][movetypes[client]].numItems ) {
+					continue;
+				}
+				picks++;
+				if ( pick( client, &animModelInfo->scriptAnims[state][movetypes[client]] ) ) {
+					break;
+				}
+			}
+			BG_UpdateConditionValue( client, ANIM_COND_MOVETYPE, movetypes[client], qtrue );
+
+			r = Q_rand( &seed ) % NUM_ANIM_EVENTTYPES;
+			if ( animModelInfo->scriptEvents[r].numItems ) {
+				picks++;
+				pick( client, &animModelInfo->scriptEvents[r] );
+			}
+		}
+	}
+
+	return picks;
+}
+
+void G_AnimBench_f( void ) {
+	static int conditions[MAX_CLIENTS][NUM_ANIM_CONDITIONS][2];
+	static int conditionBits[MAX_CLIENTS][NUM_ANIM_CONDITIONS][2];
+	static qboolean conditionBitsValid[MAX_CLIENTS];
+	static const animBenchPick_t pickers[] = { G_AnimBenchScan, BG_FirstValidItem, G_AnimBenchCompare };
+	animModelInfo_t *models[MAX_ANIMSCRIPT_MODELS];
+	animScriptData_t *scriptData = &level.animScriptData;
+	char arg[MAX_TOKEN_CHARS];
+	int msec[ARRAY_LEN( pickers )];
+	int numModels, ticks, picks, i, t;
+
+	ticks = 2000;
+	if ( trap_Argc() > 1 ) {
+		trap_Argv( 1, arg, sizeof( arg ) );
+		ticks = atoi( arg );
+	}
+	if ( ticks < 1 ) {
+		ticks = 1;
+	}
+
+	numModels = 0;
+	for ( i = 0; i < MAX_ANIMSCRIPT_MODELS; i++ ) {
+		if ( scriptData->modelInfo[i].numScriptItems ) {
+			models[numModels++] = &scriptData->modelInfo[i];
+		}
+	}
+
+	if ( !numModels ) {
+		G_Printf( "animbench: no animation scripts loaded\n" );
+		return;
+	}
+
+	// the ticks run on every client slot, the real conditions go back afterwards
+	memcpy( conditions, scriptData->clientConditions, sizeof( conditions ) );
+	memcpy( conditionBits, scriptData->clientConditionBits, sizeof( conditionBits ) );
+	memcpy( conditionBitsValid, scriptData->clientConditionBitsValid, sizeof( conditionBitsValid ) );
+
+	animBenchDiffer = 0;
+	for ( i = 0; i < ARRAY_LEN( pickers ); i++ ) {
+		// every run starts from the same conditions
+		memcpy( scriptData->clientConditions, conditions, sizeof( conditions ) );
+		memcpy( scriptData->clientConditionBits, conditionBits, sizeof( conditionBits ) );
+		memcpy( scriptData->clientConditionBitsValid, conditionBitsValid, sizeof( conditionBitsValid ) );
+
+		t = trap_Milliseconds();
+		picks = G_AnimBenchRun( models, numModels, ticks, pickers[i] );
+		msec[i] = trap_Milliseconds() - t;
+	}
+
+	memcpy( scriptData->clientConditions, conditions, sizeof( conditions ) );
+	memcpy( scriptData->clientConditionBits, conditionBits, sizeof( conditionBits ) );
+	memcpy( scriptData->clientConditionBitsValid, conditionBitsValid, sizeof( conditionBitsValid ) );
+
+	G_Printf( "animbench: %i models, %i clients, %i ticks, %i picks\n", numModels, MAX_CLIENTS, ticks, picks );
+	G_Printf( "  conditions: %i msec\n", msec[0] );
+	G_Printf( "  bits:       %i msec\n", msec[1] );
+	G_Printf( "  %i picks differ\n", animBenchDiffer );
+}
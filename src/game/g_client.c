@@ -324,7 +324,7 @@ After sitting around for five seconds, fall into the ground and dissapear
 */
 void BodySink2( gentity_t *ent ) {
 	ent->physicsObject = qfalse;
-	ent->nextthink = level.time + BODY_TIME( BODY_TEAM( ent ) ) + 1500;
+	G_SetNextThink( ent, level.time + BODY_TIME( BODY_TEAM( ent ) ) + 1500 );
 	ent->think = BodyUnlink;
 	ent->s.pos.trType = TR_LINEAR;
 	ent->s.pos.trTime = level.time;
@@ -343,7 +343,7 @@ void BodySink( gentity_t *ent ) {
 	if ( ent->activator ) {
 		// see if parent is still disguised
 		if ( ent->activator->client->ps.powerups[PW_OPS_DISGUISED] ) {
-			ent->nextthink = level.time + 100;
+			G_SetNextThink( ent, level.time + 100 );
 			return;
 		} else {
 			ent->activator = NULL;
@@ -454,7 +454,7 @@ void CopyToBodyQue( gentity_t *ent ) {
 
 	body->activator = NULL;
 
-	body->nextthink = level.time + BODY_TIME( ent->client->sess.sessionTeam );
+	G_SetNextThink( body, level.time + BODY_TIME( ent->client->sess.sessionTeam ) );
 
 	body->think = BodySink;
 
@@ -1566,6 +1566,7 @@ const char *ClientConnect( int clientNum, qboolean firstTime, qboolean isBot ) {
 	client = ent->client;
 
 	memset( client, 0, sizeof( *client ) );
+	G_ClearScoreBaseline( clientNum );
 
 	client->ps.clientNum = clientNum;
 
@@ -1634,7 +1635,7 @@ const char *ClientConnect( int clientNum, qboolean firstTime, qboolean isBot ) {
 	if ( g_gametype.integer == GT_SINGLE_PLAYER ) {
 
 		if ( !isBot ) {
-			ent->scriptName = "player";
+			G_SetScriptName( ent, "player" );
 
 // START	Mad Doctor I changes, 8/14/2002
 			// We must store this here, so that BotFindEntityForName can find the
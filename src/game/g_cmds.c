@@ -30,6 +30,182 @@ If you have questions concerning this license or the applicable additional terms
 
 qboolean G_IsOnFireteam( int entityNum, fireteamData_t** teamNum );
 
+#define SCORE_ROW_FIELDS        7
+#define SCORE_FULL_INTERVAL     10000   // in msec
+
+// what a client that takes scd deltas was last sent
+typedef struct {
+	qboolean delta;                         // it asked with "score <sequence>"
+	int sequence;                           // last scd sent, 0 when it has no scoreboard to apply one to
+	int lastSequence;
+	int fullTime;                           // level.time of the last scd built from an empty scoreboard
+	int teamScores[2];
+	int numRows;
+	int rows[MAX_CLIENTS][SCORE_ROW_FIELDS];
+} scoreBaseline_t;
+
+static scoreBaseline_t scoreBaselines[MAX_CLIENTS];
+
+/*
+==================
+G_ClearScoreBaseline
+
+A new client gets old style scoreboards until its cgame asks for deltas
+==================
+*/
+void G_ClearScoreBaseline( int clientNum ) {
+	memset( &scoreBaselines[clientNum], 0, sizeof( scoreBaselines[0] ) );
+}
+
+/*
+==================
+G_ScoreRows
+
+Fills in the scoreboard rows as ent sees them, in rank order
+==================
+*/
+static int G_ScoreRows( gentity_t *ent, int rows[MAX_CLIENTS][SCORE_ROW_FIELDS] ) {
+	int i, numSorted, numRows;
+	gclient_t   *cl;
+
+	numSorted = level.numConnectedClients;
+	if ( numSorted > MAX_CLIENTS ) {
+		numSorted = MAX_CLIENTS;
+	}
+
+	for ( numRows = 0, i = 0; i < numSorted; i++ ) {
+		int ping, playerClass, respawnsLeft, score;
+
+		cl = &level.clients[level.sortedClients[i]];
+
+		if ( g_entities[level.sortedClients[i]].r.svFlags & SVF_POW ) {
+			continue;
+		}
+
+		// NERVE - SMF - if on same team, send across player class
+		// Gordon: FIXME: remove/move elsewhere?
+		if ( cl->ps.persistant[PERS_TEAM] == ent->client->ps.persistant[PERS_TEAM] || G_smvLocateEntityInMVList( ent, level.sortedClients[i], qfalse ) ) {
+			playerClass = cl->ps.stats[STAT_PLAYER_CLASS];
+		} else {
+			playerClass = 0;
+		}
+
+		// NERVE - SMF - number of respawns left
+		respawnsLeft = cl->ps.persistant[PERS_RESPAWNS_LEFT];
+		if ( g_gametype.integer == GT_WOLF_LMS ) {
+			if ( g_entities[level.sortedClients[i]].health <= 0 ) {
+				respawnsLeft = -2;
+			}
+		} else {
+			if ( ( respawnsLeft == 0 && ( ( cl->ps.pm_flags & PMF_LIMBO ) || ( ( level.intermissiontime ) && g_entities[level.sortedClients[i]].health <= 0 ) ) ) ) {
+				respawnsLeft = -2;
+			}
+		}
+
+		if ( cl->pers.connected == CON_CONNECTING ) {
+			ping = -1;
+		} else {
+			ping = cl->ps.ping < 999 ? cl->ps.ping : 999;
+		}
+
+		if ( g_gametype.integer == GT_WOLF_LMS ) {
+			score = cl->ps.persistant[PERS_SCORE];
+		} else {
+			int j;
+
+			for ( score = 0, j = 0; j < SK_NUM_SKILLS; j++ ) {
+				score += cl->sess.skillpoints[j];
+			}
+		}
+
+		rows[numRows][0] = level.sortedClients[i];
+		rows[numRows][1] = score;
+		rows[numRows][2] = ping;
+		rows[numRows][3] = ( level.time - cl->pers.enterTime ) / 60000;
+		rows[numRows][4] = g_entities[level.sortedClients[i]].s.powerups;
+		rows[numRows][5] = playerClass;
+		rows[numRows][6] = respawnsLeft;
+		numRows++;
+	}
+
+	return numRows;
+}
+
+/*
+==================
+G_SendScoreDeltaCommand
+==================
+*/
+static void G_SendScoreDeltaCommand( gentity_t *ent, scoreBaseline_t *baseline, int numRows, int count, const char *buffer ) {
+	int sequence = ++baseline->lastSequence;
+
+	trap_SendServerCommand( ent - g_entities, va( "scd %i %i %i %i %i %i%s", baseline->sequence, sequence,
+												  level.teamScores[TEAM_AXIS], level.teamScores[TEAM_ALLIES], numRows, count, buffer ) );
+
+	baseline->sequence = sequence;
+}
+
+/*
+==================
+G_SendScoreDelta
+
+Sends only the rows that changed since the last scd, by position. A client
+without a base, and every client now and then so demos recorded from the
+middle of a chain pick one up, gets all of them against base 0.
+==================
+*/
+static void G_SendScoreDelta( gentity_t *ent, int rows[MAX_CLIENTS][SCORE_ROW_FIELDS], int numRows ) {
+	scoreBaseline_t *baseline = &scoreBaselines[ent - g_entities];
+	char entry[128];
+	char buffer[1024];
+	int i, size, count;
+	qboolean sent;
+
+	if ( baseline->sequence && level.time - baseline->fullTime >= SCORE_FULL_INTERVAL ) {
+		baseline->sequence = 0;
+	}
+	if ( !baseline->sequence ) {
+		baseline->numRows = 0;
+		baseline->fullTime = level.time;
+	}
+
+	sent = qfalse;
+	*buffer = '\0';
+	size = count = 0;
+
+	for ( i = 0; i < numRows; i++ ) {
+		if ( i < baseline->numRows && !memcmp( rows[i], baseline->rows[i], sizeof( rows[i] ) ) ) {
+			continue;
+		}
+
+		Com_sprintf( entry, sizeof( entry ), " %i %i %i %i %i %i %i %i", i, rows[i][0], rows[i][1], rows[i][2],
+					 rows[i][3], rows[i][4], rows[i][5], rows[i][6] );
+
+		// leave room for the header
+		if ( size + strlen( entry ) > 900 ) {
+			G_SendScoreDeltaCommand( ent, baseline, numRows, count, buffer );
+			sent = qtrue;
+			*buffer = '\0';
+			size = count = 0;
+		}
+
+		Q_strcat( buffer, sizeof( buffer ), entry );
+		size += strlen( entry );
+		count++;
+	}
+
+	if ( count || ( !sent && ( !baseline->sequence || numRows != baseline->numRows ||
+							   baseline->teamScores[0] != level.teamScores[TEAM_AXIS] ||
+							   baseline->teamScores[1] != level.teamScores[TEAM_ALLIES] ) ) ) {
+		G_SendScoreDeltaCommand( ent, baseline, numRows, count, buffer );
+	}
+
+	memcpy( baseline->rows, rows, numRows * sizeof( rows[0] ) );
+	baseline->numRows = numRows;
+	baseline->teamScores[0] = level.teamScores[TEAM_AXIS];
+	baseline->teamScores[1] = level.teamScores[TEAM_ALLIES];
+}
+
 /*
 ==================
 G_SendScore
@@ -38,18 +214,19 @@ Sends current scoreboard information
 ==================
 */
 void G_SendScore( gentity_t *ent ) {
-	char entry[128];
-	int i;
-	gclient_t   *cl;
-	int numSorted;
+	int rows[MAX_CLIENTS][SCORE_ROW_FIELDS];
+	int i, numRows;
 	int team, size, count;
+	char entry[128];
 	char buffer[1024];
 	char startbuffer[32];
 
 	// send the latest information on all clients
-	numSorted = level.numConnectedClients;
-	if ( numSorted > 64 ) {
-		numSorted = 64;
+	numRows = G_ScoreRows( ent, rows );
+
+	if ( scoreBaselines[ent - g_entities].delta ) {
+		G_SendScoreDelta( ent, rows, numRows );
+		return;
 	}
 
 	i = 0;
@@ -65,64 +242,18 @@ void G_SendScore( gentity_t *ent ) {
 		size = strlen( startbuffer ) + 1;
 		count = 0;
 
-		for (; i < numSorted ; i++ ) {
-			int ping, playerClass, respawnsLeft;
-
-			cl = &level.clients[level.sortedClients[i]];
-
-			if ( g_entities[level.sortedClients[i]].r.svFlags & SVF_POW ) {
-				continue;
-			}
-
-			// NERVE - SMF - if on same team, send across player class
-			// Gordon: FIXME: remove/move elsewhere?
-			if ( cl->ps.persistant[PERS_TEAM] == ent->client->ps.persistant[PERS_TEAM] || G_smvLocateEntityInMVList( ent, level.sortedClients[i], qfalse ) ) {
-				playerClass = cl->ps.stats[STAT_PLAYER_CLASS];
-			} else {
-				playerClass = 0;
-			}
-
-			// NERVE - SMF - number of respawns left
-			respawnsLeft = cl->ps.persistant[PERS_RESPAWNS_LEFT];
-			if ( g_gametype.integer == GT_WOLF_LMS ) {
-				if ( g_entities[level.sortedClients[i]].health <= 0 ) {
-					respawnsLeft = -2;
-				}
-			} else {
-				if ( ( respawnsLeft == 0 && ( ( cl->ps.pm_flags & PMF_LIMBO ) || ( ( level.intermissiontime ) && g_entities[level.sortedClients[i]].health <= 0 ) ) ) ) {
-					respawnsLeft = -2;
-				}
-			}
-
-			if ( cl->pers.connected == CON_CONNECTING ) {
-				ping = -1;
-			} else {
-				ping = cl->ps.ping < 999 ? cl->ps.ping : 999;
-			}
-
-			if ( g_gametype.integer == GT_WOLF_LMS ) {
-				Com_sprintf( entry, sizeof( entry ), " %i %i %i %i %i %i %i", level.sortedClients[i], cl->ps.persistant[PERS_SCORE], ping,
-							 ( level.time - cl->pers.enterTime ) / 60000, g_entities[level.sortedClients[i]].s.powerups, playerClass, respawnsLeft );
-			} else {
-				int j, totalXP;
-
-				for ( totalXP = 0, j = 0; j < SK_NUM_SKILLS; j++ ) {
-					totalXP += cl->sess.skillpoints[j];
-				}
-
-				Com_sprintf( entry, sizeof( entry ), " %i %i %i %i %i %i %i", level.sortedClients[i], totalXP, ping,
-							 ( level.time - cl->pers.enterTime ) / 60000, g_entities[level.sortedClients[i]].s.powerups, playerClass, respawnsLeft );
-			}
+		for (; i < numRows ; i++ ) {
+			Com_sprintf( entry, sizeof( entry ), " %i %i %i %i %i %i %i", rows[i][0], rows[i][1], rows[i][2],
+						 rows[i][3], rows[i][4], rows[i][5], rows[i][6] );
 
 			if ( size + strlen( entry ) > 1000 ) {
-				i--; // we need to redo this client in the next buffer (if we can)
-				break;
+				break;  // the next buffer starts with this client
 			}
 			size += strlen( entry );
 
 			Q_strcat( buffer, 1024, entry );
 			if ( ++count >= 32 ) {
-				i--; // we need to redo this client in the next buffer (if we can)
+				i++;
 				break;
 			}
 		}
@@ -137,10 +268,23 @@ void G_SendScore( gentity_t *ent ) {
 ==================
 Cmd_Score_f
 
-Request current scoreboard information
+Request current scoreboard information, a cgame that applies scd deltas asks
+with the sequence of the last one it has, 0 for a full scoreboard
 ==================
 */
 void Cmd_Score_f( gentity_t *ent ) {
+	if ( trap_Argc() > 1 ) {
+		scoreBaseline_t *baseline = &scoreBaselines[ent - g_entities];
+		char arg[MAX_TOKEN_CHARS];
+
+		trap_Argv( 1, arg, sizeof( arg ) );
+
+		baseline->delta = qtrue;
+		if ( !atoi( arg ) ) {
+			baseline->sequence = 0;
+		}
+	}
+
 	ent->client->wantsscore = qtrue;
 //	G_SendScore( ent );
 }
@@ -2480,7 +2624,7 @@ qboolean Do_Activate2_f( gentity_t *ent, gentity_t *traceEnt ) {
 
 					if ( BODY_VALUE( traceEnt ) >= 250 ) {
 
-						traceEnt->nextthink = traceEnt->timestamp + BODY_TIME( BODY_TEAM( traceEnt ) );
+						G_SetNextThink( traceEnt, traceEnt->timestamp + BODY_TIME( BODY_TEAM( traceEnt ) ) );
 
 //						BG_AnimScriptEvent( &ent->client->ps, ent->client->pers.character->animModelInfo, ANIM_ET_PICKUPGRENADE, qfalse, qtrue );
 //						ent->client->ps.pm_flags |= PMF_TIME_LOCKPLAYER;
@@ -2565,6 +2709,7 @@ qboolean Do_Activate_f( gentity_t *ent, gentity_t *traceEnt ) {
 					ent->client->pers.autoActivate = PICKUP_FORCE;      //----(SA) force pickup
 				}
 				traceEnt->active = qtrue;
+				G_WakeEntity( traceEnt );
 				traceEnt->touch( traceEnt, ent, &trace );
 			}
 
@@ -62,7 +62,7 @@ void AddScore( gentity_t *ent, int score ) {
 	ent->client->sess.game_points += score;
 
 //	level.teamScores[ ent->client->ps.persistant[PERS_TEAM] ] += score;
-	CalculateRanks();
+	G_QueueCalculateRanks();
 }
 
 /*
@@ -92,7 +92,7 @@ void AddKillScore( gentity_t *ent, int score ) {
 	}
 	ent->client->sess.game_points += score;
 
-	CalculateRanks();
+	G_QueueCalculateRanks();
 }
 
 /*
@@ -711,7 +711,7 @@ void player_die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int
 
 	G_FadeItems( self, MOD_SATCHEL );
 
-	CalculateRanks();
+	G_QueueCalculateRanks();
 
 	if ( killedintank /*Gordon: automatically go to limbo from tank*/ ) {
 		limbo( self, qfalse ); // but no corpse
@@ -754,19 +754,24 @@ qboolean IsHeadShotWeapon( int mod ) {
 	return qfalse;
 }
 
-gentity_t* G_BuildHead( gentity_t *ent ) {
-	gentity_t* head;
-	orientation_t or;           // DHM - Nerve
+/*
+==============
+G_HeadBox
 
-	head = G_Spawn();
+Head hit box of a player whose body is at origin, shared by the temporary
+head entities and the antilag traces
+==============
+*/
+void G_HeadBox( gentity_t *ent, const vec3_t origin, vec3_t headOrigin, vec3_t mins, vec3_t maxs ) {
+	orientation_t or;           // DHM - Nerve
 
 	if ( trap_GetTag( ent->s.number, 0, "tag_head", &or ) ) {
-		G_SetOrigin( head, or.origin );
+		VectorCopy( or.origin, headOrigin );
 	} else {
 		float height, dest;
 		vec3_t v, angles, forward, up, right;
 
-		G_SetOrigin( head, ent->r.currentOrigin );
+		VectorCopy( origin, headOrigin );
 
 		if ( ent->client->ps.eFlags & EF_PRONE ) {
 			height = ent->client->ps.viewheight - 56;
@@ -793,17 +798,28 @@ gentity_t* G_BuildHead( gentity_t *ent ) {
 		}
 		VectorMA( v, 18, up, v );
 
-		VectorAdd( v, head->r.currentOrigin, head->r.currentOrigin );
-		head->r.currentOrigin[2] += height / 2;
+		VectorAdd( v, headOrigin, headOrigin );
+		headOrigin[2] += height / 2;
 		// -NERVE - SMF
 	}
 
+	VectorSet( mins, -6, -6, -2 ); // JPW NERVE changed this z from -12 to -6 for crouching, also removed standing offset
+	VectorSet( maxs, 6, 6, 10 ); // changed this z from 0 to 6
+}
+
+gentity_t* G_BuildHead( gentity_t *ent ) {
+	gentity_t* head;
+	vec3_t origin;
+
+	head = G_Spawn();
+
+	G_HeadBox( ent, ent->r.currentOrigin, origin, head->r.mins, head->r.maxs );
+	G_SetOrigin( head, origin );
+
 	VectorCopy( head->r.currentOrigin, head->s.origin );
 	VectorCopy( ent->r.currentAngles, head->s.angles );
 	VectorCopy( head->s.angles, head->s.apos.trBase );
 	VectorCopy( head->s.angles, head->s.apos.trDelta );
-	VectorSet( head->r.mins, -6, -6, -2 ); // JPW NERVE changed this z from -12 to -6 for crouching, also removed standing offset
-	VectorSet( head->r.maxs, 6, 6, 10 ); // changed this z from 0 to 6
 	head->clipmask = CONTENTS_SOLID;
 	head->r.contents = CONTENTS_SOLID;
 	head->parent = ent;
@@ -814,24 +830,44 @@ gentity_t* G_BuildHead( gentity_t *ent ) {
 	return head;
 }
 
-gentity_t* G_BuildLeg( gentity_t *ent ) {
-	gentity_t* leg;
-	vec3_t flatforward, org;
-	//orientation_t or;			// DHM - Nerve
+/*
+==============
+G_LegBox
+
+Leg hit box of a prone player whose body is at origin, returns qfalse
+when the player is not prone
+==============
+*/
+qboolean G_LegBox( gentity_t *ent, const vec3_t origin, vec3_t legOrigin, vec3_t mins, vec3_t maxs ) {
+	vec3_t flatforward;
 
 	if ( !( ent->client->ps.eFlags & EF_PRONE ) ) {
-		return NULL;
+		return qfalse;
 	}
 
-	leg = G_Spawn();
-
 	AngleVectors( ent->client->ps.viewangles, flatforward, NULL, NULL );
 	flatforward[2] = 0;
 	VectorNormalizeFast( flatforward );
 
-	org[0] = ent->r.currentOrigin[0] + flatforward[0] * -32;
-	org[1] = ent->r.currentOrigin[1] + flatforward[1] * -32;
-	org[2] = ent->r.currentOrigin[2] + ent->client->pmext.proneLegsOffset;
+	legOrigin[0] = origin[0] + flatforward[0] * -32;
+	legOrigin[1] = origin[1] + flatforward[1] * -32;
+	legOrigin[2] = origin[2] + ent->client->pmext.proneLegsOffset;
+
+	VectorCopy( playerlegsProneMins, mins );
+	VectorCopy( playerlegsProneMaxs, maxs );
+
+	return qtrue;
+}
+
+gentity_t* G_BuildLeg( gentity_t *ent ) {
+	gentity_t* leg;
+	vec3_t org, mins, maxs;
+
+	if ( !G_LegBox( ent, ent->r.currentOrigin, org, mins, maxs ) ) {
+		return NULL;
+	}
+
+	leg = G_Spawn();
 
 	G_SetOrigin( leg, org );
 
@@ -839,8 +875,8 @@ gentity_t* G_BuildLeg( gentity_t *ent ) {
 	VectorCopy( ent->r.currentAngles, leg->s.angles );
 	VectorCopy( leg->s.angles, leg->s.apos.trBase );
 	VectorCopy( leg->s.angles, leg->s.apos.trDelta );
-	VectorCopy( playerlegsProneMins, leg->r.mins );
-	VectorCopy( playerlegsProneMaxs, leg->r.maxs );
+	VectorCopy( mins, leg->r.mins );
+	VectorCopy( maxs, leg->r.maxs );
 	leg->clipmask = CONTENTS_SOLID;
 	leg->r.contents = CONTENTS_SOLID;
 	leg->parent = ent;
@@ -1081,6 +1117,9 @@ void G_Damage( gentity_t *targ, gentity_t *inflictor, gentity_t *attacker,  vec3
 		return;
 	}
 
+	// the pain and die functions may change anything about it
+	G_WakeEntity( targ );
+
 	// xkan, 12/23/2002 - was the bot alive before applying any damage?
 	wasAlive = ( targ->health > 0 );
 
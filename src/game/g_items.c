@@ -735,7 +735,7 @@ void RespawnItem( gentity_t *ent ) {
 	// play the normal respawn sound only to nearby clients
 	G_AddEvent( ent, EV_ITEM_RESPAWN, 0 );
 
-	ent->nextthink = 0;
+	G_SetNextThink( ent, 0 );
 }
 
 
@@ -873,10 +873,10 @@ void Touch_Item( gentity_t *ent, gentity_t *other, trace_t *trace ) {
 	// delete it).  This is used by items that are respawned by third party
 	// events such as ctf flags
 	if ( respawn <= 0 ) {
-		ent->nextthink = 0;
+		G_SetNextThink( ent, 0 );
 		ent->think = 0;
 	} else {
-		ent->nextthink = level.time + respawn * 1000;
+		G_SetNextThink( ent, level.time + respawn * 1000 );
 		ent->think = RespawnItem;
 	}
 	trap_LinkEntity( ent );
@@ -949,7 +949,7 @@ gentity_t *LaunchItem( gitem_t *item, vec3_t origin, vec3_t velocity, int ownerN
 		dropped->s.otherEntityNum = g_entities[ownerNum].client->flagParent;    // store the entitynum of our original flag spawner
 		dropped->s.density = 1;
 		dropped->think = Team_DroppedFlagThink;
-		dropped->nextthink = level.time + 30000;
+		G_SetNextThink( dropped, level.time + 30000 );
 
 		if ( level.gameManager ) {
 			G_Script_ScriptEvent( level.gameManager, "trigger", flag->item->giTag == PW_REDFLAG ? "allied_object_dropped" : "axis_object_dropped" );
@@ -958,7 +958,7 @@ gentity_t *LaunchItem( gitem_t *item, vec3_t origin, vec3_t velocity, int ownerN
 	} else { // auto-remove after 30 seconds
 		dropped->think = G_FreeEntity;
 
-		dropped->nextthink = level.time + 30000;
+		G_SetNextThink( dropped, level.time + 30000 );
 	}
 
 	dropped->flags = FL_DROPPED_ITEM;
@@ -1142,7 +1142,7 @@ void G_SpawnItem( gentity_t *ent, gitem_t *item ) {
 	ent->item = item;
 	// some movers spawn on the second frame, so delay item
 	// spawns until the third frame so they can ride trains
-	ent->nextthink = level.time + FRAMETIME * 2;
+	G_SetNextThink( ent, level.time + FRAMETIME * 2 );
 	ent->think = FinishSpawningItem;
 
 	if ( G_SpawnString( "noise", 0, &noise ) ) {
@@ -130,10 +130,24 @@ typedef struct gclient_s gclient_t;
 //====================================================================
 //
 // Scripting, these structure are not saved into savegames (parsed each start)
+//
+// the params of an action resolved once when the script is parsed,
+// or on the first run for what can't be resolved before the level is up
+typedef struct
+{
+	int op;                                 // action specific sub command
+	int values[2];
+	char names[2][MAX_QPATH];               // entity, scriptName or trigger names
+	int hashes[2];                          // BG_StringHashValue of the names
+} g_script_operands_t;
+//
 typedef struct
 {
 	char    *actionString;
 	qboolean ( *actionFunc )( gentity_t *ent, char *params );
+	// optional, returns an error message if the params are invalid
+	const char *( *compileFunc )( g_script_operands_t *operands, const char *params );
+	qboolean ( *operandsFunc )( gentity_t *ent, g_script_operands_t *operands );
 	int hash;
 } g_script_stack_action_t;
 //
@@ -143,6 +157,7 @@ typedef struct
 	// set during script parsing
 	g_script_stack_action_t     *action;            // points to an action to perform
 	char                        *params;
+	g_script_operands_t         *operands;          // NULL if the action runs from params
 } g_script_stack_item_t;
 //
 // Gordon: need to up this, forest has a HUGE script for the tank.....
@@ -467,7 +482,7 @@ struct gentity_s {
 
 	vec3_t oldOrigin;
 
-	qboolean runthisframe;
+	int runFrame;               // level.framenum of the last G_RunEntity
 
 	g_constructible_stats_t constructibleStats;
 
@@ -921,6 +936,7 @@ typedef struct {
 	int numNonSpectatorClients;         // includes connecting clients
 	int numPlayingClients;              // connected, non-spectators
 	int sortedClients[MAX_CLIENTS];             // sorted by score
+	qboolean ranksDirty;                // CalculateRanks is due at the end of the frame
 	int follow1, follow2;               // clientNums for auto-follow spectators
 
 //	int			snd_fry;				// sound index for standing in lava
@@ -1166,6 +1182,11 @@ void    G_KillBox( gentity_t *ent );
 gentity_t *G_Find( gentity_t *from, int fieldofs, const char *match );
 gentity_t* G_FindByTargetname( gentity_t *from, const char* match );
 gentity_t* G_FindByTargetnameFast( gentity_t *from, const char* match, int hash );
+gentity_t *G_FindByScriptName( gentity_t *from, const char *match );
+gentity_t *G_FindByScriptNameFast( gentity_t *from, const char *match, int hash );
+void G_SetScriptName( gentity_t *ent, char *scriptName );
+void G_ClearNameIndex( void );
+void G_FindBench_f( void );
 gentity_t *G_PickTarget( const char *targetname );
 void    G_UseTargets( gentity_t *ent, gentity_t *activator );
 void    G_SetMovedir( vec3_t angles, vec3_t movedir );
@@ -1211,6 +1232,8 @@ qboolean G_RadiusDamage( vec3_t origin, gentity_t *inflictor, gentity_t *attacke
 qboolean etpro_RadiusDamage( vec3_t origin, gentity_t *inflictor, gentity_t *attacker, float damage, float radius, gentity_t *ignore, int mod, qboolean clientsonly );
 void body_die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int damage, int meansOfDeath );
 void TossClientItems( gentity_t *self );
+void G_HeadBox( gentity_t *ent, const vec3_t origin, vec3_t headOrigin, vec3_t mins, vec3_t maxs );
+qboolean G_LegBox( gentity_t *ent, const vec3_t origin, vec3_t legOrigin, vec3_t mins, vec3_t maxs );
 gentity_t* G_BuildHead( gentity_t *ent );
 gentity_t* G_BuildLeg( gentity_t *ent );
 
@@ -1317,6 +1340,7 @@ void player_die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int
 void AddScore( gentity_t *ent, int score );
 void AddKillScore( gentity_t *ent, int score );
 void CalculateRanks( void );
+void G_QueueCalculateRanks( void );
 qboolean SpotWouldTelefrag( gentity_t *spot );
 qboolean G_CheckForExistingModelInfo( bg_playerclass_t* classInfo, const char *modelName, animModelInfo_t **modelInfo );
 void G_StartPlayerAppropriateSound( gentity_t *ent, char* soundType );
@@ -1332,6 +1356,7 @@ qboolean G_RegisterCharacter( const char *characterFile, bg_character_t *charact
 void G_RegisterPlayerClasses( void );
 //void G_SetCharacter( gclient_t *client, bg_character_t *character, qboolean custom );
 void G_UpdateCharacter( gclient_t *client );
+void G_AnimBench_f( void );
 
 //
 // g_svcmds.c
@@ -1376,6 +1401,7 @@ qboolean IsSilencedWeapon
 // g_cmds.c
 //
 void G_SendScore( gentity_t *client );
+void G_ClearScoreBaseline( int clientNum );
 void G_SayTo( gentity_t *ent, gentity_t *other, int mode, int color, const char *name, const char *message, qboolean localize ); // JPW NERVE removed static declaration so it would link
 qboolean Cmd_CallVote_f( gentity_t *ent, unsigned int dwCommand, qboolean fValue );
 void Cmd_Follow_f( gentity_t *ent, unsigned int dwCommand, qboolean fValue );
@@ -1390,6 +1416,9 @@ void Cmd_SetClass_f( gentity_t *ent, unsigned int dwCommand, qboolean fValue );
 void FindIntermissionPoint( void );
 void MoveClientToIntermission( gentity_t *client );
 void G_RunThink( gentity_t *ent );
+void G_ClearThinkSchedule( void );
+void G_WakeEntity( gentity_t *ent );
+void G_SetNextThink( gentity_t *ent, int time );
 void QDECL G_LogPrintf( const char *fmt, ... ) FORMAT_PRINTF(1,2);
 void SendScoreboardMessageToAllClients( void );
 void QDECL G_Printf( const char *fmt, ... ) FORMAT_PRINTF(1,2);
@@ -1485,6 +1514,7 @@ extern vmCvar_t g_gametype;
 extern vmCvar_t g_logFile;
 extern vmCvar_t g_dedicated;
 extern vmCvar_t g_cheats;
+extern vmCvar_t g_cmOptimize;
 extern vmCvar_t g_maxclients;               // allow this many total, including spectators
 extern vmCvar_t g_maxGameClients;           // allow this many active
 extern vmCvar_t g_minGameClients;           // NERVE - SMF - we need at least this many before match actually starts
@@ -1559,6 +1589,7 @@ extern vmCvar_t g_landminetimeout;
 
 // What level of detail do we want script printing to go to.
 extern vmCvar_t g_scriptDebugLevel;
+extern vmCvar_t g_thinkSchedule;
 
 // How fast do SP player and allied bots move?
 extern vmCvar_t g_movespeed;
@@ -1737,6 +1768,7 @@ void G_HistoricalTrace( gentity_t* ent, trace_t *results, const vec3_t start, co
 void G_HistoricalTraceBegin( gentity_t *ent );
 void G_HistoricalTraceEnd( gentity_t *ent );
 void G_Trace( gentity_t* ent, trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask );
+void G_AntilagBench_f( void );
 
 #define BODY_VALUE( ENT ) ENT->watertype
 #define BODY_TEAM( ENT ) ENT->s.modelindex
@@ -51,6 +51,7 @@ vmCvar_t g_dedicated;
 vmCvar_t g_speed;
 vmCvar_t g_gravity;
 vmCvar_t g_cheats;
+vmCvar_t g_cmOptimize;
 vmCvar_t g_knockback;
 vmCvar_t g_forcerespawn;
 vmCvar_t g_inactivity;
@@ -176,6 +177,7 @@ vmCvar_t g_landminetimeout;
 // enabled in bot scripts and regular scripts.
 // Added by Mad Doctor I, 8/23/2002
 vmCvar_t g_scriptDebugLevel;
+vmCvar_t g_thinkSchedule;
 vmCvar_t g_movespeed;
 
 vmCvar_t g_axismapxp;
@@ -333,6 +335,8 @@ static void G_CheckGameType( vmCvar_t *cv ) {
 static const vmCvarTableItem_t game_cvars[] = {
 	// don't override the cheat state set by the system
 	{ &g_cheats, "sv_cheats", "", 0, qfalse },
+	// the engine's trace pre-reject, antilag traces follow it
+	{ &g_cmOptimize, "cm_optimize", "1", CVAR_CHEAT, qfalse },
 
 	// noset vars
 	{ NULL, "gamename", GAMEVERSION, CVAR_SERVERINFO | CVAR_ROM, qfalse },
@@ -467,6 +471,9 @@ static const vmCvarTableItem_t game_cvars[] = {
 	// What level of detail do we want script printing to go to.
 	{ &g_scriptDebugLevel, "g_scriptDebugLevel", "0", CVAR_CHEAT, qfalse },
 
+	// 0 runs every entity every frame instead of letting idle ones sleep
+	{ &g_thinkSchedule, "g_thinkSchedule", "1", 0, qfalse },
+
 	// How fast do we want Allied single player movement?
 //	{ &g_movespeed, "g_movespeed", "127", CVAR_CHEAT, qfalse },
 	{ &g_movespeed, "g_movespeed", "76", CVAR_CHEAT, qfalse },
@@ -1313,15 +1320,6 @@ void G_CheckForCursorHints( gentity_t *ent ) {
 
 }
 
-void G_SetTargetName( gentity_t* ent, char* targetname ) {
-	if ( targetname && *targetname ) {
-		ent->targetname = targetname;
-		ent->targetnamehash = BG_StringHashValue( targetname );
-	} else {
-		ent->targetnamehash = -1;
-	}
-}
-
 /*
 ================
 G_FindTeams
@@ -1803,6 +1801,8 @@ void G_InitGame( int levelTime, int randomSeed, int restart ) {
 	// initialize all entities for this game
 	memset( g_entities, 0, MAX_GENTITIES * sizeof( g_entities[0] ) );
 	level.gentities = g_entities;
+	G_ClearNameIndex();
+	G_ClearThinkSchedule();
 
 	// initialize all clients for this game
 	level.maxclients = g_maxclients.integer;
@@ -2003,6 +2003,8 @@ PLAYER COUNTING / SCORE SORTING
 ========================================================================
 */
 
+static int rankTotalXP[MAX_CLIENTS];         // skill point totals SortRanks compares, set by CalculateRanks
+
 /*
 =============
 SortRanks
@@ -2016,6 +2018,9 @@ int QDECL SortRanks( const void *a, const void *b ) {
 	cb = &level.clients[*(int *)b];
 
 	// sort special clients last
+	if ( ca->sess.spectatorClient < 0 && cb->sess.spectatorClient < 0 ) {
+		return 0;
+	}
 	if ( /*ca->sess.spectatorState == SPECTATOR_SCOREBOARD ||*/ ca->sess.spectatorClient < 0 ) {
 		return 1;
 	}
@@ -2060,24 +2065,40 @@ int QDECL SortRanks( const void *a, const void *b ) {
 			return 1;
 		}
 	} else {
-		int i, totalXP[2];
-
-		for ( totalXP[0] = totalXP[1] = 0, i = 0; i < SK_NUM_SKILLS; i++ ) {
-			totalXP[0] += ca->sess.skillpoints[i];
-			totalXP[1] += cb->sess.skillpoints[i];
-		}
-
 		// then sort by xp
-		if ( totalXP[0] > totalXP[1] ) {
+		if ( rankTotalXP[*(int *)a] > rankTotalXP[*(int *)b] ) {
 			return -1;
 		}
-		if ( totalXP[0] < totalXP[1] ) {
+		if ( rankTotalXP[*(int *)a] < rankTotalXP[*(int *)b] ) {
 			return 1;
 		}
 	}
 	return 0;
 }
 
+/*
+=============
+G_SortRanks
+
+Insertion sort of level.sortedClients, which still holds the order of the
+last sort. Only the clients whose rank changed since then move, and clients
+that tie keep their place.
+=============
+*/
+static void G_SortRanks( void ) {
+	int i, j, num;
+
+	for ( i = 1; i < level.numConnectedClients; i++ ) {
+		num = level.sortedClients[i];
+
+		for ( j = i; j > 0 && SortRanks( &level.sortedClients[j - 1], &num ) > 0; j-- ) {
+			level.sortedClients[j] = level.sortedClients[j - 1];
+		}
+
+		level.sortedClients[j] = num;
+	}
+}
+
 //bani - #184
 //(relatively) sane replacement for OSP's Players_Axis/Players_Allies
 void etpro_PlayerInfo( void ) {
@@ -2123,17 +2144,22 @@ void etpro_PlayerInfo( void ) {
 CalculateRanks
 
 Recalculates the score ranks of all players
-This will be called on every client connect, begin, disconnect, death,
-and team change.
+This will be called on every client connect, begin, disconnect and team
+change, score changes go through G_QueueCalculateRanks instead.
 ============
 */
 void CalculateRanks( void ) {
-	int i;
+	int i, j;
 //	int		rank;
 //	int		score;
 //	int		newScore;
 	char teaminfo[TEAM_NUM_TEAMS][256];     // OSP
 	gclient_t   *cl;
+	int numSorted, lastConnectedClients;
+	qboolean sorted[MAX_CLIENTS];
+
+	level.ranksDirty = qfalse;
+	lastConnectedClients = level.numConnectedClients;
 
 	level.follow1 = -1;
 	level.follow2 = -1;
@@ -2159,7 +2185,6 @@ void CalculateRanks( void ) {
 		if ( level.clients[i].pers.connected != CON_DISCONNECTED ) {
 			int team = level.clients[i].sess.sessionTeam;
 
-			level.sortedClients[level.numConnectedClients] = i;
 			level.numConnectedClients++;
 
 			if ( team != TEAM_SPECTATOR ) {
@@ -2211,8 +2236,30 @@ void CalculateRanks( void ) {
 		}
 	}
 
-	qsort( level.sortedClients, level.numConnectedClients,
-		   sizeof( level.sortedClients[0] ), SortRanks );
+	// keep the clients that are still connected in their last order, then
+	// add the new ones
+	memset( sorted, 0, sizeof( sorted ) );
+	for ( numSorted = 0, i = 0; i < lastConnectedClients; i++ ) {
+		j = level.sortedClients[i];
+		if ( !sorted[j] && level.clients[j].pers.connected != CON_DISCONNECTED ) {
+			level.sortedClients[numSorted++] = j;
+			sorted[j] = qtrue;
+		}
+	}
+	for ( i = 0; i < level.maxclients; i++ ) {
+		if ( !sorted[i] && level.clients[i].pers.connected != CON_DISCONNECTED ) {
+			level.sortedClients[numSorted++] = i;
+		}
+	}
+
+	for ( i = 0; i < level.numConnectedClients; i++ ) {
+		cl = &level.clients[ level.sortedClients[i] ];
+		for ( rankTotalXP[level.sortedClients[i]] = 0, j = 0; j < SK_NUM_SKILLS; j++ ) {
+			rankTotalXP[level.sortedClients[i]] += cl->sess.skillpoints[j];
+		}
+	}
+
+	G_SortRanks();
 
 	// set the rank value for all clients that are connected and not spectators
 	// in team games, rank is just the order of the teams, 0=red, 1=blue, 2=tied
@@ -2248,6 +2295,18 @@ void CalculateRanks( void ) {
 }
 
 
+/*
+============
+G_QueueCalculateRanks
+
+Score changes can come several times a frame during a fight, they only mark
+the ranks and G_RunFrame recalculates them once
+============
+*/
+void G_QueueCalculateRanks( void ) {
+	level.ranksDirty = qtrue;
+}
+
 /*
 ========================================================================
 
@@ -3270,10 +3329,11 @@ static void G_CheckLoadGame( void ) {
 			trap_Cvar_Set( "savegame_loading", "0" ); // in-case it aborts
 			saveGamePending = 0;
 			G_LoadGame();
+			G_ClearThinkSchedule();
 
 			// RF, spawn a thinker that will enable rendering after the client has had time to process the entities and setup the display
 			ent = G_Spawn();
-			ent->nextthink = level.time + 200;
+			G_SetNextThink( ent, level.time + 200 );
 			ent->think = G_EnableRenderingThink;
 
 			// wait for the clients to return from faded screen
@@ -3312,6 +3372,246 @@ static void G_CheckLoadGame( void ) {
 }
 #endif // SAVEGAME_SUPPORT
 
+/*
+===============================================================================
+
+THINK SCHEDULE
+
+An entity whose frame can do nothing but compare nextthink to level.time is
+put to sleep: G_RunFrame skips it until nextthink comes due, which a min-heap
+keyed by nextthink tracks, or until something that could change it wakes it.
+G_SetNextThink, events, state changes, freeing and its own callbacks all
+wake an entity. Clients, missiles, movers, items and anything scripts can
+reach never sleep, so they stay on the active list and run every frame.
+
+===============================================================================
+*/
+
+static unsigned int activeEntities[MAX_GENTITIES / 32];    // bit per entity G_RunFrame runs
+static int thinkHeap[MAX_GENTITIES];         // sleeping entity numbers, earliest nextthink first
+static int thinkHeapTime[MAX_GENTITIES];     // nextthink of each heap entry when it went to sleep
+static int thinkHeapSlot[MAX_GENTITIES];     // heap position of each entity, -1 when not in it
+static int numThinkHeap;
+
+static void G_ThinkHeapSwap( int a, int b ) {
+	int num = thinkHeap[a], time = thinkHeapTime[a];
+
+	thinkHeap[a] = thinkHeap[b];
+	thinkHeapTime[a] = thinkHeapTime[b];
+	thinkHeap[b] = num;
+	thinkHeapTime[b] = time;
+
+	thinkHeapSlot[thinkHeap[a]] = a;
+	thinkHeapSlot[thinkHeap[b]] = b;
+}
+
+static void G_ThinkHeapUp( int slot ) {
+	int parent;
+
+	while ( slot > 0 ) {
+		parent = ( slot - 1 ) / 2;
+		if ( thinkHeapTime[parent] <= thinkHeapTime[slot] ) {
+			break;
+		}
+		G_ThinkHeapSwap( slot, parent );
+		slot = parent;
+	}
+}
+
+static void G_ThinkHeapDown( int slot ) {
+	int child;
+
+	while ( ( child = slot * 2 + 1 ) < numThinkHeap ) {
+		if ( child + 1 < numThinkHeap && thinkHeapTime[child + 1] < thinkHeapTime[child] ) {
+			child++;
+		}
+		if ( thinkHeapTime[slot] <= thinkHeapTime[child] ) {
+			break;
+		}
+		G_ThinkHeapSwap( slot, child );
+		slot = child;
+	}
+}
+
+static void G_ThinkHeapRemove( int num ) {
+	int slot = thinkHeapSlot[num];
+
+	thinkHeapSlot[num] = -1;
+	if ( --numThinkHeap == slot ) {
+		return;
+	}
+
+	thinkHeap[slot] = thinkHeap[numThinkHeap];
+	thinkHeapTime[slot] = thinkHeapTime[numThinkHeap];
+	thinkHeapSlot[thinkHeap[slot]] = slot;
+
+	G_ThinkHeapUp( slot );
+	G_ThinkHeapDown( slot );
+}
+
+/*
+=============
+G_ClearThinkSchedule
+
+Every entity starts out active
+=============
+*/
+void G_ClearThinkSchedule( void ) {
+	memset( activeEntities, 0xff, sizeof( activeEntities ) );
+	memset( thinkHeapSlot, -1, sizeof( thinkHeapSlot ) );
+	numThinkHeap = 0;
+}
+
+/*
+=============
+G_WakeEntity
+
+Puts an entity back on the active list, it runs every frame until it can
+sleep again
+=============
+*/
+void G_WakeEntity( gentity_t *ent ) {
+	int num = ent - g_entities;
+
+	if ( thinkHeapSlot[num] >= 0 ) {
+		G_ThinkHeapRemove( num );
+	}
+
+	activeEntities[num >> 5] |= 1u << ( num & 31 );
+}
+
+/*
+=============
+G_SetNextThink
+=============
+*/
+void G_SetNextThink( gentity_t *ent, int time ) {
+	ent->nextthink = time;
+	G_WakeEntity( ent );
+}
+
+/*
+=============
+G_CanSleep
+
+True when the next frames of an entity that just ran the plain think path
+would be no-ops until its nextthink, as long as nothing wakes it
+=============
+*/
+static qboolean G_CanSleep( gentity_t *ent ) {
+	if ( ent - g_entities < MAX_CLIENTS || level.match_pause != PAUSE_NONE || !g_thinkSchedule.integer ) {
+		return qfalse;
+	}
+
+	if ( !ent->inuse ) {
+		return qtrue;
+	}
+
+	// scripts run every frame and may change the entity at any time
+	if ( ent->scriptName || ent->scriptEvents ) {
+		return qfalse;
+	}
+
+	if ( ent->tagParent || ( ent->s.eFlags & EF_PATH_LINK ) ) {
+		return qfalse;
+	}
+
+	if ( ent->s.event || ent->freeAfterEvent || ent->unlinkAfterEvent ) {
+		return qfalse;
+	}
+
+	// still moving, instantVelocity needs another frame to settle
+	if ( !VectorCompare( ent->r.currentOrigin, ent->oldOrigin ) ) {
+		return qfalse;
+	}
+
+	if ( !( ent->flags & FL_NODRAW ) != !( ent->s.eFlags & EF_NODRAW ) ) {
+		return qfalse;
+	}
+
+	if ( ent->entstate != STATE_DEFAULT ) {
+		return qfalse;
+	}
+
+	// the think may have turned it into something that runs every frame
+	switch ( ent->s.eType ) {
+	case ET_MISSILE:
+	case ET_FLAMEBARREL:
+	case ET_FP_PARTS:
+	case ET_FIRE_COLUMN:
+	case ET_FIRE_COLUMN_SMOKE:
+	case ET_EXPLO_PART:
+	case ET_RAMJET:
+	case ET_FLAMETHROWER_CHUNK:
+	case ET_ITEM:
+	case ET_MOVER:
+	case ET_PROP:
+	case ET_PORTAL:
+	case ET_HEALER:
+	case ET_SUPPLIER:
+	case ET_CONSTRUCTIBLE:
+		return qfalse;
+	default:
+		break;
+	}
+
+	return !ent->physicsObject;
+}
+
+/*
+=============
+G_SleepEntity
+=============
+*/
+static void G_SleepEntity( gentity_t *ent ) {
+	int num = ent - g_entities;
+
+	activeEntities[num >> 5] &= ~( 1u << ( num & 31 ) );
+
+	// already asleep but run again through a tag child, its nextthink may
+	// have moved so it goes back in at the new time
+	if ( thinkHeapSlot[num] >= 0 ) {
+		G_ThinkHeapRemove( num );
+	}
+
+	if ( ent->inuse && ent->nextthink > 0 ) {
+		thinkHeap[numThinkHeap] = num;
+		thinkHeapTime[numThinkHeap] = ent->nextthink;
+		thinkHeapSlot[num] = numThinkHeap;
+		G_ThinkHeapUp( numThinkHeap++ );
+	}
+}
+
+/*
+=============
+G_WakeDueEntities
+
+Wakes the sleeping entities whose nextthink has come, or all of them while
+the match is paused so their nextthink gets pushed back every frame
+=============
+*/
+static void G_WakeDueEntities( void ) {
+	int num;
+
+	if ( level.match_pause != PAUSE_NONE || !g_thinkSchedule.integer ) {
+		G_ClearThinkSchedule();
+		return;
+	}
+
+	while ( numThinkHeap && thinkHeapTime[0] <= level.time ) {
+		num = thinkHeap[0];
+		if ( thinkHeapSlot[num] != 0 ) {
+			// stale duplicate, shouldn't happen but must not hang the frame
+			G_DPrintf( "G_WakeDueEntities: stale think heap entry for entity %i\n", num );
+			thinkHeapSlot[num] = 0;
+			G_ThinkHeapRemove( num );
+			activeEntities[num >> 5] |= 1u << ( num & 31 );
+			continue;
+		}
+		G_WakeEntity( &g_entities[num] );
+	}
+}
+
 /*
 =============
 G_RunThink
@@ -3521,13 +3821,16 @@ void G_TagLinkEntity( gentity_t* ent, int msec ) {
 }
 
 void G_RunEntity( gentity_t* ent, int msec ) {
-	if ( ent->runthisframe ) {
+	if ( ent->runFrame == level.framenum ) {
 		return;
 	}
 
-	ent->runthisframe = qtrue;
+	ent->runFrame = level.framenum;
 
 	if ( !ent->inuse ) {
+		if ( G_CanSleep( ent ) ) {
+			G_SleepEntity( ent );
+		}
 		return;
 	}
 
@@ -3681,6 +3984,10 @@ void G_RunEntity( gentity_t* ent, int msec ) {
 	// ydnar: hack for instantaneous velocity
 	VectorSubtract( ent->r.currentOrigin, ent->oldOrigin, ent->instantVelocity );
 	VectorScale( ent->instantVelocity, 1000.0f / msec, ent->instantVelocity );
+
+	if ( G_CanSleep( ent ) ) {
+		G_SleepEntity( ent );
+	}
 }
 
 /*
@@ -3736,15 +4043,23 @@ void G_RunFrame( int levelTime ) {
 	// get any cvar changes
 	G_UpdateCvars();
 
-	for ( i = 0; i < level.num_entities; i++ ) {
-		g_entities[i].runthisframe = qfalse;
-	}
+	G_WakeDueEntities();
 
-	// go through all allocated objects
+	// go through all active objects, an entity woken during the frame still
+	// runs in it if the loop hasn't passed it yet
 	for ( i = 0; i < level.num_entities; i++ ) {
-		G_RunEntity( &g_entities[ i ], msec );
+		if ( !activeEntities[i >> 5] ) {
+			i |= 31;
+			continue;
+		}
+		if ( activeEntities[i >> 5] & ( 1u << ( i & 31 ) ) ) {
+			G_RunEntity( &g_entities[ i ], msec );
+		}
 	}
 
+	if ( level.ranksDirty ) {
+		CalculateRanks();
+	}
 
 	for ( i = 0; i < level.numConnectedClients; i++ ) {
 		ClientEndFrame( &g_entities[level.sortedClients[i]] );
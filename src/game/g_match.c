@@ -175,7 +175,7 @@ void G_delayPrint( gentity_t *dpent ) {
 		break;
 	}
 
-	dpent->nextthink = think_next;
+	G_SetNextThink( dpent, think_next );
 	if ( fFree ) {
 		dpent->think = 0;
 		G_FreeEntity( dpent );
@@ -207,7 +207,7 @@ void G_spawnPrintf( int print_type, int print_time, gentity_t *owner ) {
 	ent->spawnflags = print_type;       // Tunnel in DP enum
 	ent->timestamp = level.time;        // Time entity was created
 
-	ent->nextthink = print_time;
+	G_SetNextThink( ent, print_time );
 	ent->think = G_delayPrint;
 }
 
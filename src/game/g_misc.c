@@ -61,7 +61,7 @@ void SP_info_null( gentity_t *self ) {
 	}
 
 	self->think = G_FreeEntity;
-	self->nextthink = level.time + ( FRAMETIME * 2 );
+	G_SetNextThink( self, level.time + ( FRAMETIME * 2 ) );
 }
 
 
@@ -206,7 +206,7 @@ void grabber_think_hit( gentity_t *ent ) {
 	G_RadiusDamage( ent->s.pos.trBase, NULL, ent, ent->damage, ent->duration, ent, MOD_GRABBER );
 	G_AddEvent( ent, EV_GENERAL_SOUND, ent->sound2to1 ); // sound2to1 is the 'pain' sound
 
-	ent->nextthink  = level.time + ( attackDurations[( ent->s.frame ) - 2] - attackHittimes[( ent->s.frame ) - 2] );
+	G_SetNextThink( ent, level.time + ( attackDurations[( ent->s.frame ) - 2] - attackHittimes[( ent->s.frame ) - 2] ) );
 	ent->think      = grabber_think_idle;
 }
 
@@ -228,14 +228,14 @@ void grabber_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int
 
 //	trap_UnlinkEntity(ent->enemy);
 	ent->enemy->think = G_FreeEntity;
-	ent->enemy->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent->enemy, level.time + FRAMETIME );
 //	G_FreeEntity(ent->enemy);
 
 	G_UseTargets( ent, attacker );
 
 //	trap_UnlinkEntity(ent);
 	ent->think = G_FreeEntity;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 //	G_FreeEntity(ent);
 }
 
@@ -251,7 +251,7 @@ grabber_attack
 void grabber_attack( gentity_t *ent ) {
 	ent->s.frame    = ( rand() % 3 ) + 2;   // randomly choose an attack sequence
 
-	ent->nextthink  = level.time + attackHittimes[( ent->s.frame ) - 2];
+	G_SetNextThink( ent, level.time + attackHittimes[( ent->s.frame ) - 2] );
 	ent->think      = grabber_think_hit;
 }
 
@@ -318,7 +318,7 @@ void grabber_wake( gentity_t *ent ) {
 		ent->s.frame        = 5;    // starting position
 
 		// go back to an idle if not attacking immediately
-		parent->nextthink   = level.time + FRAMETIME;
+		G_SetNextThink( parent, level.time + FRAMETIME );
 		parent->think       = grabber_think_idle;
 	}
 
@@ -474,7 +474,7 @@ void spotlight_finish_spawning( gentity_t *ent ) {
 
 	ent->use        = use_spotlight;
 	ent->think      = 0;
-	ent->nextthink  = 0;
+	G_SetNextThink( ent, 0 );
 }
 
 
@@ -491,7 +491,7 @@ void SP_misc_spotlight( gentity_t *ent ) {
 	ent->s.eType        = ET_EF_SPOTLIGHT;
 
 	ent->think = spotlight_finish_spawning;
-	ent->nextthink = level.time + 100;
+	G_SetNextThink( ent, level.time + 100 );
 
 	if ( ent->model ) {
 		ent->s.modelindex   = G_ModelIndex( ent->model );
@@ -664,7 +664,7 @@ void SP_misc_vis_dummy( gentity_t *ent ) {
 	trap_LinkEntity( ent );
 
 	ent->think = locateMaster;
-	ent->nextthink = level.time + 1000;
+	G_SetNextThink( ent, level.time + 1000 );
 
 }
 
@@ -757,7 +757,7 @@ void SP_misc_portal_surface( gentity_t *ent ) {
 		VectorCopy( ent->s.origin, ent->s.origin2 );
 	} else {
 		ent->think = locateCamera;
-		ent->nextthink = level.time + 100;
+		G_SetNextThink( ent, level.time + 100 );
 	}
 }
 
@@ -840,7 +840,7 @@ void Use_Shooter( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 static void InitShooter_Finish( gentity_t *ent ) {
 	ent->enemy = G_PickTarget( ent->target );
 	ent->think = 0;
-	ent->nextthink = 0;
+	G_SetNextThink( ent, 0 );
 }
 
 void InitShooter( gentity_t *ent, int weapon ) {
@@ -858,7 +858,7 @@ void InitShooter( gentity_t *ent, int weapon ) {
 	// target might be a moving object, so we can't set movedir for it
 	if ( ent->target ) {
 		ent->think = InitShooter_Finish;
-		ent->nextthink = level.time + 500;
+		G_SetNextThink( ent, level.time + 500 );
 	}
 	trap_LinkEntity( ent );
 }
@@ -1051,7 +1051,7 @@ void shutoff_dlight( gentity_t *ent ) {
 
 	trap_UnlinkEntity( ent );
 	ent->think = 0;
-	ent->nextthink = 0;
+	G_SetNextThink( ent, 0 );
 }
 
 
@@ -1070,7 +1070,7 @@ void use_dlight( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 
 		if ( ent->spawnflags & 4 ) {   // ONETIME
 			ent->think = shutoff_dlight;
-			ent->nextthink = level.time + (  strlen( ent->dl_stylestring )  * 100 ) - 100;
+			G_SetNextThink( ent, level.time + (  strlen( ent->dl_stylestring )  * 100 ) - 100 );
 		}
 	}
 }
@@ -1122,7 +1122,7 @@ void SP_dlight( gentity_t *ent ) {
 	if ( !dlightstarttime ) {                      // sync up all the dlights
 		dlightstarttime = level.time + 100;
 	}
-	ent->nextthink  = dlightstarttime;
+	G_SetNextThink( ent, dlightstarttime );
 
 	if ( ent->dl_color[0] <= 0 &&                // if it's black or has no color assigned, make it white
 		 ent->dl_color[1] <= 0 &&
@@ -1400,7 +1400,7 @@ void aagun_think( gentity_t *self ) {
 			self->active = qtrue;
 			owner->client->ps.persistant[PERS_HWEAPON_USE] = 2;
 			aagun_track( self, owner );
-			self->nextthink = level.time + 50;
+			G_SetNextThink( self, level.time + 50 );
 			self->timestamp = level.time + 1000;
 
 			for ( i = 0; i < 3; i++ ) {
@@ -1439,7 +1439,7 @@ void aagun_think( gentity_t *self ) {
 		self->s.apos.trTime = level.time;
 		self->s.apos.trDuration = 50;
 	}
-	self->nextthink = level.time + 50;
+	G_SetNextThink( self, level.time + 50 );
 
 	SnapVector( self->s.apos.trDelta );
 }
@@ -1526,7 +1526,7 @@ void aagun_spawn( gentity_t *gun ) {
 	gun->use =                  aagun_use;
 	gun->die =                  aagun_die;
 
-	gun->nextthink =            level.time + FRAMETIME;
+	G_SetNextThink( gun, level.time + FRAMETIME );
 	gun->timestamp =            level.time + 1000;
 	gun->s.number =             gun - g_entities;
 	gun->s.origin2[0] =         gun->harc;
@@ -1681,7 +1681,7 @@ void mg42_think( gentity_t *self ) {
 			self->active = qtrue;
 			owner->client->ps.persistant[PERS_HWEAPON_USE] = 1;
 			mg42_track( self, owner );
-			self->nextthink = level.time + 50;
+			G_SetNextThink( self, level.time + 50 );
 			self->timestamp = level.time + 1000;
 
 			//owner->client->ps.weapHeat[WP_DUMMY_MG42] = self->mg42weapHeat;
@@ -1735,7 +1735,7 @@ void mg42_think( gentity_t *self ) {
 		self->s.apos.trTime = level.time;
 		self->s.apos.trDuration = 50;
 	}
-	self->nextthink = level.time + 50;
+	G_SetNextThink( self, level.time + 50 );
 
 	SnapVector( self->s.apos.trDelta );
 }
@@ -1928,7 +1928,7 @@ void mg42_spawn( gentity_t *ent ) {
 		gun->use =              mg42_use;
 		gun->die =              mg42_die;
 
-		gun->nextthink =        level.time + FRAMETIME;
+		G_SetNextThink( gun, level.time + FRAMETIME );
 		gun->timestamp =        level.time + 1000;
 		gun->s.number =         gun - g_entities;
 		gun->harc =             ent->harc;
@@ -1997,7 +1997,7 @@ void SP_mg42( gentity_t *self ) {
 	}
 
 	self->think = mg42_spawn;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 
 	if ( G_SpawnString( "damage", "0", &damage ) ) {
 		self->damage = atoi( damage );
@@ -2089,7 +2089,7 @@ void flak_spawn( gentity_t *ent ) {
 	VectorCopy( gun->s.angles, gun->s.apos.trBase );
 	VectorCopy( gun->s.angles, gun->s.apos.trDelta );
 	gun->think = mg42_think;
-	gun->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( gun, level.time + FRAMETIME );
 	gun->s.number = gun - g_entities;
 	gun->harc = ent->harc;
 	gun->varc = ent->varc;
@@ -2124,7 +2124,7 @@ void SP_misc_flak( gentity_t *self ) {
 	}
 
 	self->think = flak_spawn;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 /*QUAKED misc_spawner (.3 .7 .8) (-8 -8 -8) (8 8 8)
@@ -2155,7 +2155,7 @@ void misc_spawner_think( gentity_t *ent ) {
 void misc_spawner_use( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 
 	ent->think = misc_spawner_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 //	VectorCopy (other->r.currentOrigin, ent->r.currentOrigin);
 //	VectorCopy (ent->r.currentOrigin, ent->s.pos.trBase);
@@ -2356,7 +2356,7 @@ damage = damage caused by each bullet
 	}
 
 	ent->think = miscGunnerThink;
-	ent->nextthink = level.time + 50;
+	G_SetNextThink( ent, level.time + 50 );
 }*/
 
 void firetrail_die( gentity_t *ent ) {
@@ -2422,7 +2422,7 @@ void misc_firetrails_think( gentity_t *ent ) {
 
 void SP_misc_firetrails( gentity_t *ent ) {
 	ent->think = misc_firetrails_think;
-	ent->nextthink = level.time + 100;
+	G_SetNextThink( ent, level.time + 100 );
 
 }
 
@@ -2474,7 +2474,7 @@ void SP_misc_constructiblemarker( gentity_t *ent ) {
 	VectorCopy( ent->s.origin, ent->r.currentOrigin );
 
 	ent->think = constructiblemarker_setup;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 /*QUAKED misc_landmine (.35 0.85 .35) (-16 -16 0) (16 16 16) AXIS ALLIED
@@ -2542,7 +2542,7 @@ void landmine_setup( gentity_t *ent ) {
 	ent->health         = 0;
 	ent->s.modelindex2  = 0;
 
-	ent->nextthink      = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->think          = G_LandmineThink;
 
 	ent->damage         = 0;
@@ -2565,7 +2565,7 @@ void SP_misc_landmine( gentity_t *ent ) {
 		G_Error( "ERROR: misc_landmine without a team\n" );
 	}
 
-	ent->nextthink = level.time + FRAMETIME * 5;
+	G_SetNextThink( ent, level.time + FRAMETIME * 5 );
 	ent->think = landmine_setup;
 }
 
@@ -130,7 +130,7 @@ void G_BounceMissile( gentity_t *ent, trace_t *trace ) {
 			ent->s.time = level.time; // final rotation value
 			if ( ent->s.weapon == WP_M7 || ent->s.weapon == WP_GPG40 ) {
 				// explode one 750msecs after launchtime
-				ent->nextthink = level.time + ( 750 - ( level.time + 4000 - ent->nextthink ) );
+				G_SetNextThink( ent, level.time + ( 750 - ( level.time + 4000 - ent->nextthink ) ) );
 			}
 			return;
 		}
@@ -318,7 +318,7 @@ void M_think( gentity_t *ent ) {
 	tent->s.angles2[1] = 96;
 	tent->s.angles2[2] = 50;
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 }
 
@@ -453,7 +453,7 @@ void G_ExplodeMissile( gentity_t *ent ) {
 
 					G_UseTargets( hit, ent );
 					hit->think = G_FreeEntity;
-					hit->nextthink = level.time + FRAMETIME;
+					G_SetNextThink( hit, level.time + FRAMETIME );
 				}
 			}
 		}
@@ -483,7 +483,7 @@ void G_MissileDie( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, i
 	}
 	self->takedamage    = qfalse;
 	self->think         = G_ExplodeMissile;
-	self->nextthink     = level.time + 10;
+	G_SetNextThink( self, level.time + 10 );
 }
 
 /*
@@ -513,7 +513,7 @@ Explode a missile without an impact
 
 		gas = G_Spawn();
 		gas->think = gas_think;
-		gas->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( gas, level.time + FRAMETIME );
 		gas->r.contents = CONTENTS_TRIGGER;
 		gas->touch = gas_touch;
 		gas->health = 100;
@@ -1215,12 +1215,12 @@ void DynaSink( gentity_t *self ) {
 
 	if ( self->timestamp < level.time ) {
 		self->think = G_FreeEntity;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( self, level.time + FRAMETIME );
 		return;
 	}
 
 	self->s.pos.trBase[2] -= 0.5f;
-	self->nextthink = level.time + 50;
+	G_SetNextThink( self, level.time + 50 );
 }
 
 void DynaFree( gentity_t* self ) {
@@ -1511,7 +1511,7 @@ void LandminePostThink( gentity_t *self );
 void LandMineTrigger( gentity_t* self ) {
 	self->r.contents = CONTENTS_CORPSE;
 	trap_LinkEntity( self );
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 	self->think = LandminePostThink;
 	self->s.teamNum += 8;
 	// rain - communicate trigger time to client
@@ -1519,7 +1519,7 @@ void LandMineTrigger( gentity_t* self ) {
 }
 
 void LandMinePostTrigger( gentity_t* self ) {
-	self->nextthink = level.time + 300;
+	G_SetNextThink( self, level.time + 300 );
 	self->think = G_ExplodeMissile;
 }
 
@@ -1540,10 +1540,10 @@ void G_TripMineThink( gentity_t* ent ) {
 
 	trap_Trace( &trace, start, NULL, NULL, end, ent->s.number, MASK_SHOT );
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	if ( trace.fraction == 1.f ) { // Gordon: shouldnt really happen once we do a proper range check on placing
-/*		ent->nextthink = level.time;
+/*		G_SetNextThink( ent, level.time );
 		ent->think = DynaSink;
 		ent->timestamp = level.time + 1500;*/
 		return;
@@ -1569,7 +1569,7 @@ G_TripMinePrime
 
 void G_TripMinePrime( gentity_t* ent ) {
 	ent->think = G_TripMineThink;
-	ent->nextthink = level.time + 500;
+	G_SetNextThink( ent, level.time + 500 );
 }
 
 /*107     11      20      0       0       0       0       //fire gren
@@ -1607,7 +1607,7 @@ void G_LandmineThink( gentity_t *self ) {
 	qboolean trigger = qfalse;
 	gentity_t* ent;
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 
 	if ( level.time - self->missionLevel > 200 ) {
 		self->s.density = 0; // Gordon: time out the covert ops visibile thing, or we could get other clients being able to see mine later, etc
@@ -1649,7 +1649,7 @@ void LandminePostThink( gentity_t *self ) {
 	qboolean trigger = qfalse;
 	gentity_t* ent;
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 
 	if ( level.time - self->missionLevel > 5000 ) {
 		self->s.density = 0; // Gordon: time out the covert ops visibile thing, or we could get other clients being able to see mine later, etc
@@ -1682,7 +1682,7 @@ G_LandminePrime
 */
 
 void G_LandminePrime( gentity_t *self ) {
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 	self->think = G_LandmineThink;
 }
 
@@ -1735,14 +1735,14 @@ gentity_t *fire_grenade( gentity_t *self, vec3_t start, vec3_t dir, int grenadeW
 
 	// no self->client for shooter_grenade's
 	if ( self->client && self->client->ps.grenadeTimeLeft ) {
-		bolt->nextthink = level.time + self->client->ps.grenadeTimeLeft;
+		G_SetNextThink( bolt, level.time + self->client->ps.grenadeTimeLeft );
 	} else {
-		bolt->nextthink = level.time + 2500;
+		G_SetNextThink( bolt, level.time + 2500 );
 	}
 
 	if ( grenadeWPID == WP_DYNAMITE ) {
 		noExplode = qtrue;
-		bolt->nextthink = level.time + 15000;
+		G_SetNextThink( bolt, level.time + 15000 );
 		bolt->think = DynaSink;
 		bolt->timestamp = level.time + 16500;
 		bolt->free = DynaFree;
@@ -1750,21 +1750,21 @@ gentity_t *fire_grenade( gentity_t *self, vec3_t start, vec3_t dir, int grenadeW
 
 	if ( grenadeWPID == WP_LANDMINE ) {
 		noExplode = qtrue;
-		bolt->nextthink = level.time + 15000;
+		G_SetNextThink( bolt, level.time + 15000 );
 		bolt->think = DynaSink;
 		bolt->timestamp = level.time + 16500;
 	}
 
 	if ( grenadeWPID == WP_SATCHEL ) {
 		noExplode = qtrue;
-		bolt->nextthink = 0;
+		G_SetNextThink( bolt, 0 );
 		bolt->s.clientNum = self->s.clientNum;
 		bolt->free = G_FreeSatchel;
 	}
 
 	if ( grenadeWPID == WP_MORTAR_SET ) {    // only on impact
 		noExplode = qtrue;
-		bolt->nextthink = 0;
+		G_SetNextThink( bolt, 0 );
 	}
 
 	// no self->client for shooter_grenade's
@@ -1796,7 +1796,7 @@ gentity_t *fire_grenade( gentity_t *self, vec3_t start, vec3_t dir, int grenadeW
 		bolt->methodOfDeath         = MOD_GPG40;
 		bolt->splashMethodOfDeath   = MOD_GPG40;
 		bolt->s.eFlags              = /*0;*/ EF_BOUNCE_HALF | EF_BOUNCE;
-		bolt->nextthink             = level.time + 4000;
+		G_SetNextThink( bolt, level.time + 4000 );
 		break;
 	case WP_M7:
 		bolt->classname             = "m7_grenade";
@@ -1804,7 +1804,7 @@ gentity_t *fire_grenade( gentity_t *self, vec3_t start, vec3_t dir, int grenadeW
 		bolt->methodOfDeath         = MOD_M7;
 		bolt->splashMethodOfDeath   = MOD_M7;
 		bolt->s.eFlags              = /*0;*/ EF_BOUNCE_HALF | EF_BOUNCE;
-		bolt->nextthink             = level.time + 4000;
+		G_SetNextThink( bolt, level.time + 4000 );
 		break;
 	case WP_SMOKE_BOMB:
 		// xkan 11/25/2002, fixed typo, classname used to be "somke_bomb"
@@ -1952,7 +1952,7 @@ gentity_t *fire_rocket( gentity_t *self, vec3_t start, vec3_t dir ) {
 
 	bolt = G_Spawn();
 	bolt->classname = "rocket";
-	bolt->nextthink = level.time + 20000;   // push it out a little
+	G_SetNextThink( bolt, level.time + 20000 );   // push it out a little
 	bolt->think = G_ExplodeMissile;
 	bolt->accuracy = 4;
 	bolt->s.eType = ET_MISSILE;
@@ -2005,7 +2005,7 @@ gentity_t *fire_flamebarrel( gentity_t *self, vec3_t start, vec3_t dir ) {
 	bolt->accuracy      = 3;
 
 	bolt->classname = "flamebarrel";
-	bolt->nextthink = level.time + 3000;
+	G_SetNextThink( bolt, level.time + 3000 );
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_FLAMEBARREL;
 	bolt->s.eFlags = EF_BOUNCE_HALF;
@@ -2146,7 +2146,7 @@ gentity_t *fire_mortar( gentity_t *self, vec3_t start, vec3_t dir ) {
 
 	bolt = G_Spawn();
 	bolt->classname = "mortar";
-	bolt->nextthink = level.time + 20000;   // push it out a little
+	G_SetNextThink( bolt, level.time + 20000 );   // push it out a little
 	bolt->think = G_ExplodeMissile;
 
 	// Gordon: for explosion type
@@ -999,7 +999,7 @@ void Reached_BinaryMover( gentity_t *ent ) {
 
 		if ( ent->flags & FL_TOGGLE ) {
 			ent->think = ReturnToPos1;
-			ent->nextthink = 0;
+			G_SetNextThink( ent, 0 );
 			return;
 		}
 
@@ -1007,7 +1007,7 @@ void Reached_BinaryMover( gentity_t *ent ) {
 		// return to pos1 after a delay
 		if ( ent->wait != -1000 ) {
 			ent->think = ReturnToPos1;
-			ent->nextthink = level.time + ent->wait;
+			G_SetNextThink( ent, level.time + ent->wait );
 		}
 		// END JOSEPH
 	} else if ( ent->moverState == MOVER_2TO1 ) {
@@ -1044,13 +1044,13 @@ void Reached_BinaryMover( gentity_t *ent ) {
 
 		if ( ent->flags & FL_TOGGLE ) {
 			ent->think = ReturnToPos1Rotate;
-			ent->nextthink = 0;
+			G_SetNextThink( ent, 0 );
 			return;
 		}
 
 		// return to pos1 after a delay
 		ent->think = ReturnToPos1Rotate;
-		ent->nextthink = level.time + ent->wait;
+		G_SetNextThink( ent, level.time + ent->wait );
 
 	} else if ( ent->moverState == MOVER_2TO1ROTATE )   {
 		// reached pos1
@@ -1164,7 +1164,7 @@ void Reached_TrinaryMover( gentity_t *ent ) {
 
 		// goto pos 3
 		ent->think = GotoPos3;
-		ent->nextthink = level.time + 1000; //FRAMETIME;
+		G_SetNextThink( ent, level.time + 1000 ); //FRAMETIME;
 
 		// play sound
 		G_AddEvent( ent, EV_GENERAL_SOUND, ent->soundPos2 );
@@ -1189,7 +1189,7 @@ void Reached_TrinaryMover( gentity_t *ent ) {
 		// return to pos2 after a delay
 		if ( ent->wait != -1000 ) {
 			ent->think = ReturnToPos2;
-			ent->nextthink = level.time + ent->wait;
+			G_SetNextThink( ent, level.time + ent->wait );
 		}
 
 		// fire targets
@@ -1203,7 +1203,7 @@ void Reached_TrinaryMover( gentity_t *ent ) {
 
 		// return to pos1
 		ent->think = ReturnToPos1;
-		ent->nextthink = level.time + 1000; //FRAMETIME;
+		G_SetNextThink( ent, level.time + 1000 ); //FRAMETIME;
 
 		// play sound
 		G_AddEvent( ent, EV_GENERAL_SOUND, ent->soundPos3 );
@@ -1287,7 +1287,7 @@ void Use_TrinaryMover( gentity_t *ent, gentity_t *other, gentity_t *activator )
 	// if all the way up, just delay before coming down
 	if ( ent->moverState == MOVER_POS3 ) {
 		if ( ent->wait != -1000 ) {
-			ent->nextthink = level.time + ent->wait;
+			G_SetNextThink( ent, level.time + ent->wait );
 		}
 		return;
 	}
@@ -1489,12 +1489,12 @@ void Use_BinaryMover( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 	// JOSEPH 1-27-00
 	if ( ent->moverState == MOVER_POS2 ) {
 		if ( ent->flags & FL_TOGGLE ) {
-			ent->nextthink = level.time + 50;
+			G_SetNextThink( ent, level.time + 50 );
 			return;
 		}
 
 		if ( ent->wait != -1000 ) {
-			ent->nextthink = level.time + ent->wait;
+			G_SetNextThink( ent, level.time + ent->wait );
 		}
 		return;
 	}
@@ -1503,9 +1503,9 @@ void Use_BinaryMover( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 	// if all the way up, just delay before coming down
 	if ( ent->moverState == MOVER_POS2ROTATE ) {
 		if ( ent->flags & FL_TOGGLE ) {
-			ent->nextthink = level.time + 50;   // do it *now* for toggles
+			G_SetNextThink( ent, level.time + 50 );   // do it *now* for toggles
 		} else {
-			ent->nextthink = level.time + ent->wait;
+			G_SetNextThink( ent, level.time + ent->wait );
 		}
 		return;
 	}
@@ -1969,7 +1969,7 @@ void finishSpawningKeyedMover( gentity_t *ent ) {
 	}
 //----(SA)	end
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	if ( !( ent->flags & FL_TEAMSLAVE ) ) {
 		if ( ent->targetname || ent->takedamage ) {  // non touch/shoot doors
@@ -2278,7 +2278,7 @@ void SP_func_door( gentity_t *ent ) {
 		}
 	}
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->think = finishSpawningKeyedMover;
 }
 
@@ -2396,7 +2396,7 @@ void SP_func_secret( gentity_t *ent ) {
 		}
 	}
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->think = finishSpawningKeyedMover;
 }
 // END JOSEPH
@@ -2423,7 +2423,7 @@ void Touch_Plat( gentity_t *ent, gentity_t *other, trace_t *trace ) {
 
 	// delay return-to-pos1 by one second
 	if ( ent->moverState == MOVER_POS2 ) {
-		ent->nextthink = level.time + 1000;
+		G_SetNextThink( ent, level.time + 1000 );
 	}
 }
 
@@ -2714,7 +2714,7 @@ void Reached_Train( gentity_t *ent ) {
 
 	// if there is a "wait" value on the target, don't start moving yet
 	if ( next->wait ) {
-		ent->nextthink = level.time + next->wait * 1000;
+		G_SetNextThink( ent, level.time + next->wait * 1000 );
 		ent->think = Think_BeginMoving;
 		ent->s.pos.trType = TR_STATIONARY;
 	}
@@ -2937,7 +2937,7 @@ void SP_info_limbo_camera( gentity_t* self ) {
 	}
 
 	self->think =       info_limbo_camera_setup;
-	self->nextthink =   level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 
 	G_SpawnInt( "objective", "-1", &self->count );
 }
@@ -2984,7 +2984,7 @@ void SP_func_train( gentity_t *self ) {
 
 	// start trains on the second frame, to make sure their targets have had
 	// a chance to spawn
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 	self->think = Think_SetupTrainTargets;
 
 	self->blocked = Blocked_Door;
@@ -3112,7 +3112,7 @@ void Reached_Train_rotating( gentity_t *ent ) {
 
 	// if there is a "wait" value on the target, don't start moving yet
 	if ( next->wait ) {
-		ent->nextthink = level.time + next->wait * 1000;
+		G_SetNextThink( ent, level.time + next->wait * 1000 );
 		ent->think = Think_BeginMoving_rotating;
 		ent->s.pos.trType = TR_STATIONARY;
 	}
@@ -3220,7 +3220,7 @@ void SP_func_train_rotating( gentity_t *self ) {
 
 	// start trains on the second frame, to make sure their targets have had
 	// a chance to spawn
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 	self->think = Think_SetupTrainTargets_rotating;
 }
 // END JOSEPH
@@ -3279,7 +3279,7 @@ void Static_Pain( gentity_t *ent, gentity_t *attacker, int damage, vec3_t point
 }
 
 void G_BlockThink( gentity_t *ent ) {
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 
@@ -3683,7 +3683,7 @@ void SP_func_door_rotating( gentity_t *ent ) {
 		}
 	}
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->think = finishSpawningKeyedMover;
 
 	VectorCopy( ent->s.origin, ent->s.pos.trBase );
@@ -3815,7 +3815,7 @@ void BecomeExplosion( gentity_t *self ) {
 	self->pain  = NULL;
 	self->touch = NULL;
 	self->use   = NULL;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 	self->think = G_FreeEntity;
 
 	G_FreeEntity( self );
@@ -3838,7 +3838,7 @@ void func_explosive_explode( gentity_t *self, gentity_t *inflictor, gentity_t *a
 	self->takedamage = qfalse;          // don't allow anything try to hurt me now that i'm exploding
 
 	self->think = BecomeExplosion;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 
 	VectorSubtract( self->r.absmax, self->r.absmin, size );
 	VectorScale( size, 0.5, size );
@@ -3976,7 +3976,7 @@ void InitExplosive( gentity_t *ent ) {
 	trap_LinkEntity( ent );
 
 	ent->think = G_BlockThink;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 /*QUAKED target_explosion (0 .5 .8) (-32 -32 -32) (32 32 32) LOWGRAV
@@ -4759,7 +4759,7 @@ void func_constructible_underconstructionthink( gentity_t *ent ) {
 			}
 
 			ent->think = NULL;
-			ent->nextthink = 0;
+			G_SetNextThink( ent, 0 );
 			ent->s.angles2[0] = 0;
 
 			ent->lastHintCheckTime = level.time;    // don't allow building again for a lil while
@@ -4767,7 +4767,7 @@ void func_constructible_underconstructionthink( gentity_t *ent ) {
 		}
 	}
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 extern void explosive_indicator_think( gentity_t *ent );
@@ -4948,7 +4948,7 @@ void func_constructiblespawn( gentity_t *ent ) {
 				e->s.modelindex2 = ent->parent->s.teamNum;
 				e->r.ownerNum = ent->s.number;
 				e->think = explosive_indicator_think;
-				e->nextthink = level.time + FRAMETIME;
+				G_SetNextThink( e, level.time + FRAMETIME );
 
 				e->s.effect1Time = ent->constructibleStats.weaponclass;
 
@@ -5042,7 +5042,7 @@ void SP_func_constructible( gentity_t *ent ) {
 	ent->s.dmgFlags = 0;
 
 	ent->think = func_constructiblespawn;
-	ent->nextthink = level.time + ( 2 * FRAMETIME );
+	G_SetNextThink( ent, level.time + ( 2 * FRAMETIME ) );
 }
 
 /*QUAKED func_brushmodel (.9 .50 .50) ?
@@ -5065,7 +5065,7 @@ void SP_func_brushmodel( gentity_t *ent ) {
 	}
 
 	ent->think = func_brushmodel_delete;
-	ent->nextthink = level.time + ( 3 * FRAMETIME );
+	G_SetNextThink( ent, level.time + ( 3 * FRAMETIME ) );
 }
 
 // Gordon: debris test
@@ -50,7 +50,7 @@ void DropToFloorG( gentity_t *ent ) {
 
 	G_SetOrigin( ent, tr.endpos );
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 void DropToFloor( gentity_t *ent ) {
@@ -73,7 +73,7 @@ void DropToFloor( gentity_t *ent ) {
 	G_SetOrigin( ent, tr.endpos );
 
 	ent->think = DropToFloorG;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 void moveit( gentity_t *ent, float yaw, float dist ) {
@@ -149,7 +149,7 @@ void SP_props_box_32( gentity_t *self ) {
 	trap_LinkEntity( self );
 
 	self->think = DropToFloor;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 void touch_props_box_48( gentity_t *self, gentity_t *other, trace_t *trace ) {
@@ -183,7 +183,7 @@ void SP_props_box_48( gentity_t *self ) {
 	trap_LinkEntity( self );
 
 	self->think = DropToFloor;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 void touch_props_box_64( gentity_t *self, gentity_t *other, trace_t *trace ) {
@@ -217,7 +217,7 @@ void SP_props_box_64( gentity_t *self ) {
 	trap_LinkEntity( self );
 
 	self->think = DropToFloor;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 // END JOSEPH
 
@@ -241,7 +241,7 @@ void Psmoke_think( gentity_t *ent ) {
 	tent->s.angles2[1] = 32;
 	tent->s.angles2[2] = 50;
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 void prop_smoke( gentity_t *ent ) {
@@ -250,7 +250,7 @@ void prop_smoke( gentity_t *ent ) {
 	Psmoke = G_Spawn();
 	VectorCopy( ent->r.currentOrigin, Psmoke->s.origin );
 	Psmoke->think = Psmoke_think;
-	Psmoke->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( Psmoke, level.time + FRAMETIME );
 }
 
 /*QUAKED props_sparks (.8 .46 .16) (-8 -8 -8) (8 8 8) ELECTRIC
@@ -300,7 +300,7 @@ void Psparks_think( gentity_t *ent ) {
 	tent->s.angles2[1] = ent->end_size;
 	tent->s.angles2[2] = ent->speed;
 
-	ent->nextthink = level.time + FRAMETIME + ent->delay + ( rand() % 600 );
+	G_SetNextThink( ent, level.time + FRAMETIME + ent->delay + ( rand() % 600 ) );
 }
 
 void sparks_angles_think( gentity_t *ent ) {
@@ -322,7 +322,7 @@ void sparks_angles_think( gentity_t *ent ) {
 
 	trap_LinkEntity( ent );
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	if ( !Q_stricmp( ent->classname, "props_sparks" ) ) {
 		ent->think = Psparks_think;
 	} else {
@@ -341,7 +341,7 @@ void SP_props_sparks( gentity_t *ent ) {
 	ent->s.eType = ET_GENERAL;
 
 	ent->think = sparks_angles_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	if ( !ent->health ) {
 		ent->health = 8;
@@ -384,7 +384,7 @@ void SP_props_gunsparks( gentity_t *ent ) {
 	ent->s.eType = ET_GENERAL;
 
 	ent->think = sparks_angles_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	if ( !ent->speed ) {
 		ent->speed = 20;
@@ -489,7 +489,7 @@ void SP_Dust( gentity_t *ent ) {
 
 	if ( ent->target ) {
 		ent->think = dust_angles_think;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 	}
 
 	trap_LinkEntity( ent );
@@ -509,7 +509,7 @@ void propExplosionLarge( gentity_t *ent ) {
 	bolt->accuracy      = 2;
 
 	bolt->classname = "props_explosion_large";
-	bolt->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( bolt, level.time + FRAMETIME );
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_MISSILE;
 	bolt->r.svFlags = 0;
@@ -537,7 +537,7 @@ void propExplosion( gentity_t *ent ) {
 
 	bolt = G_Spawn();
 	bolt->classname = "props_explosion";
-	bolt->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( bolt, level.time + FRAMETIME );
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_MISSILE;
 	bolt->r.svFlags = 0;
@@ -629,7 +629,7 @@ void props_bench_think( gentity_t *ent ) {
 	ent->s.frame++;
 
 	if ( ent->s.frame < 28 ) {
-		ent->nextthink = level.time + ( FRAMETIME / 2 );
+		G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 	} else
 	{
 		ent->clipmask = 0;
@@ -643,7 +643,7 @@ void props_bench_think( gentity_t *ent ) {
 
 void props_bench_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int damage, int mod ) {
 	ent->think = props_bench_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 /*QUAKED props_bench (.8 .6 .2) ?
@@ -777,14 +777,14 @@ void locker_tall_think( gentity_t *ent ) {
 	} else
 	{
 		ent->s.frame++;
-		ent->nextthink = level.time + ( FRAMETIME / 2 );
+		G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 	}
 
 }
 
 void props_locker_tall_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int damage, int mod ) {
 	ent->think = locker_tall_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->takedamage = qfalse;
 
@@ -890,7 +890,7 @@ void Just_Got_Thrown( gentity_t *self ) {
 	len = 0;
 
 	if ( self->s.groundEntityNum == -1 ) {
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( self, level.time + FRAMETIME );
 
 		if ( self->enemy ) {
 			//prop_hits = qtrue;
@@ -933,7 +933,7 @@ void Just_Got_Thrown( gentity_t *self ) {
 	self->s.eType = ET_MOVER;
 	self->s.dmgFlags = HINT_CHAIR;  // so client knows what kind of mover it is for cursorhints
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 
 	self->r.ownerNum = self->s.number;
 
@@ -965,7 +965,7 @@ void Props_Activated( gentity_t *self ) {
 
 	owner = &g_entities[self->r.ownerNum];
 
-	self->nextthink = level.time + 50;
+	G_SetNextThink( self, level.time + 50 );
 
 	if ( !owner->client ) {
 		return;
@@ -995,7 +995,7 @@ void Props_Activated( gentity_t *self ) {
 		VectorCopy( velocity, self->s.pos.trDelta );
 
 		self->think = NULL;
-		self->nextthink = 0;
+		G_SetNextThink( self, 0 );
 
 		prop = G_Spawn();
 		prop->s.modelindex = self->s.modelindex;
@@ -1033,7 +1033,7 @@ void Props_Activated( gentity_t *self ) {
 		prop->count = self->count;
 
 		prop->think = Just_Got_Thrown;
-		prop->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( prop, level.time + FRAMETIME );
 
 		prop->takedamage = qtrue;
 
@@ -1154,7 +1154,7 @@ void Props_Chair_Think( gentity_t *self ) {
 	//a stationary object.
 //	Prop_Check_Ground (self);
 
-	self->nextthink = level.time + 50;
+	G_SetNextThink( self, level.time + 50 );
 //	trap_LinkEntity (self);
 
 	//bani - prevent unneeded links
@@ -1293,13 +1293,13 @@ void Props_Chair_Animate( gentity_t *ent ) {
 			ent->s.frame = 27;
 			G_UseTargets( ent, NULL );
 			ent->think = G_FreeEntity;
-			ent->nextthink = level.time + 2000;
+			G_SetNextThink( ent, level.time + 2000 );
 			ent->s.time = level.time;
 			ent->s.time2 = level.time + 2000;
 			return;
 		} else
 		{
-			ent->nextthink = level.time + ( FRAMETIME / 2 );
+			G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 		}
 	} else if (
 		( !Q_stricmp( ent->classname, "props_chair_side" ) ) ||
@@ -1311,13 +1311,13 @@ void Props_Chair_Animate( gentity_t *ent ) {
 			ent->s.frame = 20;
 			G_UseTargets( ent, NULL );
 			ent->think = G_FreeEntity;
-			ent->nextthink = level.time + 2000;
+			G_SetNextThink( ent, level.time + 2000 );
 			ent->s.time = level.time;
 			ent->s.time2 = level.time + 2000;
 			return;
 		} else
 		{
-			ent->nextthink = level.time + ( FRAMETIME / 2 );
+			G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 		}
 	} else if ( !Q_stricmp( ent->classname, "props_desklamp" ) )       {
 		if ( ent->s.frame >= 11 ) {
@@ -1327,13 +1327,13 @@ void Props_Chair_Animate( gentity_t *ent ) {
 			}
 
 			ent->think = G_FreeEntity;
-			ent->nextthink = level.time + 2000;
+			G_SetNextThink( ent, level.time + 2000 );
 			ent->s.time = level.time;
 			ent->s.time2 = level.time + 2000;
 			return;
 		} else
 		{
-			ent->nextthink = level.time + ( FRAMETIME / 2 );
+			G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 		}
 	}
 
@@ -1394,7 +1394,7 @@ void Spawn_Shard( gentity_t *ent, gentity_t *inflictor, int quantity, int type )
 
 	sfx->think = G_FreeEntity;
 
-	sfx->nextthink = level.time + 1000;
+	G_SetNextThink( sfx, level.time + 1000 );
 
 	sfx->s.frame = quantity;
 
@@ -1423,7 +1423,7 @@ void Props_Chair_Die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker,
 	int type;
 
 	ent->think = Props_Chair_Animate;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->health = ent->duration;
 	ent->delay = damage;
@@ -1489,7 +1489,7 @@ void SP_Props_Chair( gentity_t *ent ) {
 	}
 
 	ent->think = Props_Chair_Think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->touch = Props_Chair_Touch;
 	ent->die = Props_Chair_Die;
@@ -1539,7 +1539,7 @@ void SP_Props_ChairHiback( gentity_t *ent ) {
 	}
 
 	ent->think = Props_Chair_Think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->touch = Props_Chair_Touch;
 	ent->die = Props_Chair_Die;
@@ -1587,7 +1587,7 @@ void SP_Props_ChairSide( gentity_t *ent ) {
 	}
 
 	ent->think = Props_Chair_Think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->touch = Props_Chair_Touch;
 	ent->die = Props_Chair_Die;
@@ -1643,7 +1643,7 @@ void SP_Props_ChateauChair( gentity_t *ent ) {
 	}
 
 	ent->think = Props_Chair_Think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->touch = Props_Chair_Touch;
 	ent->die = Props_Chair_Die;
@@ -1727,7 +1727,7 @@ void Use_Props_Shard_Generator( gentity_t *ent, gentity_t *other, gentity_t *act
 	type = ent->count;
 	quantity = ent->wait;
 
-	inflictor = G_Find( NULL, FOFS( targetname ), ent->target );
+	inflictor = G_FindByTargetname( NULL, ent->target );
 
 	if ( inflictor ) {
 		Spawn_Shard( ent, inflictor, quantity, type );
@@ -1802,7 +1802,7 @@ void SP_Props_Desklamp( gentity_t *ent ) {
 	}
 
 	ent->think = Props_Chair_Think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->touch = Props_Chair_Touch;
 	ent->die = Props_Chair_Die;
@@ -1836,20 +1836,20 @@ void Props_Barrel_Animate( gentity_t *ent ) {
 		if ( ent->spawnflags & 1 ) {
 			//	G_UseTargets (ent, NULL);
 			ent->think = G_FreeEntity;
-			ent->nextthink = level.time + 25000;
+			G_SetNextThink( ent, level.time + 25000 );
 			return;
 		} else
 		{
 			//	G_UseTargets (ent, NULL);
 			ent->think = G_FreeEntity;
-			ent->nextthink = level.time + 25000;
+			G_SetNextThink( ent, level.time + 25000 );
 			//ent->s.time = level.time;
 			//ent->s.time2 = level.time + 2000;
 			return;
 		}
 	} else
 	{
-		ent->nextthink = level.time + ( FRAMETIME / 2 );
+		G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 	}
 
 	ent->s.frame++;
@@ -1887,7 +1887,7 @@ void smoker_think( gentity_t *ent ) {
 	} else
 	{
 		barrel_smoke( ent );
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 	}
 
 }
@@ -1910,7 +1910,7 @@ void OilParticles_think( gentity_t *ent ) {
 	owner = &g_entities[ent->s.density];
 
 	if ( owner && owner->takedamage && ent->count2 > level.time - 5000 ) {
-		ent->nextthink = ( level.time + FRAMETIME / 2 );
+		G_SetNextThink( ent, ( level.time + FRAMETIME / 2 ) );
 
 		tent = G_TempEntity( ent->r.currentOrigin, EV_OILPARTICLES );
 		VectorCopy( ent->r.currentOrigin, tent->s.origin );
@@ -1989,7 +1989,7 @@ void SP_OilParticles( gentity_t *ent ) {
 	VectorCopy( forward, OilLeak->rotate );
 
 	OilLeak->think = OilParticles_think;
-	OilLeak->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( OilLeak, level.time + FRAMETIME );
 
 	OilLeak->s.density = ent->s.number;
 	OilLeak->count2 = level.time;
@@ -2031,7 +2031,7 @@ void OilSlick_remove( gentity_t *ent ) {
 	remove = G_Spawn();
 	remove->s.density = ent->s.number;
 	remove->think = OilSlick_remove_think;
-	remove->nextthink = level.time + 1000;
+	G_SetNextThink( remove, level.time + 1000 );
 	VectorCopy( ent->r.currentOrigin, remove->r.currentOrigin );
 	trap_LinkEntity( remove );
 }
@@ -2067,7 +2067,7 @@ void Props_Barrel_Die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker
 	ent->touch = NULL;
 
 	ent->think = Props_Barrel_Animate;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->health = ent->duration;
 	ent->delay = damage;
@@ -2137,7 +2137,7 @@ void SP_Props_Flamebarrel( gentity_t *ent ) {
 	ent->count = FXTYPE_METAL; // metal shards
 
 	ent->think = Props_Barrel_Think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->touch = Props_Barrel_Touch;
 
@@ -2210,14 +2210,14 @@ void crate_animate( gentity_t *ent ) {
 	if ( ent->s.frame == 17 ) {
 		G_UseTargets( ent, NULL );
 		ent->think = G_FreeEntity;
-		ent->nextthink = level.time + 2000;
+		G_SetNextThink( ent, level.time + 2000 );
 		ent->s.time = level.time;
 		ent->s.time2 = level.time + 2000;
 		return;
 	}
 
 	ent->s.frame++;
-	ent->nextthink = level.time + ( FRAMETIME / 2 );
+	G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 }
 
 void crate_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int damage, int mod ) {
@@ -2231,7 +2231,7 @@ void crate_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int d
 
 	ent->takedamage = qfalse;
 	ent->think = crate_animate;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->touch = NULL;
 
 	trap_UnlinkEntity( ent );
@@ -2282,7 +2282,7 @@ void SP_crate_64( gentity_t *self ) {
 	trap_LinkEntity( self );
 
 	self->think = DropToFloor;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 void SP_crate_32( gentity_t *self ) {
@@ -2323,7 +2323,7 @@ void SP_crate_32( gentity_t *self ) {
 	trap_LinkEntity( self );
 
 	self->think = DropToFloor;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 //////////////////////////////////////////////
@@ -2332,7 +2332,7 @@ void props_crate32x64_think( gentity_t *ent ) {
 	ent->s.frame++;
 
 	if ( ent->s.frame < 17 ) {
-		ent->nextthink = level.time + ( FRAMETIME / 2 );
+		G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 	} else
 	{
 		ent->clipmask = 0;
@@ -2346,7 +2346,7 @@ void props_crate32x64_think( gentity_t *ent ) {
 
 void props_crate32x64_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int damage, int mod ) {
 	ent->think = props_crate32x64_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 void SP_Props_Crate32x64( gentity_t *ent ) {
@@ -2410,7 +2410,7 @@ void flippy_table_use( gentity_t *ent, gentity_t *other, gentity_t *activator )
 			VectorCopy( ent->s.apos.trDelta, slave->s.apos.trDelta );
 
 			slave->think = ent->think;
-			slave->nextthink = ent->nextthink;
+			G_SetNextThink( slave, ent->nextthink );
 
 			VectorCopy( ent->pos1, slave->pos1 );
 			VectorCopy( ent->pos2, slave->pos2 );
@@ -2437,17 +2437,17 @@ void flippy_table_animate( gentity_t *ent ) {
 	if ( ent->s.frame == 9 ) {
 		G_UseTargets( ent, NULL );
 		ent->think = G_FreeEntity;
-		ent->nextthink = level.time + 2000;
+		G_SetNextThink( ent, level.time + 2000 );
 	} else
 	{
 		ent->s.frame++;
-		ent->nextthink = level.time + ( FRAMETIME / 2 );
+		G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 	}
 }
 
 void props_flippy_table_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int damage, int mod ) {
 	ent->think = flippy_table_animate;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->takedamage = qfalse;
 
@@ -2573,7 +2573,7 @@ void props_58x112tablew_think( gentity_t *ent ) {
 	ent->s.frame++;
 
 	if ( ent->s.frame < 16 ) {
-		ent->nextthink = level.time + ( FRAMETIME / 2 );
+		G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 	} else
 	{
 
@@ -2587,7 +2587,7 @@ void props_58x112tablew_think( gentity_t *ent ) {
 
 void props_58x112tablew_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int damage, int mod ) {
 	ent->think = props_58x112tablew_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->takedamage = qfalse;
 }
 
@@ -2654,7 +2654,7 @@ void props_castlebed_animate( gentity_t *ent ) {
 	ent->s.frame++;
 
 	if ( ent->s.frame < 8 ) {
-		ent->nextthink = level.time + ( FRAMETIME / 2 );
+		G_SetNextThink( ent, level.time + ( FRAMETIME / 2 ) );
 	} else
 	{
 		ent->clipmask = 0;
@@ -2665,7 +2665,7 @@ void props_castlebed_animate( gentity_t *ent ) {
 
 void props_castlebed_die( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int damage, int mod ) {
 	ent->think = props_castlebed_animate;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->touch = NULL;
 	ent->takedamage = qfalse;
 
@@ -2736,9 +2736,9 @@ void props_snowGenerator_think( gentity_t *ent ) {
 	}
 
 	if ( ent->spawnflags & 2 ) {
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 	} else if ( ent->wait < level.time ) {
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 	}
 }
 
@@ -2746,7 +2746,7 @@ void props_snowGenerator_use( gentity_t *ent, gentity_t *other, gentity_t *activ
 	if ( !( ent->spawnflags & 1 ) ) {
 		ent->spawnflags |= 1;
 		ent->think = props_snowGenerator_think;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 		ent->wait = level.time + ent->duration;
 	} else {
 		ent->spawnflags &= ~1;
@@ -2769,7 +2769,7 @@ void SP_props_snowGenerator( gentity_t *ent ) {
 		return;
 	} else
 	{
-		target = G_Find( target, FOFS( targetname ), ent->target );
+		target = G_FindByTargetname( target, ent->target );
 		if ( !target ) {
 			G_Printf( "error snowGenerator at loc %s does cant find target %s\n", vtos( center ), ent->target );
 			return;
@@ -2784,7 +2784,7 @@ void SP_props_snowGenerator( gentity_t *ent ) {
 
 	if ( ent->spawnflags & 1 || ent->spawnflags & 2 ) {
 		ent->think = props_snowGenerator_think;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 
 		if ( ent->spawnflags & 2 ) {
 			ent->spawnflags |= 1;
@@ -2873,7 +2873,7 @@ assign a model
 	// TBD
 	// lifetime
 	if (ent->duration)
-		tent->nextthink = level.time + ent->duration;
+		G_SetNextThink( tent, level.time + ent->duration );
 
 	// speed
 	if (ent->speed)
@@ -2904,7 +2904,7 @@ assign a model
 
 	if (ent->target)
 	{
-		target = G_Find (NULL, FOFS (targetname), ent->target);
+		target = G_FindByTargetname( NULL, ent->target );
 		VectorSubtract (target->s.origin, ent->s.origin, vec);
 		vectoangles (vec, angles);
 		G_SetAngle (ent, angles);
@@ -2927,7 +2927,7 @@ assign a model
 {
 	G_SetOrigin (ent, ent->s.origin);
 	ent->think = propsFireColumnInit;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->use = propsFireColumnUse;
 	trap_LinkEntity (ent);
 }*/
@@ -2993,7 +2993,7 @@ for stone:
 
 	if (ent->target)
 	{
-		target = G_Find (NULL, FOFS (targetname), ent->target);
+		target = G_FindByTargetname( NULL, ent->target );
 		VectorSubtract (target->s.origin, ent->s.origin, vec);
 		vectoangles (vec, angles);
 		G_SetAngle (ent, angles);
@@ -3047,7 +3047,7 @@ for stone:
 	}
 
 	ent->think = props_ExploPartInit;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	ent->use = props_ExploPartUse;
 }*/
@@ -3090,7 +3090,7 @@ void props_decoration_animate( gentity_t *ent ) {
 		}
 	}
 
-	ent->nextthink = level.time + 50;
+	G_SetNextThink( ent, level.time + 50 );
 }
 
 void props_decoration_death( gentity_t *ent, gentity_t *inflictor, gentity_t *attacker, int damage, int mod ) {
@@ -3110,7 +3110,7 @@ void props_decoration_death( gentity_t *ent, gentity_t *inflictor, gentity_t *at
 	}
 
 	if ( ent->spawnflags & 4 ) {
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 		ent->think = props_decoration_animate;
 		return;
 	}
@@ -3124,7 +3124,7 @@ void Use_props_decoration( gentity_t *ent, gentity_t *self, gentity_t *activator
 		trap_LinkEntity( ent );
 		ent->spawnflags &= ~1;
 	} else if ( ent->spawnflags & 4 )     {
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 		ent->think = props_decoration_animate;
 	} else
 	{
@@ -3259,7 +3259,7 @@ void SP_props_decoration( gentity_t *ent ) {
 	}
 
 	if ( ent->spawnflags & 64 ) {
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 		ent->think = props_decoration_animate;
 	}
 
@@ -3489,7 +3489,7 @@ void props_statue_animate( gentity_t *ent ) {
 	}
 
 	if ( ent->s.frame < ent->count2 ) {
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 	}
 }
 
@@ -3516,7 +3516,7 @@ void props_statue_death( gentity_t *ent, gentity_t *inflictor, gentity_t *attack
 	}
 
 	if ( ent->spawnflags & 4 ) {
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 		ent->think = props_statue_animate;
 		return;
 	}
@@ -3707,7 +3707,7 @@ void Spawn_Junk( gentity_t *ent ) {
 
 	sfx->think = G_FreeEntity;
 
-	sfx->nextthink = level.time + 1000;
+	G_SetNextThink( sfx, level.time + 1000 );
 
 	trap_LinkEntity( sfx );
 }
@@ -3720,7 +3720,7 @@ props_locker_endrattle
 void props_locker_endrattle( gentity_t *ent ) {
 	ent->s.frame = 0;   // idle
 	ent->think = 0;
-	ent->nextthink = 0;
+	G_SetNextThink( ent, 0 );
 	ent->delay = 0;
 }
 
@@ -3731,7 +3731,7 @@ void props_locker_use( gentity_t *ent, gentity_t *other, gentity_t *activator )
 	}
 	ent->delay = 1;
 	ent->think = props_locker_endrattle;
-	ent->nextthink = level.time + 1000; // rattle a sec
+	G_SetNextThink( ent, level.time + 1000 ); // rattle a sec
 }
 
 void props_locker_pain( gentity_t *ent, gentity_t *attacker, int damage, vec3_t point ) {
@@ -3859,7 +3859,7 @@ void props_locker_death( gentity_t *ent, gentity_t *inflictor, gentity_t *attack
 	ent->takedamage = qfalse;
 	ent->s.frame = 2;   // opening animation
 	ent->think = 0;
-	ent->nextthink = 0;
+	G_SetNextThink( ent, 0 );
 
 	trap_UnlinkEntity( ent );
 	ent->r.maxs[2] = 11;    // (SA) make the dead bb half height so the item can look like it's sitting inside
@@ -3991,7 +3991,7 @@ void props_flamethrower_think( gentity_t *ent ) {
 	if ( ( ent->timestamp + ent->duration ) > level.time ) {
 		G_AddEvent( ent, EV_FLAMETHROWER_EFFECT, 0 );
 
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 
 		// TAT 11/12/2002
 		//		The flamethrower effect above is purely visual
@@ -4010,7 +4010,7 @@ void props_flamethrower_think( gentity_t *ent ) {
 			}
 
 			ent->timestamp = level.time + rnd;
-			ent->nextthink = ent->timestamp + 50;
+			G_SetNextThink( ent, ent->timestamp + 50 );
 		}
 	}
 }
@@ -4022,7 +4022,7 @@ void props_flamethrower_use( gentity_t *ent, gentity_t *other, gentity_t *activa
 	if ( ent->spawnflags & 2 ) {
 		ent->spawnflags &= ~2;
 		ent->think = NULL;      // (SA) wasn't working
-		ent->nextthink = 0;
+		G_SetNextThink( ent, 0 );
 		return;
 	} else
 	{
@@ -4039,7 +4039,7 @@ void props_flamethrower_use( gentity_t *ent, gentity_t *other, gentity_t *activa
 	ent->timestamp = level.time + rnd;
 
 	ent->think = props_flamethrower_think;
-	ent->nextthink = level.time + 50;
+	G_SetNextThink( ent, level.time + 50 );
 
 }
 
@@ -4074,7 +4074,7 @@ void SP_props_flamethrower( gentity_t *ent ) {
 	float dsize;
 
 	ent->think = props_flamethrower_init;
-	ent->nextthink = level.time + 50;
+	G_SetNextThink( ent, level.time + 50 );
 	ent->use = props_flamethrower_use;
 
 	G_SetOrigin( ent, ent->s.origin );
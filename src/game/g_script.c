@@ -50,15 +50,27 @@ vmCvar_t g_scriptDebug;
 // action functions need to be declared here so they can be accessed in the scriptAction table
 qboolean G_ScriptAction_GotoMarker( gentity_t *ent, char *params );
 qboolean G_ScriptAction_Wait( gentity_t *ent, char *params );
+const char *G_ScriptCompile_Wait( g_script_operands_t *operands, const char *params );
+qboolean G_ScriptOperands_Wait( gentity_t *ent, g_script_operands_t *operands );
 qboolean G_ScriptAction_Trigger( gentity_t *ent, char *params );
+const char *G_ScriptCompile_Trigger( g_script_operands_t *operands, const char *params );
+qboolean G_ScriptOperands_Trigger( gentity_t *ent, g_script_operands_t *operands );
 qboolean G_ScriptAction_PlaySound( gentity_t *ent, char *params );
+const char *G_ScriptCompile_PlaySound( g_script_operands_t *operands, const char *params );
+qboolean G_ScriptOperands_PlaySound( gentity_t *ent, g_script_operands_t *operands );
 qboolean G_ScriptAction_PlayAnim( gentity_t *ent, char *params );
 qboolean G_ScriptAction_AlertEntity( gentity_t *ent, char *params );
+const char *G_ScriptCompile_AlertEntity( g_script_operands_t *operands, const char *params );
+qboolean G_ScriptOperands_AlertEntity( gentity_t *ent, g_script_operands_t *operands );
 qboolean G_ScriptAction_ToggleSpeaker( gentity_t *ent, char *params );
 qboolean G_ScriptAction_DisableSpeaker( gentity_t *ent, char *params );
 qboolean G_ScriptAction_EnableSpeaker( gentity_t *ent, char *params );
 qboolean G_ScriptAction_Accum( gentity_t *ent, char *params );
+const char *G_ScriptCompile_Accum( g_script_operands_t *operands, const char *params );
+qboolean G_ScriptOperands_Accum( gentity_t *ent, g_script_operands_t *operands );
 qboolean G_ScriptAction_GlobalAccum( gentity_t *ent, char *params );
+const char *G_ScriptCompile_GlobalAccum( g_script_operands_t *operands, const char *params );
+qboolean G_ScriptOperands_GlobalAccum( gentity_t *ent, g_script_operands_t *operands );
 qboolean G_ScriptAction_Print( gentity_t *ent, char *params );
 qboolean G_ScriptAction_FaceAngles( gentity_t *ent, char *params );
 qboolean G_ScriptAction_ResetScript( gentity_t *ent, char *params );
@@ -82,6 +94,8 @@ qboolean G_ScriptAction_EndRound( gentity_t *ent, char *params );
 qboolean G_ScriptAction_SetRoundTimelimit( gentity_t *ent, char *params );
 qboolean G_ScriptAction_RemoveEntity( gentity_t *ent, char *params );
 qboolean G_ScriptAction_SetState( gentity_t *ent, char *params );
+const char *G_ScriptCompile_SetState( g_script_operands_t *operands, const char *params );
+qboolean G_ScriptOperands_SetState( gentity_t *ent, g_script_operands_t *operands );
 qboolean G_ScriptAction_VoiceAnnounce( gentity_t *ent, char *params );
 qboolean G_ScriptAction_FollowSpline( gentity_t *ent, char *params );
 qboolean G_ScriptAction_FollowPath( gentity_t *ent, char *params );
@@ -108,6 +122,8 @@ qboolean G_ScriptAction_PrintGlobalAccum( gentity_t *ent, char *params );
 qboolean G_ScriptAction_ObjectiveStatus( gentity_t *ent, char *params );
 qboolean G_ScriptAction_SetModelFromBrushmodel( gentity_t *ent, char *params );
 qboolean G_ScriptAction_SetPosition( gentity_t *ent, char *params );
+const char *G_ScriptCompile_SetPosition( g_script_operands_t *operands, const char *params );
+qboolean G_ScriptOperands_SetPosition( gentity_t *ent, g_script_operands_t *operands );
 qboolean G_ScriptAction_SetAutoSpawn( gentity_t *ent, char *params );
 qboolean G_ScriptAction_SetMainObjective( gentity_t *ent, char *params );
 qboolean G_ScriptAction_SpawnRubble( gentity_t *ent, char *params );
@@ -140,20 +156,21 @@ qboolean G_ScriptAction_ConstructibleDuration( gentity_t *ent, char *params ) ;
 //bani
 qboolean etpro_ScriptAction_SetValues( gentity_t *ent, char *params );
 
-// these are the actions that each event can call
+// these are the actions that each event can call, the ones run often also
+// have their params compiled when the script is parsed
 g_script_stack_action_t gScriptActions[] =
 {
 	{"gotomarker",                       G_ScriptAction_GotoMarker},
-	{"playsound",                        G_ScriptAction_PlaySound},
+	{"playsound",                        G_ScriptAction_PlaySound,           G_ScriptCompile_PlaySound,      G_ScriptOperands_PlaySound},
 	{"playanim",                     G_ScriptAction_PlayAnim},
-	{"wait",                         G_ScriptAction_Wait},
-	{"trigger",                          G_ScriptAction_Trigger},
-	{"alertentity",                      G_ScriptAction_AlertEntity},
+	{"wait",                         G_ScriptAction_Wait,                G_ScriptCompile_Wait,           G_ScriptOperands_Wait},
+	{"trigger",                          G_ScriptAction_Trigger,             G_ScriptCompile_Trigger,        G_ScriptOperands_Trigger},
+	{"alertentity",                      G_ScriptAction_AlertEntity,         G_ScriptCompile_AlertEntity,    G_ScriptOperands_AlertEntity},
 	{"togglespeaker",                    G_ScriptAction_ToggleSpeaker},
 	{"disablespeaker",                   G_ScriptAction_DisableSpeaker},
 	{"enablespeaker",                    G_ScriptAction_EnableSpeaker},
-	{"accum",                            G_ScriptAction_Accum},
-	{"globalaccum",                      G_ScriptAction_GlobalAccum},
+	{"accum",                            G_ScriptAction_Accum,               G_ScriptCompile_Accum,          G_ScriptOperands_Accum},
+	{"globalaccum",                      G_ScriptAction_GlobalAccum,         G_ScriptCompile_GlobalAccum,    G_ScriptOperands_GlobalAccum},
 	{"print",                            G_ScriptAction_Print},
 	{"faceangles",                       G_ScriptAction_FaceAngles},
 	{"resetscript",                      G_ScriptAction_ResetScript},
@@ -179,7 +196,7 @@ g_script_stack_action_t gScriptActions[] =
 	{"wm_objective_status",              G_ScriptAction_ObjectiveStatus},
 	{"wm_set_main_objective",            G_ScriptAction_SetMainObjective},
 	{"remove",                           G_ScriptAction_RemoveEntity},
-	{"setstate",                     G_ScriptAction_SetState},
+	{"setstate",                     G_ScriptAction_SetState,            G_ScriptCompile_SetState,       G_ScriptOperands_SetState},
 	{"followspline",                 G_ScriptAction_FollowSpline},
 	{"followpath",                       G_ScriptAction_FollowPath},
 	{"abortmove",                        G_ScriptAction_AbortMove},
@@ -213,7 +230,7 @@ g_script_stack_action_t gScriptActions[] =
 	{"mu_queue",                     G_ScriptAction_MusicQueue},
 	{"mu_fade",                          G_ScriptAction_MusicFade},
 	{"setdebuglevel",                    G_ScriptAction_SetDebugLevel},
-	{"setposition",                      G_ScriptAction_SetPosition},
+	{"setposition",                      G_ScriptAction_SetPosition,         G_ScriptCompile_SetPosition,    G_ScriptOperands_SetPosition},
 	{"setautospawn",                 G_ScriptAction_SetAutoSpawn},
 
 	// Gordon: going for longest silly script command ever here :) (sets a model for a brush to one stolen from a func_brushmodel
@@ -420,8 +437,11 @@ void G_Script_ScriptParse( gentity_t *ent ) {
 	qboolean wantName;
 	qboolean inScript;
 	int eventNum;
-	g_script_event_t events[G_MAX_SCRIPT_STACK_ITEMS];
+	static g_script_event_t events[G_MAX_SCRIPT_STACK_ITEMS];    // too big for the stack
 	int numEventItems;
+	g_script_operands_t operands;
+	g_script_stack_item_t *item;
+	const char *error;
 	g_script_event_t *curEvent;
 	// DHM - Nerve :: Some of our multiplayer script commands have longer parameters
 	//char		params[MAX_QPATH];
@@ -599,9 +619,23 @@ void G_Script_ScriptParse( gentity_t *ent ) {
 					}
 				}
 
+				item = &curEvent->stack.items[curEvent->stack.numItems];
+
 				if ( strlen( params ) ) { // copy the params into the event
-					curEvent->stack.items[curEvent->stack.numItems].params = G_Alloc( strlen( params ) + 1 );
-					Q_strncpyz( curEvent->stack.items[curEvent->stack.numItems].params, params, strlen( params ) + 1 );
+					item->params = G_Alloc( strlen( params ) + 1 );
+					Q_strncpyz( item->params, params, strlen( params ) + 1 );
+				}
+
+				// resolve the params now, invalid ones are left to fail when run
+				if ( action->compileFunc ) {
+					memset( &operands, 0, sizeof( operands ) );
+					error = action->compileFunc( &operands, item->params );
+					if ( error ) {
+						G_Printf( "^3WARNING: G_Script_ScriptParse(), line %d: %s\n", COM_GetCurrentParseLine(), error );
+					} else {
+						item->operands = G_Alloc( sizeof( operands ) );
+						memcpy( item->operands, &operands, sizeof( operands ) );
+					}
 				}
 
 				curEvent->stack.numItems++;
@@ -748,6 +782,8 @@ G_Script_ScriptRun
 */
 qboolean G_Script_ScriptRun( gentity_t *ent ) {
 	g_script_stack_t *stack;
+	g_script_stack_item_t *item;
+	qboolean done;
 	int oldScriptId;
 
 	if ( !ent->scriptEvents ) {
@@ -786,7 +822,13 @@ qboolean G_Script_ScriptRun( gentity_t *ent ) {
 	while ( ent->scriptStatus.scriptStackHead < stack->numItems )
 	{
 		oldScriptId = ent->scriptStatus.scriptId;
-		if ( !stack->items[ent->scriptStatus.scriptStackHead].action->actionFunc( ent, stack->items[ent->scriptStatus.scriptStackHead].params ) ) {
+		item = &stack->items[ent->scriptStatus.scriptStackHead];
+		if ( item->operands ) {
+			done = item->action->operandsFunc( ent, item->operands );
+		} else {
+			done = item->action->actionFunc( ent, item->params );
+		}
+		if ( !done ) {
 			ent->scriptStatus.scriptFlags &= ~SCFL_FIRST_CALL;
 			return qfalse;
 		}
@@ -885,7 +927,7 @@ void script_mover_think( gentity_t *ent ) {
 		}
 	}
 
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 void script_mover_spawn( gentity_t *ent ) {
@@ -916,7 +958,7 @@ void script_mover_spawn( gentity_t *ent ) {
 	script_linkentity( ent );
 
 	ent->think = script_mover_think;
-	ent->nextthink = level.time + 200;
+	G_SetNextThink( ent, level.time + 200 );
 }
 
 void script_mover_use( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
@@ -1093,7 +1135,7 @@ void SP_script_mover( gentity_t *ent ) {
 	}
 
 	ent->think = script_mover_spawn;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 //..............................................................................
@@ -1185,7 +1227,7 @@ void SP_script_camera( gentity_t *ent ) {
 "scriptname" name used for scripting purposes (REQUIRED)
 */
 void SP_script_multiplayer( gentity_t *ent ) {
-	ent->scriptName = "game_manager";
+	G_SetScriptName( ent, "game_manager" );
 
 	// Gordon: broadcasting this to clients now, should be cheaper in bandwidth for sending landmine info
 	ent->s.eType = ET_GAMEMANAGER;
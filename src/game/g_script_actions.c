@@ -46,6 +46,74 @@ should proceed to the next item on the list.
 
 void script_linkentity( gentity_t *ent );
 
+/*
+=================
+G_ScriptOperandName
+
+Copies a name into the operands, cut to the size of the names like the
+fixed buffers actions used to parse into. Returns qfalse if it was cut.
+=================
+*/
+static qboolean G_ScriptOperandName( g_script_operands_t *operands, int i, const char *name ) {
+	Q_strncpyz( operands->names[i], name, sizeof( operands->names[i] ) );
+	operands->hashes[i] = BG_StringHashValue( operands->names[i] );
+
+	return strlen( name ) < sizeof( operands->names[i] );
+}
+
+/*
+=================
+G_ScriptRunOperands
+
+Runs an action that has no compiled operands, for a script that failed to
+compile or a direct call, by compiling its params on the spot
+=================
+*/
+static qboolean G_ScriptRunOperands( gentity_t *ent, const char *params,
+									 const char *( *compileFunc )( g_script_operands_t *operands, const char *params ),
+									 qboolean ( *operandsFunc )( gentity_t *ent, g_script_operands_t *operands ) ) {
+	g_script_operands_t operands;
+	const char *error;
+
+	memset( &operands, 0, sizeof( operands ) );
+	error = compileFunc( &operands, params );
+	if ( error ) {
+		G_Error( "G_Scripting: %s\n", error );
+	}
+
+	return operandsFunc( ent, &operands );
+}
+
+/*
+=================
+G_ScriptTriggerScriptName
+
+Sends the trigger event to every entity with the scriptName. Returns qfalse
+if that changed the script ent is running, found tells if there were any.
+=================
+*/
+static qboolean G_ScriptTriggerScriptName( gentity_t *ent, const char *scriptName, int hash, const char *trigger, qboolean skipBots, qboolean *found ) {
+	gentity_t *trent = NULL;
+	qboolean terminate = qfalse;
+	int oldId;
+
+	*found = qfalse;
+	while ( ( trent = G_FindByScriptNameFast( trent, scriptName, hash ) ) != NULL ) {
+		*found = qtrue;
+		if ( skipBots && ( trent->r.svFlags & SVF_BOT ) ) {
+			continue;
+		}
+		oldId = trent->scriptStatus.scriptId;
+		G_Script_ScriptEvent( trent, "trigger", trigger );
+		// if the script changed, return false so we don't muck with it's variables
+		if ( ( trent == ent ) && ( oldId != trent->scriptStatus.scriptId ) ) {
+			terminate = qtrue;
+		}
+	}
+
+	return !terminate;
+}
+
 qboolean G_ScriptAction_SetModelFromBrushmodel( gentity_t *ent, char *params ) {
 	const char    *pString, *token;
 	char modelname[MAX_QPATH];
@@ -92,25 +160,33 @@ qboolean G_ScriptAction_SetModelFromBrushmodel( gentity_t *ent, char *params ) {
 	return qtrue;
 }
 
-qboolean G_ScriptAction_SetPosition( gentity_t *ent, char *params ) {
-	pathCorner_t* pPathCorner;
+const char *G_ScriptCompile_SetPosition( g_script_operands_t *operands, const char *params ) {
 	const char    *pString, *token;
-	gentity_t *target;
 
 	pString = params;
 	token = COM_ParseExt( &pString, qfalse );
 	if ( !token[0] ) {
-		G_Error( "G_Scripting: setposition must have an targetname\n" );
+		return "setposition must have an targetname";
+	}
+	if ( !G_ScriptOperandName( operands, 0, token ) ) {
+		return "setposition targetname is too long";
 	}
 
-	pPathCorner = BG_Find_PathCorner( token );
+	return NULL;
+}
+
+qboolean G_ScriptOperands_SetPosition( gentity_t *ent, g_script_operands_t *operands ) {
+	pathCorner_t* pPathCorner;
+	gentity_t *target;
+
+	pPathCorner = BG_Find_PathCorner( operands->names[0] );
 	if ( pPathCorner != NULL ) {
 		G_SetOrigin( ent, pPathCorner->origin );
 	} else {
 		// find the entity with the given "targetname"
-		target = G_FindByTargetname( NULL, token );
+		target = G_FindByTargetnameFast( NULL, operands->names[0], operands->hashes[0] );
 		if ( !target ) {
-			G_Error( "G_Scripting: can't find entity with \"targetname\" = \"%s\"\n", token );
+			G_Error( "G_Scripting: can't find entity with \"targetname\" = \"%s\"\n", operands->names[0] );
 		}
 
 		G_SetOrigin( ent, target->r.currentOrigin );
@@ -122,6 +198,10 @@ qboolean G_ScriptAction_SetPosition( gentity_t *ent, char *params ) {
 	return qtrue;
 }
 
+qboolean G_ScriptAction_SetPosition( gentity_t *ent, char *params ) {
+	return G_ScriptRunOperands( ent, params, G_ScriptCompile_SetPosition, G_ScriptOperands_SetPosition );
+}
+
 void SetPlayerSpawn( gentity_t* ent, int spawn, qboolean update );
 
 qboolean G_ScriptAction_SetAutoSpawn( gentity_t* ent, char *params ) {
@@ -1306,32 +1386,51 @@ G_ScriptAction_Wait
 			wait random <min> <max>
 =================
 */
-qboolean G_ScriptAction_Wait( gentity_t *ent, char *params ) {
+// operands->op of wait
+enum {
+	WAIT_DURATION,
+	WAIT_RANDOM
+};
+
+const char *G_ScriptCompile_Wait( g_script_operands_t *operands, const char *params ) {
 	const char    *pString, *token;
-	int duration;
 
 	// get the duration
 	pString = params;
 	token = COM_ParseExt( &pString, qfalse );
 	if ( !*token ) {
-		G_Error( "G_Scripting: wait must have a duration\n" );
+		return "wait must have a duration";
 	}
 
 	// Gordon: adding random wait ability
 	if ( !Q_stricmp( token, "random" ) ) {
-		int min, max;
+		operands->op = WAIT_RANDOM;
 
 		token = COM_ParseExt( &pString, qfalse );
 		if ( !*token ) {
-			G_Error( "G_Scripting: wait random must have a min duration\n" );
+			return "wait random must have a min duration";
 		}
-		min = atoi( token );
+		operands->values[0] = atoi( token );
 
 		token = COM_ParseExt( &pString, qfalse );
 		if ( !*token ) {
-			G_Error( "G_Scripting: wait random must have a max duration\n" );
+			return "wait random must have a max duration";
 		}
-		max = atoi( token );
+		operands->values[1] = atoi( token );
+
+		return NULL;
+	}
+
+	operands->op = WAIT_DURATION;
+	operands->values[0] = atoi( token );
+
+	return NULL;
+}
+
+qboolean G_ScriptOperands_Wait( gentity_t *ent, g_script_operands_t *operands ) {
+	if ( operands->op == WAIT_RANDOM ) {
+		const int min = operands->values[0];
+		const int max = operands->values[1];
 
 		if ( ent->scriptStatus.scriptStackChangeTime + min > level.time ) {
 			return qfalse;
@@ -1344,8 +1443,11 @@ qboolean G_ScriptAction_Wait( gentity_t *ent, char *params ) {
 		return !( rand() % (int)( ( max - min ) * 0.02f ) );
 	}
 
-	duration = atoi( token );
-	return ( ent->scriptStatus.scriptStackChangeTime + duration < level.time );
+	return ( ent->scriptStatus.scriptStackChangeTime + operands->values[0] < level.time );
+}
+
+qboolean G_ScriptAction_Wait( gentity_t *ent, char *params ) {
+	return G_ScriptRunOperands( ent, params, G_ScriptCompile_Wait, G_ScriptOperands_Wait );
 }
 
 /*
@@ -1357,34 +1459,62 @@ G_ScriptAction_Trigger
   Calls the specified trigger for the given ai character or script entity
 =================
 */
-qboolean G_ScriptAction_Trigger( gentity_t *ent, char *params ) {
-	gentity_t *trent;
+// operands->op of trigger
+enum {
+	TRIGGER_SCRIPTNAME,
+	TRIGGER_SELF,
+	TRIGGER_GLOBAL,
+	TRIGGER_PLAYER,
+	TRIGGER_ACTIVATOR
+};
+
+const char *G_ScriptCompile_Trigger( g_script_operands_t *operands, const char *params ) {
 	const char *pString, *token;
-	char name[MAX_QPATH], trigger[MAX_QPATH];
-	int oldId, i;
-	qboolean terminate, found;
 
 	// get the cast name
 	pString = params;
 	token = COM_ParseExt( &pString, qfalse );
-	Q_strncpyz( name, token, sizeof( name ) );
-	if ( !*name ) {
-		G_Error( "G_Scripting: trigger must have a name and an identifier: %s\n", params );
+	G_ScriptOperandName( operands, 0, token );
+	if ( !*operands->names[0] ) {
+		return va( "trigger must have a name and an identifier: %s", params );
 	}
 
 	token = COM_ParseExt( &pString, qfalse );
-	Q_strncpyz( trigger, token, sizeof( trigger ) );
-	if ( !*trigger ) {
-		G_Error( "G_Scripting: trigger must have a name and an identifier: %s\n", params );
+	G_ScriptOperandName( operands, 1, token );
+	if ( !*operands->names[1] ) {
+		return va( "trigger must have a name and an identifier: %s", params );
+	}
+
+	if ( !Q_stricmp( operands->names[0], "self" ) ) {
+		operands->op = TRIGGER_SELF;
+	} else if ( !Q_stricmp( operands->names[0], "global" ) ) {
+		operands->op = TRIGGER_GLOBAL;
+	} else if ( !Q_stricmp( operands->names[0], "player" ) ) {
+		operands->op = TRIGGER_PLAYER;
+	} else if ( !Q_stricmp( operands->names[0], "activator" ) ) {
+		operands->op = TRIGGER_ACTIVATOR;
+	} else {
+		operands->op = TRIGGER_SCRIPTNAME;
 	}
 
-	if ( !Q_stricmp( name, "self" ) ) {
+	return NULL;
+}
+
+qboolean G_ScriptOperands_Trigger( gentity_t *ent, g_script_operands_t *operands ) {
+	gentity_t *trent;
+	const char *trigger = operands->names[1];
+	int oldId, i;
+	qboolean terminate, found;
+
+	switch ( operands->op ) {
+	case TRIGGER_SELF:
 		trent = ent;
 		oldId = trent->scriptStatus.scriptId;
 		G_Script_ScriptEvent( trent, "trigger", trigger );
 		// if the script changed, return false so we don't muck with it's variables
 		return ( ( trent != ent ) || ( oldId == trent->scriptStatus.scriptId ) );
-	} else if ( !Q_stricmp( name, "global" ) ) {
+
+	case TRIGGER_GLOBAL:
 		terminate = qfalse;
 		found = qfalse;
 		// for all entities/bots with this scriptName
@@ -1418,7 +1548,9 @@ qboolean G_ScriptAction_Trigger( gentity_t *ent, char *params ) {
 		if ( found ) {
 			return qtrue;
 		}
-	} else if ( !Q_stricmp( name, "player" ) ) {
+		break;
+
+	case TRIGGER_PLAYER:
 		for ( i = 0; i < MAX_CLIENTS; i++ ) {
 			if ( level.clients[i].pers.connected != CON_CONNECTED ) {
 				continue;
@@ -1426,38 +1558,30 @@ qboolean G_ScriptAction_Trigger( gentity_t *ent, char *params ) {
 			G_Script_ScriptEvent( &g_entities[i], "trigger", trigger );
 		}
 		return qtrue;   // always true, as players aren't always there
-	} else if ( !Q_stricmp( name, "activator" ) ) {
+
+	case TRIGGER_ACTIVATOR:
 		return qtrue;   // always true, as players aren't always there
-	} else {
-		terminate = qfalse;
-		found = qfalse;
+
+	default:
 		// for all entities/bots with this scriptName
-		trent = NULL;
-		while ( ( trent = G_Find( trent, FOFS( scriptName ), name ) ) != NULL ) {
-			found = qtrue;
-			if ( !( trent->r.svFlags & SVF_BOT ) ) {
-				oldId = trent->scriptStatus.scriptId;
-				G_Script_ScriptEvent( trent, "trigger", trigger );
-				// if the script changed, return false so we don't muck with it's variables
-				if ( ( trent == ent ) && ( oldId != trent->scriptStatus.scriptId ) ) {
-					terminate = qtrue;
-				}
-			}
-		}
-		//
-		if ( terminate ) {
+		if ( !G_ScriptTriggerScriptName( ent, operands->names[0], operands->hashes[0], trigger, qtrue, &found ) ) {
 			return qfalse;
 		}
 		if ( found ) {
 			return qtrue;
 		}
+		break;
 	}
 
 //	G_Error( "G_Scripting: trigger has unknown name: %s\n", name );
-	G_Printf( "G_Scripting: trigger has unknown name: %s\n", name );
+	G_Printf( "G_Scripting: trigger has unknown name: %s\n", operands->names[0] );
 	return qtrue;   // shutup the compiler
 }
 
+qboolean G_ScriptAction_Trigger( gentity_t *ent, char *params ) {
+	return G_ScriptRunOperands( ent, params, G_ScriptCompile_Trigger, G_ScriptOperands_Trigger );
+}
+
 /*
 ================
 G_ScriptAction_PlaySound
@@ -1469,19 +1593,18 @@ G_ScriptAction_PlaySound
   Use the optional LOOPING paramater to attach the sound to the entities looping channel.
 ================
 */
-qboolean G_ScriptAction_PlaySound( gentity_t *ent, char *params ) {
+const char *G_ScriptCompile_PlaySound( g_script_operands_t *operands, const char *params ) {
 	const char *pString, *token;
-	char sound[MAX_QPATH];
 	qboolean looping = qfalse;
 	int volume = 255;
 
 	if ( !params ) {
-		G_Error( "G_Scripting: syntax error\n\nplaysound <soundname OR scriptname>\n" );
+		return "syntax error\n\nplaysound <soundname OR scriptname>";
 	}
 
 	pString = params;
 	token = COM_ParseExt( &pString, qfalse );
-	Q_strncpyz( sound, token, sizeof( sound ) );
+	G_ScriptOperandName( operands, 0, token );
 
 	token = COM_ParseExt( &pString, qfalse );
 	while ( *token ) {
@@ -1498,21 +1621,43 @@ qboolean G_ScriptAction_PlaySound( gentity_t *ent, char *params ) {
 		token = COM_ParseExt( &pString, qfalse );
 	}
 
-	if ( !looping ) {
+	// the sound index is taken on the first run, registering every sound
+	// a script names while parsing could overflow MAX_SOUNDS
+	operands->op = looping;
+	operands->values[0] = 0;
+	operands->values[1] = volume;
+
+	return NULL;
+}
+
+qboolean G_ScriptOperands_PlaySound( gentity_t *ent, g_script_operands_t *operands ) {
+	const int volume = operands->values[1];
+	int soundIndex;
+
+	if ( !operands->values[0] ) {
+		operands->values[0] = G_SoundIndex( operands->names[0] );
+	}
+	soundIndex = operands->values[0];
+
+	if ( !operands->op ) {
 		if ( volume == 255 ) {
-			G_AddEvent( ent, EV_GENERAL_SOUND, G_SoundIndex( sound ) );
+			G_AddEvent( ent, EV_GENERAL_SOUND, soundIndex );
 		} else {
-			G_AddEvent( ent, EV_GENERAL_SOUND_VOLUME, G_SoundIndex( sound ) );
+			G_AddEvent( ent, EV_GENERAL_SOUND_VOLUME, soundIndex );
 			ent->s.onFireStart = volume >> 1;
 		}
 	} else {    // looping channel
-		ent->s.loopSound = G_SoundIndex( sound );
+		ent->s.loopSound = soundIndex;
 		ent->s.onFireStart = volume >> 1;
 	}
 
 	return qtrue;
 }
 
+qboolean G_ScriptAction_PlaySound( gentity_t *ent, char *params ) {
+	return G_ScriptRunOperands( ent, params, G_ScriptCompile_PlaySound, G_ScriptOperands_PlaySound );
+}
+
 
 // START Mad Doc - TDF
 /*
@@ -1791,22 +1936,28 @@ G_ScriptAction_AlertEntity
  Arnout: modified to target multiple entities with the same targetname
 =================
 */
-qboolean G_ScriptAction_AlertEntity( gentity_t *ent, char *params ) {
-	gentity_t   *alertent = NULL;
-	qboolean foundalertent = qfalse;
-	int hash;
-
+const char *G_ScriptCompile_AlertEntity( g_script_operands_t *operands, const char *params ) {
 	if ( !params || !*params ) {
-		G_Error( "G_Scripting: alertentity without targetname\n" );
+		return "alertentity without targetname";
 	}
-	hash = BG_StringHashValue( params );
+	if ( !G_ScriptOperandName( operands, 0, params ) ) {
+		return "alertentity targetname is too long";
+	}
+
+	return NULL;
+}
+
+qboolean G_ScriptOperands_AlertEntity( gentity_t *ent, g_script_operands_t *operands ) {
+	const char  *name = operands->names[0];
+	gentity_t   *alertent = NULL;
+	qboolean foundalertent = qfalse;
 
 	// find this targetname
 	while ( 1 ) {
-		alertent = G_FindByTargetnameFast( alertent, params, hash );
+		alertent = G_FindByTargetnameFast( alertent, name, operands->hashes[0] );
 		if ( !alertent ) {
 			if ( !foundalertent ) {
-				G_Error( "G_Scripting: alertentity cannot find targetname \"%s\"\n", params );
+				G_Error( "G_Scripting: alertentity cannot find targetname \"%s\"\n", name );
 			} else {
 				break;
 			}
@@ -1817,12 +1968,12 @@ qboolean G_ScriptAction_AlertEntity( gentity_t *ent, char *params ) {
 		if ( alertent->client ) {
 			// call this entity's AlertEntity function
 			if ( !alertent->AIScript_AlertEntity ) {
-				G_Error( "G_Scripting: alertentity \"%s\" (classname = %s) doesn't have an \"AIScript_AlertEntity\" function\n", params, alertent->classname );
+				G_Error( "G_Scripting: alertentity \"%s\" (classname = %s) doesn't have an \"AIScript_AlertEntity\" function\n", name, alertent->classname );
 			}
 			alertent->AIScript_AlertEntity( alertent );
 		} else {
 			if ( !alertent->use ) {
-				G_Error( "G_Scripting: alertentity \"%s\" (classname = %s) doesn't have a \"use\" function\n", params, alertent->classname );
+				G_Error( "G_Scripting: alertentity \"%s\" (classname = %s) doesn't have a \"use\" function\n", name, alertent->classname );
 			}
 			G_UseEntity( alertent, NULL, NULL );
 		}
@@ -1831,6 +1982,10 @@ qboolean G_ScriptAction_AlertEntity( gentity_t *ent, char *params ) {
 	return qtrue;
 }
 
+qboolean G_ScriptAction_AlertEntity( gentity_t *ent, char *params ) {
+	return G_ScriptRunOperands( ent, params, G_ScriptCompile_AlertEntity, G_ScriptOperands_AlertEntity );
+}
+
 /*
 =================
 G_ScriptAction_ToggleSpeaker
@@ -1967,197 +2122,223 @@ G_ScriptAction_Accum
 =================
 */
 
-qboolean G_ScriptAction_Accum( gentity_t *ent, char *params ) {
+// operands->op of accum and globalaccum
+typedef enum {
+	ACCUM_INC,
+	ACCUM_ABORT_IF_LESS_THAN,
+	ACCUM_ABORT_IF_GREATER_THAN,
+	ACCUM_ABORT_IF_NOT_EQUAL,
+	ACCUM_ABORT_IF_EQUAL,
+	ACCUM_BITSET,
+	ACCUM_BITRESET,
+	ACCUM_ABORT_IF_BITSET,
+	ACCUM_ABORT_IF_NOT_BITSET,
+	ACCUM_SET,
+	ACCUM_RANDOM,
+	ACCUM_TRIGGER_IF_EQUAL,
+	ACCUM_WAIT_WHILE_EQUAL,
+	ACCUM_SET_TO_DYNAMITECOUNT,     // accum only
+	ACCUM_NUM_COMMANDS
+} accumCommand_t;
+
+static const char *accumCommands[ACCUM_NUM_COMMANDS] = {
+	"inc",
+	"abort_if_less_than",
+	"abort_if_greater_than",
+	"abort_if_not_equal",
+	"abort_if_equal",
+	"bitset",
+	"bitreset",
+	"abort_if_bitset",
+	"abort_if_not_bitset",
+	"set",
+	"random",
+	"trigger_if_equal",
+	"wait_while_equal",
+	"set_to_dynamitecount"
+};
+
+/*
+=================
+G_ScriptCompileAccum
+
+values[0] is the buffer index and values[1] the parameter of the command
+=================
+*/
+static const char *G_ScriptCompileAccum( g_script_operands_t *operands, const char *params, qboolean global ) {
 	const char *pString, *token;
-	char lastToken[MAX_QPATH], name[MAX_QPATH];
-	int bufferIndex;
-	qboolean terminate, found;
+	int command;
 
 	pString = params;
 
 	token = COM_ParseExt( &pString, qfalse );
 	if ( !token[0] ) {
-		G_Error( "G_Scripting: accum without a buffer index\n" );
+		return "accum without a buffer index";
 	}
 
-	bufferIndex = atoi( token );
-	if ( bufferIndex >= G_MAX_SCRIPT_ACCUM_BUFFERS ) {
-		G_Error( "G_Scripting: accum buffer is outside range (0 - %i)\n", G_MAX_SCRIPT_ACCUM_BUFFERS );
+	operands->values[0] = atoi( token );
+	if ( operands->values[0] < 0 || operands->values[0] >= G_MAX_SCRIPT_ACCUM_BUFFERS ) {
+		return va( "accum buffer is outside range (0 - %i)", G_MAX_SCRIPT_ACCUM_BUFFERS );
 	}
 
 	token = COM_ParseExt( &pString, qfalse );
 	if ( !token[0] ) {
-		G_Error( "G_Scripting: accum without a command\n" );
+		return "accum without a command";
 	}
 
-	Q_strncpyz( lastToken, token, sizeof( lastToken ) );
+	if ( !Q_stricmp( token, "abort_if_not_equals" ) ) {
+		command = ACCUM_ABORT_IF_NOT_EQUAL;
+	} else {
+		for ( command = 0; command < ACCUM_NUM_COMMANDS; command++ ) {
+			if ( !Q_stricmp( token, accumCommands[command] ) ) {
+				break;
+			}
+		}
+	}
+	if ( command == ACCUM_NUM_COMMANDS || ( global && command == ACCUM_SET_TO_DYNAMITECOUNT ) ) {
+		return va( "accum %s: unknown command", params );
+	}
+	operands->op = command;
+
 	token = COM_ParseExt( &pString, qfalse );
+	if ( !token[0] ) {
+		return va( "accum %s requires a parameter", accumCommands[command] );
+	}
 
-	if ( !Q_stricmp( lastToken, "inc" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		ent->scriptAccumBuffer[bufferIndex] += atoi( token );
-	} else if ( !Q_stricmp( lastToken, "abort_if_less_than" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( ent->scriptAccumBuffer[bufferIndex] < atoi( token ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "abort_if_greater_than" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
+	if ( command == ACCUM_SET_TO_DYNAMITECOUNT ) {
+		if ( !G_ScriptOperandName( operands, 0, token ) ) {
+			return va( "accum %s target name is too long", accumCommands[command] );
 		}
-		if ( ent->scriptAccumBuffer[bufferIndex] > atoi( token ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "abort_if_not_equal" ) || !Q_stricmp( lastToken, "abort_if_not_equals" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( ent->scriptAccumBuffer[bufferIndex] != atoi( token ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "abort_if_equal" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( ent->scriptAccumBuffer[bufferIndex] == atoi( token ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "bitset" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		ent->scriptAccumBuffer[bufferIndex] |= ( 1 << atoi( token ) );
-	} else if ( !Q_stricmp( lastToken, "bitreset" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		ent->scriptAccumBuffer[bufferIndex] &= ~( 1 << atoi( token ) );
-	} else if ( !Q_stricmp( lastToken, "abort_if_bitset" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( ent->scriptAccumBuffer[bufferIndex] & ( 1 << atoi( token ) ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "abort_if_not_bitset" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( !( ent->scriptAccumBuffer[bufferIndex] & ( 1 << atoi( token ) ) ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "set" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		ent->scriptAccumBuffer[bufferIndex] = atoi( token );
-	} else if ( !Q_stricmp( lastToken, "random" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		ent->scriptAccumBuffer[bufferIndex] = rand() % atoi( token );
-	} else if ( !Q_stricmp( lastToken, "trigger_if_equal" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( ent->scriptAccumBuffer[bufferIndex] == atoi( token ) ) {
-			gentity_t* trent;
-			int oldId;
-//			qboolean loop = qfalse;
+		return NULL;
+	}
 
-			token = COM_ParseExt( &pString, qfalse );
-			Q_strncpyz( lastToken, token, sizeof( lastToken ) );
-			if ( !*lastToken ) {
-				G_Error( "G_Scripting: trigger must have a name and an identifier: %s\n", params );
-			}
+	operands->values[1] = atoi( token );
 
-			token = COM_ParseExt( &pString, qfalse );
-			Q_strncpyz( name, token, sizeof( name ) );
-			if ( !*name ) {
-				G_Error( "G_Scripting: trigger must have a name and an identifier: %s\n", params );
+	// missing names are only an error once the buffer matches
+	if ( command == ACCUM_TRIGGER_IF_EQUAL ) {
+		token = COM_ParseExt( &pString, qfalse );
+		G_ScriptOperandName( operands, 0, token );
+
+		token = COM_ParseExt( &pString, qfalse );
+		G_ScriptOperandName( operands, 1, token );
+	}
+
+	return NULL;
+}
+
+/*
+=================
+G_ScriptRunAccum
+=================
+*/
+static qboolean G_ScriptRunAccum( gentity_t *ent, int *buffer, g_script_operands_t *operands ) {
+	const int value = operands->values[1];
+	qboolean abort = qfalse;
+	qboolean found;
+
+	switch ( operands->op ) {
+	case ACCUM_INC:
+		*buffer += value;
+		break;
+	case ACCUM_ABORT_IF_LESS_THAN:
+		abort = ( *buffer < value );
+		break;
+	case ACCUM_ABORT_IF_GREATER_THAN:
+		abort = ( *buffer > value );
+		break;
+	case ACCUM_ABORT_IF_NOT_EQUAL:
+		abort = ( *buffer != value );
+		break;
+	case ACCUM_ABORT_IF_EQUAL:
+		abort = ( *buffer == value );
+		break;
+	case ACCUM_BITSET:
+		*buffer |= ( 1 << value );
+		break;
+	case ACCUM_BITRESET:
+		*buffer &= ~( 1 << value );
+		break;
+	case ACCUM_ABORT_IF_BITSET:
+		abort = ( *buffer & ( 1 << value ) ) != 0;
+		break;
+	case ACCUM_ABORT_IF_NOT_BITSET:
+		abort = !( *buffer & ( 1 << value ) );
+		break;
+	case ACCUM_SET:
+		*buffer = value;
+		break;
+	case ACCUM_RANDOM:
+		*buffer = rand() % value;
+		break;
+	case ACCUM_TRIGGER_IF_EQUAL:
+		if ( *buffer == value ) {
+			if ( !*operands->names[0] || !*operands->names[1] ) {
+				G_Error( "G_Scripting: trigger must have a name and an identifier: %i %s %i %s %s\n", operands->values[0],
+					accumCommands[ACCUM_TRIGGER_IF_EQUAL], value, operands->names[0], operands->names[1] );
 			}
-			//
-			terminate = qfalse;
-			found = qfalse;
 			// for all entities/bots with this scriptName
-			trent = NULL;
-			while ( ( trent = G_Find( trent, FOFS( scriptName ), lastToken ) ) != NULL ) {
-				found = qtrue;
-				oldId = trent->scriptStatus.scriptId;
-				G_Script_ScriptEvent( trent, "trigger", name );
-				// if the script changed, return false so we don't muck with it's variables
-				if ( ( trent == ent ) && ( oldId != trent->scriptStatus.scriptId ) ) {
-					terminate = qtrue;
-				}
-			}
-			//
-			if ( terminate ) {
+			if ( !G_ScriptTriggerScriptName( ent, operands->names[0], operands->hashes[0], operands->names[1], qfalse, &found ) ) {
 				return qfalse;
 			}
-			if ( found ) {
-				return qtrue;
+			if ( !found ) {
+//				G_Error( "G_Scripting: trigger has unknown name: %s\n", name );
+				G_Printf( "G_Scripting: trigger has unknown name: %s\n", operands->names[1] );
 			}
-			//
-//			G_Error( "G_Scripting: trigger has unknown name: %s\n", name );
-			G_Printf( "G_Scripting: trigger has unknown name: %s\n", name );
-			return qtrue;
-		}
-	} else if ( !Q_stricmp( lastToken, "wait_while_equal" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
 		}
-		if ( ent->scriptAccumBuffer[bufferIndex] == atoi( token ) ) {
+		break;
+	case ACCUM_WAIT_WHILE_EQUAL:
+		if ( *buffer == value ) {
 			return qfalse;
 		}
-	} else if ( !Q_stricmp( lastToken, "set_to_dynamitecount" ) ) {
+		break;
+	case ACCUM_SET_TO_DYNAMITECOUNT:
+	{
 		gentity_t* target;
-		if ( !*token ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
+		int num = 0, i;
 
-		target = G_FindByTargetname( NULL, token );
+		target = G_FindByTargetnameFast( NULL, operands->names[0], operands->hashes[0] );
 		if ( !target ) {
-			G_Error( "Scripting: accum %s could not find target\n", lastToken );
+			G_Error( "Scripting: accum %s could not find target\n", accumCommands[ACCUM_SET_TO_DYNAMITECOUNT] );
 		}
 
-		{
-			int num = 0, i;
-			// sigh, searching..
-			for (i = MAX_CLIENTS ; i < level.num_entities; ++i)
-			{
-
-				if (!(g_entities[i].etpro_misc_1 & 1))
-				{
-					continue;
-				}
-
-				if (g_entities[i].etpro_misc_2 != target - g_entities)
-				{
-					continue;
-				}
+		// sigh, searching..
+		for ( i = MAX_CLIENTS ; i < level.num_entities; ++i ) {
+			if ( !( g_entities[i].etpro_misc_1 & 1 ) ) {
+				continue;
+			}
 
-				num++;
+			if ( g_entities[i].etpro_misc_2 != target - g_entities ) {
+				continue;
 			}
 
-			ent->scriptAccumBuffer[bufferIndex] = num;
+			num++;
 		}
-	} else {
-		G_Error( "Scripting: accum %s: unknown command\n", params );
+
+		*buffer = num;
+		break;
+	}
+	}
+
+	if ( abort ) {
+		// abort the current script
+		ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
 	}
 
 	return qtrue;
 }
 
+const char *G_ScriptCompile_Accum( g_script_operands_t *operands, const char *params ) {
+	return G_ScriptCompileAccum( operands, params, qfalse );
+}
+
+qboolean G_ScriptOperands_Accum( gentity_t *ent, g_script_operands_t *operands ) {
+	return G_ScriptRunAccum( ent, &ent->scriptAccumBuffer[operands->values[0]], operands );
+}
+
+qboolean G_ScriptAction_Accum( gentity_t *ent, char *params ) {
+	return G_ScriptRunOperands( ent, params, G_ScriptCompile_Accum, G_ScriptOperands_Accum );
+}
+
 /*
 =================
 G_ScriptAction_GlobalAccum
@@ -2185,163 +2366,16 @@ G_ScriptAction_GlobalAccum
 	globalAccum <n> wait_while_equal <m>
 =================
 */
-qboolean G_ScriptAction_GlobalAccum( gentity_t *ent, char *params ) {
-	const char *pString, *token;
-	char lastToken[MAX_QPATH], name[MAX_QPATH];
-	int bufferIndex;
-	qboolean terminate, found;
-
-	pString = params;
-
-	token = COM_ParseExt( &pString, qfalse );
-	if ( !token[0] ) {
-		G_Error( "G_Scripting: accum without a buffer index\n" );
-	}
-
-	bufferIndex = atoi( token );
-	if ( bufferIndex >= G_MAX_SCRIPT_ACCUM_BUFFERS ) {
-		G_Error( "G_Scripting: accum buffer is outside range (0 - %i)\n", G_MAX_SCRIPT_ACCUM_BUFFERS );
-	}
-
-	token = COM_ParseExt( &pString, qfalse );
-	if ( !token[0] ) {
-		G_Error( "G_Scripting: accum without a command\n" );
-	}
-
-	Q_strncpyz( lastToken, token, sizeof( lastToken ) );
-	token = COM_ParseExt( &pString, qfalse );
-
-	if ( !Q_stricmp( lastToken, "inc" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		level.globalAccumBuffer[bufferIndex] += atoi( token );
-	} else if ( !Q_stricmp( lastToken, "abort_if_less_than" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( level.globalAccumBuffer[bufferIndex] < atoi( token ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "abort_if_greater_than" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( level.globalAccumBuffer[bufferIndex] > atoi( token ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "abort_if_not_equal" ) || !Q_stricmp( lastToken, "abort_if_not_equals" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( level.globalAccumBuffer[bufferIndex] != atoi( token ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "abort_if_equal" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( level.globalAccumBuffer[bufferIndex] == atoi( token ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "bitset" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		level.globalAccumBuffer[bufferIndex] |= ( 1 << atoi( token ) );
-	} else if ( !Q_stricmp( lastToken, "bitreset" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		level.globalAccumBuffer[bufferIndex] &= ~( 1 << atoi( token ) );
-	} else if ( !Q_stricmp( lastToken, "abort_if_bitset" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( level.globalAccumBuffer[bufferIndex] & ( 1 << atoi( token ) ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "abort_if_not_bitset" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( !( level.globalAccumBuffer[bufferIndex] & ( 1 << atoi( token ) ) ) ) {
-			// abort the current script
-			ent->scriptStatus.scriptStackHead = ent->scriptEvents[ent->scriptStatus.scriptEventIndex].stack.numItems;
-		}
-	} else if ( !Q_stricmp( lastToken, "set" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		level.globalAccumBuffer[bufferIndex] = atoi( token );
-	} else if ( !Q_stricmp( lastToken, "random" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		level.globalAccumBuffer[bufferIndex] = rand() % atoi( token );
-	} else if ( !Q_stricmp( lastToken, "trigger_if_equal" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( level.globalAccumBuffer[bufferIndex] == atoi( token ) ) {
-			gentity_t* trent;
-			int oldId;
-//			qboolean loop = qfalse;
-
-			token = COM_ParseExt( &pString, qfalse );
-			Q_strncpyz( lastToken, token, sizeof( lastToken ) );
-			if ( !*lastToken ) {
-				G_Error( "G_Scripting: trigger must have a name and an identifier: %s\n", params );
-			}
-
-			token = COM_ParseExt( &pString, qfalse );
-			Q_strncpyz( name, token, sizeof( name ) );
-			if ( !*name ) {
-				G_Error( "G_Scripting: trigger must have a name and an identifier: %s\n", params );
-			}
-
-			terminate = qfalse;
-			found = qfalse;
-			// for all entities/bots with this scriptName
-			trent = NULL;
-			while ( ( trent = G_Find( trent, FOFS( scriptName ), lastToken ) ) != NULL ) {
-				found = qtrue;
-				oldId = trent->scriptStatus.scriptId;
-				G_Script_ScriptEvent( trent, "trigger", name );
-				// if the script changed, return false so we don't muck with it's variables
-				if ( ( trent == ent ) && ( oldId != trent->scriptStatus.scriptId ) ) {
-					terminate = qtrue;
-				}
-			}
-			//
-			if ( terminate ) {
-				return qfalse;
-			}
-			if ( found ) {
-				return qtrue;
-			}
+const char *G_ScriptCompile_GlobalAccum( g_script_operands_t *operands, const char *params ) {
+	return G_ScriptCompileAccum( operands, params, qtrue );
+}
 
-//			G_Error( "G_Scripting: trigger has unknown name: %s\n", name );
-			G_Printf( "G_Scripting: trigger has unknown name: %s\n", name );
-			return qtrue;
-		}
-	} else if ( !Q_stricmp( lastToken, "wait_while_equal" ) ) {
-		if ( !token[0] ) {
-			G_Error( "Scripting: accum %s requires a parameter\n", lastToken );
-		}
-		if ( level.globalAccumBuffer[bufferIndex] == atoi( token ) ) {
-			return qfalse;
-		}
-	} else {
-		G_Error( "Scripting: accum %s: unknown command\n", params );
-	}
+qboolean G_ScriptOperands_GlobalAccum( gentity_t *ent, g_script_operands_t *operands ) {
+	return G_ScriptRunAccum( ent, &level.globalAccumBuffer[operands->values[0]], operands );
+}
 
-	return qtrue;
+qboolean G_ScriptAction_GlobalAccum( gentity_t *ent, char *params ) {
+	return G_ScriptRunOperands( ent, params, G_ScriptCompile_GlobalAccum, G_ScriptOperands_GlobalAccum );
 }
 
 /*
@@ -2522,7 +2556,7 @@ qboolean G_ScriptAction_TagConnect( gentity_t *ent, char *params ) {
 
 	parent = G_FindByTargetname( NULL, token );
 	if ( !parent ) {
-		parent = G_Find( NULL, FOFS( scriptName ), token );
+		parent = G_FindByScriptName( NULL, token );
 		if ( !parent ) {
 			G_Error( "G_ScriptAction_TagConnect: unable to find entity with targetname \"%s\"", token );
 		}
@@ -3196,7 +3230,7 @@ G_ScriptAction_RemoveEntity
 */
 qboolean G_ScriptAction_RemoveEntity( gentity_t *ent, char *params ) {
 	ent->think = G_FreeEntity;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	return qtrue;
 }
@@ -3243,59 +3277,66 @@ G_ScriptAction_SetState
   syntax: remove
 ===================
 */
-qboolean G_ScriptAction_SetState( gentity_t *ent, char *params ) {
-	gentity_t *target;
+const char *G_ScriptCompile_SetState( g_script_operands_t *operands, const char *params ) {
 	const char *pString, *token;
-	char name[MAX_QPATH], state[MAX_QPATH];
-	entState_t entState = STATE_DEFAULT;
-	int hash;
-	qboolean found = qfalse;
+	const char *state;
 
 	// get the cast name
 	pString = params;
 	token = COM_ParseExt( &pString, qfalse );
-	Q_strncpyz( name, token, sizeof( name ) );
-	if ( !*name ) {
-		G_Error( "G_Scripting: setstate must have a name and an state\n" );
+	G_ScriptOperandName( operands, 0, token );
+	if ( !*operands->names[0] ) {
+		return "setstate must have a name and an state";
 	}
 
 	token = COM_ParseExt( &pString, qfalse );
-	Q_strncpyz( state, token, sizeof( state ) );
+	G_ScriptOperandName( operands, 1, token );
+	state = operands->names[1];
 	if ( !state[0] ) {
-		G_Error( "G_Scripting: setstate must have a name and an state\n" );
+		return "setstate must have a name and an state";
 	}
 
 	if ( !Q_stricmp( state, "default" ) ) {
-		entState = STATE_DEFAULT;
+		operands->op = STATE_DEFAULT;
 	} else if ( !Q_stricmp( state, "invisible" ) ) {
-		entState = STATE_INVISIBLE;
+		operands->op = STATE_INVISIBLE;
 	} else if ( !Q_stricmp( state, "underconstruction" ) ) {
-		entState = STATE_UNDERCONSTRUCTION;
+		operands->op = STATE_UNDERCONSTRUCTION;
 	} else {
-		G_Error( "G_Scripting: setstate with invalid state '%s'\n", state );
+		return va( "setstate with invalid state '%s'", state );
 	}
 
+	return NULL;
+}
+
+qboolean G_ScriptOperands_SetState( gentity_t *ent, g_script_operands_t *operands ) {
+	gentity_t *target;
+	qboolean found = qfalse;
+
 	// look for an entities
 	target = &g_entities[MAX_CLIENTS - 1];
-	hash = BG_StringHashValue( name );
 	while ( 1 ) {
-		target = G_FindByTargetnameFast( target, name, hash );
+		target = G_FindByTargetnameFast( target, operands->names[0], operands->hashes[0] );
 
 		if ( !target ) {
 			if ( !found ) {
-				G_Printf( "^1Warning: setstate(%s, %s) called and no entities found\n", name, state );
+				G_Printf( "^1Warning: setstate(%s, %s) called and no entities found\n", operands->names[0], operands->names[1] );
 			}
 			break;
 		}
 
 		found = qtrue;
 
-		G_SetEntState( target, entState );
+		G_SetEntState( target, (entState_t)operands->op );
 	}
 
 	return qtrue;
 }
 
+qboolean G_ScriptAction_SetState( gentity_t *ent, char *params ) {
+	return G_ScriptRunOperands( ent, params, G_ScriptCompile_SetState, G_ScriptOperands_SetState );
+}
+
 extern void Cmd_StartCamera_f( gentity_t *ent );
 extern void Cmd_StopCamera_f( gentity_t *ent );
 
@@ -3904,7 +3945,7 @@ qboolean G_ScriptAction_Cvar( gentity_t *ent, char *params ) {
 			found = qfalse;
 			// for all entities/bots with this scriptName
 			trent = NULL;
-			while ( ( trent = G_Find( trent, FOFS( scriptName ), lastToken ) ) != NULL ) {
+			while ( ( trent = G_FindByScriptName( trent, lastToken ) ) != NULL ) {
 				found = qtrue;
 				oldId = trent->scriptStatus.scriptId;
 				G_Script_ScriptEvent( trent, "trigger", name );
@@ -4035,7 +4076,7 @@ qboolean etpro_ScriptAction_SetValues( gentity_t *ent, char *params ) {
 
 		if ( !Q_stricmp( key, "targetname" ) ) {
 			//need to hash this ent targetname for setstate script targets...
-			ent->targetnamehash = BG_StringHashValue( ent->targetname );
+			G_SetTargetName( ent, ent->targetname );
 		}
 	}
 
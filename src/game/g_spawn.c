@@ -794,6 +794,9 @@ void G_ParseField( const char *key, const char *value, gentity_t *ent ) {
 			switch ( f->type ) {
 			case F_STRING:
 				*( char ** )( b + f->ofs ) = G_NewString( value );
+				if ( f->ofs == FOFS( scriptName ) ) {
+					G_SetScriptName( ent, ent->scriptName );
+				}
 				break;
 			case F_VECTOR:
 				sscanf( value, "%f %f %f", &vec[0], &vec[1], &vec[2] );
@@ -865,11 +868,7 @@ void G_SpawnGEntityFromSpawnVars( void ) {
 		}
 	}
 
-	if ( ent->targetname && *ent->targetname ) {
-		ent->targetnamehash = BG_StringHashValue( ent->targetname );
-	} else {
-		ent->targetnamehash = -1;
-	}
+	G_SetTargetName( ent, ent->targetname );
 
 	// move editor origin to pos
 	VectorCopy( ent->s.origin, ent->s.pos.trBase );
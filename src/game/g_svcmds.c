@@ -1275,10 +1275,13 @@ typedef struct {
 static serverCommand_t svcommands[] =
 {
 	{ "addip", Svcmd_AddIP_f },
+	{ "animbench", G_AnimBench_f },
+	{ "antilagbench", G_AntilagBench_f },
 	{ "ban", G_PlayerBan },
 	{ "campaign", Svcmd_Campaign_f },
 	{ "clientkick", Svcmd_KickNum_f },
 	{ "entitylist", Svcmd_EntityList_f },
+	{ "findbench", G_FindBench_f },
 	{ "forceteam", Svcmd_ForceTeam_f },
 	{ "game_memory", Svcmd_GameMem_f },
 	{ "kick", Svcmd_Kick_f },
@@ -61,7 +61,7 @@ void Use_Target_Give( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 		Touch_Item( t, activator, &trace );
 
 		// make sure it isn't going to respawn or show any events
-		t->nextthink = 0;
+		G_SetNextThink( t, 0 );
 		trap_UnlinkEntity( t );
 	}
 }
@@ -105,7 +105,7 @@ void Think_Target_Delay( gentity_t *ent ) {
 }
 
 void Use_Target_Delay( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
-	ent->nextthink = level.time + ( ent->wait + ent->random * crandom() ) * 1000;
+	G_SetNextThink( ent, level.time + ( ent->wait + ent->random * crandom() ) * 1000 );
 	ent->think = Think_Target_Delay;
 	ent->activator = activator;
 }
@@ -282,7 +282,7 @@ void SP_target_speaker( gentity_t *ent ) {
 
 	if ( ent->spawnflags & 16 ) {
 		ent->think = target_speaker_multiple;
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 	}
 
 	// NO_PVS
@@ -348,7 +348,7 @@ void misc_beam_think( gentity_t *self ) {
 
 	self->s.effect1Time = self->target_ent->s.effect2Time;
 
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 
 	if ( self->s.pos.trType != TR_STATIONARY || self->s.apos.trType != TR_STATIONARY || !self->accuracy ) {
 		int i;
@@ -415,7 +415,7 @@ void misc_beam_start( gentity_t *self ) {
 
 	self->accuracy = 0;
 	self->think = misc_beam_think;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 void SP_misc_beam( gentity_t *self ) {
@@ -437,7 +437,7 @@ void SP_misc_beam( gentity_t *self ) {
 	// let everything else get spawned before we start firing
 	self->accuracy = 0;
 	self->think = misc_beam_start;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 //==========================================================
@@ -472,7 +472,7 @@ void target_laser_think( gentity_t *self ) {
 	VectorCopy( tr.endpos, self->s.origin2 );
 
 	trap_LinkEntity( self );
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 void target_laser_on( gentity_t *self ) {
@@ -484,7 +484,7 @@ void target_laser_on( gentity_t *self ) {
 
 void target_laser_off( gentity_t *self ) {
 	trap_UnlinkEntity( self );
-	self->nextthink = 0;
+	G_SetNextThink( self, 0 );
 }
 
 void target_laser_use( gentity_t *self, gentity_t *other, gentity_t *activator ) {
@@ -534,7 +534,7 @@ void SP_target_laser( gentity_t *self ) {
 
 	// let everything else get spawned before we start firing
 	self->think = target_laser_start;
-	self->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 
@@ -687,7 +687,7 @@ void G_KillEnts( const char* target, gentity_t* ignore, gentity_t* killer, means
 	while ( ( targ = G_FindByTargetname( targ, target ) ) ) {
 
 		// make sure it isn't going to respawn or show any events
-		targ->nextthink = 0;
+		G_SetNextThink( targ, 0 );
 
 		if ( targ == ignore ) {
 			continue;
@@ -709,7 +709,7 @@ void G_KillEnts( const char* target, gentity_t* ignore, gentity_t* killer, means
 		}
 
 		trap_UnlinkEntity( targ );
-		targ->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( targ, level.time + FRAMETIME );
 
 		targ->use =     NULL;
 		targ->touch =   NULL;
@@ -790,7 +790,7 @@ Use_Target_Lock
 void Use_Target_Lock( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 	gentity_t   *t = 0;
 
-	while ( ( t = G_Find( t, FOFS( targetname ), ent->target ) ) != NULL )
+	while ( ( t = G_FindByTargetname( t, ent->target ) ) != NULL )
 	{
 //		G_Printf("target_lock locking entity with key: %d\n", ent->count);
 		t->key = ent->key;
@@ -907,7 +907,7 @@ shader		= custom shader to use for particles
 {
 	gentity_t	*tent;
 
-	ent->nextthink = level.time + ent->delay;
+	G_SetNextThink( ent, level.time + ent->delay );
 
 	if (!(ent->spawnflags & 4))
 		return;
@@ -918,7 +918,7 @@ shader		= custom shader to use for particles
 		if (!ent->health)
 		{
 			ent->think = G_FreeEntity;
-			ent->nextthink = level.time + FRAMETIME;
+			G_SetNextThink( ent, level.time + FRAMETIME );
 		}
 	}
 
@@ -941,7 +941,7 @@ shader		= custom shader to use for particles
 }*/
 
 void smoke_think( gentity_t *ent ) {
-	ent->nextthink = level.time + ent->s.constantLight;
+	G_SetNextThink( ent, level.time + ent->s.constantLight );
 
 	if ( !( ent->spawnflags & 4 ) ) {
 		return;
@@ -951,7 +951,7 @@ void smoke_think( gentity_t *ent ) {
 		ent->s.dl_intensity--;
 		if ( !ent->s.dl_intensity ) {
 			ent->think = G_FreeEntity;
-			ent->nextthink = level.time + FRAMETIME;
+			G_SetNextThink( ent, level.time + FRAMETIME );
 		}
 	}
 }
@@ -972,10 +972,10 @@ void smoke_init( gentity_t *ent ) {
 	vec3_t vec;
 
 	ent->think = smoke_think;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	if ( ent->target ) {
-		target = G_Find( NULL, FOFS( targetname ), ent->target );
+		target = G_FindByTargetname( NULL, ent->target );
 		if ( target ) {
 			VectorSubtract( target->s.origin, ent->s.origin, vec );
 			VectorCopy( vec, ent->s.origin2 );
@@ -1009,7 +1009,7 @@ void SP_target_smoke( gentity_t *ent ) {
 	ent->use = smoke_toggle;
 
 	ent->think = smoke_init;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	G_SetOrigin( ent, ent->s.origin );
 	ent->r.svFlags = 0;
@@ -1083,7 +1083,7 @@ void target_script_trigger_use( gentity_t *ent, gentity_t *other, gentity_t *act
 	// Are we using ainame to find another ent instead of using scriptname for this one?
 	if ( ent->aiName ) {
 		// Find the first entity with this name
-		trent = G_Find( trent, FOFS( scriptName ), ent->aiName );
+		trent = G_FindByScriptName( trent, ent->aiName );
 
 		// Was there one?
 		if ( trent ) {
@@ -1184,9 +1184,9 @@ void target_rumble_think( gentity_t * ent ) {
 			ent->s.loopSound = 0;
 		}
 
-		ent->nextthink = 0;
+		G_SetNextThink( ent, 0 );
 	} else {
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 	}
 
 }
@@ -1196,7 +1196,7 @@ void target_rumble_use( gentity_t *ent, gentity_t *other, gentity_t *activator )
 		ent->spawnflags &= ~1;
 		ent->think = target_rumble_think;
 		ent->count = 0;
-		ent->nextthink = level.time + 50;
+		G_SetNextThink( ent, level.time + 50 );
 	} else
 	{
 		ent->spawnflags |= 1;
@@ -1143,7 +1143,7 @@ void SP_team_WOLF_objective( gentity_t *ent ) {
 	ent->message = G_Alloc( strlen( desc ) + 1 );
 	Q_strncpyz( ent->message, desc, strlen( desc ) + 1 );
 
-	ent->nextthink =    level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 	ent->think =        objective_Register;
 	ent->s.eType =      ET_WOLF_OBJECTIVE;
 
@@ -1229,7 +1229,7 @@ void checkpoint_use( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 
 	ent->count2 = level.time;
 	ent->think = checkpoint_use_think;
-	ent->nextthink = level.time + 2000;
+	G_SetNextThink( ent, level.time + 2000 );
 
 	// Gordon: reset player disguise on touching flag
 	other->client->ps.powerups[PW_OPS_DISGUISED] = 0;
@@ -1251,7 +1251,7 @@ void checkpoint_hold_think( gentity_t *self ) {
 	default:
 		break;
 	}
-	self->nextthink = level.time + 5000;
+	G_SetNextThink( self, level.time + 5000 );
 }
 // jpw
 
@@ -1294,7 +1294,7 @@ void checkpoint_think( gentity_t *self ) {
 	} else if ( !( self->spawnflags & CP_HOLD ) ) {
 		self->touch = checkpoint_touch;
 	}
-	self->nextthink = 0;
+	G_SetNextThink( self, 0 );
 // jpw
 }
 
@@ -1356,7 +1356,7 @@ void checkpoint_touch( gentity_t *self, gentity_t *other, trace_t *trace ) {
 	self->touch = NULL;
 
 	self->think = checkpoint_think;
-	self->nextthink = level.time + 1000;
+	G_SetNextThink( self, level.time + 1000 );
 }
 
 // JPW NERVE -- if spawn flag is set, use this touch fn instead to turn on/off targeted spawnpoints
@@ -1441,7 +1441,7 @@ void checkpoint_spawntouch( gentity_t *self, gentity_t *other, trace_t *trace )
 	self->touch = NULL;
 
 	self->think = checkpoint_think;
-	self->nextthink = level.time + 1000;
+	G_SetNextThink( self, level.time + 1000 );
 
 	// activate all targets
 	// Arnout - updated this to allow toggling of initial spawnpoints as well, plus now it only
@@ -1526,7 +1526,7 @@ void SP_team_WOLF_checkpoint( gentity_t *ent ) {
 	ent->s.teamNum  = 1;
 
 	// Used later to set animations (and delay between captures)
-	ent->nextthink = 0;
+	G_SetNextThink( ent, 0 );
 
 	// Used to time how long it must be "held" to switch
 	ent->health = -1;
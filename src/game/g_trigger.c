@@ -43,7 +43,7 @@ void InitTrigger( gentity_t *self ) {
 
 // the wait time has passed, so set back up for another activation
 void multi_wait( gentity_t *ent ) {
-	ent->nextthink = 0;
+	G_SetNextThink( ent, 0 );
 }
 
 
@@ -63,12 +63,12 @@ void multi_trigger( gentity_t *ent, gentity_t *activator ) {
 
 	if ( ent->wait > 0 ) {
 		ent->think = multi_wait;
-		ent->nextthink = level.time + ( ent->wait + ent->random * crandom() ) * 1000;
+		G_SetNextThink( ent, level.time + ( ent->wait + ent->random * crandom() ) * 1000 );
 	} else {
 		// we can't just remove (self) here, because this is a touch function
 		// called while looping through area links...
 		ent->touch = 0;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 		ent->think = G_FreeEntity;
 	}
 }
@@ -189,7 +189,7 @@ This trigger will always fire.  It is activated by the world.
 */
 void SP_trigger_always( gentity_t *ent ) {
 	// we must have some delay to make sure our use targets are present
-	ent->nextthink = level.time + 300;
+	G_SetNextThink( ent, level.time + 300 );
 	ent->think = trigger_always_think;
 }
 
@@ -297,7 +297,7 @@ void SP_target_push( gentity_t *self ) {
 		VectorCopy( self->s.origin, self->r.absmin );
 		VectorCopy( self->s.origin, self->r.absmax );
 		self->think = AimAtTarget;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( self, level.time + FRAMETIME );
 	}
 	self->use = Use_target_push;
 }
@@ -410,7 +410,7 @@ void hurt_touch( gentity_t *self, gentity_t *other, trace_t *trace ) {
 }
 
 void hurt_think( gentity_t *ent ) {
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	if ( ent->wait < level.time ) {
 		G_FreeEntity( ent );
@@ -426,7 +426,7 @@ void hurt_use( gentity_t *self, gentity_t *other, gentity_t *activator ) {
 	}
 
 	if ( self->delay ) {
-		self->nextthink = level.time + 50;
+		G_SetNextThink( self, level.time + 50 );
 		self->think = hurt_think;
 		self->wait = level.time + ( self->delay * 1000 );
 	}
@@ -566,7 +566,7 @@ void heal_touch( gentity_t *self, gentity_t *other, trace_t *trace ) {
 
 #define HEALTH_REGENTIME 10000
 void trigger_heal_think( gentity_t* self ) {
-	self->nextthink = level.time + HEALTH_REGENTIME;
+	G_SetNextThink( self, level.time + HEALTH_REGENTIME );
 /*	if(self->timestamp - level.time > -HEALTH_REGENTIME) {
 		return;
 	}*/
@@ -586,7 +586,7 @@ void trigger_heal_setup( gentity_t* self ) {
 
 	if ( TRIGGER_HEAL_CANTHINK( self ) ) {
 		self->think = trigger_heal_think;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( self, level.time + FRAMETIME );
 	}
 }
 
@@ -641,10 +641,10 @@ void SP_trigger_heal( gentity_t *self ) {
 	self->target_ent = NULL;
 	if ( self->target && *self->target ) {
 		self->think = trigger_heal_setup;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( self, level.time + FRAMETIME );
 	} else if ( TRIGGER_HEAL_CANTHINK( self ) ) {
 		self->think = trigger_heal_think;
-		self->nextthink = level.time + HEALTH_REGENTIME;
+		G_SetNextThink( self, level.time + HEALTH_REGENTIME );
 	}
 
 	// healrate specifies the amount of healing per second
@@ -757,7 +757,7 @@ void ammo_touch( gentity_t *self, gentity_t *other, trace_t *trace ) {
 
 #define AMMO_REGENTIME 60000
 void trigger_ammo_think( gentity_t* self ) {
-	self->nextthink = level.time + AMMO_REGENTIME;
+	G_SetNextThink( self, level.time + AMMO_REGENTIME );
 /*	if(self->timestamp - level.time > -AMMO_REGENTIME) {
 		return;
 	}*/
@@ -777,7 +777,7 @@ void trigger_ammo_setup( gentity_t* self ) {
 
 	if ( TRIGGER_AMMO_CANTHINK( self ) ) {
 		self->think = trigger_ammo_think;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( self, level.time + FRAMETIME );
 	}
 }
 
@@ -831,10 +831,10 @@ void SP_trigger_ammo( gentity_t *self ) {
 	self->target_ent = NULL;
 	if ( self->target && *self->target ) {
 		self->think = trigger_ammo_setup;
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( self, level.time + FRAMETIME );
 	} else if ( TRIGGER_AMMO_CANTHINK( self ) ) {
 		self->think = trigger_ammo_think;
-		self->nextthink = level.time + AMMO_REGENTIME;
+		G_SetNextThink( self, level.time + AMMO_REGENTIME );
 	}
 
 	// ammorate specifies the amount of ammo added per second
@@ -869,7 +869,7 @@ so, the basic time between firing is a random time between
 void func_timer_think( gentity_t *self ) {
 	G_UseTargets( self, self->activator );
 	// set time before next firing
-	self->nextthink = level.time + 1000 * ( self->wait + crandom() * self->random );
+	G_SetNextThink( self, level.time + 1000 * ( self->wait + crandom() * self->random ) );
 }
 
 void func_timer_use( gentity_t *self, gentity_t *other, gentity_t *activator ) {
@@ -877,7 +877,7 @@ void func_timer_use( gentity_t *self, gentity_t *other, gentity_t *activator ) {
 
 	// if on, turn it off
 	if ( self->nextthink ) {
-		self->nextthink = 0;
+		G_SetNextThink( self, 0 );
 		return;
 	}
 
@@ -898,7 +898,7 @@ void SP_func_timer( gentity_t *self ) {
 	}
 
 	if ( self->spawnflags & 1 ) {
-		self->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( self, level.time + FRAMETIME );
 		self->activator = self;
 	}
 
@@ -960,7 +960,7 @@ void trigger_aidoor_stayopen( gentity_t * ent, gentity_t * other, trace_t * trac
 		}
 
 		if ( ( door->moverState == MOVER_POS2ROTATE ) || ( door->moverState == MOVER_POS2 ) ) { // door is in open state waiting to close keep it open
-			door->nextthink = level.time + door->wait + 3000;
+			G_SetNextThink( door, level.time + door->wait + 3000 );
 		}
 
 
@@ -1027,7 +1027,7 @@ void Touch_flagonly( gentity_t *ent, gentity_t *other, trace_t *trace ) {
 
 		// Removes itself
 		ent->touch = NULL;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 		ent->think = G_FreeEntity;
 	} else if ( ent->spawnflags & BLUE_FLAG && other->client->ps.powerups[ PW_BLUEFLAG ] ) {
 
@@ -1051,7 +1051,7 @@ void Touch_flagonly( gentity_t *ent, gentity_t *other, trace_t *trace ) {
 
 		// Removes itself
 		ent->touch = NULL;
-		ent->nextthink = level.time + FRAMETIME;
+		G_SetNextThink( ent, level.time + FRAMETIME );
 		ent->think = G_FreeEntity;
 	}
 }
@@ -1179,7 +1179,7 @@ void explosive_indicator_think( gentity_t *ent ) {
 		}
 
 		//ent->think = G_FreeEntity;
-		//ent->nextthink = level.time + FRAMETIME;
+		//G_SetNextThink( ent, level.time + FRAMETIME );
 		G_FreeEntity( ent );
 		return;
 	}
@@ -1187,7 +1187,7 @@ void explosive_indicator_think( gentity_t *ent ) {
 	if ( ent->s.eType == ET_TANK_INDICATOR || ent->s.eType == ET_TANK_INDICATOR_DEAD ) {
 		VectorCopy( ent->parent->r.currentOrigin, ent->s.pos.trBase );
 	}
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	if ( parent->s.eType == ET_OID_TRIGGER && parent->target_ent ) {
 		ent->s.effect1Time = parent->target_ent->constructibleStats.weaponclass;
@@ -1238,7 +1238,7 @@ void constructible_indicator_think( gentity_t *ent ) {
 		parent->count2 = 0;
 
 		//ent->think = G_FreeEntity;
-		//ent->nextthink = level.time + FRAMETIME;
+		//G_SetNextThink( ent, level.time + FRAMETIME );
 		G_FreeEntity( ent );
 		return;
 	}
@@ -1247,7 +1247,7 @@ void constructible_indicator_think( gentity_t *ent ) {
 		VectorCopy( ent->parent->r.currentOrigin, ent->s.pos.trBase );
 	}
 	ent->s.effect1Time = parent->constructibleStats.weaponclass;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 }
 
 void G_SetConfigStringValue( int num, const char* key, const char* value ) {
@@ -1304,7 +1304,7 @@ void Think_SetupObjectiveInfo( gentity_t *ent ) {
 			e->s.modelindex2 = ent->s.teamNum;
 			e->r.ownerNum = ent->s.number;
 			e->think = explosive_indicator_think;
-			e->nextthink = level.time + FRAMETIME;
+			G_SetNextThink( e, level.time + FRAMETIME );
 
 			e->s.effect1Time = ent->target_ent->constructibleStats.weaponclass;
 
@@ -1393,7 +1393,7 @@ void Think_SetupObjectiveInfo( gentity_t *ent ) {
 			e->r.ownerNum = ent->s.number;
 			ent->count2 = ( e - g_entities );
 			e->think = constructible_indicator_think;
-			e->nextthink = level.time + FRAMETIME;
+			G_SetNextThink( e, level.time + FRAMETIME );
 
 			e->parent = ent;
 
@@ -1515,7 +1515,7 @@ void SP_trigger_objective_info( gentity_t *ent ) {
 		trap_LinkEntity( ent );
 	} else {
 		// Arnout: finalize spawing on fourth frame to allow for proper linking with targets
-		ent->nextthink = level.time + ( 3 * FRAMETIME );
+		G_SetNextThink( ent, level.time + ( 3 * FRAMETIME ) );
 		ent->think = Think_SetupObjectiveInfo;
 	}
 }
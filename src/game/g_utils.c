@@ -214,56 +214,319 @@ gentity_t *G_Find( gentity_t *from, int fieldofs, const char *match ) {
 	return NULL;
 }
 
+/*
+=============================================================================
+
+ENTITY NAME INDEX
+
+Entities are chained by the hash of their lowercased targetname and
+scriptName, so looking them up by name only visits the entities in one
+chain. The chains are sorted by entity number, which keeps the order the
+lookups return matches in the same as a scan over g_entities.
+
+=============================================================================
+*/
+
+#define NAME_INDEX_HASH     1024    // must be a power of two
+
+typedef struct {
+	gentity_t   *chains[NAME_INDEX_HASH];
+	gentity_t   *next[MAX_GENTITIES];
+	int hash[MAX_GENTITIES];
+	qboolean linked[MAX_GENTITIES];
+} nameIndex_t;
+
+static nameIndex_t targetnameIndex;
+static nameIndex_t scriptNameIndex;
+
 /*
 =============
-G_FindByTargetname
+G_UnlinkName
 =============
 */
-gentity_t* G_FindByTargetname( gentity_t *from, const char* match ) {
-	const gentity_t* max = &g_entities[level.num_entities];
-	int hash = BG_StringHashValue( match );
+static void G_UnlinkName( nameIndex_t *index, gentity_t *ent ) {
+	const int num = ent - g_entities;
+	gentity_t   **link;
+
+	if ( !index->linked[num] ) {
+		return;
+	}
+
+	link = &index->chains[index->hash[num] & ( NAME_INDEX_HASH - 1 )];
+	while ( *link != ent ) {
+		link = &index->next[*link - g_entities];
+	}
+	*link = index->next[num];
+
+	index->next[num] = NULL;
+	index->linked[num] = qfalse;
+}
+
+/*
+=============
+G_LinkName
+=============
+*/
+static void G_LinkName( nameIndex_t *index, gentity_t *ent, int hash ) {
+	const int num = ent - g_entities;
+	gentity_t   **link;
+
+	G_UnlinkName( index, ent );
+
+	link = &index->chains[hash & ( NAME_INDEX_HASH - 1 )];
+	while ( *link && *link < ent ) {
+		link = &index->next[*link - g_entities];
+	}
+	index->next[num] = *link;
+	*link = ent;
+
+	index->hash[num] = hash;
+	index->linked[num] = qtrue;
+}
+
+/*
+=============
+G_FindInIndex
+
+Returns the next entity after from whose string at fieldofs matches
+=============
+*/
+static gentity_t *G_FindInIndex( const nameIndex_t *index, gentity_t *from, int fieldofs, const char *match, int hash ) {
+	const int chain = hash & ( NAME_INDEX_HASH - 1 );
+	gentity_t   *ent;
+	int num;
+
+	if ( !match ) {
+		return NULL;
+	}
 
 	if ( !from ) {
-		from = g_entities;
+		ent = index->chains[chain];
+	} else if ( index->linked[from - g_entities] && ( index->hash[from - g_entities] & ( NAME_INDEX_HASH - 1 ) ) == chain ) {
+		ent = index->next[from - g_entities];
 	} else {
-		from++;
+		// from was freed or renamed since it was returned, carry on after its slot
+		for ( ent = index->chains[chain]; ent && ent <= from; ent = index->next[ent - g_entities] ) {
+		}
 	}
 
-	for ( ; from < max ; from++ ) {
-		if ( !from->inuse ) {
+	for ( ; ent; ent = index->next[num] ) {
+		num = ent - g_entities;
+		if ( index->hash[num] != hash || !ent->inuse ) {
 			continue;
 		}
-
-		if ( from->targetnamehash == hash && !Q_stricmp( from->targetname, match ) ) {
-			return from;
+		if ( !Q_stricmp( *( char ** )( (byte *)ent + fieldofs ), match ) ) {
+			return ent;
 		}
 	}
 
 	return NULL;
 }
 
-// digibob: this version should be used for loops, saves the constant hash building
-gentity_t* G_FindByTargetnameFast( gentity_t *from, const char* match, int hash ) {
-	const gentity_t* max = &g_entities[level.num_entities];
+/*
+=============
+G_ClearNameIndex
+=============
+*/
+void G_ClearNameIndex( void ) {
+	memset( &targetnameIndex, 0, sizeof( targetnameIndex ) );
+	memset( &scriptNameIndex, 0, sizeof( scriptNameIndex ) );
+}
 
-	if ( !from ) {
-		from = g_entities;
+/*
+=============
+G_SetTargetName
+=============
+*/
+void G_SetTargetName( gentity_t* ent, char* targetname ) {
+	if ( targetname && *targetname ) {
+		ent->targetname = targetname;
+		ent->targetnamehash = BG_StringHashValue( targetname );
+		G_LinkName( &targetnameIndex, ent, ent->targetnamehash );
 	} else {
-		from++;
+		ent->targetnamehash = -1;
+		G_UnlinkName( &targetnameIndex, ent );
 	}
+}
 
-	for ( ; from < max ; from++ ) {
-		if ( !from->inuse ) {
-			continue;
-		}
+/*
+=============
+G_SetScriptName
+=============
+*/
+void G_SetScriptName( gentity_t *ent, char *scriptName ) {
+	ent->scriptName = scriptName;
+	if ( scriptName ) {
+		G_LinkName( &scriptNameIndex, ent, BG_StringHashValue( scriptName ) );
+	} else {
+		G_UnlinkName( &scriptNameIndex, ent );
+	}
+}
 
-		if ( from->targetnamehash == hash && !Q_stricmp( from->targetname, match ) ) {
+/*
+=============
+G_FindByTargetname
+=============
+*/
+gentity_t* G_FindByTargetname( gentity_t *from, const char* match ) {
+	return G_FindInIndex( &targetnameIndex, from, FOFS( targetname ), match, BG_StringHashValue( match ) );
+}
+
+// digibob: this version should be used for loops, saves the constant hash building
+gentity_t* G_FindByTargetnameFast( gentity_t *from, const char* match, int hash ) {
+	return G_FindInIndex( &targetnameIndex, from, FOFS( targetname ), match, hash );
+}
+
+/*
+=============
+G_FindByScriptName
+=============
+*/
+gentity_t *G_FindByScriptName( gentity_t *from, const char *match ) {
+	return G_FindInIndex( &scriptNameIndex, from, FOFS( scriptName ), match, BG_StringHashValue( match ) );
+}
+
+gentity_t *G_FindByScriptNameFast( gentity_t *from, const char *match, int hash ) {
+	return G_FindInIndex( &scriptNameIndex, from, FOFS( scriptName ), match, hash );
+}
+
+/*
+=============
+G_FindBench_f
+
+findbench [entities] [passes]
+
+Spawns an objective cascade of unlinked entities in groups of eight sharing
+a targetname and scriptName, then finds every group by both names through
+the index and with a scan over g_entities like the lookups used to, reports
+the time of both and whether they returned the same entities
+=============
+*/
+#define FIND_BENCH_GROUP    8
+
+static gentity_t *G_FindBenchScan( gentity_t *from, int fieldofs, const char *match ) {
+	const gentity_t *max = &g_entities[level.num_entities];
+
+	for ( from = from ? from + 1 : g_entities; from < max; from++ ) {
+		if ( from->inuse && !Q_stricmp( *( char ** )( (byte *)from + fieldofs ), match ) ) {
 			return from;
 		}
 	}
 
 	return NULL;
 }
+
+static qboolean G_FindBenchDiffers( int fieldofs, const char *match ) {
+	gentity_t   *indexed = NULL, *scanned = NULL;
+
+	do {
+		if ( fieldofs == FOFS( targetname ) ) {
+			indexed = G_FindByTargetname( indexed, match );
+		} else {
+			indexed = G_FindByScriptName( indexed, match );
+		}
+		scanned = G_FindBenchScan( scanned, fieldofs, match );
+		if ( indexed != scanned ) {
+			return qtrue;
+		}
+	} while ( indexed );
+
+	return qfalse;
+}
+
+void G_FindBench_f( void ) {
+	static char names[MAX_GENTITIES / FIND_BENCH_GROUP][32];
+	static gentity_t *spawned[MAX_GENTITIES];
+	char arg[MAX_TOKEN_CHARS];
+	gentity_t   *ent, *indexed, *scanned;
+	int count, passes, groups, pass, differ, inuse, i;
+	int indexMsec, scanMsec, t;
+
+	count = 900;
+	passes = 100;
+	if ( trap_Argc() > 1 ) {
+		trap_Argv( 1, arg, sizeof( arg ) );
+		count = atoi( arg );
+	}
+	if ( trap_Argc() > 2 ) {
+		trap_Argv( 2, arg, sizeof( arg ) );
+		passes = atoi( arg );
+	}
+
+	inuse = 0;
+	for ( i = 0, ent = g_entities; i < level.num_entities; i++, ent++ ) {
+		if ( ent->inuse ) {
+			inuse++;
+		}
+	}
+
+	// leave room for whatever the game spawns meanwhile
+	count = MIN( count, ENTITYNUM_MAX_NORMAL - 64 - inuse );
+	if ( count < FIND_BENCH_GROUP || passes < 1 ) {
+		G_Printf( "findbench: no room for the entities\n" );
+		return;
+	}
+
+	groups = count / FIND_BENCH_GROUP;
+	count = groups * FIND_BENCH_GROUP;
+	for ( i = 0; i < groups; i++ ) {
+		Com_sprintf( names[i], sizeof( names[i] ), "findbench_%i", i );
+	}
+
+	// interleave the groups so matches are spread over the entity range
+	for ( i = 0; i < count; i++ ) {
+		spawned[i] = G_Spawn();
+		spawned[i]->classname = "findbench";
+		G_SetTargetName( spawned[i], names[i % groups] );
+		G_SetScriptName( spawned[i], names[i % groups] );
+	}
+
+	t = trap_Milliseconds();
+	for ( pass = 0; pass < passes; pass++ ) {
+		for ( i = 0; i < groups; i++ ) {
+			for ( indexed = NULL; ( indexed = G_FindByTargetname( indexed, names[i] ) ) != NULL; ) {
+			}
+			for ( indexed = NULL; ( indexed = G_FindByScriptName( indexed, names[i] ) ) != NULL; ) {
+			}
+		}
+	}
+	indexMsec = trap_Milliseconds() - t;
+
+	t = trap_Milliseconds();
+	for ( pass = 0; pass < passes; pass++ ) {
+		for ( i = 0; i < groups; i++ ) {
+			for ( scanned = NULL; ( scanned = G_FindBenchScan( scanned, FOFS( targetname ), names[i] ) ) != NULL; ) {
+			}
+			for ( scanned = NULL; ( scanned = G_FindBenchScan( scanned, FOFS( scriptName ), names[i] ) ) != NULL; ) {
+			}
+		}
+	}
+	scanMsec = trap_Milliseconds() - t;
+
+	// the whole map, not just the bench entities, must come out the same
+	differ = 0;
+	for ( i = 0, ent = g_entities; i < level.num_entities; i++, ent++ ) {
+		if ( !ent->inuse ) {
+			continue;
+		}
+		if ( ent->targetname && G_FindBenchDiffers( FOFS( targetname ), ent->targetname ) ) {
+			differ++;
+		}
+		if ( ent->scriptName && G_FindBenchDiffers( FOFS( scriptName ), ent->scriptName ) ) {
+			differ++;
+		}
+	}
+
+	for ( i = 0; i < count; i++ ) {
+		G_FreeEntity( spawned[i] );
+	}
+
+	G_Printf( "findbench: %i entities in use, %i lookups of %i groups\n", inuse + count, passes * groups * 2, groups );
+	G_Printf( "  index: %i msec\n", indexMsec );
+	G_Printf( "  scan:  %i msec\n", scanMsec );
+	G_Printf( "  %i lookups differ\n", differ );
+}
+
 /*
 =============
 G_PickTarget
@@ -342,6 +605,7 @@ void G_UseEntity( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 	}
 
 	// Woop we got through, let's use the entity
+	G_WakeEntity( ent );
 	ent->use( ent, other, activator );
 }
 
@@ -509,6 +773,8 @@ void G_InitGentity( gentity_t *e ) {
 	e->spawnCount++;
 	// mark the time
 	e->spawnTime = level.time;
+
+	G_WakeEntity( e );
 }
 
 /*
@@ -608,11 +874,15 @@ void G_FreeEntity( gentity_t *ed ) {
 	}
 
 	trap_UnlinkEntity( ed );     // unlink from world
+	G_WakeEntity( ed );
 
 	if ( ed->neverFree ) {
 		return;
 	}
 
+	G_UnlinkName( &targetnameIndex, ed );
+	G_UnlinkName( &scriptNameIndex, ed );
+
 	spawnCount = ed->spawnCount;
 
 	memset( ed, 0, sizeof( *ed ) );
@@ -781,6 +1051,7 @@ void G_AddEvent( gentity_t *ent, int event, int eventParm ) {
 	}
 	ent->eventTime = level.time;
 	ent->r.eventTime = level.time;
+	G_WakeEntity( ent );
 }
 
 
@@ -964,6 +1235,8 @@ void G_SetEntState( gentity_t *ent, entState_t state ) {
 		return;
 	}
 
+	G_WakeEntity( ent );
+
 	switch ( state ) {
 	case STATE_DEFAULT:             if ( ent->entstate == STATE_UNDERCONSTRUCTION ) {
 			ent->clipmask = ent->realClipmask;
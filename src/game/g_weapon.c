@@ -195,7 +195,7 @@ void MagicSink( gentity_t *self ) {
 	self->clipmask = 0;
 	self->r.contents = 0;
 
-	self->nextthink = level.time + 4000;
+	G_SetNextThink( self, level.time + 4000 );
 	self->think = G_FreeEntity;
 
 	self->s.pos.trType = TR_LINEAR;
@@ -269,7 +269,7 @@ void Weapon_Medic( gentity_t *ent ) {
 
 	ent2 = LaunchItem( item, tosspos, velocity, ent->s.number );
 	ent2->think = MagicSink;
-	ent2->nextthink = level.time + 30000;
+	G_SetNextThink( ent2, level.time + 30000 );
 //	ent2->timestamp = level.time + 31200;
 
 	ent2->parent = ent; // JPW NERVE so we can score properly later
@@ -303,7 +303,7 @@ void G_PlaceTripmine( gentity_t* ent ) {
 	bomb->s.weapon = WP_TRIPMINE;
 	bomb->parent = ent;
 	bomb->think = G_TripMinePrime;
-	bomb->nextthink = level.time + 2000;
+	G_SetNextThink( bomb, level.time + 2000 );
 	bomb->splashDamage = 300;
 	bomb->splashRadius = 300;
 	bomb->methodOfDeath = MOD_TRIPMINE;
@@ -430,7 +430,7 @@ void Weapon_MagicAmmo( gentity_t *ent ) {
 
 	ent2 = LaunchItem( item, tosspos, velocity, ent->s.number );
 	ent2->think = MagicSink;
-	ent2->nextthink = level.time + 30000;
+	G_SetNextThink( ent2, level.time + 30000 );
 //	ent2->timestamp = level.time + 31200;
 
 	ent2->parent = ent;
@@ -592,7 +592,7 @@ void Weapon_Syringe( gentity_t *ent ) {
 
 				// Arnout: calculate ranks to update numFinalDead arrays. Have to do it manually as addscore has an early out
 				if ( g_gametype.integer == GT_WOLF_LMS ) {
-					CalculateRanks();
+					G_QueueCalculateRanks();
 				}
 			}
 		}
@@ -1041,7 +1041,7 @@ static qboolean TryConstructing( gentity_t *ent ) {
 
 			// setup our think function for decaying
 			constructible->think = func_constructible_underconstructionthink;
-			constructible->nextthink = level.time + FRAMETIME;
+			G_SetNextThink( constructible, level.time + FRAMETIME );
 
 			G_PrintClientSpammyCenterPrint( ent - g_entities, "Constructing..." );
 		}
@@ -1135,7 +1135,7 @@ static qboolean TryConstructing( gentity_t *ent ) {
 
 		// Stop thinking
 		constructible->think = NULL;
-		constructible->nextthink = 0;
+		G_SetNextThink( constructible, 0 );
 
 		if ( !constructible->count2 ) {
 			// call script
@@ -1200,7 +1200,7 @@ static qboolean TryConstructing( gentity_t *ent ) {
 				e->s.modelindex2 = ent->client->touchingTOI->s.teamNum;
 				e->r.ownerNum = constructible->s.number;
 				e->think = explosive_indicator_think;
-				e->nextthink = level.time + FRAMETIME;
+				G_SetNextThink( e, level.time + FRAMETIME );
 
 				e->s.effect1Time = constructible->constructibleStats.weaponclass;
 
@@ -1225,6 +1225,7 @@ static qboolean TryConstructing( gentity_t *ent ) {
 
 					if ( check->r.ownerNum == constructible->s.number ) {
 						// found it!
+						G_WakeEntity( check );
 						if ( constructible->parent->tagParent ) {
 							check->tagParent = constructible->parent->tagParent;
 							Q_strncpyz( check->tagName, constructible->parent->tagName, MAX_QPATH );
@@ -1310,7 +1311,7 @@ void AutoBuildConstruction( gentity_t* constructible ) {
 
 	// Stop thinking
 	constructible->think = NULL;
-	constructible->nextthink = 0;
+	G_SetNextThink( constructible, 0 );
 
 	if ( !constructible->count2 ) {
 		// call script
@@ -1375,7 +1376,7 @@ void AutoBuildConstruction( gentity_t* constructible ) {
 			e->s.modelindex2 = constructible->parent->s.teamNum == TEAM_AXIS ? TEAM_ALLIES : TEAM_AXIS;
 			e->r.ownerNum = constructible->s.number;
 			e->think = explosive_indicator_think;
-			e->nextthink = level.time + FRAMETIME;
+			G_SetNextThink( e, level.time + FRAMETIME );
 
 			e->s.effect1Time = constructible->constructibleStats.weaponclass;
 
@@ -1400,6 +1401,7 @@ void AutoBuildConstruction( gentity_t* constructible ) {
 
 				if ( check->r.ownerNum == constructible->s.number ) {
 					// found it!
+					G_WakeEntity( check );
 					if ( constructible->parent->tagParent ) {
 						check->tagParent = constructible->parent->tagParent;
 						Q_strncpyz( check->tagName, constructible->parent->tagName, MAX_QPATH );
@@ -1644,7 +1646,7 @@ void Weapon_Engineer( gentity_t *ent ) {
 					traceEnt->s.teamNum = ent->client->sess.sessionTeam;
 					traceEnt->s.modelindex2 = 0;
 
-					traceEnt->nextthink = level.time + 2000;
+					G_SetNextThink( traceEnt, level.time + 2000 );
 					traceEnt->think = G_LandminePrime;
 				} else {
 //bani - #471
@@ -1667,7 +1669,7 @@ evilbanigoto:
 					if ( traceEnt->health >= 250 ) {
 /*						traceEnt->health = 255;
 						traceEnt->think = G_FreeEntity;
-						traceEnt->nextthink = level.time + FRAMETIME;*/
+						G_SetNextThink( traceEnt, level.time + FRAMETIME );*/
 
 						trap_SendServerCommand( ent - g_entities, "cp \"Landmine defused...\" 1" );
 
@@ -1734,7 +1736,7 @@ evilbanigoto:
 
 				traceEnt->health = 255;
 				traceEnt->think = G_FreeEntity;
-				traceEnt->nextthink = level.time + FRAMETIME;
+				G_SetNextThink( traceEnt, level.time + FRAMETIME );
 
 				//bani - consistency with dynamite defusing
 				G_PrintClientSpammyCenterPrint( ent - g_entities, "Satchel charge disarmed..." );
@@ -1755,7 +1757,7 @@ evilbanigoto:
 			if ( traceEnt->health >= 250 ) {
 				traceEnt->health = 255;
 				traceEnt->think = G_FreeEntity;
-				traceEnt->nextthink = level.time + FRAMETIME;
+				G_SetNextThink( traceEnt, level.time + FRAMETIME );
 
 				Add_Ammo( ent, WP_TRIPMINE, 1, qfalse );
 			} else {
@@ -1890,7 +1892,7 @@ evilbanigoto:
 				traceEnt->s.effect1Time = level.time;
 
 				// ARM IT!
-				traceEnt->nextthink = level.time + 30000;
+				G_SetNextThink( traceEnt, level.time + 30000 );
 				traceEnt->think = G_ExplodeMissile;
 
 				// Gordon: moved down here to prevent two prints when dynamite IS near objective
@@ -2054,7 +2056,7 @@ evilbanigoto:
 //					Add_Ammo( ent, WP_DYNAMITE, 1, qtrue );
 
 					traceEnt->think = G_FreeEntity;
-					traceEnt->nextthink = level.time + FRAMETIME;
+					G_SetNextThink( traceEnt, level.time + FRAMETIME );
 
 					VectorCopy( traceEnt->r.currentOrigin, origin );
 					SnapVector( origin );
@@ -2242,7 +2244,7 @@ void G_AirStrikeExplode( gentity_t *self ) {
 	self->r.svFlags |= SVF_BROADCAST;
 
 	self->think = G_ExplodeMissile;
-	self->nextthink = level.time + 50;
+	G_SetNextThink( self, level.time + 50 );
 }
 
 qboolean G_AvailableAirstrikes( gentity_t* ent ) {
@@ -2278,23 +2280,23 @@ extern void G_SayTo( gentity_t *ent, gentity_t *other, int mode, int color, cons
 void weapon_checkAirStrikeThink1( gentity_t *ent ) {
 	if ( !weapon_checkAirStrike( ent ) ) {
 		ent->think = G_ExplodeMissile;
-		ent->nextthink = level.time + 1000;
+		G_SetNextThink( ent, level.time + 1000 );
 		return;
 	}
 
 	ent->think = weapon_callAirStrike;
-	ent->nextthink = level.time + 1500;
+	G_SetNextThink( ent, level.time + 1500 );
 }
 
 void weapon_checkAirStrikeThink2( gentity_t *ent ) {
 	if ( !weapon_checkAirStrike( ent ) ) {
 		ent->think = G_ExplodeMissile;
-		ent->nextthink = level.time + 1000;
+		G_SetNextThink( ent, level.time + 1000 );
 		return;
 	}
 
 	ent->think = weapon_callSecondPlane;
-	ent->nextthink = level.time + 500;
+	G_SetNextThink( ent, level.time + 500 );
 }
 
 void weapon_callSecondPlane( gentity_t *ent ) {
@@ -2304,7 +2306,7 @@ void weapon_callSecondPlane( gentity_t *ent ) {
 	te->s.eventParm = G_SoundIndex( "sound/weapons/airstrike/airstrike_plane.wav" );
 	te->r.svFlags |= SVF_BROADCAST;
 
-	ent->nextthink = level.time + 1000;
+	G_SetNextThink( ent, level.time + 1000 );
 	ent->think = weapon_callAirStrike;
 }
 
@@ -2320,7 +2322,7 @@ qboolean weapon_checkAirStrike( gentity_t *ent ) {
 	if ( !g_friendlyFire.integer && ent->parent->client && ent->parent->client->sess.sessionTeam == TEAM_SPECTATOR ) {
 		ent->splashDamage = 0;  // no damage
 		ent->think = G_ExplodeMissile;
-		ent->nextthink = level.time + crandom() * 50;
+		G_SetNextThink( ent, level.time + crandom() * 50 );
 
 		ent->active = qfalse;
 		if ( ent->s.teamNum == TEAM_AXIS ) {
@@ -2391,7 +2393,7 @@ void weapon_callAirStrike( gentity_t *ent ) {
 
 	// turn off smoke grenade
 	ent->think = G_ExplodeMissile;
-	ent->nextthink = level.time + 950 + NUMBOMBS * 100 + crandom() * 50; // 950 offset is for aircraft flyby
+	G_SetNextThink( ent, level.time + 950 + NUMBOMBS * 100 + crandom() * 50 ); // 950 offset is for aircraft flyby
 
 	ent->active = qtrue;
 
@@ -2464,7 +2466,7 @@ void weapon_callAirStrike( gentity_t *ent ) {
 
 		for ( i = 0; i < NUMBOMBS; i++ ) {
 			bomb = G_Spawn();
-			bomb->nextthink     = level.time + i * 100 + crandom() * 50 + 1000 + ( j * 2000 ); // 1000 for aircraft flyby, other term for tumble stagger
+			G_SetNextThink( bomb, level.time + i * 100 + crandom() * 50 + 1000 + ( j * 2000 ) ); // 1000 for aircraft flyby, other term for tumble stagger
 			bomb->think         = G_AirStrikeExplode;
 			bomb->s.eType       = ET_MISSILE;
 			bomb->r.svFlags     = SVF_NOCLIENT;
@@ -2541,7 +2543,7 @@ void artilleryThink_real( gentity_t *ent ) {
 }
 void artilleryThink( gentity_t *ent ) {
 	ent->think = artilleryThink_real;
-	ent->nextthink = level.time + 100;
+	G_SetNextThink( ent, level.time + 100 );
 
 	ent->r.svFlags = SVF_BROADCAST;
 }
@@ -2558,7 +2560,7 @@ void artillerySpotterThink( gentity_t *ent ) {
 	vec3_t tmpdir;
 	int i;
 	ent->think = G_ExplodeMissile;
-	ent->nextthink = level.time + 1;
+	G_SetNextThink( ent, level.time + 1 );
 	SnapVector( ent->s.pos.trBase );
 
 	for ( i = 0; i < 7; i++ ) {
@@ -2568,7 +2570,7 @@ void artillerySpotterThink( gentity_t *ent ) {
 		bomb->r.ownerNum    = ent->s.number;
 		bomb->parent        = ent;
 		bomb->s.teamNum     = ent->s.teamNum;
-		bomb->nextthink     = level.time + 1000 + random() * 300;
+		G_SetNextThink( bomb, level.time + 1000 + random() * 300 );
 		bomb->classname     = "WP";              // WP == White Phosphorous, so we can check for bounce noise in grenade bounce routine
 		bomb->damage        = 000;              // maybe should un-hard-code these?
 		bomb->splashDamage  = 000;
@@ -2726,7 +2728,7 @@ void Weapon_Artillery( gentity_t *ent ) {
 		bomb->s.teamNum     = ent->client->sess.sessionTeam;
 
 		if ( i == 0 ) {
-			bomb->nextthink     = level.time + 5000;
+			G_SetNextThink( bomb, level.time + 5000 );
 			bomb->r.svFlags     = SVF_BROADCAST;
 			bomb->classname     = "props_explosion"; // was "air strike"
 			bomb->damage        = 0; // maybe should un-hard-code these?
@@ -2740,9 +2742,9 @@ void Weapon_Artillery( gentity_t *ent ) {
 			bomb->think = artillerySpotterThink;
 		} else {
 			if ( ent->client->sess.skill[SK_SIGNALS] >= 3 ) {
-				bomb->nextthink     = level.time + 8950 + 2000 * i + crandom() * 800;
+				G_SetNextThink( bomb, level.time + 8950 + 2000 * i + crandom() * 800 );
 			} else {
-				bomb->nextthink     = level.time + 8950 + 2000 * i + crandom() * 800;
+				G_SetNextThink( bomb, level.time + 8950 + 2000 * i + crandom() * 800 );
 			}
 
 			// Gordon: for explosion type
@@ -2793,7 +2795,7 @@ void Weapon_Artillery( gentity_t *ent ) {
 		bomb2->parent       = ent;
 		bomb2->s.teamNum    = ent->s.teamNum;
 		bomb2->damage       = 0;
-		bomb2->nextthink = bomb->nextthink - 600;
+		G_SetNextThink( bomb2, bomb->nextthink - 600 );
 		bomb2->classname = "air strike";
 		bomb2->clipmask = MASK_MISSILESHOT;
 		bomb2->s.pos.trType = TR_STATIONARY; // was TR_GRAVITY,  might wanna go back to this and drop from height
@@ -2840,7 +2842,7 @@ void weapon_smokeBombExplode( gentity_t *ent ) {
 	}
 
 	lived = level.time - ent->grenadeExplodeTime;
-	ent->nextthink = level.time + FRAMETIME;
+	G_SetNextThink( ent, level.time + FRAMETIME );
 
 	if ( lived < SMOKEBOMB_GROWTIME ) {
 		// Just been thrown, increase radius
@@ -3100,7 +3102,7 @@ void RubbleFlagCheck( gentity_t *ent, trace_t tr ) {
 			G_AddEvent( sfx, EV_SHARD, DirToByte( dir ) );
 
 			sfx->think = G_FreeEntity;
-			sfx->nextthink = level.time + 1000;
+			G_SetNextThink( sfx, level.time + 1000 );
 
 			sfx->s.frame = 3 + ( rand() % 3 ) ;
 
@@ -3584,11 +3586,11 @@ gentity_t *weapon_grenadelauncher_fire( gentity_t *ent, int grenType ) {
 		m->s.teamNum = ent->client->sess.sessionTeam;   // store team so we can generate red or blue smoke
 		if ( ent->client->sess.skill[SK_SIGNALS] >= 3 ) {
 			m->count = 2;
-			m->nextthink = level.time + 3500;
+			G_SetNextThink( m, level.time + 3500 );
 			m->think = weapon_checkAirStrikeThink2;
 		} else {
 			m->count = 1;
-			m->nextthink = level.time + 2500;
+			G_SetNextThink( m, level.time + 2500 );
 			m->think = weapon_checkAirStrikeThink1;
 		}
 	}
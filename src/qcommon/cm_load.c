@@ -60,8 +60,8 @@ void SetPlaneSignbits( cplane_t *out ) {
 
 
 clipMap_t	cm;
+cTraceState_t	cm_traceState;
 int			c_pointcontents;
-int			c_traces, c_brush_traces, c_patch_traces;
 
 
 static byte *cmod_base;
@@ -71,7 +71,9 @@ cvar_t		*cm_noAreas;
 cvar_t		*cm_noCurves;
 cvar_t		*cm_playerCurveClip;
 cvar_t      *cm_optimize;
+cvar_t      *cm_packedBrushes;
 cvar_t		*cm_optimizePatchPlanes;
+cvar_t		*cm_debugSurfaceUpdate;
 #endif
 
 static cmodel_t box_model;
@@ -238,6 +240,50 @@ static void CM_BoundBrush( cbrush_t *b ) {
 }
 
 
+#ifdef CM_SIMD_BRUSHES
+/*
+=================
+CMod_PackBrushes
+
+Copies the side planes of every brush into arrays of doubles,
+so the trace code can load two sides at once
+=================
+*/
+static void CMod_PackBrushes( void ) {
+	cbrush_t	*b;
+	double		*packed;
+	size_t		total;
+	int			i, j, n;
+
+	total = 0;
+	for ( i = 0, b = cm.brushes; i < cm.numBrushes; i++, b++ ) {
+		if ( b->numsides <= MAX_PACKED_SIDES ) {
+			total += 4 * PACKED_SIDES( b->numsides );
+		}
+	}
+
+	packed = Hunk_Alloc( total * sizeof( double ) + 16, h_high );
+	packed = PADP( packed, 16 );
+
+	for ( i = 0, b = cm.brushes; i < cm.numBrushes; i++, b++ ) {
+		if ( !b->numsides || b->numsides > MAX_PACKED_SIDES ) {
+			continue;
+		}
+		n = PACKED_SIDES( b->numsides );
+		// padding stays zero
+		for ( j = 0; j < b->numsides; j++ ) {
+			packed[ j ] = b->sides[ j ].plane->normal[0];
+			packed[ n + j ] = b->sides[ j ].plane->normal[1];
+			packed[ n * 2 + j ] = b->sides[ j ].plane->normal[2];
+			packed[ n * 3 + j ] = b->sides[ j ].plane->dist;
+		}
+		b->packed = packed;
+		packed += n * 4;
+	}
+}
+#endif
+
+
 /*
 =================
 CMod_LoadBrushes
@@ -273,6 +319,9 @@ static void CMod_LoadBrushes( const lump_t *l ) {
 		CM_BoundBrush( out );
 	}
 
+#ifdef CM_SIMD_BRUSHES
+	CMod_PackBrushes();
+#endif
 }
 
 
@@ -659,6 +708,9 @@ void CM_LoadMap( const char *name, qboolean clientload, int *checksum ) {
 	cm_playerCurveClip = Cvar_Get( "cm_playerCurveClip", "1", CVAR_ARCHIVE_ND | CVAR_CHEAT );
 	Cvar_SetDescription( cm_playerCurveClip, "Collide player against curves" );
 	cm_optimize = Cvar_Get( "cm_optimize", "1", CVAR_CHEAT );
+	cm_packedBrushes = Cvar_Get( "cm_packedBrushes", "1", CVAR_CHEAT );
+	Cvar_SetDescription( cm_packedBrushes, "Test two brush sides at a time with SSE2 where available, results are the same either way" );
+	cm_debugSurfaceUpdate = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
 #endif
 
 	// We only care about this cvar on server, client will parse it out of systeminfo directly
@@ -746,6 +798,11 @@ void CM_LoadMap( const char *name, qboolean clientload, int *checksum ) {
 
 	CMod_CheckLeafBrushes();
 
+	// check counts of the main thread, CM_BoxTraceBatch jobs get their own
+	cm_traceState.checkcount = 0;
+	cm_traceState.brushChecks = Hunk_Alloc( ( cm.numBrushes + cm.numSurfaces ) * sizeof( int ), h_high );
+	cm_traceState.patchChecks = cm_traceState.brushChecks + cm.numBrushes;
+
 	// we are NOT freeing the file, because it is cached for the ref
 	FS_FreeFile( buf );
 
@@ -766,7 +823,10 @@ CM_ClearMap
 ==================
 */
 void CM_ClearMap( void ) {
+	CM_FreeTraceStates();
 	Com_Memset( &cm, 0, sizeof( cm ) );
+	cm_traceState.brushChecks = NULL;
+	cm_traceState.patchChecks = NULL;
 	CM_ClearLevelPatches();
 }
 
@@ -940,6 +1000,20 @@ void CM_SetTempBoxModelContents( int contents ) {
 }
 // dhm
 
+
+/*
+===================
+CM_GetTempBox
+
+Current temp box for a trace to take along, main thread only
+===================
+*/
+void CM_GetTempBox( cTempBox_t *box ) {
+	VectorCopy( box_model.mins, box->mins );
+	VectorCopy( box_model.maxs, box->maxs );
+	box->contents = box_brush->contents;
+}
+
 /*
 ===================
 CM_ModelBounds
@@ -89,6 +89,15 @@ static ID_INLINE vec_t VectorNormalizeDP( vec3_t v ) {
 // enable to make the collision detection a bunch faster
 #define MRE_OPTIMIZE
 
+// test two brush sides at a time with SSE2, which every x86_64 cpu has
+#if idx64 && !defined( BSPC )
+#define CM_SIMD_BRUSHES
+#endif
+
+// number of doubles in each of the packed brush side arrays
+#define PACKED_SIDES( numsides )	( ( ( numsides ) + 1 ) & ~1 )
+#define MAX_PACKED_SIDES			64	// larger brushes use the scalar code
+
 typedef struct {
 	cplane_t    *plane;
 	int children[2];                // negative numbers are leafs
@@ -122,12 +131,11 @@ typedef struct {
 	vec3_t bounds[2];
 	int numsides;
 	cbrushside_t    *sides;
-	int checkcount;             // to avoid repeated testings
+	double          *packed;    // side normals x, y, z and dists as PACKED_SIDES() long arrays, may be NULL
 } cbrush_t;
 
 
 typedef struct {
-	int checkcount;                     // to avoid repeated testings
 	int surfaceFlags;
 	int contents;
 	struct patchCollide_s   *pc;
@@ -185,7 +193,6 @@ typedef struct {
 	cPatch_t    **surfaces;         // non-patches will be NULL
 
 	int floodvalid;
-	int checkcount;                         // incremented on each trace
 	unsigned int checksum;
 } clipMap_t;
 
@@ -194,14 +201,34 @@ typedef struct {
 // and to avoid various numeric issues
 #define SURFACE_CLIP_EPSILON    ( 0.125 )
 
+// everything a trace writes besides its own traceWork_t, one per thread
+// tracing at the same time so that traces never share any state
+typedef struct {
+	int checkcount;             // incremented on each trace
+	int *brushChecks;           // [numBrushes] to avoid repeated testings
+	int *patchChecks;           // [numSurfaces]
+	int traces;                 // for statistics, may be zeroed
+	int brushTraces;
+	int patchTraces;
+} cTraceState_t;
+
+// the temp box or capsule model a trace clips against, copied into the
+// trace because CM_TempBoxModel may be changed by another trace meanwhile
+typedef struct {
+	vec3_t mins, maxs;
+	int contents;
+} cTempBox_t;
+
 extern clipMap_t cm;
+extern cTraceState_t cm_traceState;     // main thread
 extern int c_pointcontents;
-extern int c_traces, c_brush_traces, c_patch_traces;
 extern cvar_t      *cm_noAreas;
 extern cvar_t      *cm_noCurves;
 extern cvar_t      *cm_playerCurveClip;
 extern cvar_t      *cm_optimize;
+extern cvar_t      *cm_packedBrushes;
 extern cvar_t      *cm_optimizePatchPlanes;
+extern cvar_t      *cm_debugSurfaceUpdate;
 
 // cm_test.c
 
@@ -227,6 +254,11 @@ typedef struct {
 	qboolean isPoint;       // optimized case
 	trace_t trace;          // returned from trace call
 	sphere_t sphere;        // sphere for oriendted capsule collision
+	cTraceState_t *state;   // of the thread running the trace
+	cTempBox_t tempBox;     // for BOX_MODEL_HANDLE and CAPSULE_MODEL_HANDLE
+	cbrush_t boxBrush;      // built from the temp box, see CM_InitTraceBox
+	cbrushside_t boxSides[6];
+	cplane_t boxPlanes[6];
 #ifdef MRE_OPTIMIZE
 	cplane_t tracePlane1;
 	cplane_t tracePlane2;
@@ -255,6 +287,10 @@ void CM_StoreBrushes( leafList_t *ll, int nodenum );
 void CM_BoxLeafnums_r( leafList_t *ll, int nodenum );
 
 cmodel_t	*CM_ClipHandleToModel( clipHandle_t handle );
+void CM_GetTempBox( cTempBox_t *box );
+
+// cm_trace.c
+void CM_FreeTraceStates( void );
 qboolean CM_BoundsIntersect( const vec3_t mins, const vec3_t maxs, const vec3_t mins2, const vec3_t maxs2 );
 qboolean CM_BoundsIntersectPoint( const vec3_t mins, const vec3_t maxs, const vec3_t point );
 
@@ -1348,9 +1348,6 @@ static void CM_TracePointThroughPatchCollide( traceWork_t *tw, const struct patc
 	int			i, j, k;
 	float		offset;
 	float		d1, d2;
-#ifndef BSPC
-	static cvar_t *cv;
-#endif //BSPC
 
 #ifndef BSPC
 	if ( !cm_playerCurveClip->integer && !tw->isPoint ) {
@@ -1408,10 +1405,8 @@ static void CM_TracePointThroughPatchCollide( traceWork_t *tw, const struct patc
 		if ( j == facet->numBorders ) {
 			// we hit this facet
 #ifndef BSPC
-			if (!cv) {
-				cv = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
-			}
-			if (cv->integer) {
+			// batch jobs with their own state may run at the same time
+			if ( cm_debugSurfaceUpdate->integer && tw->state == &cm_traceState ) {
 				debugPatchCollide = pc;
 				debugFacet = facet;
 			}
@@ -1494,9 +1489,6 @@ void CM_TraceThroughPatchCollide( traceWork_t *tw, const struct patchCollide_s *
 	facet_t	*facet;
 	float plane[4], bestplane[4];
 	vec3_t startp, endp;
-#ifndef BSPC
-	static cvar_t *cv;
-#endif //BSPC
 
 	if ( !CM_BoundsIntersect( tw->bounds[0], tw->bounds[1],
 				pc->bounds[0], pc->bounds[1] ) ) {
@@ -1599,10 +1591,7 @@ void CM_TraceThroughPatchCollide( traceWork_t *tw, const struct patchCollide_s *
 				//	enterFrac = 0;
 				//}
 #ifndef BSPC
-				if (!cv) {
-					cv = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
-				}
-				if (cv && cv->integer) {
+				if ( cm_debugSurfaceUpdate->integer && tw->state == &cm_traceState ) {
 					debugPatchCollide = pc;
 					debugFacet = facet;
 				}
@@ -58,6 +58,19 @@ void		CM_TransformedBoxTrace( trace_t *results, const vec3_t start, const vec3_t
 						clipHandle_t model, int brushmask,
 						const vec3_t origin, const vec3_t angles, qboolean capsule );
 
+typedef struct {
+	vec3_t		start;
+	vec3_t		end;
+	vec3_t		mins;
+	vec3_t		maxs;
+	int			brushmask;
+	trace_t		trace;		// filled in by CM_BoxTraceBatch
+} cmRay_t;
+
+// traces every ray through the same model on the worker threads
+void		CM_BoxTraceBatch( cmRay_t *rays, int numRays, clipHandle_t model, qboolean capsule );
+void		CM_PrintTraceStats( void );
+
 byte        *CM_ClusterPVS( int cluster );
 
 int         CM_PointLeafnum( const vec3_t p );
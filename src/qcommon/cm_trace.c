@@ -30,6 +30,10 @@ If you have questions concerning this license or the applicable additional terms
 #include "cm_local.h"
 #include "cm_patch.h"
 
+#ifdef CM_SIMD_BRUSHES
+#include <emmintrin.h>
+#endif
+
 // always use bbox vs. bbox collision and never capsule vs. bbox or vice versa
 #define ALWAYS_BBOX_VS_BBOX
 // always use capsule vs. capsule collision and never capsule vs. bbox or vice versa
@@ -159,6 +163,115 @@ POSITION TESTING
 ===============================================================================
 */
 
+#ifdef CM_SIMD_BRUSHES
+
+// m ? a : b for each lane
+#define SelectPD( m, a, b )	_mm_or_pd( _mm_and_pd( m, a ), _mm_andnot_pd( m, b ) )
+#define SelectPS( m, a, b )	_mm_or_ps( _mm_and_ps( m, a ), _mm_andnot_ps( m, b ) )
+
+// same order as DotProductDP
+#define DotProductPD( ax, ay, az, bx, by, bz ) \
+	_mm_add_pd( _mm_add_pd( _mm_mul_pd( ax, bx ), _mm_mul_pd( ay, by ) ), _mm_mul_pd( az, bz ) )
+#define DotProductPS( ax, ay, az, bx, by, bz ) \
+	_mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ), _mm_mul_ps( az, bz ) )
+
+/*
+================
+CM_PackedBrushInFront
+
+The non-axial side loops of CM_TestBoxInBrush two sides at a time. Every
+operation is done in the same precision and order as there, so the
+distances are bit identical. Returns qtrue if the box is in front of a side,
+padding sides are all zero and never are.
+================
+*/
+static qboolean CM_PackedBrushInFront( const traceWork_t *tw, const cbrush_t *brush ) {
+	const int	n = PACKED_SIDES( brush->numsides );
+	const double *nx = brush->packed;
+	const double *ny = nx + n;
+	const double *nz = ny + n;
+	const double *pd = nz + n;
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d sx = _mm_set1_pd( tw->start[0] );
+	const __m128d sy = _mm_set1_pd( tw->start[1] );
+	const __m128d sz = _mm_set1_pd( tw->start[2] );
+	__m128d		x, y, z, t, m, dist, d1;
+	__m128		xf, yf, zf;
+	vec3_t		startp[2];
+	int			i;
+
+	if ( tw->sphere.use ) {
+		const __m128 radius = _mm_set1_ps( tw->sphere.radius );
+		const __m128d ox = _mm_set1_pd( tw->sphere.offset[0] );
+		const __m128d oy = _mm_set1_pd( tw->sphere.offset[1] );
+		const __m128d oz = _mm_set1_pd( tw->sphere.offset[2] );
+		__m128d px[2], py[2], pz[2];
+
+		// closest point on the capsule to a side, see VectorSubtractDP
+		for ( i = 0; i < 3; i++ ) {
+			startp[0][i] = tw->start[i] - tw->sphere.offset[i];
+			startp[1][i] = tw->start[i] + tw->sphere.offset[i];
+		}
+		for ( i = 0; i < 2; i++ ) {
+			px[i] = _mm_set1_pd( startp[i][0] );
+			py[i] = _mm_set1_pd( startp[i][1] );
+			pz[i] = _mm_set1_pd( startp[i][2] );
+		}
+
+		for ( i = 6; i < brush->numsides; i += 2 ) {
+			x = _mm_load_pd( nx + i );
+			y = _mm_load_pd( ny + i );
+			z = _mm_load_pd( nz + i );
+
+			// adjust the plane distance appropriately for radius, in floats
+			dist = _mm_cvtps_pd( _mm_add_ps( _mm_cvtpd_ps( _mm_load_pd( pd + i ) ), radius ) );
+
+			t = DotProductPD( x, y, z, ox, oy, oz );
+			m = _mm_cmpgt_pd( t, zero );
+			d1 = _mm_sub_pd( DotProductPD( SelectPD( m, px[0], px[1] ), SelectPD( m, py[0], py[1] ),
+				SelectPD( m, pz[0], pz[1] ), x, y, z ), dist );
+
+			if ( _mm_movemask_pd( _mm_cmpgt_pd( d1, zero ) ) ) {
+				return qtrue;
+			}
+		}
+	} else {
+		const __m128 zerof = _mm_setzero_ps();
+		__m128 s0[3], s1[3];
+
+		for ( i = 0; i < 3; i++ ) {
+			s0[i] = _mm_set1_ps( tw->size[0][i] );
+			s1[i] = _mm_set1_ps( tw->size[1][i] );
+		}
+
+		for ( i = 6; i < brush->numsides; i += 2 ) {
+			x = _mm_load_pd( nx + i );
+			y = _mm_load_pd( ny + i );
+			z = _mm_load_pd( nz + i );
+
+			// adjust the plane distance appropriately for mins/maxs, in floats,
+			// the offset is picked by the sign of each normal like signbits
+			xf = _mm_cvtpd_ps( x );
+			yf = _mm_cvtpd_ps( y );
+			zf = _mm_cvtpd_ps( z );
+			dist = _mm_cvtps_pd( _mm_sub_ps( _mm_cvtpd_ps( _mm_load_pd( pd + i ) ), DotProductPS(
+				SelectPS( _mm_cmplt_ps( xf, zerof ), s1[0], s0[0] ),
+				SelectPS( _mm_cmplt_ps( yf, zerof ), s1[1], s0[1] ),
+				SelectPS( _mm_cmplt_ps( zf, zerof ), s1[2], s0[2] ), xf, yf, zf ) ) );
+
+			d1 = _mm_sub_pd( DotProductPD( sx, sy, sz, x, y, z ), dist );
+
+			if ( _mm_movemask_pd( _mm_cmpgt_pd( d1, zero ) ) ) {
+				return qtrue;
+			}
+		}
+	}
+
+	return qfalse;
+}
+
+#endif // CM_SIMD_BRUSHES
+
 /*
 ================
 CM_TestBoxInBrush
@@ -189,6 +302,13 @@ static void CM_TestBoxInBrush( traceWork_t *tw, const cbrush_t *brush ) {
 		return;
 	}
 
+#ifdef CM_SIMD_BRUSHES
+	if ( brush->packed && cm_packedBrushes->integer ) {
+		if ( CM_PackedBrushInFront( tw, brush ) ) {
+			return;
+		}
+	} else
+#endif
 	if ( tw->sphere.use ) {
 		// the first six planes are the axial planes, so we only
 		// need to test the remainder
@@ -246,19 +366,21 @@ CM_TestInLeaf
 ================
 */
 static void CM_TestInLeaf( traceWork_t *tw, const cLeaf_t *leaf ) {
+	cTraceState_t *state = tw->state;
 	int			k;
 	int			brushnum;
+	int			patchnum;
 	cbrush_t	*b;
 	cPatch_t	*patch;
 
 	// test box position against all brushes in the leaf
 	for (k=0 ; k<leaf->numLeafBrushes ; k++) {
 		brushnum = cm.leafbrushes[leaf->firstLeafBrush+k];
-		b = &cm.brushes[brushnum];
-		if (b->checkcount == cm.checkcount) {
+		if (state->brushChecks[brushnum] == state->checkcount) {
 			continue;	// already checked this brush in another leaf
 		}
-		b->checkcount = cm.checkcount;
+		state->brushChecks[brushnum] = state->checkcount;
+		b = &cm.brushes[brushnum];
 
 		if ( !(b->contents & tw->contents)) {
 			continue;
@@ -277,14 +399,15 @@ static void CM_TestInLeaf( traceWork_t *tw, const cLeaf_t *leaf ) {
 	if ( !cm_noCurves->integer ) {
 #endif //BSPC
 		for ( k = 0 ; k < leaf->numLeafSurfaces ; k++ ) {
-			patch = cm.surfaces[ cm.leafsurfaces[ leaf->firstLeafSurface + k ] ];
+			patchnum = cm.leafsurfaces[ leaf->firstLeafSurface + k ];
+			patch = cm.surfaces[ patchnum ];
 			if ( !patch ) {
 				continue;
 			}
-			if ( patch->checkcount == cm.checkcount ) {
+			if ( state->patchChecks[patchnum] == state->checkcount ) {
 				continue;	// already checked this brush in another leaf
 			}
-			patch->checkcount = cm.checkcount;
+			state->patchChecks[patchnum] = state->checkcount;
 
 			if ( !(patch->contents & tw->contents)) {
 				continue;
@@ -301,6 +424,58 @@ static void CM_TestInLeaf( traceWork_t *tw, const cLeaf_t *leaf ) {
 }
 
 
+/*
+================
+CM_InitTraceBox
+
+Builds a box brush in the trace work laid out like the one CM_InitBoxHull
+puts into the clip map, so traces through temp boxes don't share it
+================
+*/
+static void CM_InitTraceBox( traceWork_t *tw, const vec3_t mins, const vec3_t maxs ) {
+	cplane_t	*p;
+	int			i;
+
+	for ( i = 0; i < 6; i++ ) {
+		p = &tw->boxPlanes[i];
+		VectorClear( p->normal );
+		if ( i & 1 ) {
+			p->type = 3 + ( i >> 1 );
+			p->normal[i >> 1] = -1;
+			p->dist = -mins[i >> 1];
+		} else {
+			p->type = i >> 1;
+			p->normal[i >> 1] = 1;
+			p->dist = maxs[i >> 1];
+		}
+		SetPlaneSignbits( p );
+
+		tw->boxSides[i].plane = p;
+		tw->boxSides[i].surfaceFlags = 0;
+		tw->boxSides[i].shaderNum = 0;
+	}
+
+	tw->boxBrush.shaderNum = 0;
+	tw->boxBrush.contents = tw->tempBox.contents;
+	VectorCopy( mins, tw->boxBrush.bounds[0] );
+	VectorCopy( maxs, tw->boxBrush.bounds[1] );
+	tw->boxBrush.numsides = 6;
+	tw->boxBrush.sides = tw->boxSides;
+}
+
+
+/*
+================
+CM_TestInTraceBox
+================
+*/
+static void CM_TestInTraceBox( traceWork_t *tw ) {
+	if ( tw->boxBrush.contents & tw->contents ) {
+		CM_TestBoxInBrush( tw, &tw->boxBrush );
+	}
+}
+
+
 /*
 ==================
 CM_TestCapsuleInCapsule
@@ -308,16 +483,15 @@ CM_TestCapsuleInCapsule
 capsule inside capsule check
 ==================
 */
-static void CM_TestCapsuleInCapsule( traceWork_t *tw, clipHandle_t model ) {
+static void CM_TestCapsuleInCapsule( traceWork_t *tw ) {
 	int i;
-	vec3_t mins, maxs;
+	const float *mins = tw->tempBox.mins;
+	const float *maxs = tw->tempBox.maxs;
 	vec3_t top, bottom;
 	vec3_t p1, p2, tmp;
 	vec3_t offset, symetricSize[2];
 	float radius, halfwidth, halfheight, offs, r;
 
-	CM_ModelBounds(model, mins, maxs);
-
 	VectorAdd(tw->start, tw->sphere.offset, top);
 	VectorSubtract(tw->start, tw->sphere.offset, bottom);
 	for ( i = 0 ; i < 3 ; i++ ) {
@@ -378,15 +552,12 @@ CM_TestBoundingBoxInCapsule
 bounding box inside capsule check
 ==================
 */
-static void CM_TestBoundingBoxInCapsule( traceWork_t *tw, clipHandle_t model ) {
-	vec3_t mins, maxs, offset, size[2];
-	clipHandle_t h;
-	cmodel_t *cmod;
+static void CM_TestBoundingBoxInCapsule( traceWork_t *tw ) {
+	const float *mins = tw->tempBox.mins;   // mins maxs of the capsule
+	const float *maxs = tw->tempBox.maxs;
+	vec3_t offset, size[2];
 	int i;
 
-	// mins maxs of the capsule
-	CM_ModelBounds(model, mins, maxs);
-
 	// offset for capsule center
 	for ( i = 0 ; i < 3 ; i++ ) {
 		offset[i] = ( mins[i] + maxs[i] ) * 0.5;
@@ -403,10 +574,9 @@ static void CM_TestBoundingBoxInCapsule( traceWork_t *tw, clipHandle_t model ) {
 	VectorSet( tw->sphere.offset, 0, 0, size[1][2] - tw->sphere.radius );
 
 	// replace the capsule with the bounding box
-	h = CM_TempBoxModel(tw->size[0], tw->size[1], qfalse);
+	CM_InitTraceBox( tw, tw->size[0], tw->size[1] );
 	// calculate collision
-	cmod = CM_ClipHandleToModel( h );
-	CM_TestInLeaf( tw, &cmod->leaf );
+	CM_TestInTraceBox( tw );
 }
 
 
@@ -437,13 +607,8 @@ static void CM_PositionTest( traceWork_t *tw ) {
 	ll.lastLeaf = 0;
 	ll.overflowed = qfalse;
 
-	cm.checkcount++;
-
 	CM_BoxLeafnums_r( &ll, 0 );
 
-
-	cm.checkcount++;
-
 	// test the contents of the leafs
 	for (i=0 ; i < ll.count ; i++) {
 		CM_TestInLeaf( tw, &cm.leafs[leafs[i]] );
@@ -470,7 +635,7 @@ CM_TraceThroughPatch
 static void CM_TraceThroughPatch( traceWork_t *tw, const cPatch_t *patch ) {
 	float		oldFrac;
 
-	c_patch_traces++;
+	tw->state->patchTraces++;
 
 	oldFrac = tw->trace.fraction;
 
@@ -580,6 +745,197 @@ static int CM_TraceThroughBounds( traceWork_t *tw, vec3_t mins, vec3_t maxs ) {
 
 #endif
 
+// the closest crossings of the brush sides found so far
+typedef struct {
+	float		enterFrac;
+	float		leaveFrac;
+	qboolean	getout;
+	qboolean	startout;
+	const cbrushside_t *leadside;
+} brushClip_t;
+
+
+/*
+================
+CM_ClipToBrushSide
+
+Takes the distances of the trace start and end from a side. Returns qfalse
+if the trace is completely in front of it and can't touch the brush.
+================
+*/
+static ID_INLINE qboolean CM_ClipToBrushSide( brushClip_t *bc, const cbrushside_t *side, double d1, double d2 ) {
+	float f;
+
+	if (d2 > 0) {
+		bc->getout = qtrue;	// endpoint is not in solid
+	}
+	if (d1 > 0) {
+		bc->startout = qtrue;
+	}
+
+	// if completely in front of face, no intersection with the entire brush
+	if (d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 )  ) {
+		return qfalse;
+	}
+
+	// if it doesn't cross the plane, the plane isn't relevant
+	if (d1 <= 0 && d2 <= 0 ) {
+		return qtrue;
+	}
+
+	// crosses face
+	if (d1 > d2) {	// enter
+		f = (d1-SURFACE_CLIP_EPSILON) / (d1-d2);
+		if ( f < 0 ) {
+			f = 0;
+		}
+		if (f > bc->enterFrac) {
+			bc->enterFrac = f;
+			bc->leadside = side;
+		}
+	} else {	// leave
+		f = (d1+SURFACE_CLIP_EPSILON) / (d1-d2);
+		if ( f > 1 ) {
+			f = 1;
+		}
+		if (f < bc->leaveFrac) {
+			bc->leaveFrac = f;
+		}
+	}
+
+	return qtrue;
+}
+
+
+#ifdef CM_SIMD_BRUSHES
+/*
+================
+CM_PackedSidesInFront
+
+The early out of CM_ClipToBrushSide for two sides, padding sides are all
+zero and never in front
+================
+*/
+static ID_INLINE qboolean CM_PackedSidesInFront( __m128d d1, __m128d d2 ) {
+	const __m128d front = _mm_and_pd( _mm_cmpgt_pd( d1, _mm_setzero_pd() ),
+		_mm_or_pd( _mm_cmpge_pd( d2, _mm_set1_pd( SURFACE_CLIP_EPSILON ) ), _mm_cmpge_pd( d2, d1 ) ) );
+
+	return _mm_movemask_pd( front ) != 0;
+}
+
+
+/*
+================
+CM_ClipToPackedBrush
+
+The side loops of CM_TraceThroughBrush two sides at a time, with the same
+precision and order of operations so the distances are bit identical.
+As any side the trace is completely in front of ends the test without
+changing anything, all of them are checked for that first.
+================
+*/
+static qboolean CM_ClipToPackedBrush( const traceWork_t *tw, const cbrush_t *brush, brushClip_t *bc ) {
+	const int	n = PACKED_SIDES( brush->numsides );
+	const double *nx = brush->packed;
+	const double *ny = nx + n;
+	const double *nz = ny + n;
+	const double *pd = nz + n;
+	const __m128d zero = _mm_setzero_pd();
+	__m128d		x, y, z, t, m, dist, d1, d2;
+	__m128d		px[2], py[2], pz[2], qx[2], qy[2], qz[2];
+	__m128d		dists[2][ MAX_PACKED_SIDES / 2 ];
+	vec3_t		startp[2], endp[2];
+	int			i;
+
+	if ( tw->sphere.use ) {
+		const __m128 radius = _mm_set1_ps( tw->sphere.radius );
+		const __m128d ox = _mm_set1_pd( tw->sphere.offset[0] );
+		const __m128d oy = _mm_set1_pd( tw->sphere.offset[1] );
+		const __m128d oz = _mm_set1_pd( tw->sphere.offset[2] );
+
+		// closest points on the capsule to a side, see VectorSubtractDP
+		for ( i = 0; i < 3; i++ ) {
+			startp[0][i] = tw->start[i] - tw->sphere.offset[i];
+			startp[1][i] = tw->start[i] + tw->sphere.offset[i];
+			endp[0][i] = tw->end[i] - tw->sphere.offset[i];
+			endp[1][i] = tw->end[i] + tw->sphere.offset[i];
+		}
+		for ( i = 0; i < 2; i++ ) {
+			px[i] = _mm_set1_pd( startp[i][0] );
+			py[i] = _mm_set1_pd( startp[i][1] );
+			pz[i] = _mm_set1_pd( startp[i][2] );
+			qx[i] = _mm_set1_pd( endp[i][0] );
+			qy[i] = _mm_set1_pd( endp[i][1] );
+			qz[i] = _mm_set1_pd( endp[i][2] );
+		}
+
+		for ( i = 0; i < brush->numsides; i += 2 ) {
+			x = _mm_load_pd( nx + i );
+			y = _mm_load_pd( ny + i );
+			z = _mm_load_pd( nz + i );
+
+			// adjust the plane distance appropriately for radius, in floats
+			dist = _mm_cvtps_pd( _mm_add_ps( _mm_cvtpd_ps( _mm_load_pd( pd + i ) ), radius ) );
+
+			t = DotProductPD( x, y, z, ox, oy, oz );
+			m = _mm_cmpgt_pd( t, zero );
+			d1 = _mm_sub_pd( DotProductPD( SelectPD( m, px[0], px[1] ), SelectPD( m, py[0], py[1] ),
+				SelectPD( m, pz[0], pz[1] ), x, y, z ), dist );
+			d2 = _mm_sub_pd( DotProductPD( SelectPD( m, qx[0], qx[1] ), SelectPD( m, qy[0], qy[1] ),
+				SelectPD( m, qz[0], qz[1] ), x, y, z ), dist );
+
+			if ( CM_PackedSidesInFront( d1, d2 ) ) {
+				return qfalse;
+			}
+			dists[0][i >> 1] = d1;
+			dists[1][i >> 1] = d2;
+		}
+	} else {
+		// [0] is the offset for a negative normal component, like signbits
+		for ( i = 0; i < 2; i++ ) {
+			px[i] = _mm_set1_pd( tw->size[i ^ 1][0] );
+			py[i] = _mm_set1_pd( tw->size[i ^ 1][1] );
+			pz[i] = _mm_set1_pd( tw->size[i ^ 1][2] );
+		}
+		qx[0] = _mm_set1_pd( tw->start[0] );
+		qy[0] = _mm_set1_pd( tw->start[1] );
+		qz[0] = _mm_set1_pd( tw->start[2] );
+		qx[1] = _mm_set1_pd( tw->end[0] );
+		qy[1] = _mm_set1_pd( tw->end[1] );
+		qz[1] = _mm_set1_pd( tw->end[2] );
+
+		for ( i = 0; i < brush->numsides; i += 2 ) {
+			x = _mm_load_pd( nx + i );
+			y = _mm_load_pd( ny + i );
+			z = _mm_load_pd( nz + i );
+
+			// adjust the plane distance appropriately for mins/maxs
+			dist = _mm_sub_pd( _mm_load_pd( pd + i ), DotProductPD(
+				SelectPD( _mm_cmplt_pd( x, zero ), px[0], px[1] ),
+				SelectPD( _mm_cmplt_pd( y, zero ), py[0], py[1] ),
+				SelectPD( _mm_cmplt_pd( z, zero ), pz[0], pz[1] ), x, y, z ) );
+
+			d1 = _mm_sub_pd( DotProductPD( qx[0], qy[0], qz[0], x, y, z ), dist );
+			d2 = _mm_sub_pd( DotProductPD( qx[1], qy[1], qz[1], x, y, z ), dist );
+
+			if ( CM_PackedSidesInFront( d1, d2 ) ) {
+				return qfalse;
+			}
+			dists[0][i >> 1] = d1;
+			dists[1][i >> 1] = d2;
+		}
+	}
+
+	// the trace can't be in front of any side anymore
+	for ( i = 0; i < brush->numsides; i++ ) {
+		CM_ClipToBrushSide( bc, brush->sides + i, ( (double *)dists[0] )[i], ( (double *)dists[1] )[i] );
+	}
+
+	return qtrue;
+}
+#endif // CM_SIMD_BRUSHES
+
+
 /*
 ================
 CM_TraceThroughBrush
@@ -587,32 +943,34 @@ CM_TraceThroughBrush
 */
 static void CM_TraceThroughBrush( traceWork_t *tw, const cbrush_t *brush ) {
 	int			i;
-	cplane_t	*plane, *clipplane;
+	cplane_t	*plane;
 	double		dist;
-	float		enterFrac, leaveFrac;
 	double		d1, d2;
-	qboolean	getout, startout;
-	float		f;
-	cbrushside_t	*side, *leadside;
+	cbrushside_t	*side;
 	double		t;
 	vec3_t		startp;
 	vec3_t		endp;
-
-	enterFrac = -1.0;
-	leaveFrac = 1.0;
-	clipplane = NULL;
+	brushClip_t	bc;
 
 	if ( !brush->numsides ) {
 		return;
 	}
 
-	c_brush_traces++;
+	tw->state->brushTraces++;
 
-	getout = qfalse;
-	startout = qfalse;
-
-	leadside = NULL;
+	bc.enterFrac = -1.0;
+	bc.leaveFrac = 1.0;
+	bc.getout = qfalse;
+	bc.startout = qfalse;
+	bc.leadside = NULL;
 
+#ifdef CM_SIMD_BRUSHES
+	if ( brush->packed && cm_packedBrushes->integer ) {
+		if ( !CM_ClipToPackedBrush( tw, brush, &bc ) ) {
+			return;
+		}
+	} else
+#endif
 	if ( tw->sphere.use ) {
 		//
 		// compare the trace against all planes of the brush
@@ -642,43 +1000,9 @@ static void CM_TraceThroughBrush( traceWork_t *tw, const cbrush_t *brush ) {
 			d1 = DotProductDP( startp, plane->normal ) - dist;
 			d2 = DotProductDP( endp, plane->normal ) - dist;
 
-			if (d2 > 0) {
-				getout = qtrue;	// endpoint is not in solid
-			}
-			if (d1 > 0) {
-				startout = qtrue;
-			}
-
-			// if completely in front of face, no intersection with the entire brush
-			if (d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 )  ) {
+			if ( !CM_ClipToBrushSide( &bc, side, d1, d2 ) ) {
 				return;
 			}
-
-			// if it doesn't cross the plane, the plane isn't relevant
-			if (d1 <= 0 && d2 <= 0 ) {
-				continue;
-			}
-
-			// crosses face
-			if (d1 > d2) {	// enter
-				f = (d1-SURFACE_CLIP_EPSILON) / (d1-d2);
-				if ( f < 0 ) {
-					f = 0;
-				}
-				if (f > enterFrac) {
-					enterFrac = f;
-					clipplane = plane;
-					leadside = side;
-				}
-			} else {	// leave
-				f = (d1+SURFACE_CLIP_EPSILON) / (d1-d2);
-				if ( f > 1 ) {
-					f = 1;
-				}
-				if (f < leaveFrac) {
-					leaveFrac = f;
-				}
-			}
 		}
 	} else {
 		//
@@ -696,43 +1020,9 @@ static void CM_TraceThroughBrush( traceWork_t *tw, const cbrush_t *brush ) {
 			d1 = DotProductDP( tw->start, plane->normal ) - dist;
 			d2 = DotProductDP( tw->end, plane->normal ) - dist;
 
-			if (d2 > 0) {
-				getout = qtrue;	// endpoint is not in solid
-			}
-			if (d1 > 0) {
-				startout = qtrue;
-			}
-
-			// if completely in front of face, no intersection with the entire brush
-			if (d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 )  ) {
+			if ( !CM_ClipToBrushSide( &bc, side, d1, d2 ) ) {
 				return;
 			}
-
-			// if it doesn't cross the plane, the plane isn't relevant
-			if (d1 <= 0 && d2 <= 0 ) {
-				continue;
-			}
-
-			// crosses face
-			if (d1 > d2) {	// enter
-				f = (d1-SURFACE_CLIP_EPSILON) / (d1-d2);
-				if ( f < 0 ) {
-					f = 0;
-				}
-				if (f > enterFrac) {
-					enterFrac = f;
-					clipplane = plane;
-					leadside = side;
-				}
-			} else {	// leave
-				f = (d1+SURFACE_CLIP_EPSILON) / (d1-d2);
-				if ( f > 1 ) {
-					f = 1;
-				}
-				if (f < leaveFrac) {
-					leaveFrac = f;
-				}
-			}
 		}
 	}
 
@@ -740,9 +1030,9 @@ static void CM_TraceThroughBrush( traceWork_t *tw, const cbrush_t *brush ) {
 	// all planes have been checked, and the trace was not
 	// completely outside the brush
 	//
-	if (!startout) {	// original point was inside brush
+	if (!bc.startout) {	// original point was inside brush
 		tw->trace.startsolid = qtrue;
-		if (!getout) {
+		if (!bc.getout) {
 			tw->trace.allsolid = qtrue;
 			tw->trace.fraction = 0;
 			tw->trace.contents = brush->contents;
@@ -750,17 +1040,15 @@ static void CM_TraceThroughBrush( traceWork_t *tw, const cbrush_t *brush ) {
 		return;
 	}
 
-	if (enterFrac < leaveFrac) {
-		if (enterFrac > -1 && enterFrac < tw->trace.fraction) {
-			if (enterFrac < 0) {
-				enterFrac = 0;
+	if (bc.enterFrac < bc.leaveFrac) {
+		if (bc.enterFrac > -1 && bc.enterFrac < tw->trace.fraction) {
+			if (bc.enterFrac < 0) {
+				bc.enterFrac = 0;
 			}
-			tw->trace.fraction = enterFrac;
-			if ( clipplane != NULL ) {
-				tw->trace.plane = *clipplane;
-			}
-			if ( leadside != NULL ) {
-				tw->trace.surfaceFlags = leadside->surfaceFlags;
+			tw->trace.fraction = bc.enterFrac;
+			if ( bc.leadside != NULL ) {
+				tw->trace.plane = *bc.leadside->plane;
+				tw->trace.surfaceFlags = bc.leadside->surfaceFlags;
 			}
 			tw->trace.contents = brush->contents;
 		}
@@ -774,8 +1062,10 @@ CM_TraceThroughLeaf
 ================
 */
 static void CM_TraceThroughLeaf( traceWork_t *tw, const cLeaf_t *leaf ) {
+	cTraceState_t *state = tw->state;
 	int k;
 	int brushnum;
+	int patchnum;
 	cbrush_t    *brush;
 	cPatch_t    *patch;
 
@@ -787,11 +1077,11 @@ static void CM_TraceThroughLeaf( traceWork_t *tw, const cLeaf_t *leaf ) {
 	for ( k = 0 ; k < leaf->numLeafBrushes ; k++ ) {
 		brushnum = cm.leafbrushes[leaf->firstLeafBrush + k];
 
-		brush = &cm.brushes[brushnum];
-		if ( brush->checkcount == cm.checkcount ) {
+		if ( state->brushChecks[brushnum] == state->checkcount ) {
 			continue;   // already checked this brush in another leaf
 		}
-		brush->checkcount = cm.checkcount;
+		state->brushChecks[brushnum] = state->checkcount;
+		brush = &cm.brushes[brushnum];
 
 		if ( !( brush->contents & tw->contents ) ) {
 			continue;
@@ -830,14 +1120,15 @@ static void CM_TraceThroughLeaf( traceWork_t *tw, const cLeaf_t *leaf ) {
 	if ( !cm_noCurves->integer ) {
 #endif
 		for ( k = 0 ; k < leaf->numLeafSurfaces ; k++ ) {
-			patch = cm.surfaces[ cm.leafsurfaces[ leaf->firstLeafSurface + k ] ];
+			patchnum = cm.leafsurfaces[ leaf->firstLeafSurface + k ];
+			patch = cm.surfaces[ patchnum ];
 			if ( !patch ) {
 				continue;
 			}
-			if ( patch->checkcount == cm.checkcount ) {
+			if ( state->patchChecks[patchnum] == state->checkcount ) {
 				continue;	// already checked this patch in another leaf
 			}
-			patch->checkcount = cm.checkcount;
+			state->patchChecks[patchnum] = state->checkcount;
 
 			if ( !(patch->contents & tw->contents) ) {
 				continue;
@@ -870,6 +1161,31 @@ static void CM_TraceThroughLeaf( traceWork_t *tw, const cLeaf_t *leaf ) {
 	}
 }
 
+
+/*
+================
+CM_TraceThroughTraceBox
+================
+*/
+static void CM_TraceThroughTraceBox( traceWork_t *tw ) {
+	if ( !( tw->boxBrush.contents & tw->contents ) ) {
+		return;
+	}
+
+#ifdef MRE_OPTIMIZE
+#ifndef BSPC
+	if ( cm_optimize->integer )
+#endif
+	{
+		if ( !CM_TraceThroughBounds( tw, tw->boxBrush.bounds[0], tw->boxBrush.bounds[1] ) ) {
+			return;
+		}
+	}
+#endif
+
+	CM_TraceThroughBrush( tw, &tw->boxBrush );
+}
+
 #define RADIUS_EPSILON		1.0f
 
 /*
@@ -1074,14 +1390,14 @@ CM_TraceCapsuleThroughCapsule
 capsule vs. capsule collision (not rotated)
 ================
 */
-static void CM_TraceCapsuleThroughCapsule( traceWork_t *tw, clipHandle_t model ) {
+static void CM_TraceCapsuleThroughCapsule( traceWork_t *tw ) {
 	int i;
-	vec3_t mins, maxs;
+	const float *mins = tw->tempBox.mins;
+	const float *maxs = tw->tempBox.maxs;
 	vec3_t top, bottom, starttop, startbottom, endtop, endbottom;
 	vec3_t offset, symetricSize[2];
 	float radius, halfwidth, halfheight, offs, h;
 
-	CM_ModelBounds(model, mins, maxs);
 	// test trace bounds vs. capsule bounds
 	if ( tw->bounds[0][0] > maxs[0] + RADIUS_EPSILON
 		|| tw->bounds[0][1] > maxs[1] + RADIUS_EPSILON
@@ -1137,15 +1453,12 @@ CM_TraceBoundingBoxThroughCapsule
 bounding box vs. capsule collision
 ================
 */
-static void CM_TraceBoundingBoxThroughCapsule( traceWork_t *tw, clipHandle_t model ) {
-	vec3_t mins, maxs, offset, size[2];
-	clipHandle_t h;
-	cmodel_t *cmod;
+static void CM_TraceBoundingBoxThroughCapsule( traceWork_t *tw ) {
+	const float *mins = tw->tempBox.mins;   // mins maxs of the capsule
+	const float *maxs = tw->tempBox.maxs;
+	vec3_t offset, size[2];
 	int i;
 
-	// mins maxs of the capsule
-	CM_ModelBounds(model, mins, maxs);
-
 	// offset for capsule center
 	for ( i = 0 ; i < 3 ; i++ ) {
 		offset[i] = ( mins[i] + maxs[i] ) * 0.5;
@@ -1162,10 +1475,9 @@ static void CM_TraceBoundingBoxThroughCapsule( traceWork_t *tw, clipHandle_t mod
 	VectorSet( tw->sphere.offset, 0, 0, size[1][2] - tw->sphere.radius );
 
 	// replace the capsule with the bounding box
-	h = CM_TempBoxModel(tw->size[0], tw->size[1], qfalse);
+	CM_InitTraceBox( tw, tw->size[0], tw->size[1] );
 	// calculate collision
-	cmod = CM_ClipHandleToModel( h );
-	CM_TraceThroughLeaf( tw, &cmod->leaf );
+	CM_TraceThroughTraceBox( tw );
 }
 
 //=========================================================================================
@@ -1306,7 +1618,8 @@ CM_Trace
 ==================
 */
 static void CM_Trace( trace_t *results, const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs,
-						clipHandle_t model, const vec3_t origin, int brushmask, qboolean capsule, const sphere_t *sphere ) {
+						clipHandle_t model, const vec3_t origin, int brushmask, qboolean capsule, const sphere_t *sphere,
+						cTraceState_t *state, const cTempBox_t *tempBox ) {
 	int			i;
 	traceWork_t	tw;
 	vec3_t		offset;
@@ -1320,14 +1633,15 @@ static void CM_Trace( trace_t *results, const vec3_t start, const vec3_t end, co
 
 	cmod = CM_ClipHandleToModel( model );
 
-	cm.checkcount++;		// for multi-check avoidance
+	state->checkcount++;	// for multi-check avoidance
 
-	c_traces++;				// for statistics, may be zeroed
+	state->traces++;		// for statistics, may be zeroed
 
 	// fill in a default trace
 	Com_Memset( &tw, 0, sizeof(tw) );
 	tw.trace.fraction = 1.0f;	// assume it goes the entire distance until shown otherwise
 	VectorCopy(origin, tw.modelOrigin);
+	tw.state = state;
 
 	if (!cm.numNodes) {
 		*results = tw.trace;
@@ -1335,6 +1649,16 @@ static void CM_Trace( trace_t *results, const vec3_t start, const vec3_t end, co
 		return;	// map not loaded, shouldn't happen
 	}
 
+	// take the temp box along, it's traced without going through the clip map
+	if ( model == BOX_MODEL_HANDLE || model == CAPSULE_MODEL_HANDLE ) {
+		if ( tempBox ) {
+			tw.tempBox = *tempBox;
+		} else {
+			CM_GetTempBox( &tw.tempBox );
+		}
+		CM_InitTraceBox( &tw, tw.tempBox.mins, tw.tempBox.maxs );
+	}
+
 	// allow NULL to be passed in for 0,0,0
 	if ( !mins ) {
 		mins = vec3_origin;
@@ -1486,23 +1810,26 @@ static void CM_Trace( trace_t *results, const vec3_t start, const vec3_t end, co
 #ifdef ALWAYS_BBOX_VS_BBOX
 			if ( model == BOX_MODEL_HANDLE || model == CAPSULE_MODEL_HANDLE ) {
 				tw.sphere.use = qfalse;
-				CM_TestInLeaf( &tw, &cmod->leaf );
+				CM_TestInTraceBox( &tw );
 			}
 			else
 #elif defined( ALWAYS_CAPSULE_VS_CAPSULE )
 			if ( model == BOX_MODEL_HANDLE || model == CAPSULE_MODEL_HANDLE ) {
-				CM_TestCapsuleInCapsule( &tw, model );
+				CM_TestCapsuleInCapsule( &tw );
 			}
 			else
 #endif
 			if ( model == CAPSULE_MODEL_HANDLE ) {
 				if ( tw.sphere.use ) {
-					CM_TestCapsuleInCapsule( &tw, model );
+					CM_TestCapsuleInCapsule( &tw );
 				}
 				else {
-					CM_TestBoundingBoxInCapsule( &tw, model );
+					CM_TestBoundingBoxInCapsule( &tw );
 				}
 			}
+			else if ( model == BOX_MODEL_HANDLE ) {
+				CM_TestInTraceBox( &tw );
+			}
 			else {
 				CM_TestInLeaf( &tw, &cmod->leaf );
 			}
@@ -1518,23 +1845,26 @@ static void CM_Trace( trace_t *results, const vec3_t start, const vec3_t end, co
 #ifdef ALWAYS_BBOX_VS_BBOX
 			if ( model == BOX_MODEL_HANDLE || model == CAPSULE_MODEL_HANDLE ) {
 				tw.sphere.use = qfalse;
-				CM_TraceThroughLeaf( &tw, &cmod->leaf );
+				CM_TraceThroughTraceBox( &tw );
 			}
 			else
 #elif defined( ALWAYS_CAPSULE_VS_CAPSULE )
 			if ( model == BOX_MODEL_HANDLE || model == CAPSULE_MODEL_HANDLE ) {
-				CM_TraceCapsuleThroughCapsule( &tw, model );
+				CM_TraceCapsuleThroughCapsule( &tw );
 			}
 			else
 #endif
 			if ( model == CAPSULE_MODEL_HANDLE ) {
 				if ( tw.sphere.use ) {
-					CM_TraceCapsuleThroughCapsule( &tw, model );
+					CM_TraceCapsuleThroughCapsule( &tw );
 				}
 				else {
-					CM_TraceBoundingBoxThroughCapsule( &tw, model );
+					CM_TraceBoundingBoxThroughCapsule( &tw );
 				}
 			}
+			else if ( model == BOX_MODEL_HANDLE ) {
+				CM_TraceThroughTraceBox( &tw );
+			}
 			else {
 				CM_TraceThroughLeaf( &tw, &cmod->leaf );
 			}
@@ -1564,7 +1894,7 @@ CM_BoxTrace
 void CM_BoxTrace( trace_t *results, const vec3_t start, const vec3_t end,
 						const vec3_t mins, const vec3_t maxs,
 						clipHandle_t model, int brushmask, qboolean capsule ) {
-	CM_Trace( results, start, end, mins, maxs, model, vec3_origin, brushmask, capsule, NULL );
+	CM_Trace( results, start, end, mins, maxs, model, vec3_origin, brushmask, capsule, NULL, &cm_traceState, NULL );
 }
 
 
@@ -1650,7 +1980,7 @@ void CM_TransformedBoxTrace( trace_t *results, const vec3_t start, const vec3_t
 	}
 
 	// sweep the box through the model
-	CM_Trace( &trace, start_l, end_l, symetricSize[0], symetricSize[1], model, origin, brushmask, capsule, &sphere );
+	CM_Trace( &trace, start_l, end_l, symetricSize[0], symetricSize[1], model, origin, brushmask, capsule, &sphere, &cm_traceState, NULL );
 
 	// if the bmodel was rotated and there was a collision
 	if ( rotated && trace.fraction != 1.0 ) {
@@ -1667,3 +1997,141 @@ void CM_TransformedBoxTrace( trace_t *results, const vec3_t start, const vec3_t
 
 	*results = trace;
 }
+
+/*
+===============================================================================
+
+BATCHED TRACES
+
+===============================================================================
+*/
+
+// fewer rays than this aren't worth handing over to another thread
+#define TRACE_BATCH_RAYS	32
+
+typedef struct {
+	cmRay_t			*rays;
+	int				numRays;
+	int				raysPerJob;
+	clipHandle_t	model;
+	qboolean		capsule;
+	cTempBox_t		tempBox;
+} traceBatch_t;
+
+// check counts of the batch jobs, the first job uses cm_traceState
+static cTraceState_t *cm_jobStates[ MAX_WORKER_THREADS ];
+
+
+/*
+==================
+CM_FreeTraceStates
+==================
+*/
+void CM_FreeTraceStates( void ) {
+	int i;
+
+	for ( i = 0; i < MAX_WORKER_THREADS; i++ ) {
+		if ( cm_jobStates[ i ] ) {
+			Z_Free( cm_jobStates[ i ] );
+			cm_jobStates[ i ] = NULL;
+		}
+	}
+}
+
+
+/*
+==================
+CM_TraceBatchJob
+==================
+*/
+static void CM_TraceBatchJob( void *data, int index, int worker ) {
+	const traceBatch_t *batch = (const traceBatch_t *)data;
+	cTraceState_t *state;
+	cmRay_t *ray;
+	int i, count;
+
+	state = index ? cm_jobStates[ index ] : &cm_traceState;
+
+	i = index * batch->raysPerJob;
+	count = batch->numRays - i;
+	if ( count > batch->raysPerJob ) {
+		count = batch->raysPerJob;
+	}
+
+	for ( ray = batch->rays + i; count > 0; count--, ray++ ) {
+		CM_Trace( &ray->trace, ray->start, ray->end, ray->mins, ray->maxs, batch->model, vec3_origin,
+			ray->brushmask, batch->capsule, NULL, state, &batch->tempBox );
+	}
+}
+
+
+/*
+==================
+CM_BoxTraceBatch
+
+Same as calling CM_BoxTrace for each ray, but the rays are split across the
+worker threads. The temp box model is taken as it is when this is called.
+==================
+*/
+void CM_BoxTraceBatch( cmRay_t *rays, int numRays, clipHandle_t model, qboolean capsule ) {
+	traceBatch_t batch;
+	cTraceState_t *state;
+	int numJobs, i;
+
+	if ( numRays <= 0 ) {
+		return;
+	}
+
+	// errors must be thrown here rather than on a worker thread
+	CM_ClipHandleToModel( model );
+
+	batch.rays = rays;
+	batch.numRays = numRays;
+	batch.raysPerJob = ( numRays + MAX_WORKER_THREADS - 1 ) / MAX_WORKER_THREADS;
+	if ( batch.raysPerJob < TRACE_BATCH_RAYS ) {
+		batch.raysPerJob = TRACE_BATCH_RAYS;
+	}
+	batch.model = model;
+	batch.capsule = capsule;
+	if ( model == BOX_MODEL_HANDLE || model == CAPSULE_MODEL_HANDLE ) {
+		CM_GetTempBox( &batch.tempBox );
+	}
+
+	numJobs = ( numRays + batch.raysPerJob - 1 ) / batch.raysPerJob;
+
+	for ( i = 1; i < numJobs; i++ ) {
+		if ( !cm_jobStates[ i ] ) {
+			state = Z_Malloc( sizeof( *state ) + ( cm.numBrushes + cm.numSurfaces ) * sizeof( int ) );
+			state->brushChecks = (int *)( state + 1 );
+			state->patchChecks = state->brushChecks + cm.numBrushes;
+			cm_jobStates[ i ] = state;
+		}
+	}
+
+	Sys_RunJobs( CM_TraceBatchJob, &batch, numJobs );
+
+	for ( i = 1; i < numJobs; i++ ) {
+		state = cm_jobStates[ i ];
+		cm_traceState.traces += state->traces;
+		cm_traceState.brushTraces += state->brushTraces;
+		cm_traceState.patchTraces += state->patchTraces;
+		state->traces = state->brushTraces = state->patchTraces = 0;
+	}
+}
+
+
+/*
+==================
+CM_PrintTraceStats
+
+Prints and zeroes the counters shown by com_showtrace
+==================
+*/
+void CM_PrintTraceStats( void ) {
+	Com_Printf( "%4i traces  (%ib %ip) %4i points\n", cm_traceState.traces,
+		cm_traceState.brushTraces, cm_traceState.patchTraces, c_pointcontents );
+	cm_traceState.traces = 0;
+	cm_traceState.brushTraces = 0;
+	cm_traceState.patchTraces = 0;
+	c_pointcontents = 0;
+}
@@ -138,6 +138,10 @@ static int	com_frameNumber;
 int com_expectedhunkusage;
 int com_hunkusedvalue;
 
+// set by the server while it replays a packet journal
+qboolean	com_replay = qfalse;
+int			com_replayTime;
+
 qboolean	com_errorEntered = qfalse;
 qboolean	com_fullyInitialized = qfalse;
 
@@ -4501,18 +4505,11 @@ void Com_Frame( qboolean noDelay ) {
 	// trace optimization tracking
 	//
 	if ( com_showtrace->integer ) {
-
-		extern	int c_traces, c_brush_traces, c_patch_traces;
-		extern	int	c_pointcontents;
-
-		Com_Printf ("%4i traces  (%ib %ip) %4i points\n", c_traces,
-			c_brush_traces, c_patch_traces, c_pointcontents);
-		c_traces = 0;
-		c_brush_traces = 0;
-		c_patch_traces = 0;
-		c_pointcontents = 0;
+		CM_PrintTraceStats();
 	}
 
+	NET_FrameStats();
+
 	com_frameNumber++;
 }
 
@@ -909,6 +909,44 @@ fileHandle_t FS_SV_FOpenFileWrite( const char *filename ) {
 }
 
 
+/*
+===========
+FS_SV_FindOSPath
+
+Returns the OS path of the file FS_SV_FOpenFileRead would open, NULL if there is none
+===========
+*/
+const char *FS_SV_FindOSPath( const char *filename ) {
+	const char *bases[5];
+	fileOffset_t size;
+	fileTime_t mtime, ctime;
+	const char *ospath;
+	int i, numBases;
+
+	numBases = 0;
+	bases[ numBases++ ] = fs_homepath->string;
+	if ( Q_stricmp( fs_homepath->string, fs_basepath->string ) != 0 )
+		bases[ numBases++ ] = fs_basepath->string;
+	if ( fs_steampath->string[0] )
+		bases[ numBases++ ] = fs_steampath->string;
+	if ( fs_gogpath->string[0] )
+		bases[ numBases++ ] = fs_gogpath->string;
+#ifdef _WIN32
+	if ( fs_msstorepath->string[0] )
+		bases[ numBases++ ] = fs_msstorepath->string;
+#endif
+
+	for ( i = 0; i < numBases; i++ ) {
+		ospath = FS_BuildOSPath( bases[i], filename, NULL );
+		if ( Sys_GetFileStats( ospath, &size, &mtime, &ctime ) ) {
+			return ospath;
+		}
+	}
+
+	return NULL;
+}
+
+
 /*
 ===========
 FS_SV_FOpenFileRead
@@ -208,4 +208,93 @@ int HuffmanGetSymbol( unsigned int* symbol, const byte* buffer, int bitIndex )
 	*symbol = (unsigned int)(entry & 0xFF);
 
 	return (int)(entry >> 8);
-}
\ No newline at end of file
+}
+
+
+/*
+=================
+HuffmanPutBits
+
+Writes bits&7 raw bits followed by one code per remaining byte of value,
+exactly as a sequence of HuffmanPutBit/HuffmanPutSymbol calls would, but
+gathers the whole field in a 64-bit accumulator and stores it bytewise:
+at most 7 + 7 + 4 * 11 bits are ever pending.
+Returns the number of bits written.
+=================
+*/
+int HuffmanPutBits( byte *fout, int32_t bitIndex, uint32_t value, int bits )
+{
+	const int nbits = bits & 7;
+	const int shift = bitIndex & 7;
+	byte *out = fout + ( bitIndex >> 3 );
+	uint64_t acc;
+	uint16_t result;
+	int count, i;
+
+	acc = value & ( ( 1U << nbits ) - 1 );
+	count = nbits;
+	value >>= nbits;
+
+	for ( i = nbits; i < bits; i += 8 )
+	{
+		result = HuffmanEncoderTable[ value & 0xFF ];
+		acc |= (uint64_t)( ( result >> 4 ) & 0x7FF ) << count;
+		count += result & 15;
+		value >>= 8;
+	}
+
+	acc <<= shift;
+
+	// preserve already written bits of the first byte, overwrite the rest
+	if ( shift )
+		out[0] |= (byte)acc;
+	else
+		out[0] = (byte)acc;
+
+	for ( i = 8; i < shift + count; i += 8 )
+		out[ i >> 3 ] = (byte)( acc >> i );
+
+	return count;
+}
+
+
+/*
+=================
+HuffmanGetBits
+
+Reverse of HuffmanPutBits: extracts bits&7 raw bits with a single shift
+and decodes every following symbol with one 11-bit table lookup.
+Advances *bitIndex and returns assembled value.
+=================
+*/
+uint32_t HuffmanGetBits( const byte *buffer, int32_t *bitIndex, int bits )
+{
+	const int nbits = bits & 7;
+	int32_t index = *bitIndex;
+	uint32_t value, code;
+	uint16_t entry;
+	int i;
+
+	if ( nbits )
+	{
+		value = ( buffer[ index >> 3 ] | ( buffer[ ( index >> 3 ) + 1 ] << 8 ) ) >> ( index & 7 );
+		value &= ( 1U << nbits ) - 1;
+		index += nbits;
+	}
+	else
+	{
+		value = 0;
+	}
+
+	for ( i = nbits; i < bits; i += 8 )
+	{
+		code = ( (*(const uint32_t*)(buffer + (index >> 3))) >> ((uint32_t)index & 7) ) & 0x7FF;
+		entry = HuffmanDecoderTable[ code ];
+		value |= (uint32_t)( entry & 0xFF ) << i;
+		index += entry >> 8;
+	}
+
+	*bitIndex = index;
+
+	return value;
+}
@@ -111,8 +111,6 @@ bit functions
 
 // negative bit values include signs
 void MSG_WriteBits( msg_t *msg, int value, int bits ) {
-	int	i;
-
 	msg->uncompsize += bits;            // NERVE - SMF - net debugging
 
 	if ( bits == 0 || bits < -31 || bits > 32 ) {
@@ -145,22 +143,7 @@ void MSG_WriteBits( msg_t *msg, int value, int bits ) {
 		}
 	} else {
 		value &= (0xffffffff>>(32-bits));
-		if ( bits & 7 ) {
-			int nbits;
-			nbits = bits&7;
-			for ( i = 0; i < nbits ; i++ ) {
-				HuffmanPutBit( msg->data, msg->bit, (value & 1) );
-				msg->bit++;
-				value = (value>>1);
-			}
-			bits = bits - nbits;
-		}
-		if ( bits ) {
-			for( i = 0 ; i < bits ; i += 8 ) {
-				msg->bit += HuffmanPutSymbol( msg->data, msg->bit, (value & 0xFF) );
-				value = (value>>8);
-			}
-		}
+		msg->bit += HuffmanPutBits( msg->data, msg->bit, value, bits );
 		msg->cursize = (msg->bit>>3)+1;
 	}
 
@@ -173,8 +156,6 @@ void MSG_WriteBits( msg_t *msg, int value, int bits ) {
 int MSG_ReadBits( msg_t *msg, int bits ) {
 	int		value;
 	qboolean	sgn;
-	int		i;
-	unsigned int	sym;
 	const byte *buffer = msg->data; // dereference optimization
 
 	if ( msg->bit >= msg->maxbits )
@@ -213,24 +194,9 @@ int MSG_ReadBits( msg_t *msg, int bits ) {
 		else
 			Com_Error( ERR_DROP, "can't read %d bits", bits );
 	} else {
-		const int nbits = bits & 7;
 		int bitIndex = msg->bit; // dereference optimization
-		if ( nbits )
-		{		
-			for ( i = 0; i < nbits; i++ ) {
-				value |= HuffmanGetBit( buffer, bitIndex ) << i;
-				bitIndex++;
-			}
-			bits -= nbits;
-		}
-		if ( bits )
-		{
-			for ( i = 0; i < bits; i += 8 )
-			{
-				bitIndex += HuffmanGetSymbol( &sym, buffer, bitIndex );
-				value |= ( sym << (i+nbits) );
-			}
-		}
+		value = HuffmanGetBits( buffer, &bitIndex, bits );
+		bits -= bits & 7; // sign extension below has always used the symbol part only
 		msg->bit = bitIndex;
 		msg->readcount = (bitIndex >> 3) + 1;
 	}
@@ -279,6 +245,51 @@ void MSG_WriteData( msg_t *buf, const void *data, int length ) {
 	}
 }
 
+/*
+=================
+MSG_WriteBitStream
+
+Appends everything written to src, which must be a bitstream message
+started at bit 0. Huffman codes do not depend on their position, so the
+encoded bits are copied as is, shifted to the current bit of msg
+=================
+*/
+void MSG_WriteBitStream( msg_t *msg, const msg_t *src ) {
+	const int shift = msg->bit & 7;
+	const byte *in = src->data;
+	byte *out;
+	int i, n, last;
+
+	msg->uncompsize += src->uncompsize;
+
+	if ( msg->overflowed != qfalse || src->bit == 0 )
+		return;
+
+	if ( msg->bit + src->bit > msg->maxbits ) {
+		msg->overflowed = qtrue;
+		return;
+	}
+
+	out = msg->data + ( msg->bit >> 3 );
+	n = ( src->bit + 7 ) >> 3;
+
+	if ( shift == 0 ) {
+		Com_Memcpy( out, in, n );
+	} else {
+		// bits past the current one are always zero, see HuffmanPutBits
+		last = ( shift + src->bit - 1 ) >> 3;
+		for ( i = 0; i < n; i++ ) {
+			out[i] |= (byte)( in[i] << shift );
+			if ( i + 1 <= last ) {
+				out[i+1] = in[i] >> ( 8 - shift );
+			}
+		}
+	}
+
+	msg->bit += src->bit;
+	msg->cursize = ( msg->bit >> 3 ) + 1;
+}
+
 void MSG_WriteShort( msg_t *sb, int c ) {
 #ifdef PARANOID
 	if ( c < ( (short)0x8000 ) || c > (short)0x7fff ) {
@@ -519,6 +519,11 @@ void NET_FlushPacketQueue( void )
 	packetQueue_t *last;
 	int now;
 
+	if ( !packetQueue )
+		return;
+
+	NET_BeginSendBatch();
+
 	while ( packetQueue ) {
 		now = Sys_Milliseconds();
 		if ( packetQueue->release - now >= 0 )
@@ -539,6 +544,8 @@ void NET_FlushPacketQueue( void )
 		Z_Free( last->data );
 		Z_Free( last );
 	}
+
+	NET_EndSendBatch();
 }
 
 
@@ -20,6 +20,12 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 ===========================================================================
 */
 
+#ifdef __linux__
+#	ifndef _GNU_SOURCE
+#		define _GNU_SOURCE	// recvmmsg/sendmmsg
+#	endif
+#endif
+
 #include "../qcommon/q_shared.h"
 #include "../qcommon/qcommon.h"
 
@@ -93,6 +99,11 @@ static qboolean	winsockInitialized = qfalse;
 #		include <sys/filio.h>
 #	endif
 
+#	ifdef __linux__
+#		include <sys/epoll.h>
+#		define USE_NET_BATCH	// epoll + recvmmsg/sendmmsg backend
+#	endif
+
 typedef int SOCKET;
 #	define INVALID_SOCKET		-1
 #	define SOCKET_ERROR			-1
@@ -175,6 +186,8 @@ static cvar_t	*net_mcast6addr;
 static cvar_t	*net_mcast6iface;
 #endif
 static cvar_t	*net_dropsim;
+static cvar_t	*net_batchIO;
+static cvar_t	*net_showstats;
 
 static sockaddr_t socksRelayAddr;
 
@@ -215,6 +228,63 @@ static int numIP;
 
 static void	NET_Restart_f( void );
 
+// socket syscalls issued during current frame, see net_showstats
+typedef struct {
+	int		waits;			// select() / epoll_wait()
+	int		recvCalls;		// recvfrom() / recvmmsg()
+	int		recvPackets;
+	int		sendCalls;		// sendto() / sendmmsg()
+	int		sendPackets;
+} netStats_t;
+
+static netStats_t netStats;
+
+#ifdef USE_NET_BATCH
+#define NET_BATCH_SIZE		32			// datagrams per recvmmsg()/sendmmsg() call
+#define NET_SENDQUEUE_SIZE	64
+#define NET_SENDQUEUE_DATA	(NET_SENDQUEUE_SIZE*MAX_PACKETLEN)
+
+static int epoll_fd = INVALID_SOCKET;
+
+// receive ring, drained by a single recvmmsg() call
+static byte recvData[ NET_BATCH_SIZE ][ MAX_MSGLEN_BUF ];
+
+// outgoing datagrams collected between NET_BeginSendBatch() and NET_EndSendBatch()
+typedef struct {
+	SOCKET			sock;
+	netadrtype_t	type;
+	sockaddr_t		addr;
+	struct iovec	iov;
+} netSendEntry_t;
+
+static struct {
+	netSendEntry_t	entries[ NET_SENDQUEUE_SIZE ];
+	struct mmsghdr	hdrs[ NET_SENDQUEUE_SIZE ];
+	byte			data[ NET_SENDQUEUE_DATA ];
+	int				count;
+	int				dataUsed;
+} sendQueue;
+
+
+/*
+====================
+NET_CloseBatchIO
+
+Drops the epoll instance, NET_InitBatchIO picks up the current set of
+sockets the next time
+====================
+*/
+static void NET_CloseBatchIO( void )
+{
+	if ( epoll_fd != INVALID_SOCKET ) {
+		close( epoll_fd );
+		epoll_fd = INVALID_SOCKET;
+	}
+}
+#endif
+
+static int sendBatchDepth;
+
 //=============================================================================
 
 
@@ -639,126 +709,223 @@ qboolean NET_IsLocalAddress( const netadr_t *adr )
 
 /*
 ==================
-NET_GetPacket
+NET_ReadPacket
 
-Receive one packet
+Converts a datagram received on sock to net_from/net_message
 ==================
 */
-static qboolean NET_GetPacket( netadr_t *net_from, msg_t *net_message, const fd_set *fdr )
+static qboolean NET_ReadPacket( SOCKET sock, sockaddr_t *from, socklen_t fromlen, int ret, netadr_t *net_from, msg_t *net_message )
+{
+	if ( sock == ip_socket )
+	{
+		memset( &from->v4.sin_zero, 0, sizeof( from->v4.sin_zero ) );
+
+		if ( usingSocks && memcmp( from, &socksRelayAddr, fromlen ) == 0 ) {
+			if ( ret < 10 || net_message->data[0] != 0 || net_message->data[1] != 0 || net_message->data[2] != 0 || net_message->data[3] != 1 ) {
+				return qfalse;
+			}
+			net_from->type = NA_IP;
+			net_from->ipv._4[0] = net_message->data[4];
+			net_from->ipv._4[1] = net_message->data[5];
+			net_from->ipv._4[2] = net_message->data[6];
+			net_from->ipv._4[3] = net_message->data[7];
+			net_from->port = *(uint16_t *)&net_message->data[8];
+			net_message->readcount = 10;
+		}
+		else {
+			net_from->type = NA_BAD;
+			SockadrToNetadr( from, net_from );
+			net_message->readcount = 0;
+		}
+	}
+	else
+	{
+		net_from->type = NA_BAD;
+		SockadrToNetadr( from, net_from );
+		net_message->readcount = 0;
+	}
+
+	if( ret >= net_message->maxsize ) {
+		Com_Printf( "Oversize packet from %s\n", NET_AdrToString( net_from ) );
+		return qfalse;
+	}
+
+	net_message->cursize = ret;
+	return qtrue;
+}
+
+
+/*
+==================
+NET_RecvFrom
+
+Receive one packet from sock, returns qfalse if nothing was received
+==================
+*/
+static qboolean NET_RecvFrom( SOCKET sock, netadr_t *net_from, msg_t *net_message, qboolean *valid )
 {
 	int 	ret;
 	sockaddr_t	from;
 	socklen_t	fromlen;
 	int		err;
 
-	if(ip_socket != INVALID_SOCKET && FD_ISSET(ip_socket, fdr))
+	fromlen = sizeof(from);
+	ret = recvfrom( sock, (void *)net_message->data, net_message->maxsize, 0, (struct sockaddr *) &from, &fromlen );
+	netStats.recvCalls++;
+
+	if (ret == SOCKET_ERROR)
 	{
-		fromlen = sizeof(from);
-		ret = recvfrom( ip_socket, (void *)net_message->data, net_message->maxsize, 0, (struct sockaddr *) &from, &fromlen );
+		err = socketError;
 
-		if (ret == SOCKET_ERROR)
-		{
-			err = socketError;
+		if( err != EAGAIN && err != ECONNRESET )
+			Com_Printf( "NET_GetPacket: %s\n", NET_ErrorString() );
 
-			if( err != EAGAIN && err != ECONNRESET )
-				Com_Printf( "NET_GetPacket: %s\n", NET_ErrorString() );
-		}
-		else
-		{
-			memset( &from.v4.sin_zero, 0, sizeof( from.v4.sin_zero ) );
+		return qfalse;
+	}
 
-			if ( usingSocks && memcmp( &from, &socksRelayAddr, fromlen ) == 0 ) {
-				if ( ret < 10 || net_message->data[0] != 0 || net_message->data[1] != 0 || net_message->data[2] != 0 || net_message->data[3] != 1 ) {
-					return qfalse;
-				}
-				net_from->type = NA_IP;
-				net_from->ipv._4[0] = net_message->data[4];
-				net_from->ipv._4[1] = net_message->data[5];
-				net_from->ipv._4[2] = net_message->data[6];
-				net_from->ipv._4[3] = net_message->data[7];
-				net_from->port = *(uint16_t *)&net_message->data[8];
-				net_message->readcount = 10;
-			}
-			else {
-				net_from->type = NA_BAD;
-				SockadrToNetadr( &from, net_from );
-				net_message->readcount = 0;
-			}
+	netStats.recvPackets++;
 
-			if( ret >= net_message->maxsize ) {
-				Com_Printf( "Oversize packet from %s\n", NET_AdrToString( net_from ) );
-				return qfalse;
-			}
+	*valid = NET_ReadPacket( sock, &from, fromlen, ret, net_from, net_message );
+	return qtrue;
+}
 
-			net_message->cursize = ret;
-			return qtrue;
-		}
+
+/*
+==================
+NET_GetPacket
+
+Receive one packet
+==================
+*/
+static qboolean NET_GetPacket( netadr_t *net_from, msg_t *net_message, const fd_set *fdr )
+{
+	qboolean valid;
+
+	if(ip_socket != INVALID_SOCKET && FD_ISSET(ip_socket, fdr))
+	{
+		if ( NET_RecvFrom( ip_socket, net_from, net_message, &valid ) )
+			return valid;
 	}
 
 #ifdef USE_IPV6
 	if(ip6_socket != INVALID_SOCKET && FD_ISSET(ip6_socket, fdr))
 	{
-		fromlen = sizeof(from);
-		ret = recvfrom(ip6_socket, (void *)net_message->data, net_message->maxsize, 0, (struct sockaddr *) &from, &fromlen);
+		if ( NET_RecvFrom( ip6_socket, net_from, net_message, &valid ) )
+			return valid;
+	}
 
-		if (ret == SOCKET_ERROR)
-		{
-			err = socketError;
+	if(multicast6_socket != INVALID_SOCKET && multicast6_socket != ip6_socket && FD_ISSET(multicast6_socket, fdr))
+	{
+		if ( NET_RecvFrom( multicast6_socket, net_from, net_message, &valid ) )
+			return valid;
+	}
+#endif // USE_IPV6
 
-			if( err != EAGAIN && err != ECONNRESET )
-				Com_Printf( "NET_GetPacket: %s\n", NET_ErrorString() );
-		}
-		else
-		{
-			net_from->type = NA_BAD;
-			SockadrToNetadr( &from, net_from );
-			net_message->readcount = 0;
+	return qfalse;
+}
 
-			if(ret >= net_message->maxsize)
-			{
-				Com_Printf( "Oversize packet from %s\n", NET_AdrToString( net_from ) );
-				return qfalse;
-			}
-			
-			net_message->cursize = ret;
-			return qtrue;
-		}
+//=============================================================================
+
+
+/*
+==================
+NET_SendError
+==================
+*/
+static void NET_SendError( netadrtype_t type )
+{
+	int err = socketError;
+
+	// wouldblock is silent
+	if( err == EAGAIN ) {
+		return;
 	}
 
-	if(multicast6_socket != INVALID_SOCKET && multicast6_socket != ip6_socket && FD_ISSET(multicast6_socket, fdr))
-	{
-		fromlen = sizeof(from);
-		ret = recvfrom(multicast6_socket, (void *)net_message->data, net_message->maxsize, 0, (struct sockaddr *) &from, &fromlen);
+	// some PPP links do not allow broadcasts and return an error
+	if( ( err == EADDRNOTAVAIL ) && ( type == NA_BROADCAST ) ) {
+		return;
+	}
 
-		if (ret == SOCKET_ERROR)
-		{
-			err = socketError;
+	Com_Printf( "Sys_SendPacket: %s\n", NET_ErrorString() );
+}
 
-			if( err != EAGAIN && err != ECONNRESET )
-				Com_Printf( "NET_GetPacket: %s\n", NET_ErrorString() );
+
+#ifdef USE_NET_BATCH
+/*
+==================
+NET_FlushSendQueue
+
+Passes queued datagrams to sendmmsg(), one call per socket run
+==================
+*/
+static void NET_FlushSendQueue( void )
+{
+	int start, count, ret;
+
+	for ( start = 0; start < sendQueue.count; start += ret ) {
+		const SOCKET sock = sendQueue.entries[ start ].sock;
+
+		for ( count = 1; start + count < sendQueue.count; count++ ) {
+			if ( sendQueue.entries[ start + count ].sock != sock )
+				break;
 		}
-		else
-		{
-			net_from->type = NA_BAD;
-			SockadrToNetadr( &from, net_from );
-			net_message->readcount = 0;
 
-			if(ret >= net_message->maxsize)
-			{
-				Com_Printf( "Oversize packet from %s\n", NET_AdrToString( net_from ) );
-				return qfalse;
-			}
+		ret = sendmmsg( sock, &sendQueue.hdrs[ start ], count, 0 );
+		netStats.sendCalls++;
 
-			net_message->cursize = ret;
-			return qtrue;
+		if ( ret <= 0 ) {
+			// first datagram failed, report and skip it
+			NET_SendError( sendQueue.entries[ start ].type );
+			ret = 1;
+		} else {
+			netStats.sendPackets += ret;
 		}
 	}
-#endif // USE_IPV6
 
-	return qfalse;
+	sendQueue.count = 0;
+	sendQueue.dataUsed = 0;
 }
 
-//=============================================================================
+
+/*
+==================
+NET_QueueSend
+
+Returns qfalse if datagram should be sent immediately
+==================
+*/
+static qboolean NET_QueueSend( SOCKET sock, const sockaddr_t *addr, const void *data, int length, netadrtype_t type )
+{
+	netSendEntry_t *entry;
+	struct msghdr *hdr;
+
+	if ( sendBatchDepth <= 0 || !net_batchIO->integer || length > NET_SENDQUEUE_DATA )
+		return qfalse;
+
+	if ( sendQueue.count >= NET_SENDQUEUE_SIZE || sendQueue.dataUsed + length > NET_SENDQUEUE_DATA )
+		NET_FlushSendQueue();
+
+	entry = &sendQueue.entries[ sendQueue.count ];
+	entry->sock = sock;
+	entry->type = type;
+	entry->addr = *addr;
+	entry->iov.iov_base = sendQueue.data + sendQueue.dataUsed;
+	entry->iov.iov_len = length;
+	memcpy( entry->iov.iov_base, data, length );
+
+	hdr = &sendQueue.hdrs[ sendQueue.count ].msg_hdr;
+	memset( hdr, 0, sizeof( *hdr ) );
+	hdr->msg_name = &entry->addr;
+	hdr->msg_namelen = ( addr->ss.ss_family == AF_INET ) ? sizeof( struct sockaddr_in ) : sizeof( struct sockaddr_in6 );
+	hdr->msg_iov = &entry->iov;
+	hdr->msg_iovlen = 1;
+
+	sendQueue.dataUsed += length;
+	sendQueue.count++;
+
+	return qtrue;
+}
+#endif // USE_NET_BATCH
 
 
 /*
@@ -770,6 +937,11 @@ void Sys_SendPacket( int length, const void *data, const netadr_t *to ) {
 	int ret = SOCKET_ERROR;
 	sockaddr_t addr;
 
+	// replayed clients are not listening
+	if ( com_replay ) {
+		return;
+	}
+
 	switch ( to->type ) {
 		case NA_BROADCAST:
 		case NA_IP:
@@ -811,31 +983,68 @@ void Sys_SendPacket( int length, const void *data, const netadr_t *to ) {
 			cmd.s.u.v4.port = addr.v4.sin_port;
 			memcpy( cmd.s.u.v4.data, data, length );
 			ret = sendto( ip_socket, cmd.buf, length + 10, 0, ( struct sockaddr * ) &socksRelayAddr.v4, sizeof( socksRelayAddr.v4 ) );
+			netStats.sendCalls++;
 		}
 	}
 	else {
-		if ( addr.ss.ss_family == AF_INET )
-			ret = sendto( ip_socket, data, length, 0, (struct sockaddr *) &addr, sizeof(struct sockaddr_in) );
+		SOCKET sock = INVALID_SOCKET;
+		socklen_t addrlen = 0;
+
+		if ( addr.ss.ss_family == AF_INET ) {
+			sock = ip_socket;
+			addrlen = sizeof( struct sockaddr_in );
+		}
 #ifdef USE_IPV6
-		else if ( addr.ss.ss_family == AF_INET6 )
-			ret = sendto( ip6_socket, data, length, 0, (struct sockaddr *) &addr, sizeof(struct sockaddr_in6) );
+		else if ( addr.ss.ss_family == AF_INET6 ) {
+			sock = ip6_socket;
+			addrlen = sizeof( struct sockaddr_in6 );
+		}
 #endif
+		if ( sock != INVALID_SOCKET ) {
+#ifdef USE_NET_BATCH
+			if ( NET_QueueSend( sock, &addr, data, length, to->type ) )
+				return;
+#endif
+			ret = sendto( sock, data, length, 0, (struct sockaddr *) &addr, addrlen );
+			netStats.sendCalls++;
+		}
 	}
 
-	if( ret == SOCKET_ERROR ) {
-		int err = socketError;
+	if ( ret == SOCKET_ERROR )
+		NET_SendError( to->type );
+	else
+		netStats.sendPackets++;
+}
+
 
-		// wouldblock is silent
-		if( err == EAGAIN ) {
-			return;
-		}
+/*
+==================
+NET_BeginSendBatch
 
-		// some PPP links do not allow broadcasts and return an error
-		if( ( err == EADDRNOTAVAIL ) && ( to->type == NA_BROADCAST ) ) {
-			return;
-		}
+Datagrams sent until matching NET_EndSendBatch() call may be
+collected and passed to the kernel in as few syscalls as possible
+==================
+*/
+void NET_BeginSendBatch( void )
+{
+	sendBatchDepth++;
+}
+
+
+/*
+==================
+NET_EndSendBatch
+==================
+*/
+void NET_EndSendBatch( void )
+{
+	if ( sendBatchDepth <= 0 )
+		return;
 
-		Com_Printf( "Sys_SendPacket: %s\n", NET_ErrorString() );
+	if ( --sendBatchDepth == 0 ) {
+#ifdef USE_NET_BATCH
+		NET_FlushSendQueue();
+#endif
 	}
 }
 
@@ -1158,6 +1367,11 @@ void NET_JoinMulticast6( void )
 	
 	if(ip6_socket == INVALID_SOCKET || multicast6_socket != INVALID_SOCKET || (net_enabled->integer & NET_DISABLEMCAST))
 		return;
+
+#ifdef USE_NET_BATCH
+	// a separate multicast socket has to be watched as well
+	NET_CloseBatchIO();
+#endif
 	
 	if(IN6_IS_ADDR_MULTICAST(&boundto.sin6_addr) || IN6_IS_ADDR_UNSPECIFIED(&boundto.sin6_addr))
 	{
@@ -1207,6 +1421,10 @@ void NET_LeaveMulticast6( void )
 {
 	if(multicast6_socket != INVALID_SOCKET)
 	{
+#ifdef USE_NET_BATCH
+		NET_CloseBatchIO();
+#endif
+
 		if(multicast6_socket != ip6_socket)
 			closesocket(multicast6_socket);
 		else
@@ -1684,6 +1902,18 @@ static qboolean NET_GetCvars( void ) {
 	net_dropsim = Cvar_Get( "net_dropsim", "", CVAR_TEMP );
 	Cvar_SetDescription( net_dropsim, "Simulated packet drops" );
 
+	net_batchIO = Cvar_Get( "net_batchIO", "1", CVAR_ARCHIVE_ND );
+	Cvar_CheckRange( net_batchIO, "0", "1", CV_INTEGER );
+#ifdef USE_NET_BATCH
+	Cvar_SetDescription( net_batchIO, "Use epoll() and batched recvmmsg()/sendmmsg() socket calls instead of select() and per-packet calls" );
+#else
+	Cvar_SetDescription( net_batchIO, "Batched socket calls, not available on this platform" );
+#endif
+
+	net_showstats = Cvar_Get( "net_showstats", "0", CVAR_TEMP );
+	Cvar_CheckRange( net_showstats, "0", "1", CV_INTEGER );
+	Cvar_SetDescription( net_showstats, "Print number of socket syscalls and datagrams per frame" );
+
 	return modified ? qtrue : qfalse;
 }
 
@@ -1733,6 +1963,10 @@ static void NET_Config( qboolean enableNetworking ) {
 	}
 
 	if( stop ) {
+#ifdef USE_NET_BATCH
+		NET_FlushSendQueue();
+		NET_CloseBatchIO();
+#endif
 		if ( ip_socket != INVALID_SOCKET ) {
 			closesocket( ip_socket );
 			ip_socket = INVALID_SOCKET;
@@ -1815,6 +2049,31 @@ NET_Shutdown
 }*/
 
 
+/*
+====================
+NET_DispatchPacket
+====================
+*/
+static void NET_DispatchPacket( const netadr_t *from, msg_t *netmsg )
+{
+	if ( net_dropsim->value > 0.0f && net_dropsim->value <= 100.0f )
+	{
+		// com_dropsim->value percent of incoming packets get dropped.
+		if ( rand() < (int) (((double) RAND_MAX) / 100.0 * (double) net_dropsim->value) )
+			return; // drop this packet
+	}
+
+#ifdef DEDICATED
+	Com_RunAndTimeServerPacket( from, netmsg );
+#else
+	if ( com_sv_running->integer || com_dedicated->integer )
+		Com_RunAndTimeServerPacket( from, netmsg );
+	else
+		CL_PacketEvent( from, netmsg );
+#endif
+}
+
+
 /*
 ====================
 NET_Event
@@ -1833,29 +2092,157 @@ static void NET_Event( const fd_set *fdr )
 		MSG_Init( &netmsg, bufData, MAX_MSGLEN );
 
 		if ( NET_GetPacket( &from, &netmsg, fdr ) )
-		{
-			if ( net_dropsim->value > 0.0f && net_dropsim->value <= 100.0f )
-			{
-				// com_dropsim->value percent of incoming packets get dropped.
-				if ( rand() < (int) (((double) RAND_MAX) / 100.0 * (double) net_dropsim->value) )
-					continue; // drop this packet
-			}
+			NET_DispatchPacket( &from, &netmsg );
+		else
+			break;
+	}
+}
 
-#ifdef DEDICATED
-			Com_RunAndTimeServerPacket( &from, &netmsg );
+
+#ifdef USE_NET_BATCH
+/*
+====================
+NET_BatchEvent
+
+Drains sock with recvmmsg() into the receive ring, responses
+generated while handling the batch are sent together
+====================
+*/
+static void NET_BatchEvent( SOCKET sock )
+{
+	struct mmsghdr hdrs[ NET_BATCH_SIZE ];
+	struct iovec iov[ NET_BATCH_SIZE ];
+	sockaddr_t addrs[ NET_BATCH_SIZE ];
+	netadr_t from;
+	msg_t netmsg;
+	int i, ret;
+
+	do {
+		memset( hdrs, 0, sizeof( hdrs ) );
+		for ( i = 0; i < NET_BATCH_SIZE; i++ ) {
+			iov[i].iov_base = recvData[i];
+			iov[i].iov_len = MAX_MSGLEN;
+			hdrs[i].msg_hdr.msg_name = &addrs[i];
+			hdrs[i].msg_hdr.msg_namelen = sizeof( addrs[i] );
+			hdrs[i].msg_hdr.msg_iov = &iov[i];
+			hdrs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		ret = recvmmsg( sock, hdrs, NET_BATCH_SIZE, MSG_DONTWAIT, NULL );
+		netStats.recvCalls++;
+
+		if ( ret == SOCKET_ERROR ) {
+			const int err = socketError;
+			if ( err != EAGAIN && err != ECONNRESET && err != EINTR )
+				Com_Printf( "NET_GetPacket: %s\n", NET_ErrorString() );
+			return;
+		}
+
+		netStats.recvPackets += ret;
+
+		NET_BeginSendBatch();
+
+		for ( i = 0; i < ret; i++ ) {
+			MSG_Init( &netmsg, recvData[i], MAX_MSGLEN );
+			if ( NET_ReadPacket( sock, &addrs[i], hdrs[i].msg_hdr.msg_namelen, hdrs[i].msg_len, &from, &netmsg ) )
+				NET_DispatchPacket( &from, &netmsg );
+			// packet handlers may restart networking
+			if ( epoll_fd == INVALID_SOCKET )
+				break;
+		}
+
+		NET_EndSendBatch();
+
+	} while ( ret == NET_BATCH_SIZE && epoll_fd != INVALID_SOCKET );
+}
+
+
+/*
+====================
+NET_InitBatchIO
+
+Lazily creates epoll instance for currently opened sockets
+====================
+*/
+static qboolean NET_InitBatchIO( void )
+{
+	struct epoll_event ev;
+	SOCKET sockets[3];
+	int i;
+
+	if ( epoll_fd != INVALID_SOCKET )
+		return qtrue;
+
+	sockets[0] = ip_socket;
+#ifdef USE_IPV6
+	sockets[1] = ip6_socket;
+	// NET_JoinMulticast6 opens its own socket when ip6_socket is bound to a unicast address
+	sockets[2] = ( multicast6_socket != ip6_socket ) ? multicast6_socket : INVALID_SOCKET;
 #else
-			if ( com_sv_running->integer || com_dedicated->integer )
-				Com_RunAndTimeServerPacket( &from, &netmsg );
-			else
-				CL_PacketEvent( &from, &netmsg );
+	sockets[1] = INVALID_SOCKET;
+	sockets[2] = INVALID_SOCKET;
 #endif
+
+	if ( sockets[0] == INVALID_SOCKET && sockets[1] == INVALID_SOCKET )
+		return qfalse;
+
+	epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+	if ( epoll_fd == INVALID_SOCKET ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: epoll_create1() failed: %s, using select()\n", NET_ErrorString() );
+		Cvar_Set( "net_batchIO", "0" );
+		return qfalse;
+	}
+
+	for ( i = 0; i < ARRAY_LEN( sockets ); i++ ) {
+		if ( sockets[i] == INVALID_SOCKET )
+			continue;
+		memset( &ev, 0, sizeof( ev ) );
+		ev.events = EPOLLIN;
+		ev.data.fd = sockets[i];
+		if ( epoll_ctl( epoll_fd, EPOLL_CTL_ADD, sockets[i], &ev ) == SOCKET_ERROR ) {
+			Com_Printf( S_COLOR_YELLOW "WARNING: epoll_ctl() failed: %s, using select()\n", NET_ErrorString() );
+			close( epoll_fd );
+			epoll_fd = INVALID_SOCKET;
+			Cvar_Set( "net_batchIO", "0" );
+			return qfalse;
 		}
-		else
-			break;
 	}
+
+	return qtrue;
 }
 
 
+/*
+====================
+NET_BatchSleep
+====================
+*/
+static qboolean NET_BatchSleep( int timeout )
+{
+	struct epoll_event events[3];
+	int i, retval;
+
+	// epoll_wait() has millisecond resolution, round to nearest
+	retval = epoll_wait( epoll_fd, events, ARRAY_LEN( events ), ( timeout + 500 ) / 1000 );
+	netStats.waits++;
+
+	if ( retval > 0 ) {
+		for ( i = 0; i < retval && epoll_fd != INVALID_SOCKET; i++ ) {
+			NET_BatchEvent( events[i].data.fd );
+		}
+		return qfalse;
+	}
+
+	if ( retval == SOCKET_ERROR && socketError != EINTR ) {
+		Com_Printf( S_COLOR_YELLOW "Warning: epoll_wait() syscall failed: %s\n", 
+			NET_ErrorString() );
+	}
+
+	return qtrue;
+}
+#endif // USE_NET_BATCH
+
+
 /*
 ====================
 NET_Sleep
@@ -1875,6 +2262,13 @@ qboolean NET_Sleep( int timeout )
 	if ( timeout < 0 )
 		timeout = 0;
 
+#ifdef USE_NET_BATCH
+	NET_FlushSendQueue();
+
+	if ( net_batchIO->integer && NET_InitBatchIO() )
+		return NET_BatchSleep( timeout );
+#endif
+
 	FD_ZERO( &fdr );
 
 	if ( ip_socket != INVALID_SOCKET )
@@ -1910,6 +2304,7 @@ qboolean NET_Sleep( int timeout )
 	tv.tv_usec = timeout - tv.tv_sec * 1000000;
 
 	retval = select( highestfd + 1, &fdr, NULL, NULL, &tv );
+	netStats.waits++;
 
 	if ( retval > 0 ) {
 		NET_Event( &fdr );
@@ -1937,3 +2332,22 @@ static void NET_Restart_f( void )
 {
 	NET_Config( qtrue );
 }
+
+
+/*
+====================
+NET_FrameStats
+
+Reports and resets socket syscall counters, called once per frame
+====================
+*/
+void NET_FrameStats( void )
+{
+	if ( net_showstats && net_showstats->integer ) {
+		Com_Printf( "net: %i waits, %i recv calls (%i pkts), %i send calls (%i pkts)\n",
+			netStats.waits, netStats.recvCalls, netStats.recvPackets,
+			netStats.sendCalls, netStats.sendPackets );
+	}
+
+	Com_Memset( &netStats, 0, sizeof( netStats ) );
+}
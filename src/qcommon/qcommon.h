@@ -94,6 +94,7 @@ struct entityState_s;
 struct playerState_s;
 
 void MSG_WriteBits( msg_t *msg, int value, int bits );
+void MSG_WriteBitStream( msg_t *msg, const msg_t *src );
 
 void MSG_WriteChar (msg_t *sb, int c);
 void MSG_WriteByte (msg_t *sb, int c);
@@ -226,6 +227,9 @@ void		NET_JoinMulticast6( void );
 void		NET_LeaveMulticast6( void );
 #endif
 qboolean	NET_Sleep( int timeout );
+void		NET_BeginSendBatch( void );
+void		NET_EndSendBatch( void );	// sends everything queued since NET_BeginSendBatch
+void		NET_FrameStats( void );
 
 #define	MAX_PACKETLEN	1400	// max size of a network packet
 
@@ -786,6 +790,7 @@ qboolean FS_SV_FileExists( const char *file );
 
 fileHandle_t FS_SV_FOpenFileWrite( const char *filename );
 int		FS_SV_FOpenFileRead( const char *filename, fileHandle_t *fp );
+const char *FS_SV_FindOSPath( const char *filename );
 void	FS_SV_Rename( const char *from, const char *to );
 int		FS_FOpenFileRead( const char *qpath, fileHandle_t *file, qboolean uniqueFILE );
 // if uniqueFILE is true, then a new FILE will be fopened even if the file
@@ -1188,6 +1193,11 @@ extern	int		com_frameTime;
 extern int com_expectedhunkusage;
 extern int com_hunkusedvalue;
 
+// while a server packet journal is replayed Sys_Milliseconds() returns
+// com_replayTime and Sys_SendPacket() drops everything
+extern	qboolean	com_replay;
+extern	int			com_replayTime;
+
 #ifndef DEDICATED
 extern	qboolean	gw_minimized;
 extern	qboolean	gw_active;
@@ -1447,6 +1457,23 @@ int64_t	Sys_Microseconds( void );
 
 void	Sys_SnapVector( float *vector );
 
+// worker threads for independent per-frame jobs, the calling thread
+// always takes part as worker 0 so count includes it
+#define MAX_WORKER_THREADS 16
+typedef void (*sysJob_t)( void *data, int index, int worker );
+int		Sys_InitWorkers( int count );	// returns number of workers actually running
+void	Sys_ShutdownWorkers( void );
+void	Sys_RunJobs( sysJob_t func, void *data, int numJobs ); // returns when all jobs are finished
+
+// streams that must not block the frame on disk access, written in order
+// by a background thread, Sys_AsyncWrite() copies data and returns qfalse
+// after a write error or if more than MAX_ASYNC_PENDING bytes are queued
+#define MAX_ASYNC_PENDING (32*1024*1024)
+typedef struct asyncFile_s asyncFile_t;
+asyncFile_t	*Sys_AsyncOpen( const char *ospath );
+qboolean	Sys_AsyncWrite( asyncFile_t *file, const void *data, int len );
+qboolean	Sys_AsyncClose( asyncFile_t *file );	// returns qfalse if any write failed
+
 qboolean Sys_RandomBytes( byte *string, int len );
 
 
@@ -1523,6 +1550,8 @@ void HuffmanPutBit( byte* fout, int32_t bitIndex, int bit );
 int HuffmanPutSymbol( byte* fout, uint32_t offset, int symbol );
 int HuffmanGetBit( const byte* buffer, int bitIndex );
 int HuffmanGetSymbol( unsigned int* symbol, const byte* buffer, int bitIndex );
+int HuffmanPutBits( byte *fout, int32_t bitIndex, uint32_t value, int bits );
+uint32_t HuffmanGetBits( const byte *buffer, int32_t *bitIndex, int bits );
 
 #define	SV_ENCODE_START		4
 #define	SV_DECODE_START		12
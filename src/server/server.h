@@ -55,7 +55,6 @@ typedef struct svEntity_s {
 	int clusternums[MAX_ENT_CLUSTERS];
 	int lastCluster;                // if all the clusters don't fit in clusternums
 	int areanum, areanum2;
-	int snapshotCounter;            // used to prevent double adding from portal views
 	int originCluster;              // Gordon: calced upon linking, for origin only bmodel vis checks
 } svEntity_t;
 
@@ -85,7 +84,7 @@ typedef struct {
 	// show_bug.cgi?id=475
 	// the serverId associated with the current checksumFeed (always <= serverId)
 	int checksumFeedServerId;
-	int snapshotCounter;                // incremented for each snapshot built
+	int randomSeed;                     // passed to srand() and the game on spawn
 	int timeResidual;                   // <= 1000 / sv_frame->value
 	char*           configstrings[MAX_CONFIGSTRINGS];
 	svEntity_t svEntities[MAX_GENTITIES];
@@ -124,6 +123,17 @@ typedef struct {
 	int num_tags;
 
 	byte			baselineUsed[ MAX_GENTITIES ];
+
+	// configstrings and baselines of the gamestate, encoded once and shared
+	// by every client's gamestate until SV_SetConfigstring marks them dirty
+	qboolean		gameStateDirty;
+	msg_t			gameState;
+	byte			gameStateBuffer[ MAX_MSGLEN_BUF ];
+
+	// configstrings set since the last SV_FlushConfigstrings, in order of change
+	qboolean		configstringDirty[ MAX_CONFIGSTRINGS ];
+	int				dirtyConfigstrings[ MAX_CONFIGSTRINGS ];
+	int				numDirtyConfigstrings;
 } server_t;
 
 typedef struct {
@@ -161,6 +171,13 @@ typedef struct netchan_buffer_s {
 	struct netchan_buffer_s *next;
 } netchan_buffer_t;
 
+// reliable command text shared by every client it was sent to,
+// freed when the last of them acknowledges or drops it
+typedef struct reliableCommand_s {
+	int			refCount;
+	char		text[4];	// variable sized
+} reliableCommand_t;
+
 typedef struct rateLimit_s {
 	int			lastTime;
 	int			burst;
@@ -188,7 +205,7 @@ typedef struct client_s {
 	clientState_t state;
 	char userinfo[MAX_INFO_STRING];                 // name, etc
 
-	char reliableCommands[MAX_RELIABLE_COMMANDS][MAX_STRING_CHARS];
+	reliableCommand_t *reliableCommands[MAX_RELIABLE_COMMANDS];	// NULL for empty slots
 	int reliableSequence;                   // last added reliable message, not necesarily sent or acknowledged yet
 	int reliableAcknowledge;                // last acknowledged reliable message
 	int messageAcknowledge;
@@ -320,7 +337,7 @@ typedef struct {
 } serverStatic_t;
 
 #ifdef USE_BANS
-#define SERVER_MAXBANS	1024
+#define SERVER_MAXBANS	262144
 // Structure for managing bans
 typedef struct
 {
@@ -372,6 +389,11 @@ extern cvar_t  *sv_onlyVisibleClients;
 
 extern cvar_t  *sv_showAverageBPS;          // NERVE - SMF - net debugging
 
+extern cvar_t  *sv_snapshotThreads;
+extern cvar_t  *sv_telemetry;
+extern cvar_t  *sv_packetJournal;
+extern cvar_t  *sv_snapshotPacing;
+
 extern cvar_t* sv_gameType;
 
 extern cvar_t  *sv_filterCommands;
@@ -398,6 +420,10 @@ extern cvar_t *sv_wwwBaseURL; // the base URL of all the files
 // this gets you a better throughput, but you loose the ability to control the download usage
 extern cvar_t *sv_wwwDlDisconnected;
 extern cvar_t *sv_wwwFallbackURL;
+// built-in http server for pk3 downloads
+extern cvar_t *sv_httpPort;
+extern cvar_t *sv_httpHost;
+extern cvar_t *sv_httpMaxConnections;
 
 //bani
 extern cvar_t *sv_cheats;
@@ -407,7 +433,7 @@ extern cvar_t *sv_fullmsg;
 
 #ifdef USE_BANS
 extern	cvar_t	*sv_banFile;
-extern	serverBan_t serverBans[SERVER_MAXBANS];
+extern	serverBan_t *serverBans;
 extern	int serverBansCount;
 #endif
 
@@ -431,6 +457,7 @@ void SV_RemoveOperatorCommands( void );
 void SV_MasterShutdown( void );
 int SV_RateMsec( const client_t *client );
 void SV_MasterGameCompleteStatus( void );     // NERVE - SMF
+void SV_QueryBench_f( void );
 //bani - bugtraq 12534
 
 
@@ -442,6 +469,7 @@ void SV_SetConfigstring( int index, const char *val );
 //void SV_UpdateConfigStrings( void );
 void SV_GetConfigstring( int index, char *buffer, int bufferSize );
 void SV_UpdateConfigstrings( client_t *client );
+void SV_FlushConfigstrings( void );
 
 void SV_SetUserinfo( int index, const char *val );
 void SV_GetUserinfo( int index, char *buffer, int bufferSize );
@@ -471,6 +499,7 @@ void SV_ClientThink( client_t *cl, usercmd_t *cmd );
 
 int SV_SendDownloadMessages( void );
 int SV_SendQueuedMessages( void );
+qboolean SV_ReferencedPak( const char *name );
 
 void SV_FreeIP4DB( void );
 void SV_PrintLocations_f( client_t *client );
@@ -488,6 +517,13 @@ void SV_TempBanNetAddress( const netadr_t *address, int length );
 // sv_snapshot.c
 //
 void SV_AddServerCommand( client_t *client, const char *cmd );
+void SV_AddReliableCommand( client_t *client, reliableCommand_t *cmd );
+reliableCommand_t *SV_AllocReliableCommand( const char *text );
+void SV_ReleaseReliableCommand( reliableCommand_t *cmd );
+void SV_SetReliableCommand( client_t *client, int sequence, reliableCommand_t *cmd );
+const char *SV_ReliableCommand( const client_t *client, int sequence );
+void SV_AcknowledgeReliableCommands( client_t *client, int acknowledge );
+void SV_FreeReliableCommands( client_t *client );
 void SV_UpdateServerCommandsToClient( client_t *client, msg_t *msg );
 void SV_WriteFrameToClient( client_t *client, msg_t *msg );
 void SV_SendMessageToClient( msg_t *msg, client_t *client );
@@ -499,8 +535,87 @@ void SV_SendClientIdle( client_t *client );
 void SV_InitSnapshotStorage( void );
 void SV_IssueNewSnapshot( void );
 
+void SV_ShutdownSnapshotWorkers( void );
+void SV_SnapshotBench_f( void );
+
+void SV_BuildDemoFrame( client_t *client, clientSnapshot_t *frame );
+const snapshotFrame_t *SV_GetCommonSnapshot( void );
+
 int SV_RemainingGameState( void );
 
+//
+// sv_demo.c
+//
+void SV_DemoServerCommand( const client_t *client, const char *cmd );
+void SV_DemoConfigstring( int index );
+void SV_DemoFrame( void );
+void SV_DemoStopRecord( void );
+void SV_RecordServer_f( void );
+void SV_StopRecordServer_f( void );
+void SV_ConvertServerDemo_f( void );
+void SV_CompleteServerDemoName( char *args, int argNum );
+
+//
+// sv_http.c
+//
+qboolean SV_HTTPFrame( void );
+void SV_HTTPShutdown( void );
+const char *SV_HTTPBaseURL( void );
+
+//
+// sv_telemetry.c
+//
+typedef enum {
+	TM_PACKETS_USEC,		// processing received packets
+	TM_GAME_USEC,			// GAME_RUN_FRAME calls
+	TM_SNAPSHOT_USEC,		// building and encoding client snapshots
+	TM_SEND_USEC,			// transmitting client snapshots
+	TM_DOWNLOAD_USEC,		// queued fragments and download pump
+	TM_FRAME_USEC,			// whole SV_Frame
+	TM_CLIENTS,
+	TM_ACTIVE_CLIENTS,
+	TM_PACKETS_IN,
+	TM_BYTES_IN,
+	TM_PACKETS_OUT,
+	TM_BYTES_OUT,
+	TM_SNAPSHOT_ENTITIES,	// entities in the common snapshot
+	TM_CLIENT_ENTITIES,		// entities in all client snapshots sent
+	TM_NUM_METRICS
+} telemetryMetric_t;
+
+void SV_TelemetryAdd( telemetryMetric_t metric, int64_t value );
+void SV_TelemetryEndFrame( void );
+int64_t SV_TelemetryTotal( telemetryMetric_t metric );
+void SV_TelemetryClear( void );
+void SV_Telemetry_f( void );
+
+//
+// sv_pacing.c
+//
+qboolean SV_PaceSnapshot( client_t *client, const msg_t *msg );
+int SV_SendPacedSnapshots( void );
+void SV_BeginPacing( void );
+void SV_ShutdownPacing( void );
+void SV_Pacing_f( void );
+
+#ifdef USE_BANS
+// sv_bans.c
+serverBan_t *SV_AllocBan( void );
+void SV_IndexBan( const serverBan_t *ban );
+void SV_ReindexBans( void );
+qboolean SV_IsBanned( const netadr_t *from );
+void SV_BanBench_f( void );
+#endif
+
+// sv_journal.c
+void SV_JournalSpawn( const char *mapname );
+void SV_JournalStop( void );
+void SV_JournalFrame( int msec );
+void SV_JournalPacket( const netadr_t *from, const msg_t *msg );
+void SV_JournalIdle( void );
+void SV_JournalSnapshot( const client_t *client, const msg_t *msg );
+void SV_Replay_f( void );
+
 //
 // sv_game.c
 //
@@ -559,6 +674,8 @@ clipHandle_t SV_ClipHandleForEntity( const sharedEntity_t *ent );
 
 
 void SV_SectorList_f( void );
+void SV_SectorBench_f( void );
+void SV_TraceBench_f( void );
 
 
 int SV_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entityList, int maxcount );
@@ -0,0 +1,531 @@
+/*
+===========================================================================
+
+Wolfenstein: Enemy Territory GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Wolfenstein: Enemy Territory GPL Source Code (Wolf ET Source Code).
+
+Wolf ET Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Wolf ET Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Wolf ET Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Wolf: ET Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Wolf ET Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+// sv_bans.c -- ban list storage and a path-compressed binary trie over the
+// banned and excepted prefixes, so checking an address costs O(prefix length)
+// instead of a scan of the whole list
+
+#include "server.h"
+
+#ifdef USE_BANS
+
+#define BAN_NODE_BAN		1
+#define BAN_NODE_EXCEPT		2
+
+#define BAN_ROOT_IP			0
+#define BAN_ROOT_IP6		1
+
+typedef struct {
+	byte	key[16];		// prefix, only the first bits are meaningful
+	int		bits;			// prefix length
+	int		flags;			// BAN_NODE_*, zero for pure branch nodes
+	int		child[2];		// next node when the following bit is 0 or 1, -1 if none
+} banNode_t;
+
+typedef struct {
+	banNode_t	*nodes;
+	int			numNodes;
+	int			maxNodes;
+	int			root[2];	// BAN_ROOT_*
+} banTrie_t;
+
+serverBan_t	*serverBans;
+int			serverBansCount;
+static int	serverBansSize;
+
+static banTrie_t	banTrie = { NULL, 0, 0, { -1, -1 } };
+
+
+/*
+==================
+SV_BanKey
+
+Returns the root index and address bytes of an address, or -1 for
+address types that can't be banned
+==================
+*/
+static int SV_BanKey( const netadr_t *adr, const byte **key, int *maxbits ) {
+	switch ( adr->type ) {
+		case NA_IP:
+			*key = adr->ipv._4;
+			*maxbits = 32;
+			return BAN_ROOT_IP;
+#ifdef USE_IPV6
+		case NA_IP6:
+			*key = adr->ipv._6;
+			*maxbits = 128;
+			return BAN_ROOT_IP6;
+#endif
+		default:
+			return -1;
+	}
+}
+
+
+static ID_INLINE int SV_BanBit( const byte *key, int bit ) {
+	return ( key[ bit >> 3 ] >> ( 7 - ( bit & 7 ) ) ) & 1;
+}
+
+
+/*
+==================
+SV_BanCommonBits
+
+Number of leading bits two keys share, at most bits
+==================
+*/
+static int SV_BanCommonBits( const byte *a, const byte *b, int bits ) {
+	int i, diff, n;
+
+	for ( i = 0; i < bits; i += 8 ) {
+		diff = a[ i >> 3 ] ^ b[ i >> 3 ];
+		if ( diff ) {
+			for ( n = 0; !( diff & 0x80 ); n++ ) {
+				diff <<= 1;
+			}
+			return ( i + n < bits ) ? i + n : bits;
+		}
+	}
+
+	return bits;
+}
+
+
+/*
+==================
+SV_BanNewNode
+==================
+*/
+static int SV_BanNewNode( banTrie_t *trie, const byte *key, int bits, int flags ) {
+	banNode_t *node;
+
+	if ( trie->numNodes == trie->maxNodes ) {
+		trie->maxNodes = trie->maxNodes ? trie->maxNodes * 2 : 256;
+		node = realloc( trie->nodes, trie->maxNodes * sizeof( *node ) );
+		if ( !node ) {
+			Com_Error( ERR_FATAL, "SV_BanNewNode: couldn't allocate %i nodes", trie->maxNodes );
+		}
+		trie->nodes = node;
+	}
+
+	node = &trie->nodes[ trie->numNodes ];
+	Com_Memset( node->key, 0, sizeof( node->key ) );
+	Com_Memcpy( node->key, key, ( bits + 7 ) >> 3 );
+	node->bits = bits;
+	node->flags = flags;
+	node->child[0] = -1;
+	node->child[1] = -1;
+
+	return trie->numNodes++;
+}
+
+
+/*
+==================
+SV_BanTrieInsert
+
+Adds a prefix, nodes are allocated by index so the pool can grow under us
+==================
+*/
+static void SV_BanTrieInsert( banTrie_t *trie, const serverBan_t *ban ) {
+	const byte	*key;
+	int			*link;
+	int			root, maxbits, bits, flags;
+	int			index, parent, side, common, split, leaf;
+	banNode_t	*node;
+
+	root = SV_BanKey( &ban->ip, &key, &maxbits );
+	if ( root < 0 ) {
+		return;
+	}
+
+	bits = ban->subnet;
+	if ( bits < 0 || bits > maxbits ) {
+		bits = maxbits;
+	}
+	flags = ban->isexception ? BAN_NODE_EXCEPT : BAN_NODE_BAN;
+
+	parent = -1;
+	side = 0;
+	index = trie->root[ root ];
+
+	while ( index >= 0 ) {
+		node = &trie->nodes[ index ];
+		common = SV_BanCommonBits( key, node->key, bits < node->bits ? bits : node->bits );
+
+		if ( common < node->bits ) {
+			// the new prefix ends or diverges inside this node's prefix
+			if ( common == bits ) {
+				split = SV_BanNewNode( trie, key, bits, flags );
+			} else {
+				leaf = SV_BanNewNode( trie, key, bits, flags );
+				split = SV_BanNewNode( trie, key, common, 0 );
+				trie->nodes[ split ].child[ SV_BanBit( key, common ) ] = leaf;
+			}
+			trie->nodes[ split ].child[ SV_BanBit( trie->nodes[ index ].key, common ) ] = index;
+			index = split;
+			break;
+		}
+
+		if ( node->bits == bits ) {
+			node->flags |= flags;
+			return;
+		}
+
+		parent = index;
+		side = SV_BanBit( key, node->bits );
+		index = node->child[ side ];
+	}
+
+	if ( index < 0 ) {
+		index = SV_BanNewNode( trie, key, bits, flags );
+	}
+
+	link = ( parent < 0 ) ? &trie->root[ root ] : &trie->nodes[ parent ].child[ side ];
+	*link = index;
+}
+
+
+/*
+==================
+SV_BanTrieMatch
+
+An address is banned when any banned prefix contains it and no
+excepted prefix does, the same rule the linear list scan applied
+==================
+*/
+static qboolean SV_BanTrieMatch( const banTrie_t *trie, const netadr_t *adr ) {
+	const banNode_t	*node;
+	const byte		*key;
+	int				root, maxbits, index, flags;
+
+	root = SV_BanKey( adr, &key, &maxbits );
+	if ( root < 0 ) {
+		return qfalse;
+	}
+
+	flags = 0;
+	for ( index = trie->root[ root ]; index >= 0; index = node->child[ SV_BanBit( key, node->bits ) ] ) {
+		node = &trie->nodes[ index ];
+		if ( SV_BanCommonBits( key, node->key, node->bits ) < node->bits ) {
+			break;
+		}
+		flags |= node->flags;
+		if ( flags & BAN_NODE_EXCEPT ) {
+			return qfalse;
+		}
+		if ( node->bits == maxbits ) {
+			break;
+		}
+	}
+
+	return ( flags & BAN_NODE_BAN ) ? qtrue : qfalse;
+}
+
+
+/*
+==================
+SV_BanTrieClear
+==================
+*/
+static void SV_BanTrieClear( banTrie_t *trie ) {
+	trie->numNodes = 0;
+	trie->root[ BAN_ROOT_IP ] = -1;
+	trie->root[ BAN_ROOT_IP6 ] = -1;
+}
+
+
+/*
+==================
+SV_BanTrieFree
+==================
+*/
+static void SV_BanTrieFree( banTrie_t *trie ) {
+	free( trie->nodes );
+	trie->nodes = NULL;
+	trie->maxNodes = 0;
+	SV_BanTrieClear( trie );
+}
+
+
+/*
+==================
+SV_AllocBan
+
+Appends an uninitialized entry to serverBans and returns it,
+NULL once SERVER_MAXBANS is reached
+==================
+*/
+serverBan_t *SV_AllocBan( void ) {
+	serverBan_t *bans;
+	int size;
+
+	if ( serverBansCount >= SERVER_MAXBANS ) {
+		return NULL;
+	}
+
+	if ( serverBansCount == serverBansSize ) {
+		size = serverBansSize ? serverBansSize * 2 : 1024;
+		if ( size > SERVER_MAXBANS ) {
+			size = SERVER_MAXBANS;
+		}
+		bans = realloc( serverBans, size * sizeof( *bans ) );
+		if ( !bans ) {
+			return NULL;
+		}
+		serverBans = bans;
+		serverBansSize = size;
+	}
+
+	return &serverBans[ serverBansCount++ ];
+}
+
+
+/*
+==================
+SV_IndexBan
+
+Adds the entry to the lookup trie, call after it has been appended
+==================
+*/
+void SV_IndexBan( const serverBan_t *ban ) {
+	SV_BanTrieInsert( &banTrie, ban );
+}
+
+
+/*
+==================
+SV_ReindexBans
+
+Rebuilds the lookup trie after entries were removed
+==================
+*/
+void SV_ReindexBans( void ) {
+	int i;
+
+	SV_BanTrieClear( &banTrie );
+	for ( i = 0; i < serverBansCount; i++ ) {
+		SV_BanTrieInsert( &banTrie, &serverBans[ i ] );
+	}
+}
+
+
+/*
+==================
+SV_IsBanned
+
+Check whether a certain address is banned
+==================
+*/
+qboolean SV_IsBanned( const netadr_t *from ) {
+	if ( !serverBansCount ) {
+		return qfalse;
+	}
+
+	return SV_BanTrieMatch( &banTrie, from );
+}
+
+
+/*
+==================
+SV_BanListMatch
+
+Reference scan of a ban list, exceptions first
+==================
+*/
+static qboolean SV_BanListMatch( const serverBan_t *bans, int count, const netadr_t *from ) {
+	int i;
+
+	for ( i = 0; i < count; i++ ) {
+		if ( bans[ i ].isexception && NET_CompareBaseAdrMask( &bans[ i ].ip, from, bans[ i ].subnet ) ) {
+			return qfalse;
+		}
+	}
+
+	for ( i = 0; i < count; i++ ) {
+		if ( !bans[ i ].isexception && NET_CompareBaseAdrMask( &bans[ i ].ip, from, bans[ i ].subnet ) ) {
+			return qtrue;
+		}
+	}
+
+	return qfalse;
+}
+
+
+/*
+==================
+SV_BanBenchAddress
+
+Random address, half of them inside a random list entry
+==================
+*/
+static void SV_BanBenchAddress( netadr_t *adr, const serverBan_t *bans, int count ) {
+	int i;
+
+	if ( rand() & 1 ) {
+		// vary the host part
+		*adr = bans[ rand() % count ].ip;
+#ifdef USE_IPV6
+		if ( adr->type == NA_IP6 ) {
+			adr->ipv._6[ 15 - ( rand() & 7 ) ] = rand();
+			return;
+		}
+#endif
+		adr->ipv._4[ 3 ] = rand();
+		return;
+	}
+
+	Com_Memset( adr, 0, sizeof( *adr ) );
+#ifdef USE_IPV6
+	if ( ( rand() & 7 ) == 0 ) {
+		adr->type = NA_IP6;
+		for ( i = 0; i < 16; i++ ) {
+			adr->ipv._6[ i ] = rand();
+		}
+		adr->ipv._6[ 0 ] = 0x20;	// global unicast, like the generated entries
+		return;
+	}
+#endif
+	adr->type = NA_IP;
+	for ( i = 0; i < 4; i++ ) {
+		adr->ipv._4[ i ] = rand();
+	}
+}
+
+
+/*
+==================
+SV_BanBench_f
+
+banbench [entries] [lookups]
+
+Builds a random ban list (10% exceptions, 1/8 IPv6 when enabled) into a
+separate trie and compares lookup cost with the linear scan, whose
+result must agree on every address. The server's own list is untouched.
+==================
+*/
+void SV_BanBench_f( void ) {
+	banTrie_t	trie = { NULL, 0, 0, { -1, -1 } };
+	serverBan_t	*bans;
+	netadr_t	*adrs;
+	int			entries, lookups, scans, i, j, banned, mismatches;
+	int64_t		start, buildTime, trieTime, scanTime;
+
+	entries = 100000;
+	lookups = 1000000;
+	if ( Cmd_Argc() > 1 ) {
+		entries = atoi( Cmd_Argv( 1 ) );
+	}
+	if ( Cmd_Argc() > 2 ) {
+		lookups = atoi( Cmd_Argv( 2 ) );
+	}
+	if ( entries < 1 || lookups < 1 ) {
+		Com_Printf( "usage: banbench [entries] [lookups]\n" );
+		return;
+	}
+
+	// the scan is O(entries), keep its share of the run bounded
+	scans = (int)( 200000000LL / entries );
+	if ( scans > lookups ) {
+		scans = lookups;
+	} else if ( scans < 1 ) {
+		scans = 1;
+	}
+
+	bans = malloc( entries * sizeof( *bans ) );
+	adrs = malloc( lookups * sizeof( *adrs ) );
+	if ( !bans || !adrs ) {
+		Com_Printf( "Couldn't allocate %i entries and %i addresses.\n", entries, lookups );
+		free( bans );
+		free( adrs );
+		return;
+	}
+
+	srand( 1 );
+	for ( i = 0; i < entries; i++ ) {
+		Com_Memset( &bans[ i ].ip, 0, sizeof( bans[ i ].ip ) );
+#ifdef USE_IPV6
+		if ( ( i & 7 ) == 7 ) {
+			bans[ i ].ip.type = NA_IP6;
+			for ( j = 0; j < 16; j++ ) {
+				bans[ i ].ip.ipv._6[ j ] = rand();
+			}
+			bans[ i ].ip.ipv._6[ 0 ] = 0x20;
+			bans[ i ].subnet = 32 + rand() % 97;
+		} else
+#endif
+		{
+			bans[ i ].ip.type = NA_IP;
+			for ( j = 0; j < 4; j++ ) {
+				bans[ i ].ip.ipv._4[ j ] = rand();
+			}
+			bans[ i ].subnet = 16 + rand() % 17;
+		}
+		bans[ i ].isexception = ( rand() % 10 ) == 0;
+	}
+
+	for ( i = 0; i < lookups; i++ ) {
+		SV_BanBenchAddress( &adrs[ i ], bans, entries );
+	}
+
+	start = Sys_Microseconds();
+	for ( i = 0; i < entries; i++ ) {
+		SV_BanTrieInsert( &trie, &bans[ i ] );
+	}
+	buildTime = Sys_Microseconds() - start;
+
+	banned = 0;
+	start = Sys_Microseconds();
+	for ( i = 0; i < lookups; i++ ) {
+		banned += SV_BanTrieMatch( &trie, &adrs[ i ] );
+	}
+	trieTime = Sys_Microseconds() - start;
+
+	mismatches = 0;
+	start = Sys_Microseconds();
+	for ( i = 0; i < scans; i++ ) {
+		if ( SV_BanListMatch( bans, entries, &adrs[ i ] ) != SV_BanTrieMatch( &trie, &adrs[ i ] ) ) {
+			mismatches++;
+		}
+	}
+	scanTime = Sys_Microseconds() - start;
+
+	Com_Printf( "%i entries, %i trie nodes (%i KB), built in %.1f msec\n", entries, trie.numNodes,
+		(int)( ( trie.numNodes * sizeof( banNode_t ) + 1023 ) / 1024 ), buildTime / 1000.0 );
+	Com_Printf( "trie: %i lookups, %i banned, %.1f nsec/lookup\n", lookups, banned, trieTime * 1000.0 / lookups );
+	Com_Printf( "scan: %i lookups, %.1f nsec/lookup\n", scans, scanTime * 1000.0 / scans );
+	if ( mismatches ) {
+		Com_Printf( S_COLOR_RED "%i mismatches between trie and scan\n", mismatches );
+	}
+
+	SV_BanTrieFree( &trie );
+	free( bans );
+	free( adrs );
+}
+
+#endif // USE_BANS
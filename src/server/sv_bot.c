@@ -134,7 +134,6 @@ SV_BotGetConsoleMessage
 int SV_BotGetConsoleMessage( int client, char *buf, int size ) {
 	if ( (unsigned) client < sv_maxclients->integer ) {
 		client_t* cl;
-		int index;
 
 		cl = &svs.clients[client];
 		cl->lastPacketTime = svs.time;
@@ -143,14 +142,13 @@ int SV_BotGetConsoleMessage( int client, char *buf, int size ) {
 			return qfalse;
 		}
 
-		cl->reliableAcknowledge++;
-		index = cl->reliableAcknowledge & ( MAX_RELIABLE_COMMANDS - 1 );
+		SV_AcknowledgeReliableCommands( cl, cl->reliableAcknowledge + 1 );
 
-		if ( !cl->reliableCommands[index][0] ) {
+		if ( !SV_ReliableCommand( cl, cl->reliableAcknowledge )[0] ) {
 			return qfalse;
 		}
 
-		//Q_strncpyz( buf, cl->reliableCommands[index], size );
+		//Q_strncpyz( buf, SV_ReliableCommand( cl, cl->reliableAcknowledge ), size );
 		return qtrue;
 	} else {
 		return qfalse;
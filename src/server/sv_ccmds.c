@@ -394,6 +394,8 @@ static void SV_MapRestart_f( void ) {
 	sv.state = SS_GAME;
 	sv.restarting = qfalse;
 
+	SV_DemoServerCommand( NULL, "map_restart\n" );
+
 	// connect and begin all the clients
 	for ( i = 0 ; i < sv_maxclients->integer ; i++ ) {
 		client = &svs.clients[i];
@@ -455,10 +457,11 @@ Load saved bans from file.
 */
 static void SV_RehashBans_f(void)
 {
-	int index, filelen;
+	int filelen;
 	fileHandle_t readfrom;
 	char *textbuf, *curpos, *maskpos, *newlinepos, *endpos;
 	char filepath[MAX_QPATH];
+	serverBan_t ban, *newban;
 	
 	// make sure server is running
 	if ( !com_sv_running->integer ) {
@@ -466,6 +469,7 @@ static void SV_RehashBans_f(void)
 	}
 	
 	serverBansCount = 0;
+	SV_ReindexBans();
 	
 	if(!sv_banFile->string || !*sv_banFile->string)
 		return;
@@ -488,7 +492,7 @@ static void SV_RehashBans_f(void)
 		
 		endpos = textbuf + filelen;
 		
-		for(index = 0; index < SERVER_MAXBANS && curpos + 2 < endpos; index++)
+		while(curpos + 2 < endpos)
 		{
 			// find the end of the address string
 			for(maskpos = curpos + 2; maskpos < endpos && *maskpos != ' '; maskpos++);
@@ -507,27 +511,34 @@ static void SV_RehashBans_f(void)
 			
 			*newlinepos = '\0';
 			
-			if(NET_StringToAdr(curpos + 2, &serverBans[index].ip, NA_UNSPEC))
+			if(NET_StringToAdr(curpos + 2, &ban.ip, NA_UNSPEC))
 			{
-				serverBans[index].isexception = (curpos[0] != '0');
-				serverBans[index].subnet = atoi(maskpos);
+				ban.isexception = (curpos[0] != '0');
+				ban.subnet = atoi(maskpos);
 				
-				if(serverBans[index].ip.type == NA_IP &&
-				   (serverBans[index].subnet < 1 || serverBans[index].subnet > 32))
+				if(ban.ip.type == NA_IP &&
+				   (ban.subnet < 1 || ban.subnet > 32))
 				{
-					serverBans[index].subnet = 32;
+					ban.subnet = 32;
 				}
-				else if(serverBans[index].ip.type == NA_IP6 &&
-					(serverBans[index].subnet < 1 || serverBans[index].subnet > 128))
+				else if(ban.ip.type == NA_IP6 &&
+					(ban.subnet < 1 || ban.subnet > 128))
 				{
-					serverBans[index].subnet = 128;
+					ban.subnet = 128;
+				}
+
+				// index each entry as it is read, lookups never scan the list
+				if(!(newban = SV_AllocBan()))
+				{
+					Com_Printf("Warning: only the first %d bans/exceptions were loaded\n", serverBansCount);
+					break;
 				}
+				*newban = ban;
+				SV_IndexBan(newban);
 			}
 			
 			curpos = newlinepos + 1;
 		}
-			
-		serverBansCount = index;
 		
 		Z_Free(textbuf);
 	}
@@ -573,23 +584,16 @@ static void SV_WriteBans(void)
 ==================
 SV_DelBanEntryFromList
 
-Remove a ban or an exception from the list.
+Remove a ban or an exception from the list, the caller reindexes.
 ==================
 */
 
-static qboolean SV_DelBanEntryFromList(int index)
+static void SV_DelBanEntryFromList(int index)
 {
-	if(index == serverBansCount - 1)
-		serverBansCount--;
-	else if(index < ARRAY_LEN(serverBans) - 1)
-	{
+	if(index < serverBansCount - 1)
 		memmove(serverBans + index, serverBans + index + 1, (serverBansCount - index - 1) * sizeof(*serverBans));
-		serverBansCount--;
-	}
-	else
-		return qtrue;
 
-	return qfalse;
+	serverBansCount--;
 }
 
 /*
@@ -650,7 +654,7 @@ static void SV_AddBanToList(qboolean isexception)
 	const char *banstring;
 	char addy2[NET_ADDRSTRMAXLEN];
 	netadr_t ip;
-	int index, argc, mask;
+	int index, argc, mask, count;
 	serverBan_t *curban;
 
 	// make sure server is running
@@ -667,7 +671,7 @@ static void SV_AddBanToList(qboolean isexception)
 		return;
 	}
 
-	if(serverBansCount >= ARRAY_LEN(serverBans))
+	if(serverBansCount >= SERVER_MAXBANS)
 	{
 		Com_Printf ("Error: Maximum number of bans/exceptions exceeded.\n");
 		return;
@@ -733,7 +737,7 @@ static void SV_AddBanToList(qboolean isexception)
 		
 		if(curban->subnet <= mask)
 		{
-			if((curban->isexception || !isexception) && NET_CompareBaseAdrMask(&curban->ip, ip, &curban->subnet))
+			if((curban->isexception || !isexception) && NET_CompareBaseAdrMask(&curban->ip, &ip, curban->subnet))
 			{
 				Q_strncpyz(addy2, NET_AdrToString(&ip), sizeof(addy2));
 				
@@ -759,6 +763,7 @@ static void SV_AddBanToList(qboolean isexception)
 
 	// now delete bans that are superseded by the new one
 	index = 0;
+	count = serverBansCount;
 	while(index < serverBansCount)
 	{
 		curban = &serverBans[index];
@@ -769,11 +774,20 @@ static void SV_AddBanToList(qboolean isexception)
 			index++;
 	}
 
-	serverBans[serverBansCount].ip = ip;
-	serverBans[serverBansCount].subnet = mask;
-	serverBans[serverBansCount].isexception = isexception;
-	
-	serverBansCount++;
+	if(count != serverBansCount)
+		SV_ReindexBans();
+
+	curban = SV_AllocBan();
+	if(!curban)
+	{
+		Com_Printf ("Error: Maximum number of bans/exceptions exceeded.\n");
+		return;
+	}
+
+	curban->ip = ip;
+	curban->subnet = mask;
+	curban->isexception = isexception;
+	SV_IndexBan(curban);
 	
 	SV_WriteBans();
 
@@ -869,6 +883,7 @@ static void SV_DelBanFromList(qboolean isexception)
 		}
 	}
 	
+	SV_ReindexBans();
 	SV_WriteBans();
 }
 
@@ -935,6 +950,7 @@ static void SV_FlushBans_f(void)
 	}
 
 	serverBansCount = 0;
+	SV_ReindexBans();
 	
 	// empty the ban file.
 	SV_WriteBans();
@@ -1467,14 +1483,25 @@ static const cmdListItem_t sv_cmds[] = {
 	{ "filtercmd", SV_AddFilterCmd_f },
 	{ "gameCompleteStatus", SV_GameCompleteStatus_f, NULL },
 	{ "guidstatus", SV_GUIDStatus_f, NULL },
+	{ "convertdemo_server", SV_ConvertServerDemo_f, SV_CompleteServerDemoName },
 	{ "heartbeat", SV_Heartbeat_f, NULL },
 	{ "killserver", SV_KillServer_f, NULL },
 	{ "map_restart", SV_MapRestart_f, NULL },
 	{ "map", SV_Map_f, SV_CompleteMapName },
+	{ "pacing", SV_Pacing_f, NULL },
+	{ "querybench", SV_QueryBench_f, NULL },
+	{ "record_server", SV_RecordServer_f, NULL },
+	{ "replay", SV_Replay_f, NULL },
+	{ "sectorbench", SV_SectorBench_f, NULL },
 	{ "sectorlist", SV_SectorList_f, NULL },
+	{ "snapshotbench", SV_SnapshotBench_f, NULL },
 	{ "status", SV_Status_f, NULL },
+	{ "stoprecord_server", SV_StopRecordServer_f, NULL },
+	{ "telemetry", SV_Telemetry_f, NULL },
+	{ "tracebench", SV_TraceBench_f, NULL },
 #ifdef USE_BANS
 	{ "banaddr", SV_BanAddr_f, NULL },
+	{ "banbench", SV_BanBench_f, NULL },
 	{ "bandel", SV_BanDel_f, NULL },
 	{ "exceptaddr", SV_ExceptAddr_f, NULL },
 	{ "exceptdel", SV_ExceptDel_f, NULL },
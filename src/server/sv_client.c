@@ -81,6 +81,11 @@ static qboolean SV_VerifyChallenge( int receivedChallenge, const netadr_t *from
 
 	int expectedChallenge = SV_CreateChallenge( challengeTimestamp, from );
 
+	// a replayed journal was challenged with another secret key
+	if ( com_replay ) {
+		return qtrue;
+	}
+
 	return (receivedChallenge == expectedChallenge) ? qtrue : qfalse;
 }
 
@@ -133,11 +138,11 @@ void SV_GetChallenge( const netadr_t *from ) {
 
 #ifdef USE_BANS
 	// Check whether this client is banned.
-	if(SV_IsBanned(from, qfalse))
+	if(SV_IsBanned(from))
 	{
 		// avoid excessive outgoing traffic
 		if ( !SVC_RateLimit( &bucket, 10, 200 ) ) {
-			NET_OutOfBandPrint(NS_SERVER, &from, "print\nYou are banned from this server.\n");
+			NET_OutOfBandPrint(NS_SERVER, from, "print\nYou are banned from this server.\n");
 		}
 		return;
 	}
@@ -182,43 +187,6 @@ void SV_GetChallenge( const netadr_t *from ) {
 }
 
 
-/*
-==================
-SV_IsBanned
-
-Check whether a certain address is banned
-==================
-*/
-#ifdef USE_BANS
-
-static qboolean SV_IsBanned( const netadr_t *from, qboolean isexception )
-{
-	int index;
-	serverBan_t *curban;
-
-	if(!isexception)
-	{
-		// If this is a query for a ban, first check whether the client is excepted
-		if(SV_IsBanned(from, qtrue))
-			return qfalse;
-	}
-
-	for(index = 0; index < serverBansCount; index++)
-	{
-		curban = &serverBans[index];
-
-		if(curban->isexception == isexception)
-		{
-			if(NET_CompareBaseAdrMask(&curban->ip, from, curban->subnet))
-				return qtrue;
-		}
-	}
-
-	return qfalse;
-}
-#endif
-
-
 /*
 ==================
 SV_SetClientTLD
@@ -412,23 +380,41 @@ static void SV_SaveSequences( void ) {
 
 
 static void SV_InjectLocation( const char *tld, const char *country ) {
-	char *cmd, *str;
+	reliableCommand_t *from, *to;
+	char buf[ MAX_STRING_CHARS ];
+	const char *cmd, *str;
+	client_t *cl;
 	int i, n;
+
+	// broadcasts share one command across clients, so build
+	// the replacement once and hand it to each of them
+	from = to = NULL;
 	for ( i = 0; i < sv_maxclients->integer; i++ ) {
-		if ( seqs[i] != svs.clients[i].reliableSequence ) {
-			for ( n = seqs[i]; n != svs.clients[i].reliableSequence + 1; n++ ) {
-				cmd = svs.clients[i].reliableCommands[n & (MAX_RELIABLE_COMMANDS-1)];
+		cl = &svs.clients[i];
+		if ( seqs[i] != cl->reliableSequence ) {
+			for ( n = seqs[i]; n != cl->reliableSequence + 1; n++ ) {
+				if ( from && cl->reliableCommands[n & (MAX_RELIABLE_COMMANDS-1)] == from ) {
+					SV_SetReliableCommand( cl, n, to );
+					break;
+				}
+				cmd = SV_ReliableCommand( cl, n );
 				str = strstr( cmd, "connected\n\"" );
 				if ( str && str[11] == '\0' && str < cmd + 512 ) {
+					Q_strncpyz( buf, cmd, sizeof( buf ) );
 					if ( *tld == '\0' )
-						sprintf( str, S_COLOR_WHITE "connected (%s)\n\"", country );
+						sprintf( buf + ( str - cmd ), S_COLOR_WHITE "connected (%s)\n\"", country );
 					else
-						sprintf( str, S_COLOR_WHITE "connected (" S_COLOR_RED "%s" S_COLOR_WHITE ", %s)\n\"", tld, country );
+						sprintf( buf + ( str - cmd ), S_COLOR_WHITE "connected (" S_COLOR_RED "%s" S_COLOR_WHITE ", %s)\n\"", tld, country );
+					SV_ReleaseReliableCommand( to );
+					from = cl->reliableCommands[n & (MAX_RELIABLE_COMMANDS-1)];
+					to = SV_AllocReliableCommand( buf );
+					SV_SetReliableCommand( cl, n, to );
 					break;
 				}
 			}
 		}
 	}
+	SV_ReleaseReliableCommand( to );
 }
 
 
@@ -477,11 +463,11 @@ void SV_DirectConnect( const netadr_t *from ) {
 
 #ifdef USE_BANS
 	// Check whether this client is banned.
-	if(SV_IsBanned(from, qfalse))
+	if(SV_IsBanned(from))
 	{
 		// avoid excessive outgoing traffic
 		if ( !SVC_RateLimit( &bucket, 10, 200 ) ) {
-			NET_OutOfBandPrint(NS_SERVER, &from, "print\n[err_dialog]You are banned from this server.\n");
+			NET_OutOfBandPrint(NS_SERVER, from, "print\n[err_dialog]You are banned from this server.\n");
 		}
 		return;
 	}
@@ -758,6 +744,7 @@ gotnewcl:
 	// accept the new client
 	// this is the only place a client_t is ever initialized
 	// we got a newcl, so reset the reliableSequence and reliableAcknowledge
+	SV_FreeReliableCommands( newcl );
 	Com_Memset( newcl, 0, sizeof( *newcl ) );
 	clientNum = newcl - svs.clients;
 #if 0 // skip this until CS_PRIMED
@@ -1018,6 +1005,48 @@ int SV_RemainingGameState( void )
 }
 
 
+/*
+================
+SV_BuildGameState
+
+Encodes the configstrings and baselines shared by every client's gamestate
+================
+*/
+static void SV_BuildGameState( void ) {
+	int			start;
+	entityState_t nullstate;
+	const svEntity_t *svEnt;
+	msg_t		*msg;
+
+	msg = &sv.gameState;
+	MSG_Init( msg, sv.gameStateBuffer, MAX_MSGLEN );
+
+	// write the configstrings
+	for ( start = 0 ; start < MAX_CONFIGSTRINGS ; start++ ) {
+		if (sv.configstrings[start][0]) {
+			MSG_WriteByte( msg, svc_configstring );
+			MSG_WriteShort( msg, start );
+			MSG_WriteBigString( msg, sv.configstrings[start] );
+		}
+	}
+
+	// write the baselines
+	Com_Memset( &nullstate, 0, sizeof( nullstate ) );
+	for ( start = 0 ; start < MAX_GENTITIES; start++ ) {
+		if ( !sv.baselineUsed[ start ] ) {
+			continue;
+		}
+		svEnt = &sv.svEntities[ start ];
+		MSG_WriteByte( msg, svc_baseline );
+		MSG_WriteDeltaEntity( msg, &nullstate, &svEnt->baseline, qtrue );
+	}
+
+	MSG_WriteByte( msg, svc_EOF );
+
+	sv.gameStateDirty = qfalse;
+}
+
+
 /*
 ================
 SV_SendClientGameState
@@ -1030,9 +1059,6 @@ the wrong gamestate.
 ================
 */
 static void SV_SendClientGameState( client_t *client ) {
-	int			start;
-	entityState_t nullstate;
-	const svEntity_t *svEnt;
 	msg_t		msg;
 	byte		msgBuffer[ MAX_MSGLEN_BUF ];
 
@@ -1070,27 +1096,13 @@ static void SV_SendClientGameState( client_t *client ) {
 	MSG_WriteByte( &msg, svc_gamestate );
 	MSG_WriteLong( &msg, client->reliableSequence );
 
-	// write the configstrings
-	for ( start = 0 ; start < MAX_CONFIGSTRINGS ; start++ ) {
-		if (sv.configstrings[start][0]) {
-			MSG_WriteByte( &msg, svc_configstring );
-			MSG_WriteShort( &msg, start );
-			MSG_WriteBigString( &msg, sv.configstrings[start] );
-		}
-	}
-
-	// write the baselines
-	Com_Memset( &nullstate, 0, sizeof( nullstate ) );
-	for ( start = 0 ; start < MAX_GENTITIES; start++ ) {
-		if ( !sv.baselineUsed[ start ] ) {
-			continue;
-		}
-		svEnt = &sv.svEntities[ start ];
-		MSG_WriteByte( &msg, svc_baseline );
-		MSG_WriteDeltaEntity( &msg, &nullstate, &svEnt->baseline, qtrue );
+	// write the configstrings and baselines, encoded
+	// only once per change and patched in between the
+	// client specific fields
+	if ( sv.gameStateDirty ) {
+		SV_BuildGameState();
 	}
-
-	MSG_WriteByte( &msg, svc_EOF );
+	MSG_WriteBitStream( &msg, &sv.gameState );
 
 	MSG_WriteLong( &msg, client - svs.clients );
 
@@ -1161,6 +1173,111 @@ CLIENT COMMAND EXECUTION
 ============================================================
 */
 
+#define REFPAK_HASH_SIZE 256
+
+typedef struct refPak_s {
+	struct refPak_s	*next;
+	char			name[1];
+} refPak_t;
+
+static refPak_t *refPakHash[ REFPAK_HASH_SIZE ];
+static int refPakModificationCount = -1;
+
+
+/*
+==================
+SV_RefPakHash
+
+Case and separator insensitive, same rules as FS_FilenameCompare
+==================
+*/
+static unsigned int SV_RefPakHash( const char *name )
+{
+	unsigned int hash;
+	int c;
+
+	for ( hash = 0; *name; name++ ) {
+		c = tolower( (byte)*name );
+		if ( c == '\\' || c == ':' )
+			c = '/';
+		hash = hash * 31 + c;
+	}
+
+	return hash & ( REFPAK_HASH_SIZE - 1 );
+}
+
+
+/*
+==================
+SV_BuildReferencedPaks
+
+Rebuilds pak name set from sv_referencedPakNames
+==================
+*/
+static void SV_BuildReferencedPaks( void )
+{
+	const char *s, *start;
+	refPak_t *pak, *next;
+	unsigned int hash;
+	int i, len;
+
+	for ( i = 0; i < REFPAK_HASH_SIZE; i++ ) {
+		for ( pak = refPakHash[i]; pak; pak = next ) {
+			next = pak->next;
+			Z_Free( pak );
+		}
+		refPakHash[i] = NULL;
+	}
+
+	s = sv_referencedPakNames->string;
+	while ( *s ) {
+		while ( *s == ' ' )
+			s++;
+		start = s;
+		while ( *s && *s != ' ' )
+			s++;
+		len = s - start;
+		if ( !len )
+			break;
+
+		pak = Z_Malloc( sizeof( *pak ) + len );
+		memcpy( pak->name, start, len );
+		pak->name[ len ] = '\0';
+
+		hash = SV_RefPakHash( pak->name );
+		pak->next = refPakHash[ hash ];
+		refPakHash[ hash ] = pak;
+	}
+
+	refPakModificationCount = sv_referencedPakNames->modificationCount;
+}
+
+
+/*
+==================
+SV_ReferencedPak
+
+Checks whether pak name (without extension) appears in sv_referencedPakNames
+==================
+*/
+qboolean SV_ReferencedPak( const char *name )
+{
+	const refPak_t *pak;
+
+	if ( refPakModificationCount != sv_referencedPakNames->modificationCount ) {
+		SV_BuildReferencedPaks();
+	}
+
+	for ( pak = refPakHash[ SV_RefPakHash( name ) ]; pak; pak = pak->next ) {
+		if ( !FS_FilenameCompare( pak->name, name ) ) {
+			return qtrue;
+		}
+	}
+
+	return qfalse;
+}
+
+
 /*
 ==================
 SV_CloseDownload
@@ -1357,7 +1474,7 @@ static int SV_WriteDownloadToClient( client_t *cl )
 	char errorMessage[1024];
 	int download_flag;
 	char pakbuf[MAX_QPATH], *pakptr;
-	int numRefPaks;
+	const char *baseURL;
 	msg_t msg;
 	byte msgBuffer[MAX_DOWNLOAD_BLKSIZE*2+8];
 
@@ -1390,21 +1507,13 @@ static int SV_WriteDownloadToClient( client_t *cl )
 			{
 				// Check whether the file appears in the list of referenced
 				// paks to prevent downloading of arbitrary files.
-				Cmd_TokenizeStringIgnoreQuotes( sv_referencedPakNames->string );
-				numRefPaks = Cmd_Argc();
-
-				for(curindex = 0; curindex < numRefPaks; curindex++)
+				if ( SV_ReferencedPak( pakbuf ) )
 				{
-					if(!FS_FilenameCompare(Cmd_Argv(curindex), pakbuf))
-					{
-						unreferenced = 0;
-
-						// now that we know the file is referenced,
-						// check whether it's legal to download it.
-						idPack = FS_idPak(pakbuf, BASEGAME);
+					unreferenced = 0;
 
-						break;
-					}
+					// now that we know the file is referenced,
+					// check whether it's legal to download it.
+					idPack = FS_idPak(pakbuf, BASEGAME);
 				}
 			}
 		}
@@ -1477,7 +1586,13 @@ static int SV_WriteDownloadToClient( client_t *cl )
 						FS_FCloseFile( handle ); // don't keep open, we only care about the size
 					}
 
-					Com_sprintf( cl->downloadURL, sizeof(cl->downloadURL), "%s/%s", sv_wwwBaseURL->string, cl->downloadName );
+					// built-in http server is used unless there is an external one
+					baseURL = sv_wwwBaseURL->string;
+					if ( !*baseURL && SV_HTTPBaseURL() ) {
+						baseURL = SV_HTTPBaseURL();
+					}
+
+					Com_sprintf( cl->downloadURL, sizeof(cl->downloadURL), "%s/%s", baseURL, cl->downloadName );
 
 					//bani - prevent multiple download notifications
 					if ( cl->downloadnotify & DLNOTIFY_REDIRECT ) {
@@ -2322,7 +2437,7 @@ static void SV_UserMove( client_t *cl, msg_t *msg, qboolean delta ) {
 	// also use the message acknowledge
 	key ^= cl->messageAcknowledge;
 	// also use the last acknowledged server command in the key
-	key ^= MSG_HashKey(cl->reliableCommands[ cl->reliableAcknowledge & (MAX_RELIABLE_COMMANDS-1) ], 32);
+	key ^= MSG_HashKey(SV_ReliableCommand( cl, cl->reliableAcknowledge ), 32);
 
 	oldcmd = &nullcmd;
 	for ( i = 0 ; i < cmdCount ; i++ ) {
@@ -2461,11 +2576,11 @@ void SV_ExecuteClientMessage( client_t *cl, msg_t *msg ) {
 #else
 		Com_Printf( S_COLOR_YELLOW "WARNING: dropping %i commands from %s\n", cl->reliableSequence - cl->reliableAcknowledge, cl->name );
 #endif
-		cl->reliableAcknowledge = cl->reliableSequence;
+		SV_AcknowledgeReliableCommands( cl, cl->reliableSequence );
 		return;
 	}
 
-	cl->reliableAcknowledge = reliableAcknowledge;
+	SV_AcknowledgeReliableCommands( cl, reliableAcknowledge );
 
 	cl->justConnected = qfalse;
 
@@ -0,0 +1,1196 @@
+/*
+===========================================================================
+
+Wolfenstein: Enemy Territory GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Wolfenstein: Enemy Territory GPL Source Code (Wolf ET Source Code).  
+
+Wolf ET Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Wolf ET Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Wolf ET Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Wolf: ET Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Wolf ET Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "server.h"
+
+/*
+=============================================================================
+
+Server side multi-POV demos
+
+The server writes a single stream with every entity state once per frame,
+delta compressed against the previous frame, plus playerState_t, areabits
+and the set of visible entities of each active client. Any client's point
+of view can be rebuilt from it into a standard client demo later.
+
+Stream layout:
+
+4	"SVDM"
+4	version
+<blocks>
+4	-1
+
+Each block is [length] [huffman encoded message], message is a sequence
+of svdm_* records terminated by svdm_EOF. A frame record never spans
+multiple blocks. Blocks are handed to a background writer so recording
+never waits for the disk.
+
+=============================================================================
+*/
+
+#define SVDEMO_DIR			"svdemos"
+#define SVDEMO_EXT			"svdm"
+#define SVDEMO_MAGIC		"SVDM"
+#define SVDEMO_VERSION		1
+#define SVDEMO_MSGLEN		(MAX_MSGLEN*8)
+#define SVDEMO_ALLCLIENTS	MAX_CLIENTS		// clientNum for broadcast commands and end of client list
+
+typedef enum {
+	svdm_EOF,
+	svdm_gamestate,			// [long] checksumFeed, configstrings, baselines
+	svdm_configstring,		// [short] index, [bigstring]
+	svdm_serverCommand,		// [byte] clientNum, [bigstring]
+	svdm_frame				// [long] serverTime, [byte] snapFlags, entities, client views
+} svdmOps_t;
+
+typedef struct {
+	qboolean		valid;						// present in last frame, next one is delta compressed
+	playerState_t	ps;
+	int				areabytes;
+	byte			areabits[ MAX_MAP_AREA_BYTES ];
+	byte			visible[ MAX_GENTITIES / 8 ];
+} svdmClient_t;
+
+typedef struct {
+	asyncFile_t		*file;
+	char			name[ MAX_QPATH ];
+	int				numFrames;
+	int				size;
+
+	int				numEntities;
+	entityState_t	entities[ MAX_GENTITIES ];	// last recorded frame, sorted by number
+	entityState_t	baselines[ MAX_GENTITIES ];
+	svdmClient_t	clients[ MAX_CLIENTS ];
+	clientSnapshot_t frame;						// visibility of currently recorded client
+
+	msg_t			msg;
+	byte			block[ 4 + SVDEMO_MSGLEN + 8 ];	// length followed by message data
+} svdmRecorder_t;
+
+static svdmRecorder_t *recorder;
+
+static void SV_DemoClose( void );
+
+
+/*
+=============
+SV_DemoEmitEntities
+
+Writes a delta update of sorted entity list, new entities are delta'd from baselines
+=============
+*/
+static void SV_DemoEmitEntities( msg_t *msg, const entityState_t *from, int fromCount,
+	const entityState_t *const *to, int toCount, const entityState_t *baselines ) {
+	int		oldindex, newindex;
+	int		oldnum, newnum;
+
+	oldindex = 0;
+	newindex = 0;
+	while ( newindex < toCount || oldindex < fromCount ) {
+		newnum = ( newindex < toCount ) ? to[ newindex ]->number : MAX_GENTITIES+1;
+		oldnum = ( oldindex < fromCount ) ? from[ oldindex ].number : MAX_GENTITIES+1;
+
+		if ( newnum == oldnum ) {
+			MSG_WriteDeltaEntity( msg, &from[ oldindex ], to[ newindex ], qfalse );
+			oldindex++;
+			newindex++;
+		} else if ( newnum < oldnum ) {
+			MSG_WriteDeltaEntity( msg, &baselines[ newnum ], to[ newindex ], qtrue );
+			newindex++;
+		} else {
+			MSG_WriteDeltaEntity( msg, &from[ oldindex ], NULL, qtrue );
+			oldindex++;
+		}
+	}
+
+	MSG_WriteBits( msg, (MAX_GENTITIES-1), GENTITYNUM_BITS );	// end of packetentities
+}
+
+
+/*
+=============
+SV_DemoParseEntities
+
+Inverse of SV_DemoEmitEntities, returns number of entities in new list or -1 on error
+=============
+*/
+static int SV_DemoParseEntities( msg_t *msg, const entityState_t *from, int fromCount,
+	entityState_t *to, const entityState_t *baselines ) {
+	int		oldindex, newnum;
+	int		count;
+
+	oldindex = 0;
+	count = 0;
+	for ( ;; ) {
+		newnum = MSG_ReadBits( msg, GENTITYNUM_BITS );
+		if ( newnum == MAX_GENTITIES-1 ) {
+			break;
+		}
+		if ( msg->readcount > msg->cursize ) {
+			return -1;
+		}
+
+		// unchanged entities
+		while ( oldindex < fromCount && from[ oldindex ].number < newnum ) {
+			to[ count++ ] = from[ oldindex++ ];
+		}
+
+		if ( oldindex < fromCount && from[ oldindex ].number == newnum ) {
+			MSG_ReadDeltaEntity( msg, &from[ oldindex ], &to[ count ], newnum );
+			oldindex++;
+		} else {
+			MSG_ReadDeltaEntity( msg, &baselines[ newnum ], &to[ count ], newnum );
+		}
+
+		// removed entities are returned with ENTITYNUM_NONE
+		if ( to[ count ].number != MAX_GENTITIES-1 ) {
+			count++;
+		}
+	}
+
+	while ( oldindex < fromCount ) {
+		to[ count++ ] = from[ oldindex++ ];
+	}
+
+	return count;
+}
+
+
+/*
+=============================================================================
+
+Recording
+
+=============================================================================
+*/
+
+/*
+=============
+SV_DemoFlush
+
+Hands pending records to the background writer,
+on failure recording is stopped and qfalse returned
+=============
+*/
+static qboolean SV_DemoFlush( void ) {
+	msg_t	*msg;
+	int		len;
+
+	msg = &recorder->msg;
+	if ( !msg->cursize ) {
+		return qtrue;
+	}
+
+	MSG_WriteByte( msg, svdm_EOF );
+
+	if ( msg->overflowed ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: server demo message overflowed\n" );
+		SV_DemoClose();
+		return qfalse;
+	}
+
+	len = LittleLong( msg->cursize );
+	Com_Memcpy( recorder->block, &len, 4 );
+
+	if ( !Sys_AsyncWrite( recorder->file, recorder->block, msg->cursize + 4 ) ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: server demo writer failed or can't keep up\n" );
+		SV_DemoClose();
+		return qfalse;
+	}
+
+	recorder->size += msg->cursize + 4;
+
+	MSG_Init( msg, recorder->block + 4, SVDEMO_MSGLEN );
+	msg->allowoverflow = qtrue;
+
+	return qtrue;
+}
+
+
+/*
+=============
+SV_DemoWriteGamestate
+=============
+*/
+static void SV_DemoWriteGamestate( void ) {
+	msg_t			*msg;
+	entityState_t	nullstate;
+	int				i;
+
+	msg = &recorder->msg;
+
+	MSG_WriteByte( msg, svdm_gamestate );
+	MSG_WriteLong( msg, sv.checksumFeed );
+
+	for ( i = 0; i < MAX_CONFIGSTRINGS; i++ ) {
+		if ( sv.configstrings[ i ][ 0 ] ) {
+			MSG_WriteShort( msg, i );
+			MSG_WriteBigString( msg, sv.configstrings[ i ] );
+		}
+	}
+	MSG_WriteShort( msg, MAX_CONFIGSTRINGS );
+
+	Com_Memset( &nullstate, 0, sizeof( nullstate ) );
+	for ( i = 0; i < MAX_GENTITIES; i++ ) {
+		if ( !sv.baselineUsed[ i ] ) {
+			continue;
+		}
+		recorder->baselines[ i ] = sv.svEntities[ i ].baseline;
+		MSG_WriteDeltaEntity( msg, &nullstate, &recorder->baselines[ i ], qtrue );
+	}
+	MSG_WriteBits( msg, (MAX_GENTITIES-1), GENTITYNUM_BITS );
+
+	SV_DemoFlush();
+}
+
+
+/*
+=============
+SV_DemoConfigstring
+
+Called when configstring is changed while the game is running
+=============
+*/
+void SV_DemoConfigstring( int index ) {
+	if ( !recorder ) {
+		return;
+	}
+
+	if ( recorder->msg.cursize > SVDEMO_MSGLEN / 2 && !SV_DemoFlush() ) {
+		return;
+	}
+
+	MSG_WriteByte( &recorder->msg, svdm_configstring );
+	MSG_WriteShort( &recorder->msg, index );
+	MSG_WriteBigString( &recorder->msg, sv.configstrings[ index ] );
+}
+
+
+/*
+=============
+SV_DemoServerCommand
+
+Records reliable command sent to client, NULL for broadcast.
+Configstring updates are skipped as they are recorded once by SV_DemoConfigstring()
+=============
+*/
+void SV_DemoServerCommand( const client_t *client, const char *cmd ) {
+	if ( !recorder ) {
+		return;
+	}
+
+	if ( !strncmp( cmd, "cs ", 3 ) || !strncmp( cmd, "bcs", 3 ) ) {
+		return;
+	}
+
+	if ( recorder->msg.cursize > SVDEMO_MSGLEN / 2 && !SV_DemoFlush() ) {
+		return;
+	}
+
+	MSG_WriteByte( &recorder->msg, svdm_serverCommand );
+	MSG_WriteByte( &recorder->msg, client ? (int)( client - svs.clients ) : SVDEMO_ALLCLIENTS );
+	MSG_WriteBigString( &recorder->msg, cmd );
+}
+
+
+/*
+=============
+SV_DemoWriteClient
+
+Player state, areabits and visible entities of a single client
+=============
+*/
+static void SV_DemoWriteClient( msg_t *msg, int clientNum, const clientSnapshot_t *frame ) {
+	svdmClient_t	*rc;
+	byte			visible[ MAX_GENTITIES / 8 ];
+	int				i, n, changed;
+
+	rc = &recorder->clients[ clientNum ];
+
+	MSG_WriteByte( msg, clientNum );
+	MSG_WriteBits( msg, rc->valid, 1 );
+
+	if ( rc->valid ) {
+		MSG_WriteDeltaPlayerstate( msg, &rc->ps, &frame->ps );
+	} else {
+		MSG_WriteDeltaPlayerstate( msg, NULL, &frame->ps );
+		Com_Memset( rc->visible, 0, sizeof( rc->visible ) );
+	}
+
+	if ( rc->valid && rc->areabytes == frame->areabytes && !memcmp( rc->areabits, frame->areabits, frame->areabytes ) ) {
+		MSG_WriteBits( msg, 0, 1 );
+	} else {
+		MSG_WriteBits( msg, 1, 1 );
+		MSG_WriteByte( msg, frame->areabytes );
+		MSG_WriteData( msg, frame->areabits, frame->areabytes );
+	}
+
+	// entities that became visible or hidden since last frame
+	Com_Memset( visible, 0, sizeof( visible ) );
+	for ( i = 0; i < frame->num_entities; i++ ) {
+		n = frame->ents[ i ]->number;
+		visible[ n >> 3 ] |= 1 << ( n & 7 );
+	}
+
+	for ( i = 0; i < ARRAY_LEN( visible ); i++ ) {
+		changed = visible[ i ] ^ rc->visible[ i ];
+		for ( n = 0; changed; n++, changed >>= 1 ) {
+			if ( changed & 1 ) {
+				MSG_WriteBits( msg, i * 8 + n, GENTITYNUM_BITS );
+			}
+		}
+	}
+	MSG_WriteBits( msg, (MAX_GENTITIES-1), GENTITYNUM_BITS );
+
+	rc->valid = qtrue;
+	rc->ps = frame->ps;
+	rc->areabytes = frame->areabytes;
+	Com_Memcpy( rc->areabits, frame->areabits, sizeof( rc->areabits ) );
+	Com_Memcpy( rc->visible, visible, sizeof( rc->visible ) );
+}
+
+
+/*
+=============
+SV_DemoClientFrame
+
+The frame the snapshot pass already built for the client from the current
+common snapshot, either sent or still waiting to be, NULL if the client
+wasn't due for one this server frame
+=============
+*/
+static const clientSnapshot_t *SV_DemoClientFrame( const client_t *cl, const snapshotFrame_t *sf ) {
+	const clientSnapshot_t	*frame;
+	int						i;
+
+	for ( i = 0; i < 2; i++ ) {
+		frame = &cl->frames[ ( cl->netchan.outgoingSequence - i ) & PACKET_MASK ];
+		if ( frame->frameNum == sf->frameNum ) {
+			return frame;
+		}
+	}
+
+	return NULL;
+}
+
+
+/*
+=============
+SV_DemoFrame
+
+Called after client messages are sent each server frame
+=============
+*/
+void SV_DemoFrame( void ) {
+	const snapshotFrame_t	*sf;
+	const clientSnapshot_t	*frame;
+	client_t				*cl;
+	msg_t					*msg;
+	int						i;
+
+	if ( !recorder || sv.state != SS_GAME ) {
+		return;
+	}
+
+	if ( recorder->msg.cursize > SVDEMO_MSGLEN / 2 && !SV_DemoFlush() ) {
+		return;
+	}
+
+	msg = &recorder->msg;
+	sf = SV_GetCommonSnapshot();
+
+	MSG_WriteByte( msg, svdm_frame );
+	MSG_WriteLong( msg, sv.time );
+	MSG_WriteByte( msg, svs.snapFlagServerBit );
+
+	// all entities from the common snapshot
+	SV_DemoEmitEntities( msg, recorder->entities, recorder->numEntities,
+		(const entityState_t *const *)sf->ents, sf->count, recorder->baselines );
+
+	for ( i = 0; i < sf->count; i++ ) {
+		recorder->entities[ i ] = *sf->ents[ i ];
+	}
+	recorder->numEntities = sf->count;
+
+	// point of view of each active client
+	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ ) {
+		if ( cl->state != CS_ACTIVE || !cl->gentity ) {
+			recorder->clients[ i ].valid = qfalse;
+			continue;
+		}
+		// reuse what the snapshot pass culled, only clients that weren't
+		// sent a snapshot this frame are built here
+		frame = SV_DemoClientFrame( cl, sf );
+		if ( !frame ) {
+			SV_BuildDemoFrame( cl, &recorder->frame );
+			frame = &recorder->frame;
+		}
+		SV_DemoWriteClient( msg, i, frame );
+	}
+	MSG_WriteByte( msg, SVDEMO_ALLCLIENTS );
+
+	recorder->numFrames++;
+
+	SV_DemoFlush();
+}
+
+
+/*
+=============
+SV_DemoClose
+
+Terminates the stream and waits for the writer, pending records are dropped
+=============
+*/
+static void SV_DemoClose( void ) {
+	svdmRecorder_t	*rec;
+	int				len;
+
+	rec = recorder;
+	recorder = NULL;
+
+	len = -1;
+	Sys_AsyncWrite( rec->file, &len, 4 );
+
+	if ( Sys_AsyncClose( rec->file ) ) {
+		Com_Printf( "Stopped server demo %s, %i frames, %i KB\n", rec->name, rec->numFrames, ( rec->size + 1023 ) / 1024 );
+	} else {
+		Com_Printf( S_COLOR_YELLOW "WARNING: error writing server demo %s\n", rec->name );
+	}
+
+	free( rec );
+}
+
+
+/*
+=============
+SV_DemoStopRecord
+=============
+*/
+void SV_DemoStopRecord( void ) {
+	if ( recorder && SV_DemoFlush() ) {
+		SV_DemoClose();
+	}
+}
+
+
+/*
+=============
+SV_DemoValidName
+=============
+*/
+static qboolean SV_DemoValidName( const char *name ) {
+	if ( !*name || strstr( name, ".." ) || strpbrk( name, "/\\:" ) ) {
+		Com_Printf( "Invalid demo name \"%s\"\n", name );
+		return qfalse;
+	}
+	return qtrue;
+}
+
+
+/*
+=============
+SV_RecordServer_f
+
+record_server [name]
+=============
+*/
+void SV_RecordServer_f( void ) {
+	char		name[ MAX_QPATH ];
+	char		ospath[ MAX_OSPATH ];
+	qtime_t		t;
+	int			header[ 2 ];
+
+	if ( Cmd_Argc() > 2 ) {
+		Com_Printf( "usage: record_server [name]\n" );
+		return;
+	}
+
+	if ( !com_sv_running->integer || sv.state != SS_GAME ) {
+		Com_Printf( "Server is not running.\n" );
+		return;
+	}
+
+	if ( recorder ) {
+		Com_Printf( "Already recording %s.\n", recorder->name );
+		return;
+	}
+
+	if ( Cmd_Argc() == 2 ) {
+		Q_strncpyz( name, Cmd_Argv( 1 ), sizeof( name ) );
+		FS_StripExt( name, "." SVDEMO_EXT );
+		if ( !SV_DemoValidName( name ) ) {
+			return;
+		}
+	} else {
+		Com_RealTime( &t );
+		Com_sprintf( name, sizeof( name ), "svdemo-%04d%02d%02d-%02d%02d%02d",
+			1900 + t.tm_year, 1 + t.tm_mon,	t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec );
+	}
+
+	// RF, avoid trying to allocate large chunk on a fragmented zone
+	recorder = calloc( 1, sizeof( *recorder ) );
+	if ( !recorder ) {
+		Com_Printf( "Couldn't allocate server demo recorder.\n" );
+		return;
+	}
+
+	Com_sprintf( recorder->name, sizeof( recorder->name ), SVDEMO_DIR "/%s." SVDEMO_EXT, name );
+	Q_strncpyz( ospath, FS_BuildOSPath( FS_GetHomePath(), FS_GetCurrentGameDir(), recorder->name ), sizeof( ospath ) );
+
+	if ( FS_CreatePath( ospath ) || ( recorder->file = Sys_AsyncOpen( ospath ) ) == NULL ) {
+		Com_Printf( "ERROR: couldn't open %s.\n", recorder->name );
+		free( recorder );
+		recorder = NULL;
+		return;
+	}
+
+	Com_Memcpy( &header[ 0 ], SVDEMO_MAGIC, 4 );
+	header[ 1 ] = LittleLong( SVDEMO_VERSION );
+	Sys_AsyncWrite( recorder->file, header, sizeof( header ) );
+	recorder->size = sizeof( header );
+
+	MSG_Init( &recorder->msg, recorder->block + 4, SVDEMO_MSGLEN );
+	recorder->msg.allowoverflow = qtrue;
+
+	Com_Printf( "Recording server demo to %s.\n", recorder->name );
+
+	SV_DemoWriteGamestate();
+}
+
+
+/*
+=============
+SV_StopRecordServer_f
+=============
+*/
+void SV_StopRecordServer_f( void ) {
+	if ( !recorder ) {
+		Com_Printf( "Not recording a server demo.\n" );
+		return;
+	}
+
+	SV_DemoStopRecord();
+}
+
+
+/*
+=============================================================================
+
+Conversion to client demo
+
+=============================================================================
+*/
+
+typedef struct {
+	int				clientNum;
+	fileHandle_t	in;
+	fileHandle_t	out;
+
+	// reconstructed server state
+	int				checksumFeed;
+	char			*configstrings[ MAX_CONFIGSTRINGS ];
+	entityState_t	baselines[ MAX_GENTITIES ];
+	qboolean		baselineUsed[ MAX_GENTITIES ];
+	entityState_t	entities[ 2 ][ MAX_GENTITIES ];
+	int				numEntities;
+	int				current;				// index into entities[]
+	svdmClient_t	clients[ MAX_CLIENTS ];
+
+	// client demo being written
+	qboolean		gamestateWritten;
+	qboolean		deltaValid;
+	int				messageSequence;
+	int				commandSequence;
+	int				numCommands;
+	char			commands[ MAX_RELIABLE_COMMANDS ][ MAX_STRING_CHARS ];
+	int				droppedCommands;
+	playerState_t	ps;
+	int				numSnapEntities;
+	entityState_t	snapEntities[ MAX_SNAPSHOT_ENTITIES ];
+	int				numSnapshots;
+
+	byte			inBuf[ SVDEMO_MSGLEN + 8 ];
+	byte			outBuf[ MAX_MSGLEN_BUF ];
+} svdmConverter_t;
+
+
+/*
+=============
+SV_ConvertQueueCommand
+
+Queues reliable command to be sent with the next snapshot
+=============
+*/
+static void SV_ConvertQueueCommand( svdmConverter_t *cv, const char *cmd ) {
+	if ( !cv->gamestateWritten ) {
+		return; // gamestate will hold current configstrings
+	}
+
+	// live client would be dropped with server command overflow
+	if ( cv->numCommands >= MAX_RELIABLE_COMMANDS ) {
+		cv->droppedCommands++;
+		return;
+	}
+
+	Q_strncpyz( cv->commands[ cv->numCommands++ ], cmd, MAX_STRING_CHARS );
+}
+
+
+/*
+=============
+SV_ConvertConfigstring
+
+Same commands as SV_SendConfigstring() would generate
+=============
+*/
+static void SV_ConvertConfigstring( svdmConverter_t *cv, int index ) {
+	const int	maxChunkSize = MAX_STRING_CHARS - 24;
+	const char	*cs;
+	const char	*cmd;
+	char		buf[ MAX_STRING_CHARS ];
+	int			sent, remaining;
+
+	cs = cv->configstrings[ index ];
+	remaining = strlen( cs );
+
+	if ( remaining < maxChunkSize ) {
+		SV_ConvertQueueCommand( cv, va( "cs %i \"%s\"", index, cs ) );
+		return;
+	}
+
+	for ( sent = 0; remaining > 0; sent += maxChunkSize - 1, remaining -= maxChunkSize - 1 ) {
+		if ( sent == 0 ) {
+			cmd = "bcs0";
+		} else if ( remaining < maxChunkSize ) {
+			cmd = "bcs2";
+		} else {
+			cmd = "bcs1";
+		}
+		Q_strncpyz( buf, cs + sent, maxChunkSize );
+		SV_ConvertQueueCommand( cv, va( "%s %i \"%s\"", cmd, index, buf ) );
+	}
+}
+
+
+/*
+=============
+SV_ConvertWriteMessage
+=============
+*/
+static void SV_ConvertWriteMessage( svdmConverter_t *cv, const msg_t *msg, int sequence ) {
+	int len;
+
+	len = LittleLong( sequence );
+	FS_Write( &len, 4, cv->out );
+	len = LittleLong( msg->cursize );
+	FS_Write( &len, 4, cv->out );
+	FS_Write( msg->data, msg->cursize, cv->out );
+}
+
+
+/*
+=============
+SV_ConvertWriteGamestate
+=============
+*/
+static void SV_ConvertWriteGamestate( svdmConverter_t *cv ) {
+	msg_t			msg;
+	entityState_t	nullstate;
+	int				i;
+
+	MSG_Init( &msg, cv->outBuf, MAX_MSGLEN );
+	MSG_Bitstream( &msg );
+
+	MSG_WriteLong( &msg, 0 );
+
+	MSG_WriteByte( &msg, svc_gamestate );
+	MSG_WriteLong( &msg, cv->commandSequence );
+
+	for ( i = 0; i < MAX_CONFIGSTRINGS; i++ ) {
+		if ( !cv->configstrings[ i ] || !cv->configstrings[ i ][ 0 ] ) {
+			continue;
+		}
+		MSG_WriteByte( &msg, svc_configstring );
+		MSG_WriteShort( &msg, i );
+		MSG_WriteBigString( &msg, cv->configstrings[ i ] );
+	}
+
+	Com_Memset( &nullstate, 0, sizeof( nullstate ) );
+	for ( i = 0; i < MAX_GENTITIES; i++ ) {
+		if ( !cv->baselineUsed[ i ] ) {
+			continue;
+		}
+		MSG_WriteByte( &msg, svc_baseline );
+		MSG_WriteDeltaEntity( &msg, &nullstate, &cv->baselines[ i ], qtrue );
+	}
+
+	MSG_WriteByte( &msg, svc_EOF );
+
+	MSG_WriteLong( &msg, cv->clientNum );
+	MSG_WriteLong( &msg, cv->checksumFeed );
+
+	MSG_WriteByte( &msg, svc_EOF );
+
+	SV_ConvertWriteMessage( cv, &msg, cv->messageSequence - 1 );
+
+	cv->gamestateWritten = qtrue;
+	cv->deltaValid = qfalse;
+	cv->numCommands = 0;
+}
+
+
+/*
+=============
+SV_ConvertWriteSnapshot
+
+Builds snapshot of selected client from current frame
+=============
+*/
+static qboolean SV_ConvertWriteSnapshot( svdmConverter_t *cv, int serverTime, int snapFlags ) {
+	const svdmClient_t	*rc;
+	const entityState_t	*ents[ MAX_SNAPSHOT_ENTITIES ];
+	const entityState_t	*es;
+	msg_t				msg;
+	int					i, n, count;
+
+	rc = &cv->clients[ cv->clientNum ];
+
+	count = 0;
+	for ( i = 0; i < cv->numEntities; i++ ) {
+		es = &cv->entities[ cv->current ][ i ];
+		n = es->number;
+		if ( rc->visible[ n >> 3 ] & ( 1 << ( n & 7 ) ) ) {
+			if ( count >= MAX_SNAPSHOT_ENTITIES ) {
+				break;
+			}
+			ents[ count++ ] = es;
+		}
+	}
+
+	MSG_Init( &msg, cv->outBuf, MAX_MSGLEN );
+	MSG_Bitstream( &msg );
+	msg.allowoverflow = qtrue;
+
+	MSG_WriteLong( &msg, 0 );
+
+	for ( i = 0; i < cv->numCommands; i++ ) {
+		MSG_WriteByte( &msg, svc_serverCommand );
+		MSG_WriteLong( &msg, ++cv->commandSequence );
+		MSG_WriteString( &msg, cv->commands[ i ] );
+	}
+	cv->numCommands = 0;
+
+	MSG_WriteByte( &msg, svc_snapshot );
+	MSG_WriteLong( &msg, serverTime );
+	MSG_WriteByte( &msg, cv->deltaValid ? 1 : 0 );
+	MSG_WriteByte( &msg, snapFlags );
+	MSG_WriteByte( &msg, rc->areabytes );
+	MSG_WriteData( &msg, rc->areabits, rc->areabytes );
+
+	if ( cv->deltaValid ) {
+		MSG_WriteDeltaPlayerstate( &msg, &cv->ps, &rc->ps );
+		SV_DemoEmitEntities( &msg, cv->snapEntities, cv->numSnapEntities, ents, count, cv->baselines );
+	} else {
+		MSG_WriteDeltaPlayerstate( &msg, NULL, &rc->ps );
+		SV_DemoEmitEntities( &msg, NULL, 0, ents, count, cv->baselines );
+	}
+
+	MSG_WriteByte( &msg, svc_EOF );
+
+	if ( msg.overflowed ) {
+		Com_Printf( "Snapshot message overflowed at %i\n", serverTime );
+		return qfalse;
+	}
+
+	SV_ConvertWriteMessage( cv, &msg, cv->messageSequence );
+
+	cv->ps = rc->ps;
+	for ( i = 0; i < count; i++ ) {
+		cv->snapEntities[ i ] = *ents[ i ];
+	}
+	cv->numSnapEntities = count;
+
+	cv->messageSequence++;
+	cv->deltaValid = qtrue;
+	cv->numSnapshots++;
+
+	return qtrue;
+}
+
+
+/*
+=============
+SV_ConvertParseGamestate
+=============
+*/
+static qboolean SV_ConvertParseGamestate( svdmConverter_t *cv, msg_t *msg ) {
+	entityState_t	nullstate;
+	int				i;
+
+	cv->checksumFeed = MSG_ReadLong( msg );
+
+	for ( i = 0; i < MAX_CONFIGSTRINGS; i++ ) {
+		if ( cv->configstrings[ i ] ) {
+			Z_Free( cv->configstrings[ i ] );
+			cv->configstrings[ i ] = NULL;
+		}
+	}
+
+	for ( ;; ) {
+		i = MSG_ReadShort( msg );
+		if ( i == MAX_CONFIGSTRINGS ) {
+			break;
+		}
+		if ( i < 0 || i > MAX_CONFIGSTRINGS || msg->readcount > msg->cursize ) {
+			return qfalse;
+		}
+		cv->configstrings[ i ] = CopyString( MSG_ReadBigString( msg ) );
+	}
+
+	Com_Memset( &nullstate, 0, sizeof( nullstate ) );
+	Com_Memset( cv->baselines, 0, sizeof( cv->baselines ) );
+	Com_Memset( cv->baselineUsed, 0, sizeof( cv->baselineUsed ) );
+
+	for ( ;; ) {
+		i = MSG_ReadBits( msg, GENTITYNUM_BITS );
+		if ( i == MAX_GENTITIES-1 ) {
+			break;
+		}
+		if ( msg->readcount > msg->cursize ) {
+			return qfalse;
+		}
+		MSG_ReadDeltaEntity( msg, &nullstate, &cv->baselines[ i ], i );
+		cv->baselineUsed[ i ] = qtrue;
+	}
+
+	cv->numEntities = 0;
+	Com_Memset( cv->clients, 0, sizeof( cv->clients ) );
+	cv->gamestateWritten = qfalse;
+
+	return qtrue;
+}
+
+
+/*
+=============
+SV_ConvertParseClient
+
+Returns selected client number or -1 on error
+=============
+*/
+static int SV_ConvertParseClient( svdmConverter_t *cv, msg_t *msg ) {
+	svdmClient_t	*rc;
+	playerState_t	ps;
+	int				clientNum, n;
+
+	clientNum = MSG_ReadByte( msg );
+	if ( clientNum == SVDEMO_ALLCLIENTS ) {
+		return clientNum;
+	}
+	if ( clientNum < 0 || clientNum > SVDEMO_ALLCLIENTS ) {
+		return -1;
+	}
+
+	rc = &cv->clients[ clientNum ];
+
+	if ( MSG_ReadBits( msg, 1 ) ) {
+		MSG_ReadDeltaPlayerstate( msg, &rc->ps, &ps );
+	} else {
+		MSG_ReadDeltaPlayerstate( msg, NULL, &ps );
+		Com_Memset( rc->visible, 0, sizeof( rc->visible ) );
+	}
+	rc->ps = ps;
+
+	if ( MSG_ReadBits( msg, 1 ) ) {
+		rc->areabytes = MSG_ReadByte( msg );
+		if ( rc->areabytes < 0 || rc->areabytes > MAX_MAP_AREA_BYTES ) {
+			return -1;
+		}
+		MSG_ReadData( msg, rc->areabits, rc->areabytes );
+	}
+
+	for ( ;; ) {
+		n = MSG_ReadBits( msg, GENTITYNUM_BITS );
+		if ( n == MAX_GENTITIES-1 ) {
+			break;
+		}
+		if ( msg->readcount > msg->cursize ) {
+			return -1;
+		}
+		rc->visible[ n >> 3 ] ^= 1 << ( n & 7 );
+	}
+
+	return clientNum;
+}
+
+
+/*
+=============
+SV_ConvertParseFrame
+=============
+*/
+static qboolean SV_ConvertParseFrame( svdmConverter_t *cv, msg_t *msg ) {
+	int			serverTime, snapFlags;
+	int			clientNum, count;
+	qboolean	present;
+
+	serverTime = MSG_ReadLong( msg );
+	snapFlags = MSG_ReadByte( msg );
+
+	count = SV_DemoParseEntities( msg, cv->entities[ cv->current ], cv->numEntities,
+		cv->entities[ cv->current ^ 1 ], cv->baselines );
+	if ( count < 0 ) {
+		return qfalse;
+	}
+	cv->current ^= 1;
+	cv->numEntities = count;
+
+	present = qfalse;
+	for ( ;; ) {
+		clientNum = SV_ConvertParseClient( cv, msg );
+		if ( clientNum == SVDEMO_ALLCLIENTS ) {
+			break;
+		}
+		if ( clientNum < 0 || msg->readcount > msg->cursize ) {
+			return qfalse;
+		}
+		if ( clientNum == cv->clientNum ) {
+			present = qtrue;
+		}
+	}
+
+	if ( !present ) {
+		cv->deltaValid = qfalse;
+		return qtrue;
+	}
+
+	if ( !cv->gamestateWritten ) {
+		SV_ConvertWriteGamestate( cv );
+	}
+
+	return SV_ConvertWriteSnapshot( cv, serverTime, snapFlags );
+}
+
+
+/*
+=============
+SV_ConvertParseMessage
+=============
+*/
+static qboolean SV_ConvertParseMessage( svdmConverter_t *cv, msg_t *msg ) {
+	int		cmd, index;
+
+	for ( ;; ) {
+		if ( msg->readcount > msg->cursize ) {
+			return qfalse;
+		}
+
+		cmd = MSG_ReadByte( msg );
+
+		switch ( cmd ) {
+		case svdm_EOF:
+			return qtrue;
+
+		case svdm_gamestate:
+			if ( !SV_ConvertParseGamestate( cv, msg ) ) {
+				return qfalse;
+			}
+			break;
+
+		case svdm_configstring:
+			index = MSG_ReadShort( msg );
+			if ( index < 0 || index >= MAX_CONFIGSTRINGS ) {
+				return qfalse;
+			}
+			if ( cv->configstrings[ index ] ) {
+				Z_Free( cv->configstrings[ index ] );
+			}
+			cv->configstrings[ index ] = CopyString( MSG_ReadBigString( msg ) );
+			SV_ConvertConfigstring( cv, index );
+			break;
+
+		case svdm_serverCommand:
+			index = MSG_ReadByte( msg );
+			if ( index == cv->clientNum || index == SVDEMO_ALLCLIENTS ) {
+				SV_ConvertQueueCommand( cv, MSG_ReadBigString( msg ) );
+			} else {
+				MSG_ReadBigString( msg );
+			}
+			break;
+
+		case svdm_frame:
+			if ( !SV_ConvertParseFrame( cv, msg ) ) {
+				return qfalse;
+			}
+			break;
+
+		default:
+			return qfalse;
+		}
+	}
+}
+
+
+/*
+=============
+SV_ConvertServerDemo_f
+
+convertdemo_server <svdemo> <clientNum> [output]
+=============
+*/
+void SV_ConvertServerDemo_f( void ) {
+	svdmConverter_t	*cv;
+	char			name[ MAX_QPATH ];
+	char			output[ MAX_QPATH ];
+	char			header[ 4 ];
+	msg_t			msg;
+	int				version, len, i;
+	qboolean		ok;
+
+	if ( Cmd_Argc() < 3 || Cmd_Argc() > 4 ) {
+		Com_Printf( "usage: convertdemo_server <svdemo> <clientNum> [output]\n" );
+		return;
+	}
+
+	Q_strncpyz( name, Cmd_Argv( 1 ), sizeof( name ) );
+	FS_StripExt( name, "." SVDEMO_EXT );
+	if ( !SV_DemoValidName( name ) ) {
+		return;
+	}
+
+	i = atoi( Cmd_Argv( 2 ) );
+	if ( i < 0 || i >= MAX_CLIENTS ) {
+		Com_Printf( "Bad client number %i\n", i );
+		return;
+	}
+
+	if ( Cmd_Argc() == 4 ) {
+		Q_strncpyz( output, Cmd_Argv( 3 ), sizeof( output ) );
+		if ( !SV_DemoValidName( output ) ) {
+			return;
+		}
+	} else {
+		Com_sprintf( output, sizeof( output ), "%s-%i", name, i );
+	}
+
+	// RF, avoid trying to allocate large chunk on a fragmented zone
+	cv = calloc( 1, sizeof( *cv ) );
+	if ( !cv ) {
+		Com_Printf( "Couldn't allocate server demo converter.\n" );
+		return;
+	}
+
+	cv->clientNum = i;
+	cv->messageSequence = 1;
+
+	FS_FOpenFileRead( va( SVDEMO_DIR "/%s." SVDEMO_EXT, name ), &cv->in, qtrue );
+	if ( cv->in == FS_INVALID_HANDLE ) {
+		Com_Printf( "Couldn't open " SVDEMO_DIR "/%s." SVDEMO_EXT "\n", name );
+		free( cv );
+		return;
+	}
+
+	version = 0;
+	if ( FS_Read( header, 4, cv->in ) != 4 || memcmp( header, SVDEMO_MAGIC, 4 ) != 0
+		|| FS_Read( &version, 4, cv->in ) != 4 || LittleLong( version ) != SVDEMO_VERSION ) {
+		Com_Printf( "%s is not a supported server demo\n", name );
+		FS_FCloseFile( cv->in );
+		free( cv );
+		return;
+	}
+
+	Q_strcat( output, sizeof( output ), va( ".%s%d", DEMOEXT, OLD_PROTOCOL_VERSION ) );
+	cv->out = FS_FOpenFileWrite( va( "demos/%s", output ) );
+	if ( cv->out == FS_INVALID_HANDLE ) {
+		Com_Printf( "Couldn't open demos/%s\n", output );
+		FS_FCloseFile( cv->in );
+		free( cv );
+		return;
+	}
+
+	ok = qtrue;
+	for ( ;; ) {
+		if ( FS_Read( &len, 4, cv->in ) != 4 ) {
+			ok = qfalse;
+			break;
+		}
+		len = LittleLong( len );
+		if ( len == -1 ) {
+			break;
+		}
+		if ( len <= 0 || len > SVDEMO_MSGLEN || FS_Read( cv->inBuf, len, cv->in ) != len ) {
+			ok = qfalse;
+			break;
+		}
+
+		MSG_Init( &msg, cv->inBuf, SVDEMO_MSGLEN );
+		msg.cursize = len;
+		MSG_BeginReading( &msg );
+
+		if ( !SV_ConvertParseMessage( cv, &msg ) ) {
+			ok = qfalse;
+			break;
+		}
+	}
+
+	// end of demo
+	len = -1;
+	FS_Write( &len, 4, cv->out );
+	FS_Write( &len, 4, cv->out );
+	FS_FCloseFile( cv->out );
+	FS_FCloseFile( cv->in );
+
+	if ( !ok ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: %s is truncated or corrupted\n", name );
+	}
+	if ( cv->droppedCommands ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: %i server commands dropped\n", cv->droppedCommands );
+	}
+	Com_Printf( "Wrote %i snapshots of client %i to demos/%s\n", cv->numSnapshots, cv->clientNum, output );
+
+	for ( i = 0; i < MAX_CONFIGSTRINGS; i++ ) {
+		if ( cv->configstrings[ i ] ) {
+			Z_Free( cv->configstrings[ i ] );
+		}
+	}
+	free( cv );
+}
+
+
+/*
+==================
+SV_CompleteServerDemoName
+==================
+*/
+void SV_CompleteServerDemoName( char *args, int argNum ) {
+	if ( argNum == 2 ) {
+		Field_CompleteFilename( SVDEMO_DIR, SVDEMO_EXT, qtrue, FS_MATCH_ANY | FS_MATCH_STICK );
+	}
+}
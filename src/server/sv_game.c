@@ -769,6 +769,7 @@ Called for both a full init and a restart
 */
 static void SV_InitGameVM( qboolean restart ) {
 	int		i;
+	int		seed;
 
 	// start the entity parsing at the beginning
 	sv.entityParsePoint = CM_EntityString();
@@ -785,12 +786,15 @@ static void SV_InitGameVM( qboolean restart ) {
 		Cmd_RegisterArray( etf_cmds, MODULE_SERVER );
 	}
 
-	// use the current msec count for a random seed
+	// use the current msec count for a random seed, a spawn picks
+	// it in advance so packet journals can reproduce it
+	seed = restart ? Com_Milliseconds() : sv.randomSeed;
+
 	// init for this gamestate
 	if ( currentGameMod == GAMEMOD_LEGACY )
-		VM_Call( gvm, 5, GAME_INIT, sv.time, Com_Milliseconds(), restart, qtrue, com_legacyVersion->integer );
+		VM_Call( gvm, 5, GAME_INIT, sv.time, seed, restart, qtrue, com_legacyVersion->integer );
 	else
-		VM_Call( gvm, 3, GAME_INIT, sv.time, Com_Milliseconds(), restart );
+		VM_Call( gvm, 3, GAME_INIT, sv.time, seed, restart );
 }
 
 
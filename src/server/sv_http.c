@@ -0,0 +1,796 @@
+/*
+===========================================================================
+
+Wolfenstein: Enemy Territory GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Wolfenstein: Enemy Territory GPL Source Code (Wolf ET Source Code).  
+
+Wolf ET Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Wolf ET Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Wolf ET Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Wolf: ET Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Wolf ET Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+// sv_http.c -- minimal non-blocking HTTP/1.1 server for referenced pk3 files,
+// used as the www download redirect target when sv_wwwBaseURL is not set
+
+#ifdef __linux__
+#	ifndef _GNU_SOURCE
+#		define _GNU_SOURCE
+#	endif
+#endif
+
+#include "server.h"
+
+#ifdef _WIN32
+#	include <winsock2.h>
+#	include <io.h>
+#	include <fcntl.h>
+
+typedef int socklen_t;
+typedef u_long	ioctlarg_t;
+#	define socketError			WSAGetLastError( )
+#	define HTTP_WOULDBLOCK		WSAEWOULDBLOCK
+
+#else // !_WIN32
+
+#	include <sys/socket.h>
+#	include <sys/types.h>
+#	include <sys/ioctl.h>
+#	include <netinet/in.h>
+#	include <arpa/inet.h>
+#	include <errno.h>
+#	include <fcntl.h>
+#	include <signal.h>
+#	include <unistd.h>
+#	ifdef __sun
+#		include <sys/filio.h>
+#	endif
+#	ifdef __linux__
+#		include <sys/sendfile.h>
+#		define USE_SENDFILE
+#	endif
+
+typedef int SOCKET;
+#	define INVALID_SOCKET		-1
+#	define SOCKET_ERROR			-1
+#	define closesocket			close
+#	define ioctlsocket			ioctl
+typedef int	ioctlarg_t;
+#	define socketError			errno
+#	define HTTP_WOULDBLOCK		EAGAIN
+
+#endif
+
+#ifndef MSG_NOSIGNAL
+#	define MSG_NOSIGNAL	0
+#endif
+
+#define MAX_HTTP_CONNECTIONS	64
+#define HTTP_REQUEST_SIZE		2048
+#define HTTP_HEADER_SIZE		512
+#define HTTP_IDLE_TIMEOUT		20000
+#define HTTP_SEND_BUDGET		(256*1024)	// per connection and call, keeps idle loop responsive
+
+typedef enum {
+	HTTP_FREE,
+	HTTP_READ_REQUEST,
+	HTTP_SEND_HEADER,
+	HTTP_SEND_BODY
+} httpState_t;
+
+typedef struct {
+	httpState_t	state;
+	SOCKET		sock;
+	char		address[NET_ADDRSTRMAXLEN];
+	int			lastActive;
+	qboolean	keepAlive;
+
+	char		request[HTTP_REQUEST_SIZE];
+	int			requestLength;
+
+	char		header[HTTP_HEADER_SIZE];
+	int			headerLength;
+	int			headerSent;
+
+	int			file;
+	int64_t		offset;		// next byte to send
+	int64_t		end;		// one past last byte to send
+	char		name[MAX_QPATH];
+} httpConnection_t;
+
+static SOCKET			http_socket = INVALID_SOCKET;
+static int				http_port;
+static httpConnection_t	http_connections[ MAX_HTTP_CONNECTIONS ];
+
+
+/*
+==================
+SV_HTTPOpenFile
+==================
+*/
+static int SV_HTTPOpenFile( const char *ospath, int64_t *size )
+{
+	int fd;
+
+#ifdef _WIN32
+	fd = _open( ospath, _O_RDONLY | _O_BINARY );
+	if ( fd >= 0 )
+		*size = _lseeki64( fd, 0, SEEK_END );
+#else
+	fd = open( ospath, O_RDONLY );
+	if ( fd >= 0 )
+		*size = lseek( fd, 0, SEEK_END );
+#endif
+
+	return fd;
+}
+
+
+/*
+==================
+SV_HTTPCloseFile
+==================
+*/
+static void SV_HTTPCloseFile( int fd )
+{
+#ifdef _WIN32
+	_close( fd );
+#else
+	close( fd );
+#endif
+}
+
+
+#ifndef USE_SENDFILE
+/*
+==================
+SV_HTTPReadFile
+==================
+*/
+static int SV_HTTPReadFile( int fd, int64_t offset, void *buffer, int length )
+{
+#ifdef _WIN32
+	if ( _lseeki64( fd, offset, SEEK_SET ) != offset )
+		return -1;
+	return _read( fd, buffer, length );
+#else
+	return pread( fd, buffer, length, offset );
+#endif
+}
+#endif
+
+
+/*
+==================
+SV_HTTPCloseConnection
+==================
+*/
+static void SV_HTTPCloseConnection( httpConnection_t *conn )
+{
+	if ( conn->file >= 0 ) {
+		SV_HTTPCloseFile( conn->file );
+		conn->file = -1;
+	}
+
+	if ( conn->sock != INVALID_SOCKET ) {
+		closesocket( conn->sock );
+		conn->sock = INVALID_SOCKET;
+	}
+
+	conn->state = HTTP_FREE;
+}
+
+
+/*
+==================
+SV_HTTPCloseListener
+==================
+*/
+static void SV_HTTPCloseListener( void )
+{
+	if ( http_socket != INVALID_SOCKET ) {
+		closesocket( http_socket );
+		http_socket = INVALID_SOCKET;
+	}
+	http_port = 0;
+}
+
+
+/*
+==================
+SV_HTTPOpenListener
+==================
+*/
+static void SV_HTTPOpenListener( int port )
+{
+	struct sockaddr_in addr;
+	const char *ip;
+	ioctlarg_t nonblocking = 1;
+	int reuse = 1;
+
+	http_socket = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+	if ( http_socket == INVALID_SOCKET ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: SV_HTTPOpenListener: socket() failed: %i\n", socketError );
+		return;
+	}
+
+	setsockopt( http_socket, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof( reuse ) );
+
+	if ( ioctlsocket( http_socket, FIONBIO, &nonblocking ) == SOCKET_ERROR ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: SV_HTTPOpenListener: ioctl FIONBIO: %i\n", socketError );
+		SV_HTTPCloseListener();
+		return;
+	}
+
+	memset( &addr, 0, sizeof( addr ) );
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons( (unsigned short)port );
+	addr.sin_addr.s_addr = INADDR_ANY;
+
+	// follow the game socket if it is bound to a specific address
+	ip = Cvar_VariableString( "net_ip" );
+	if ( *ip && Q_stricmp( ip, "localhost" ) && inet_addr( ip ) != INADDR_NONE ) {
+		addr.sin_addr.s_addr = inet_addr( ip );
+	}
+
+	if ( bind( http_socket, (struct sockaddr *)&addr, sizeof( addr ) ) == SOCKET_ERROR
+		|| listen( http_socket, 16 ) == SOCKET_ERROR ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: SV_HTTPOpenListener: can't listen on TCP port %i: %i\n", port, socketError );
+		SV_HTTPCloseListener();
+		return;
+	}
+
+#ifndef _WIN32
+	// sendfile() has no MSG_NOSIGNAL equivalent, a vanished peer must not kill the server
+	signal( SIGPIPE, SIG_IGN );
+#endif
+
+	http_port = port;
+
+	Com_Printf( "Serving pk3 downloads over HTTP on TCP port %i\n", port );
+	if ( !SV_HTTPBaseURL() ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: sv_httpHost is not set, clients will not be redirected to the HTTP server\n" );
+	}
+}
+
+
+/*
+==================
+SV_HTTPAccept
+==================
+*/
+static void SV_HTTPAccept( void )
+{
+	struct sockaddr_in addr;
+	socklen_t addrlen;
+	httpConnection_t *conn;
+	ioctlarg_t nonblocking = 1;
+	SOCKET sock;
+	int i;
+
+	for ( ;; ) {
+		addrlen = sizeof( addr );
+		sock = accept( http_socket, (struct sockaddr *)&addr, &addrlen );
+		if ( sock == INVALID_SOCKET )
+			return;
+
+		conn = NULL;
+		for ( i = 0; i < sv_httpMaxConnections->integer; i++ ) {
+			if ( http_connections[i].state == HTTP_FREE ) {
+				conn = &http_connections[i];
+				break;
+			}
+		}
+
+		if ( !conn || ioctlsocket( sock, FIONBIO, &nonblocking ) == SOCKET_ERROR ) {
+			closesocket( sock );
+			continue;
+		}
+
+		memset( conn, 0, sizeof( *conn ) );
+		conn->state = HTTP_READ_REQUEST;
+		conn->sock = sock;
+		conn->file = -1;
+		conn->lastActive = Sys_Milliseconds();
+		Q_strncpyz( conn->address, inet_ntoa( addr.sin_addr ), sizeof( conn->address ) );
+	}
+}
+
+
+/*
+==================
+SV_HTTPHexDigit
+==================
+*/
+static int SV_HTTPHexDigit( int c )
+{
+	if ( c >= '0' && c <= '9' )
+		return c - '0';
+	return ( c | 32 ) - 'a' + 10;
+}
+
+
+/*
+==================
+SV_HTTPDecodePath
+
+Percent-decodes request path into a game relative file name,
+rejects anything that could escape the search paths
+==================
+*/
+static qboolean SV_HTTPDecodePath( const char *uri, char *out, int size )
+{
+	int c, len;
+
+	if ( *uri != '/' )
+		return qfalse;
+	uri++;
+
+	for ( len = 0; *uri && *uri != '?'; uri++ ) {
+		c = *uri;
+		if ( c == '%' ) {
+			if ( !isxdigit( (byte)uri[1] ) || !isxdigit( (byte)uri[2] ) )
+				return qfalse;
+			c = ( SV_HTTPHexDigit( uri[1] ) << 4 ) | SV_HTTPHexDigit( uri[2] );
+			uri += 2;
+		}
+		if ( c < ' ' || c == '\\' || c == ':' || len >= size - 1 )
+			return qfalse;
+		out[ len++ ] = c;
+	}
+	out[ len ] = '\0';
+
+	if ( !len || out[0] == '/' || strstr( out, ".." ) )
+		return qfalse;
+
+	return qtrue;
+}
+
+
+/*
+==================
+SV_HTTPSetResponse
+==================
+*/
+static void SV_HTTPSetResponse( httpConnection_t *conn, const char *status, const char *extra, int64_t length )
+{
+	conn->headerLength = Com_sprintf( conn->header, sizeof( conn->header ),
+		"HTTP/1.1 %s\r\n"
+		"Server: " Q3_VERSION "\r\n"
+		"Content-Type: application/octet-stream\r\n"
+		"Content-Length: %lld\r\n"
+		"Accept-Ranges: bytes\r\n"
+		"%s"
+		"Connection: %s\r\n"
+		"\r\n", status, (long long)length, extra, conn->keepAlive ? "keep-alive" : "close" );
+	conn->headerSent = 0;
+	conn->state = HTTP_SEND_HEADER;
+}
+
+
+/*
+==================
+SV_HTTPParseRange
+
+Parses single "bytes=" range, returns qfalse if range is not satisfiable.
+Unsupported forms are ignored and the whole file is sent.
+==================
+*/
+static qboolean SV_HTTPParseRange( const char *s, int64_t size, int64_t *start, int64_t *end )
+{
+	int64_t first, last;
+	char *p;
+
+	while ( *s == ' ' )
+		s++;
+
+	if ( Q_stricmpn( s, "bytes=", 6 ) || strchr( s, ',' ) )
+		return qtrue;
+	s += 6;
+
+	if ( *s == '-' ) {
+		// suffix range, last N bytes
+		last = strtoll( s + 1, &p, 10 );
+		if ( p == s + 1 || last <= 0 )
+			return qfalse;
+		*start = size > last ? size - last : 0;
+		*end = size;
+		return ( size > 0 );
+	}
+
+	first = strtoll( s, &p, 10 );
+	if ( p == s || *p != '-' || first < 0 )
+		return qtrue;
+	s = p + 1;
+
+	last = size - 1;
+	if ( *s >= '0' && *s <= '9' ) {
+		last = strtoll( s, &p, 10 );
+		if ( last < first )
+			return qtrue;
+		if ( last > size - 1 )
+			last = size - 1;
+	}
+
+	if ( first >= size )
+		return qfalse;
+
+	*start = first;
+	*end = last + 1;
+	return qtrue;
+}
+
+
+/*
+==================
+SV_HTTPParseRequest
+
+Handles complete request header in conn->request,
+returns length of consumed request data
+==================
+*/
+static int SV_HTTPParseRequest( httpConnection_t *conn, char *terminator )
+{
+	char path[ MAX_QPATH ], pakname[ MAX_QPATH ], extra[ 128 ];
+	char *line, *next, *method, *uri, *version, *ext;
+	const char *range, *ospath;
+	qboolean head;
+	int64_t size, start, end;
+	int consumed;
+
+	consumed = terminator - conn->request + 4;
+	terminator[2] = '\0';
+
+	// request line
+	method = conn->request;
+	next = strstr( method, "\r\n" );
+	*next = '\0';
+	next += 2;
+
+	uri = strchr( method, ' ' );
+	version = uri ? strchr( uri + 1, ' ' ) : NULL;
+	if ( !version ) {
+		conn->keepAlive = qfalse;
+		SV_HTTPSetResponse( conn, "400 Bad Request", "", 0 );
+		return consumed;
+	}
+	*uri++ = '\0';
+	*version++ = '\0';
+
+	conn->keepAlive = ( strcmp( version, "HTTP/1.1" ) == 0 );
+	range = NULL;
+
+	// header fields
+	for ( line = next; *line; line = next ) {
+		next = strstr( line, "\r\n" );
+		*next = '\0';
+		next += 2;
+		if ( !Q_stricmpn( line, "Range:", 6 ) ) {
+			range = line + 6;
+		} else if ( !Q_stricmpn( line, "Connection:", 11 ) ) {
+			if ( Q_stristr( line + 11, "close" ) )
+				conn->keepAlive = qfalse;
+			else if ( Q_stristr( line + 11, "keep-alive" ) )
+				conn->keepAlive = qtrue;
+		}
+	}
+
+	head = ( strcmp( method, "HEAD" ) == 0 );
+	if ( !head && strcmp( method, "GET" ) ) {
+		SV_HTTPSetResponse( conn, "405 Method Not Allowed", "Allow: GET, HEAD\r\n", 0 );
+		return consumed;
+	}
+
+	if ( !SV_HTTPDecodePath( uri, path, sizeof( path ) ) ) {
+		SV_HTTPSetResponse( conn, "400 Bad Request", "", 0 );
+		return consumed;
+	}
+
+	// same rules as UDP downloads: referenced non-id pk3 files only
+	Q_strncpyz( pakname, path, sizeof( pakname ) );
+	ext = strrchr( pakname, '.' );
+	if ( !ext || Q_stricmp( ext, ".pk3" ) ) {
+		SV_HTTPSetResponse( conn, "404 Not Found", "", 0 );
+		return consumed;
+	}
+	*ext = '\0';
+
+	ospath = NULL;
+	if ( SV_ReferencedPak( pakname ) && !FS_idPak( pakname, BASEGAME ) ) {
+		ospath = FS_SV_FindOSPath( path );
+	}
+
+	if ( !ospath || ( conn->file = SV_HTTPOpenFile( ospath, &size ) ) < 0 ) {
+		SV_HTTPSetResponse( conn, "404 Not Found", "", 0 );
+		return consumed;
+	}
+
+	start = 0;
+	end = size;
+	if ( range && !SV_HTTPParseRange( range, size, &start, &end ) ) {
+		SV_HTTPCloseFile( conn->file );
+		conn->file = -1;
+		Com_sprintf( extra, sizeof( extra ), "Content-Range: bytes */%lld\r\n", (long long)size );
+		SV_HTTPSetResponse( conn, "416 Range Not Satisfiable", extra, 0 );
+		return consumed;
+	}
+
+	if ( start != 0 || end != size ) {
+		Com_sprintf( extra, sizeof( extra ), "Content-Range: bytes %lld-%lld/%lld\r\n",
+			(long long)start, (long long)( end - 1 ), (long long)size );
+		SV_HTTPSetResponse( conn, "206 Partial Content", extra, end - start );
+	} else {
+		SV_HTTPSetResponse( conn, "200 OK", "", size );
+	}
+
+	if ( head ) {
+		SV_HTTPCloseFile( conn->file );
+		conn->file = -1;
+		return consumed;
+	}
+
+	Q_strncpyz( conn->name, path, sizeof( conn->name ) );
+	conn->offset = start;
+	conn->end = end;
+
+	Com_DPrintf( "HTTP: %s requested %s (%lld-%lld/%lld)\n", conn->address, path,
+		(long long)start, (long long)end, (long long)size );
+
+	return consumed;
+}
+
+
+/*
+==================
+SV_HTTPReadRequest
+==================
+*/
+static qboolean SV_HTTPReadRequest( httpConnection_t *conn )
+{
+	char *terminator;
+	int ret, consumed;
+
+	if ( conn->requestLength < sizeof( conn->request ) - 1 ) {
+		ret = recv( conn->sock, conn->request + conn->requestLength,
+			sizeof( conn->request ) - 1 - conn->requestLength, 0 );
+
+		if ( ret == 0 )
+			return qfalse; // peer closed connection
+
+		if ( ret == SOCKET_ERROR ) {
+			if ( socketError != HTTP_WOULDBLOCK )
+				return qfalse;
+		} else {
+			conn->requestLength += ret;
+			conn->lastActive = Sys_Milliseconds();
+		}
+	}
+
+	conn->request[ conn->requestLength ] = '\0';
+	terminator = strstr( conn->request, "\r\n\r\n" );
+	if ( !terminator ) {
+		// oversized request header
+		return ( conn->requestLength < sizeof( conn->request ) - 1 );
+	}
+
+	consumed = SV_HTTPParseRequest( conn, terminator );
+
+	// keep pipelined requests
+	conn->requestLength -= consumed;
+	memmove( conn->request, conn->request + consumed, conn->requestLength );
+
+	return qtrue;
+}
+
+
+/*
+==================
+SV_HTTPSendHeader
+==================
+*/
+static qboolean SV_HTTPSendHeader( httpConnection_t *conn )
+{
+	int ret;
+
+	ret = send( conn->sock, conn->header + conn->headerSent, conn->headerLength - conn->headerSent, MSG_NOSIGNAL );
+	if ( ret == SOCKET_ERROR )
+		return ( socketError == HTTP_WOULDBLOCK );
+
+	conn->headerSent += ret;
+	conn->lastActive = Sys_Milliseconds();
+
+	if ( conn->headerSent < conn->headerLength )
+		return qtrue;
+
+	if ( conn->file >= 0 ) {
+		conn->state = HTTP_SEND_BODY;
+		return qtrue;
+	}
+
+	conn->state = HTTP_READ_REQUEST;
+	return conn->keepAlive;
+}
+
+
+/*
+==================
+SV_HTTPSendBody
+
+Streams file data straight from the page cache where sendfile() exists
+==================
+*/
+static qboolean SV_HTTPSendBody( httpConnection_t *conn )
+{
+	int64_t remaining;
+	int budget, length, ret;
+#ifdef USE_SENDFILE
+	off_t offset;
+#else
+	static byte buffer[ 65536 ];
+#endif
+
+	budget = HTTP_SEND_BUDGET;
+
+	while ( budget > 0 && conn->offset < conn->end ) {
+		remaining = conn->end - conn->offset;
+		length = remaining < budget ? (int)remaining : budget;
+#ifdef USE_SENDFILE
+		offset = conn->offset;
+		ret = sendfile( conn->sock, conn->file, &offset, length );
+#else
+		if ( length > sizeof( buffer ) )
+			length = sizeof( buffer );
+		ret = SV_HTTPReadFile( conn->file, conn->offset, buffer, length );
+		if ( ret <= 0 ) {
+			Com_Printf( "HTTP: read error on %s\n", conn->name );
+			return qfalse;
+		}
+		ret = send( conn->sock, (const char *)buffer, ret, MSG_NOSIGNAL );
+#endif
+		if ( ret == SOCKET_ERROR )
+			return ( socketError == HTTP_WOULDBLOCK );
+		if ( ret == 0 )
+			return qfalse; // file truncated under us
+
+		conn->offset += ret;
+		conn->lastActive = Sys_Milliseconds();
+		budget -= ret;
+	}
+
+	if ( conn->offset < conn->end )
+		return qtrue;
+
+	Com_DPrintf( "HTTP: %s finished %s\n", conn->address, conn->name );
+
+	SV_HTTPCloseFile( conn->file );
+	conn->file = -1;
+	conn->state = HTTP_READ_REQUEST;
+
+	return conn->keepAlive;
+}
+
+
+/*
+==================
+SV_HTTPFrame
+
+Services listener and all connections without blocking.
+Returns qtrue while file data is still being transmitted.
+==================
+*/
+qboolean SV_HTTPFrame( void )
+{
+	httpConnection_t *conn;
+	qboolean sending, alive;
+	int i, now;
+
+	if ( sv_httpPort->integer != http_port ) {
+		SV_HTTPShutdown();
+		if ( sv_httpPort->integer ) {
+			SV_HTTPOpenListener( sv_httpPort->integer );
+		}
+		// don't retry every frame if port can't be opened
+		http_port = sv_httpPort->integer;
+	}
+
+	if ( http_socket == INVALID_SOCKET )
+		return qfalse;
+
+	SV_HTTPAccept();
+
+	now = Sys_Milliseconds();
+	sending = qfalse;
+	for ( i = 0, conn = http_connections; i < MAX_HTTP_CONNECTIONS; i++, conn++ ) {
+		if ( conn->state == HTTP_FREE )
+			continue;
+
+		alive = qtrue;
+
+		// may advance through several states at once
+		if ( conn->state == HTTP_READ_REQUEST )
+			alive = SV_HTTPReadRequest( conn );
+		if ( alive && conn->state == HTTP_SEND_HEADER )
+			alive = SV_HTTPSendHeader( conn );
+		if ( alive && conn->state == HTTP_SEND_BODY )
+			alive = SV_HTTPSendBody( conn );
+
+		if ( alive && now - conn->lastActive > HTTP_IDLE_TIMEOUT ) {
+			Com_DPrintf( "HTTP: %s timed out\n", conn->address );
+			alive = qfalse;
+		}
+
+		if ( !alive ) {
+			SV_HTTPCloseConnection( conn );
+			continue;
+		}
+
+		if ( conn->state != HTTP_READ_REQUEST )
+			sending = qtrue;
+	}
+
+	return sending;
+}
+
+
+/*
+==================
+SV_HTTPShutdown
+==================
+*/
+void SV_HTTPShutdown( void )
+{
+	int i;
+
+	for ( i = 0; i < MAX_HTTP_CONNECTIONS; i++ ) {
+		if ( http_connections[i].state != HTTP_FREE ) {
+			SV_HTTPCloseConnection( &http_connections[i] );
+		}
+	}
+
+	SV_HTTPCloseListener();
+}
+
+
+/*
+==================
+SV_HTTPBaseURL
+
+Download base URL of built-in server, NULL if it is not running
+or there is no public host name to advertise
+==================
+*/
+const char *SV_HTTPBaseURL( void )
+{
+	static char url[ MAX_CVAR_VALUE_STRING ];
+	const char *host;
+
+	if ( http_socket == INVALID_SOCKET )
+		return NULL;
+
+	host = sv_httpHost->string;
+	if ( !*host ) {
+		host = Cvar_VariableString( "net_ip" );
+		if ( !*host || !Q_stricmp( host, "localhost" ) || !strcmp( host, "0.0.0.0" ) )
+			return NULL;
+	}
+
+	Com_sprintf( url, sizeof( url ), "http://%s:%i", host, http_port );
+
+	return url;
+}
@@ -29,28 +29,42 @@ If you have questions concerning this license or the applicable additional terms
 #include "server.h"
 
 
+// longest command outdated clients can decode, see SV_SendServerCommand
+#define MAX_CS_COMMAND_LEN	1022
+
+// clients can't assemble bcs chunks into anything longer than BIG_INFO_STRING
+#define MAX_CS_CHUNKS		( BIG_INFO_STRING / ( MAX_STRING_CHARS - 25 ) + 1 )
+
 /*
 ===============
-SV_SendConfigstring
+SV_ConfigstringCommands
 
-Creates and sends the server command necessary to update the CS index for the
-given client
+Creates the server commands necessary to update the CS index, a single cs
+command unless it would be too long for the client to decode
 ===============
 */
-static void SV_SendConfigstring(client_t *client, int index)
+static int SV_ConfigstringCommands( int index, reliableCommand_t **cmds )
 {
 	int maxChunkSize = MAX_STRING_CHARS - 24;
-	int len;
+	char	buf[MAX_STRING_CHARS];
+	char	text[MAX_STRING_CHARS];
+	int len, count;
 
 	len = strlen(sv.configstrings[index]);
 
-	if( len >= maxChunkSize ) {
+	// standard cs, just send it
+	// "cs 1023 """ takes at most 10 characters
+	if ( len + 10 <= MAX_CS_COMMAND_LEN ) {
+		Com_sprintf( text, sizeof( text ), "cs %i \"%s\"", index, sv.configstrings[index] );
+		cmds[0] = SV_AllocReliableCommand( text );
+		return 1;
+	} else {
 		int		sent = 0;
 		int		remaining = len;
 		char	*cmd;
-		char	buf[MAX_STRING_CHARS];
 
-		while (remaining > 0 ) {
+		count = 0;
+		while (remaining > 0 && count < MAX_CS_CHUNKS ) {
 			if ( sent == 0 ) {
 				cmd = "bcs0";
 			}
@@ -63,19 +77,56 @@ static void SV_SendConfigstring(client_t *client, int index)
 			Q_strncpyz( buf, &sv.configstrings[index][sent],
 				maxChunkSize );
 
-			SV_SendServerCommand( client, "%s %i \"%s\"", cmd,
+			Com_sprintf( text, sizeof( text ), "%s %i \"%s\"", cmd,
 				index, buf );
+			cmds[count++] = SV_AllocReliableCommand( text );
 
 			sent += (maxChunkSize - 1);
 			remaining -= (maxChunkSize - 1);
 		}
-	} else {
-		// standard cs, just send it
-		SV_SendServerCommand( client, "cs %i \"%s\"", index,
-			sv.configstrings[index] );
+		return count;
 	}
 }
 
+
+/*
+===============
+SV_SendConfigstring
+
+Sends the CS index to the client if it should get it, otherwise marks it
+to be sent when a primed client enters the world
+===============
+*/
+static void SV_SendConfigstring( client_t *client, int index, reliableCommand_t **cmds, int count )
+{
+	int i;
+
+	if ( client->state < CS_ACTIVE ) {
+		if ( client->state == CS_PRIMED )
+			client->csUpdated[ index ] = qtrue;
+		return;
+	}
+
+	// do not always send server info to all clients
+	if ( index == CS_SERVERINFO && ( SV_GentityNum( client - svs.clients )->r.svFlags & SVF_NOSERVERINFO ) ) {
+		return;
+	}
+
+	// RF, don't send to bot/AI
+	// Gordon: Note: might want to re-enable later for bot support
+	// RF, re-enabled
+	// Arnout: removed hardcoded gametype
+	// Arnout: added coop
+	if ( ( SV_GameIsSinglePlayer() || SV_GameIsCoop() ) && ( SV_GentityNum( client - svs.clients )->r.svFlags & SVF_BOT ) ) {
+		return;
+	}
+
+	for ( i = 0; i < count; i++ ) {
+		SV_AddReliableCommand( client, cmds[i] );
+	}
+}
+
+
 /*
 ===============
 SV_UpdateConfigstrings
@@ -86,32 +137,71 @@ Configstring indexes that have changed while the client was in CS_PRIMED
 */
 void SV_UpdateConfigstrings(client_t *client)
 {
-	int index;
+	reliableCommand_t *cmds[ MAX_CS_CHUNKS ];
+	int index, i, count;
 
 	for( index = 0; index < MAX_CONFIGSTRINGS; index++ ) {
 		// if the CS hasn't changed since we went to CS_PRIMED, ignore
 		if(!client->csUpdated[index])
 			continue;
 
-		// do not always send server info to all clients
-		if ( index == CS_SERVERINFO && ( SV_GentityNum( client - svs.clients )->r.svFlags & SVF_NOSERVERINFO ) ) {
-			continue;
-		}
+		client->csUpdated[index] = qfalse;
 
-		// RF, don't send to bot/AI
-		// Gordon: Note: might want to re-enable later for bot support
-		// RF, re-enabled
-		// Arnout: removed hardcoded gametype
-		// Arnout: added coop
-		if ( ( SV_GameIsSinglePlayer() || SV_GameIsCoop() ) && ( SV_GentityNum( client - svs.clients )->r.svFlags & SVF_BOT ) ) {
-			continue;
+		count = SV_ConfigstringCommands( index, cmds );
+		SV_SendConfigstring( client, index, cmds, count );
+		for ( i = 0; i < count; i++ ) {
+			SV_ReleaseReliableCommand( cmds[i] );
 		}
+	}
+}
 
-		SV_SendConfigstring(client, index);
-		client->csUpdated[index] = qfalse;
+
+/*
+===============
+SV_FlushConfigstrings
+
+Sends one update for every configstring changed since the last flush, no
+matter how many times it was set. Called before any other server command
+is queued, so clients still see the updates in the order of events
+===============
+*/
+void SV_FlushConfigstrings( void )
+{
+	reliableCommand_t *cmds[ MAX_CS_CHUNKS ];
+	int		dirty[ MAX_CONFIGSTRINGS ];
+	int		numDirty, index, count;
+	int		i, n;
+	client_t	*client;
+
+	if ( !sv.numDirtyConfigstrings ) {
+		return;
+	}
+
+	// the commands below may lead to another flush
+	numDirty = sv.numDirtyConfigstrings;
+	Com_Memcpy( dirty, sv.dirtyConfigstrings, numDirty * sizeof( dirty[0] ) );
+	for ( n = 0; n < numDirty; n++ ) {
+		sv.configstringDirty[ dirty[n] ] = qfalse;
+	}
+	sv.numDirtyConfigstrings = 0;
+
+	for ( n = 0; n < numDirty; n++ ) {
+		index = dirty[n];
+
+		SV_DemoConfigstring( index );
+
+		// the text is shared by all the clients
+		count = SV_ConfigstringCommands( index, cmds );
+		for ( i = 0, client = svs.clients; i < sv_maxclients->integer ; i++, client++ ) {
+			SV_SendConfigstring( client, index, cmds, count );
+		}
+		for ( i = 0; i < count; i++ ) {
+			SV_ReleaseReliableCommand( cmds[i] );
+		}
 	}
 }
 
+
 /*
 ===============
 SV_SetConfigstring
@@ -135,12 +225,10 @@ void SV_SetConfigstringNoUpdate( int index, const char *val ) {
 	// change the string in sv
 	Z_Free( sv.configstrings[index] );
 	sv.configstrings[index] = CopyString( val );
+	sv.gameStateDirty = qtrue;
 }
 
 void SV_SetConfigstring (int index, const char *val) {
-	int		i;
-	client_t	*client;
-
 	if ( index < 0 || index >= MAX_CONFIGSTRINGS ) {
 		Com_Error (ERR_DROP, "SV_SetConfigstring: bad index %i", index);
 	}
@@ -157,33 +245,15 @@ void SV_SetConfigstring (int index, const char *val) {
 	// change the string in sv
 	Z_Free( sv.configstrings[index] );
 	sv.configstrings[index] = CopyString( val );
+	sv.gameStateDirty = qtrue;
 
 	// send it to all the clients if we aren't
 	// spawning a new server
 	if ( sv.state == SS_GAME || sv.restarting ) {
-
-		// send the data to all relevant clients
-		for (i = 0, client = svs.clients; i < sv_maxclients->integer ; i++, client++) {
-			if ( client->state < CS_ACTIVE ) {
-				if ( client->state == CS_PRIMED )
-					client->csUpdated[ index ] = qtrue;
-				continue;
-			}
-			// do not always send server info to all clients
-			if ( index == CS_SERVERINFO && ( SV_GentityNum( i )->r.svFlags & SVF_NOSERVERINFO ) ) {
-				continue;
-			}
-
-			// RF, don't send to bot/AI
-			// Gordon: Note: might want to re-enable later for bot support
-			// RF, re-enabled
-			// Arnout: removed hardcoded gametype
-			// Arnout: added coop
-			if ( ( SV_GameIsSinglePlayer() || SV_GameIsCoop() ) && ( SV_GentityNum( client - svs.clients )->r.svFlags & SVF_BOT ) ) {
-				continue;
-			}
-		
-			SV_SendConfigstring(client, index);
+		// coalesce changes made until the next flush
+		if ( !sv.configstringDirty[ index ] ) {
+			sv.configstringDirty[ index ] = qtrue;
+			sv.dirtyConfigstrings[ sv.numDirtyConfigstrings++ ] = index;
 		}
 	}
 }
@@ -275,6 +345,8 @@ static void SV_CreateBaseline( void ) {
 		sv.svEntities[ entnum ].baseline = ent->s;
 		sv.baselineUsed[ entnum ] = 1;
 	}
+
+	sv.gameStateDirty = qtrue;
 }
 
 
@@ -408,9 +480,14 @@ void SV_ChangeMaxClients( void ) {
 			oldClients[i] = svs.clients[i];
 		}
 		else {
+			SV_FreeReliableCommands( &svs.clients[i] );
 			Com_Memset(&oldClients[i], 0, sizeof(client_t));
 		}
 	}
+	// release commands still held by zombies that are not copied
+	for ( ; i < oldMaxClients ; i++ ) {
+		SV_FreeReliableCommands( &svs.clients[i] );
+	}
 
 	// free old clients arrays
 #ifdef USE_CLIENTS_ZONE
@@ -551,6 +628,8 @@ void SV_SpawnServer( const char *mapname ) {
 	qboolean	isBot;
 	const char	*p, *pnames;
 
+	SV_DemoStopRecord();
+
 	// ydnar: broadcast a level change to all connected clients
 	if ( svs.clients && !com_errorEntered ) {
 		SV_FinalCommand( "spawnserver", qfalse );
@@ -646,6 +725,7 @@ void SV_SpawnServer( const char *mapname ) {
 	for ( i = 0 ; i < MAX_CONFIGSTRINGS ; i++ ) {
 		sv.configstrings[i] = CopyString("");
 	}
+	sv.gameStateDirty = qtrue;
 
 	// Ridah
 	// DHM - Nerve :: We want to use the completion bar in multiplayer as well
@@ -666,8 +746,16 @@ void SV_SpawnServer( const char *mapname ) {
 	Cvar_Get( "sv_pure", "1", CVAR_SYSTEMINFO | CVAR_LATCH );
 
 	// get a new checksum feed and restart the file system
-	srand( Com_Milliseconds() );
+	sv.randomSeed = Com_Milliseconds();
 	Com_RandomBytes( (byte*)&sv.checksumFeed, sizeof( sv.checksumFeed ) );
+
+	// serverid should be different each time
+	sv.serverId = com_frameTime;
+
+	// a packet journal records these, or replaces them when it is replayed
+	SV_JournalSpawn( mapname );
+
+	srand( sv.randomSeed );
 	FS_Restart( sv.checksumFeed );
 
 	Sys_SetStatus( "Loading map %s", mapname );
@@ -678,8 +766,6 @@ void SV_SpawnServer( const char *mapname ) {
 
 	Cvar_Set( "sv_mapChecksum", va( "%i",checksum ) );
 
-	// serverid should be different each time
-	sv.serverId = com_frameTime;
 	sv.restartedServerId = sv.serverId; // I suppose the init here is just to be safe
 	sv.checksumFeedServerId = sv.serverId;
 	Cvar_Set( "sv_serverid", va( "%i", sv.serverId ) );
@@ -989,6 +1075,21 @@ void SV_Init( void )
 
 	sv_showAverageBPS = Cvar_Get( "sv_showAverageBPS", "0", 0 );           // NERVE - SMF - net debugging
 
+	sv_snapshotThreads = Cvar_Get( "sv_snapshotThreads", "0", CVAR_ARCHIVE_ND );
+	Cvar_CheckRange( sv_snapshotThreads, "0", XSTRING(MAX_WORKER_THREADS), CV_INTEGER );
+	Cvar_SetDescription( sv_snapshotThreads, "Number of threads used to build and encode client snapshots, 0 or 1 builds them on the main thread" );
+
+	sv_telemetry = Cvar_Get( "sv_telemetry", "0", CVAR_ARCHIVE_ND );
+	Cvar_CheckRange( sv_telemetry, "0", "1", CV_INTEGER );
+	Cvar_SetDescription( sv_telemetry, "Record per-frame timings and counters, reported as JSON by the telemetry command" );
+
+	sv_packetJournal = Cvar_Get( "sv_packetJournal", "", CVAR_TEMP );
+	Cvar_SetDescription( sv_packetJournal, "Capture every inbound packet into journals/<name>.svj from the next map spawn on, for the replay command" );
+
+	sv_snapshotPacing = Cvar_Get( "sv_snapshotPacing", "0", CVAR_ARCHIVE_ND );
+	Cvar_CheckRange( sv_snapshotPacing, "0", "1", CV_INTEGER );
+	Cvar_SetDescription( sv_snapshotPacing, "Spread snapshot packets evenly over the server frame instead of sending them in one burst, send jitter is reported by the pacing command" );
+
 	// NERVE - SMF - create user set cvars
 	Cvar_Get( "g_userTimeLimit", "0", 0 );
 	Cvar_Get( "g_userAlliedRespawnTime", "0", 0 );
@@ -1026,6 +1127,16 @@ void SV_Init( void )
 	sv_wwwDlDisconnected = Cvar_Get( "sv_wwwDlDisconnected", "0", CVAR_ARCHIVE );
 	sv_wwwFallbackURL = Cvar_Get( "sv_wwwFallbackURL", "", CVAR_ARCHIVE );
 
+	sv_httpPort = Cvar_Get( "sv_httpPort", "0", CVAR_ARCHIVE );
+	Cvar_CheckRange( sv_httpPort, "0", "65535", CV_INTEGER );
+	Cvar_SetDescription( sv_httpPort, "TCP port of built-in HTTP server for referenced pk3 downloads, 0 disables it\n"
+		" Clients are redirected to it when sv_wwwDownload is enabled and sv_wwwBaseURL is empty" );
+	sv_httpHost = Cvar_Get( "sv_httpHost", "", CVAR_ARCHIVE );
+	Cvar_SetDescription( sv_httpHost, "Public host name or address advertised in download URLs of built-in HTTP server, net_ip is used when empty" );
+	sv_httpMaxConnections = Cvar_Get( "sv_httpMaxConnections", "16", CVAR_ARCHIVE );
+	Cvar_CheckRange( sv_httpMaxConnections, "1", "64", CV_INTEGER );
+	Cvar_SetDescription( sv_httpMaxConnections, "Maximum number of simultaneous connections to built-in HTTP server" );
+
 	// fretn - note: redirecting of clients to other servers relies on this,
 	// ET://someserver.com
 	sv_fullmsg = Cvar_Get( "sv_fullmsg", "Server is full.", CVAR_ARCHIVE );
@@ -1132,6 +1243,11 @@ void SV_Shutdown( const char *finalmsg ) {
 	NET_LeaveMulticast6();
 #endif
 
+	SV_DemoStopRecord();
+	SV_JournalStop();
+	SV_ShutdownPacing();
+	SV_HTTPShutdown();
+
 	if ( svs.clients && !com_errorEntered ) {
 		SV_FinalCommand( va( "print \"%s\"", finalmsg ), qtrue );
 	}
@@ -1146,12 +1262,16 @@ void SV_Shutdown( const char *finalmsg ) {
 
 	SV_FreeIP4DB();
 
+	SV_ShutdownSnapshotWorkers();
+
 	// free server static data
 	if ( svs.clients ) {
 		int index;
 
-		for ( index = 0; index < sv_maxclients->integer; index++ )
+		for ( index = 0; index < sv_maxclients->integer; index++ ) {
 			SV_FreeClient( &svs.clients[ index ] );
+			SV_FreeReliableCommands( &svs.clients[ index ] );
+		}
 		
 #ifdef USE_CLIENTS_ZONE
 		Z_Free( svs.clients );
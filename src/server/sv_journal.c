@@ -0,0 +1,635 @@
+/*
+===========================================================================
+
+Wolfenstein: Enemy Territory GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Wolfenstein: Enemy Territory GPL Source Code (Wolf ET Source Code).
+
+Wolf ET Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Wolf ET Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Wolf ET Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Wolf: ET Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Wolf ET Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "server.h"
+
+/*
+=============================================================================
+
+Server packet journals
+
+With sv_packetJournal set the next map spawn starts recording every inbound
+packet, every SV_Frame() call and every idle SV_SendQueuedPackets() call,
+each stamped with Sys_Milliseconds(). The replay command spawns the same map
+with the recorded random seed, checksum feed and serverId, then feeds the
+records back without waiting while Sys_Milliseconds() returns the recorded
+times. Outgoing packets are dropped and snapshot messages are hashed, so two
+replays of one journal must print the same hash.
+
+Stream layout, all values little endian:
+
+4	"SVJR"
+4	version
+4	sv_maxclients
+4	sv_fps
+4	Sys_Milliseconds() at spawn
+4	svs.time at spawn
+4	random seed
+4	checksum feed
+4	serverId
+64	map name
+<records>
+4	-1
+
+Each record is [type] [time] [value], packet records are followed by the
+source address ([type] [16 bytes address] [port]) and value bytes of payload.
+Only the connections made after the spawn are replayed, console commands
+and commands queued by the game are not recorded.
+
+=============================================================================
+*/
+
+#define JOURNAL_DIR			"journals"
+#define JOURNAL_EXT			"svj"
+#define JOURNAL_MAGIC		"SVJR"
+#define JOURNAL_VERSION		1
+#define JOURNAL_BLOCK		0x20000
+
+typedef enum {
+	JR_END = -1,
+	JR_FRAME,				// value is msec passed to SV_Frame()
+	JR_PACKET,				// value is payload length
+	JR_IDLE					// SV_SendQueuedPackets() call
+} journalRecordType_t;
+
+typedef struct {
+	int		maxclients;
+	int		fps;
+	int		time;
+	int		svsTime;
+	int		randomSeed;
+	int		checksumFeed;
+	int		serverId;
+	char	mapname[ MAX_QPATH ];
+} journalHeader_t;
+
+typedef struct {
+	asyncFile_t		*file;
+	char			name[ MAX_QPATH ];
+	int				numFrames;
+	int				numPackets;
+	int				size;
+	int				used;
+	byte			block[ JOURNAL_BLOCK ];
+} journalRecorder_t;
+
+static journalRecorder_t *recorder;
+
+// replay in progress
+static fileHandle_t		replayFile;
+static journalHeader_t	replayHeader;
+static uint64_t			replayHash;
+static int				replaySnapshots;
+static int64_t			replayBytes;
+
+static void SV_JournalClose( void );
+
+
+/*
+=============
+SV_JournalFlush
+
+Hands buffered records to the background writer,
+on failure recording is stopped and qfalse returned
+=============
+*/
+static qboolean SV_JournalFlush( void ) {
+	if ( !recorder->used ) {
+		return qtrue;
+	}
+
+	if ( !Sys_AsyncWrite( recorder->file, recorder->block, recorder->used ) ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: packet journal writer failed or can't keep up\n" );
+		SV_JournalClose();
+		return qfalse;
+	}
+
+	recorder->size += recorder->used;
+	recorder->used = 0;
+
+	return qtrue;
+}
+
+
+/*
+=============
+SV_JournalWrite
+=============
+*/
+static qboolean SV_JournalWrite( const void *data, int len ) {
+	if ( recorder->used + len > JOURNAL_BLOCK && !SV_JournalFlush() ) {
+		return qfalse;
+	}
+
+	Com_Memcpy( recorder->block + recorder->used, data, len );
+	recorder->used += len;
+
+	return qtrue;
+}
+
+
+/*
+=============
+SV_JournalRecord
+=============
+*/
+static qboolean SV_JournalRecord( journalRecordType_t type, int value ) {
+	int record[ 3 ];
+
+	record[ 0 ] = LittleLong( type );
+	record[ 1 ] = LittleLong( Sys_Milliseconds() );
+	record[ 2 ] = LittleLong( value );
+
+	return SV_JournalWrite( record, sizeof( record ) );
+}
+
+
+/*
+=============
+SV_JournalClose
+
+Terminates the stream and waits for the writer
+=============
+*/
+static void SV_JournalClose( void ) {
+	journalRecorder_t	*rec;
+	int					end;
+
+	rec = recorder;
+	recorder = NULL;
+
+	end = LittleLong( JR_END );
+	Sys_AsyncWrite( rec->file, &end, sizeof( end ) );
+
+	if ( Sys_AsyncClose( rec->file ) ) {
+		Com_Printf( "Stopped packet journal %s, %i frames, %i packets, %i KB\n",
+			rec->name, rec->numFrames, rec->numPackets, ( rec->size + 1023 ) / 1024 );
+	} else {
+		Com_Printf( S_COLOR_YELLOW "WARNING: error writing packet journal %s\n", rec->name );
+	}
+
+	free( rec );
+}
+
+
+/*
+=============
+SV_JournalValidName
+=============
+*/
+static qboolean SV_JournalValidName( const char *name ) {
+	if ( !*name || strstr( name, ".." ) || strpbrk( name, "/\\:" ) ) {
+		Com_Printf( "Invalid journal name \"%s\"\n", name );
+		return qfalse;
+	}
+	return qtrue;
+}
+
+
+/*
+=============
+SV_JournalStart
+=============
+*/
+static void SV_JournalStart( const char *mapname ) {
+	char			name[ MAX_QPATH ];
+	char			ospath[ MAX_OSPATH ];
+	journalHeader_t	header;
+	int				i;
+
+	Q_strncpyz( name, sv_packetJournal->string, sizeof( name ) );
+	FS_StripExt( name, "." JOURNAL_EXT );
+	if ( !SV_JournalValidName( name ) ) {
+		return;
+	}
+
+	// clients carried over from the previous map have no recorded connection
+	for ( i = 0; i < sv_maxclients->integer; i++ ) {
+		if ( svs.clients[ i ].state >= CS_CONNECTED && svs.clients[ i ].netchan.remoteAddress.type != NA_BOT ) {
+			Com_Printf( S_COLOR_YELLOW "WARNING: packet journal needs an empty server, not recording\n" );
+			return;
+		}
+	}
+
+	// RF, avoid trying to allocate large chunk on a fragmented zone
+	recorder = calloc( 1, sizeof( *recorder ) );
+	if ( !recorder ) {
+		Com_Printf( "Couldn't allocate packet journal recorder.\n" );
+		return;
+	}
+
+	Com_sprintf( recorder->name, sizeof( recorder->name ), JOURNAL_DIR "/%s." JOURNAL_EXT, name );
+	Q_strncpyz( ospath, FS_BuildOSPath( FS_GetHomePath(), FS_GetCurrentGameDir(), recorder->name ), sizeof( ospath ) );
+
+	if ( FS_CreatePath( ospath ) || ( recorder->file = Sys_AsyncOpen( ospath ) ) == NULL ) {
+		Com_Printf( "ERROR: couldn't open %s.\n", recorder->name );
+		free( recorder );
+		recorder = NULL;
+		return;
+	}
+
+	Com_Memset( &header, 0, sizeof( header ) );
+	header.maxclients = LittleLong( sv_maxclients->integer );
+	header.fps = LittleLong( sv_fps->integer );
+	header.time = LittleLong( Sys_Milliseconds() );
+	header.svsTime = LittleLong( svs.time );
+	header.randomSeed = LittleLong( sv.randomSeed );
+	header.checksumFeed = LittleLong( sv.checksumFeed );
+	header.serverId = LittleLong( sv.serverId );
+	Q_strncpyz( header.mapname, mapname, sizeof( header.mapname ) );
+
+	SV_JournalWrite( JOURNAL_MAGIC, 4 );
+	i = LittleLong( JOURNAL_VERSION );
+	SV_JournalWrite( &i, 4 );
+	SV_JournalWrite( &header, sizeof( header ) );
+
+	Com_Printf( "Recording packet journal to %s.\n", recorder->name );
+}
+
+
+/*
+=============
+SV_JournalSpawn
+
+Called by SV_SpawnServer once the random seed, checksum feed and serverId
+are picked: replays put back the recorded values, otherwise a new journal
+is started when sv_packetJournal is set
+=============
+*/
+void SV_JournalSpawn( const char *mapname ) {
+	if ( com_replay ) {
+		sv.randomSeed = replayHeader.randomSeed;
+		sv.checksumFeed = replayHeader.checksumFeed;
+		sv.serverId = replayHeader.serverId;
+		return;
+	}
+
+	if ( recorder && SV_JournalFlush() ) {
+		SV_JournalClose();
+	}
+
+	if ( sv_packetJournal->string[0] ) {
+		SV_JournalStart( mapname );
+	}
+}
+
+
+/*
+=============
+SV_JournalStop
+
+Ends recording, or an interrupted replay
+=============
+*/
+void SV_JournalStop( void ) {
+	if ( recorder && SV_JournalFlush() ) {
+		SV_JournalClose();
+	}
+
+	if ( com_replay ) {
+		com_replay = qfalse;
+		FS_FCloseFile( replayFile );
+		replayFile = FS_INVALID_HANDLE;
+	}
+}
+
+
+/*
+=============
+SV_JournalFrame
+=============
+*/
+void SV_JournalFrame( int msec ) {
+	if ( !recorder ) {
+		return;
+	}
+
+	if ( SV_JournalRecord( JR_FRAME, msec ) ) {
+		recorder->numFrames++;
+		SV_JournalFlush();
+	}
+}
+
+
+/*
+=============
+SV_JournalPacket
+=============
+*/
+void SV_JournalPacket( const netadr_t *from, const msg_t *msg ) {
+	byte	adr[ 24 ];
+	int		i;
+
+	if ( !recorder ) {
+		return;
+	}
+
+	Com_Memset( adr, 0, sizeof( adr ) );
+	i = LittleLong( from->type );
+	Com_Memcpy( adr, &i, 4 );
+#ifdef USE_IPV6
+	Com_Memcpy( adr + 4, from->ipv._6, 16 );
+#else
+	Com_Memcpy( adr + 4, from->ipv._4, 4 );
+#endif
+	Com_Memcpy( adr + 20, &from->port, 2 );	// already in network byte order
+
+	if ( SV_JournalRecord( JR_PACKET, msg->cursize ) && SV_JournalWrite( adr, sizeof( adr ) ) ) {
+		SV_JournalWrite( msg->data, msg->cursize );
+		recorder->numPackets++;
+	}
+}
+
+
+/*
+=============
+SV_JournalIdle
+=============
+*/
+void SV_JournalIdle( void ) {
+	if ( !recorder ) {
+		return;
+	}
+
+	SV_JournalRecord( JR_IDLE, 0 );
+}
+
+
+/*
+=============
+SV_JournalSnapshot
+
+Folds a snapshot message into the replay hash (64-bit FNV-1a), bits past
+msg->bit in the last byte were never written and are left out
+=============
+*/
+void SV_JournalSnapshot( const client_t *client, const msg_t *msg ) {
+	uint64_t	hash;
+	int			i;
+
+	if ( !com_replay ) {
+		return;
+	}
+
+	hash = replayHash;
+	hash = ( hash ^ (uint64_t)( client - svs.clients ) ) * 0x100000001b3ULL;
+	for ( i = 0; i < msg->bit >> 3; i++ ) {
+		hash = ( hash ^ msg->data[ i ] ) * 0x100000001b3ULL;
+	}
+	if ( msg->bit & 7 ) {
+		hash = ( hash ^ ( msg->data[ i ] & ( ( 1 << ( msg->bit & 7 ) ) - 1 ) ) ) * 0x100000001b3ULL;
+	}
+	replayHash = hash;
+
+	replaySnapshots++;
+	replayBytes += msg->cursize;
+}
+
+
+/*
+=============
+SV_ReplayReadHeader
+=============
+*/
+static qboolean SV_ReplayReadHeader( fileHandle_t f, journalHeader_t *header ) {
+	char	magic[ 4 ];
+	int		version;
+
+	if ( FS_Read( magic, 4, f ) != 4 || memcmp( magic, JOURNAL_MAGIC, 4 ) != 0
+		|| FS_Read( &version, 4, f ) != 4 || LittleLong( version ) != JOURNAL_VERSION
+		|| FS_Read( header, sizeof( *header ), f ) != sizeof( *header ) ) {
+		return qfalse;
+	}
+
+	header->maxclients = LittleLong( header->maxclients );
+	header->fps = LittleLong( header->fps );
+	header->time = LittleLong( header->time );
+	header->svsTime = LittleLong( header->svsTime );
+	header->randomSeed = LittleLong( header->randomSeed );
+	header->checksumFeed = LittleLong( header->checksumFeed );
+	header->serverId = LittleLong( header->serverId );
+	header->mapname[ sizeof( header->mapname ) - 1 ] = '\0';
+
+	return header->maxclients > 0 && header->mapname[0];
+}
+
+
+/*
+=============
+SV_ReplayReadPacket
+=============
+*/
+static qboolean SV_ReplayReadPacket( netadr_t *from, msg_t *msg, int len ) {
+	byte	adr[ 24 ];
+	int		type;
+
+	if ( len < 0 || len > msg->maxsize || FS_Read( adr, sizeof( adr ), replayFile ) != sizeof( adr )
+		|| FS_Read( msg->data, len, replayFile ) != len ) {
+		return qfalse;
+	}
+
+	Com_Memset( from, 0, sizeof( *from ) );
+	Com_Memcpy( &type, adr, 4 );
+	from->type = LittleLong( type );
+#ifdef USE_IPV6
+	Com_Memcpy( from->ipv._6, adr + 4, 16 );
+#else
+	Com_Memcpy( from->ipv._4, adr + 4, 4 );
+#endif
+	Com_Memcpy( &from->port, adr + 20, 2 );
+
+	msg->cursize = len;
+	msg->readcount = 0;
+	msg->bit = 0;
+
+	return qtrue;
+}
+
+
+/*
+=============
+SV_Replay_f
+
+replay <name>
+
+Runs a packet journal through the server as fast as possible and prints
+the time spent in each phase plus a hash of all snapshot messages as JSON.
+Run it in a fresh process, connectionless rate limits are not reset
+=============
+*/
+void SV_Replay_f( void ) {
+	static byte		data[ MAX_MSGLEN_BUF ];
+	char			name[ MAX_QPATH ];
+	char			path[ MAX_QPATH ];
+	journalHeader_t	header;
+	netadr_t		from;
+	msg_t			msg;
+	int				record[ 3 ];
+	int				numFrames, numPackets, numIdle, telemetry;
+	int64_t			start, t, spawnUsec, frameUsec, packetUsec, idleUsec;
+	qboolean		complete;
+
+	if ( Cmd_Argc() != 2 ) {
+		Com_Printf( "usage: replay <journal>\n" );
+		return;
+	}
+
+	if ( com_replay ) {
+		Com_Printf( "Already replaying a packet journal.\n" );
+		return;
+	}
+
+	Q_strncpyz( name, Cmd_Argv( 1 ), sizeof( name ) );
+	FS_StripExt( name, "." JOURNAL_EXT );
+	if ( !SV_JournalValidName( name ) ) {
+		return;
+	}
+
+	Com_sprintf( path, sizeof( path ), JOURNAL_DIR "/%s." JOURNAL_EXT, name );
+	FS_FOpenFileRead( path, &replayFile, qtrue );
+	if ( replayFile == FS_INVALID_HANDLE ) {
+		Com_Printf( "Couldn't open %s.\n", path );
+		return;
+	}
+
+	if ( !SV_ReplayReadHeader( replayFile, &header ) ) {
+		Com_Printf( "%s is not a valid packet journal.\n", path );
+		FS_FCloseFile( replayFile );
+		replayFile = FS_INVALID_HANDLE;
+		return;
+	}
+
+	SV_Shutdown( "Replaying packet journal" );
+
+	Cvar_Set( "sv_maxclients", va( "%i", header.maxclients ) );
+	Cvar_Set( "sv_fps", va( "%i", header.fps ) );
+
+	telemetry = sv_telemetry->integer;
+	Cvar_Set( "sv_telemetry", "1" );
+	SV_TelemetryClear();
+
+	replayHeader = header;
+	replayHash = 0xcbf29ce484222325ULL;
+	replaySnapshots = 0;
+	replayBytes = 0;
+
+	com_replay = qtrue;
+	com_replayTime = header.time;
+	svs.time = header.svsTime;
+
+	start = Sys_Microseconds();
+	SV_SpawnServer( header.mapname );
+	spawnUsec = Sys_Microseconds() - start;
+
+	MSG_Init( &msg, data, MAX_MSGLEN );
+
+	numFrames = numPackets = numIdle = 0;
+	frameUsec = packetUsec = idleUsec = 0;
+	complete = qfalse;
+
+	start = Sys_Microseconds();
+
+	// SV_Shutdown ends the replay if the server goes down on its own
+	while ( com_replay ) {
+		if ( FS_Read( record, 4, replayFile ) != 4 ) {
+			break;
+		}
+
+		if ( LittleLong( record[ 0 ] ) == JR_END ) {
+			complete = qtrue;
+			break;
+		}
+
+		if ( FS_Read( record + 1, 8, replayFile ) != 8 ) {
+			break;
+		}
+
+		com_replayTime = LittleLong( record[ 1 ] );
+
+		switch ( LittleLong( record[ 0 ] ) ) {
+		case JR_FRAME:
+			t = Sys_Microseconds();
+			SV_Frame( LittleLong( record[ 2 ] ) );
+			frameUsec += Sys_Microseconds() - t;
+			numFrames++;
+			break;
+
+		case JR_PACKET:
+			if ( !SV_ReplayReadPacket( &from, &msg, LittleLong( record[ 2 ] ) ) ) {
+				Com_Printf( S_COLOR_YELLOW "WARNING: bad packet record in %s\n", path );
+				SV_JournalStop();
+				break;
+			}
+			t = Sys_Microseconds();
+			SV_PacketEvent( &from, &msg );
+			packetUsec += Sys_Microseconds() - t;
+			numPackets++;
+			break;
+
+		case JR_IDLE:
+			t = Sys_Microseconds();
+			SV_SendQueuedPackets();
+			idleUsec += Sys_Microseconds() - t;
+			numIdle++;
+			break;
+
+		default:
+			Com_Printf( S_COLOR_YELLOW "WARNING: unknown record type in %s\n", path );
+			SV_JournalStop();
+			break;
+		}
+	}
+
+	t = Sys_Microseconds() - start;
+
+	SV_JournalStop();
+
+	Com_Printf( "{\n" );
+	Com_Printf( "  \"journal\": \"%s\",\n", path );
+	Com_Printf( "  \"map\": \"%s\",\n", header.mapname );
+	Com_Printf( "  \"complete\": %s,\n", complete ? "true" : "false" );
+	Com_Printf( "  \"frames\": %i,\n", numFrames );
+	Com_Printf( "  \"packets\": %i,\n", numPackets );
+	Com_Printf( "  \"idle_calls\": %i,\n", numIdle );
+	Com_Printf( "  \"spawn_usec\": %lli,\n", (long long)spawnUsec );
+	Com_Printf( "  \"total_usec\": %lli,\n", (long long)t );
+	Com_Printf( "  \"frame_usec\": %lli,\n", (long long)frameUsec );
+	Com_Printf( "  \"packet_usec\": %lli,\n", (long long)packetUsec );
+	Com_Printf( "  \"idle_usec\": %lli,\n", (long long)idleUsec );
+	Com_Printf( "  \"game_usec\": %lli,\n", (long long)SV_TelemetryTotal( TM_GAME_USEC ) );
+	Com_Printf( "  \"snapshot_usec\": %lli,\n", (long long)SV_TelemetryTotal( TM_SNAPSHOT_USEC ) );
+	Com_Printf( "  \"send_usec\": %lli,\n", (long long)SV_TelemetryTotal( TM_SEND_USEC ) );
+	Com_Printf( "  \"snapshots\": %i,\n", replaySnapshots );
+	Com_Printf( "  \"snapshot_bytes\": %lli,\n", (long long)replayBytes );
+	Com_Printf( "  \"snapshot_hash\": \"%016llx\"\n", (unsigned long long)replayHash );
+	Com_Printf( "}\n" );
+
+	SV_Shutdown( "Packet journal replay finished" );
+
+	Cvar_Set( "sv_telemetry", va( "%i", telemetry ) );
+}
@@ -77,12 +77,20 @@ cvar_t  *sv_reloading;
 
 cvar_t  *sv_showAverageBPS;     // NERVE - SMF - net debugging
 
+cvar_t  *sv_snapshotThreads;    // build client snapshots on worker threads
+cvar_t  *sv_telemetry;          // record per-frame timings and counters
+cvar_t  *sv_packetJournal;      // capture inbound packets of the next map for replay
+cvar_t  *sv_snapshotPacing;     // spread snapshot packets over the frame interval
+
 cvar_t  *sv_wwwDownload; // server does a www dl redirect
 cvar_t  *sv_wwwBaseURL; // base URL for redirect
 // tell clients to perform their downloads while disconnected from the server
 // this gets you a better throughput, but you loose the ability to control the download usage
 cvar_t *sv_wwwDlDisconnected;
 cvar_t *sv_wwwFallbackURL; // URL to send to if an http/ftp fails or is refused client side
+cvar_t *sv_httpPort;
+cvar_t *sv_httpHost;
+cvar_t *sv_httpMaxConnections;
 
 //bani
 cvar_t  *sv_cheats;
@@ -99,8 +107,6 @@ cvar_t	*sv_paksOverflowMode;
 
 #ifdef USE_BANS
 cvar_t	*sv_banFile;
-serverBan_t serverBans[SERVER_MAXBANS];
-int serverBansCount = 0;
 #endif
 
 void SVC_GameCompleteStatus( const netadr_t *from );       // NERVE - SMF
@@ -150,14 +156,129 @@ static const char *SV_ExpandNewlines( const char *in ) {
 
 /*
 ======================
-SV_AddServerCommand
+SV_AllocReliableCommand
+
+Returns a command holding one reference for the caller, which must
+release it after handing it to the clients
+======================
+*/
+reliableCommand_t *SV_AllocReliableCommand( const char *text ) {
+	reliableCommand_t *cmd;
+	int len;
+
+	len = (int)strlen( text );
+	if ( len > MAX_STRING_CHARS - 1 ) {
+		len = MAX_STRING_CHARS - 1;
+	}
+
+	cmd = Z_Malloc( (int)( offsetof( reliableCommand_t, text ) + len + 1 ) );
+	cmd->refCount = 1;
+	Com_Memcpy( cmd->text, text, len );
+	cmd->text[ len ] = '\0';
+
+	return cmd;
+}
+
+
+/*
+======================
+SV_ReleaseReliableCommand
+======================
+*/
+void SV_ReleaseReliableCommand( reliableCommand_t *cmd ) {
+	if ( cmd && --cmd->refCount <= 0 ) {
+		Z_Free( cmd );
+	}
+}
+
+
+/*
+======================
+SV_SetReliableCommand
+
+Stores a reference to cmd in the slot of the given sequence,
+releasing whatever the slot held before
+======================
+*/
+void SV_SetReliableCommand( client_t *client, int sequence, reliableCommand_t *cmd ) {
+	reliableCommand_t **slot;
+
+	slot = &client->reliableCommands[ sequence & ( MAX_RELIABLE_COMMANDS - 1 ) ];
+	if ( cmd ) {
+		cmd->refCount++;
+	}
+	SV_ReleaseReliableCommand( *slot );
+	*slot = cmd;
+}
+
+
+/*
+======================
+SV_ReliableCommand
+======================
+*/
+const char *SV_ReliableCommand( const client_t *client, int sequence ) {
+	const reliableCommand_t *cmd;
+
+	cmd = client->reliableCommands[ sequence & ( MAX_RELIABLE_COMMANDS - 1 ) ];
+	if ( cmd ) {
+		return cmd->text;
+	} else {
+		return "";
+	}
+}
+
+
+/*
+======================
+SV_AcknowledgeReliableCommands
+
+Releases the commands the client will never need again. The last
+acknowledged one is kept since it still keys the netchan encoding
+======================
+*/
+void SV_AcknowledgeReliableCommands( client_t *client, int acknowledge ) {
+	int i;
+
+	// never go back past the window or the slot of the new acknowledge
+	i = client->reliableAcknowledge;
+	if ( acknowledge - i >= MAX_RELIABLE_COMMANDS ) {
+		i = acknowledge - MAX_RELIABLE_COMMANDS + 1;
+	}
+
+	for ( ; acknowledge - i > 0; i++ ) {
+		SV_SetReliableCommand( client, i, NULL );
+	}
+
+	client->reliableAcknowledge = acknowledge;
+}
+
+
+/*
+======================
+SV_FreeReliableCommands
+======================
+*/
+void SV_FreeReliableCommands( client_t *client ) {
+	int i;
+
+	for ( i = 0; i < MAX_RELIABLE_COMMANDS; i++ ) {
+		SV_ReleaseReliableCommand( client->reliableCommands[ i ] );
+		client->reliableCommands[ i ] = NULL;
+	}
+}
+
+
+/*
+======================
+SV_AddReliableCommand
 
 The given command will be transmitted to the client, and is guaranteed to
 not have future snapshot_t executed before it is executed
 ======================
 */
-void SV_AddServerCommand( client_t *client, const char *cmd ) {
-	int		index, i, n;
+void SV_AddReliableCommand( client_t *client, reliableCommand_t *cmd ) {
+	int		i, n;
 
 	// do not send commands until the gamestate has been sent
 	if ( currentGameMod != GAMEMOD_ETJUMP && client->state < CS_PRIMED )
@@ -173,14 +294,30 @@ void SV_AddServerCommand( client_t *client, const char *cmd ) {
 		n = client->reliableSequence - client->reliableAcknowledge;
 		for ( i = 0; i < n; i++ ) {
 			const int j = client->reliableAcknowledge + 1 + i;
-			Com_Printf( "cmd %5d: %s\n", i, client->reliableCommands[ j & ( MAX_RELIABLE_COMMANDS - 1 ) ] );
+			Com_Printf( "cmd %5d: %s\n", i, SV_ReliableCommand( client, j ) );
 		}
-		Com_Printf( "cmd %5d: %s\n", i, cmd );
+		Com_Printf( "cmd %5d: %s\n", i, cmd->text );
 		SV_DropClient( client, "Server command overflow" );
 		return;
 	}
-	index = client->reliableSequence & ( MAX_RELIABLE_COMMANDS - 1 );
-	Q_strncpyz( client->reliableCommands[ index ], cmd, sizeof( client->reliableCommands[ index ] ) );
+	SV_SetReliableCommand( client, client->reliableSequence, cmd );
+}
+
+
+/*
+======================
+SV_AddServerCommand
+======================
+*/
+void SV_AddServerCommand( client_t *client, const char *cmd ) {
+	reliableCommand_t *rc;
+
+	// configstring updates must arrive before anything that follows them
+	SV_FlushConfigstrings();
+
+	rc = SV_AllocReliableCommand( cmd );
+	SV_AddReliableCommand( client, rc );
+	SV_ReleaseReliableCommand( rc );
 }
 
 
@@ -196,6 +333,7 @@ A NULL client will broadcast to all clients
 void QDECL SV_SendServerCommand( client_t *cl, const char *fmt, ... ) {
 	va_list		argptr;
 	char		message[MAX_STRING_CHARS+128]; // slightly larger than allowed, to detect overflows
+	reliableCommand_t *cmd;
 	client_t	*client;
 	int			j, len;
 	
@@ -203,11 +341,15 @@ void QDECL SV_SendServerCommand( client_t *cl, const char *fmt, ... ) {
 	len = Q_vsnprintf( message, sizeof( message ), fmt, argptr );
 	va_end( argptr );
 
+	// configstring updates must arrive before anything that follows them
+	SV_FlushConfigstrings();
+
 	if ( cl != NULL ) {
 		// outdated clients can't properly decode 1023-chars-long strings
 		// http://aluigi.altervista.org/adv/q3msgboom-adv.txt
 		if ( len <= 1022 || cl->longstr ) {
 			SV_AddServerCommand( cl, message );
+			SV_DemoServerCommand( cl, message );
 		}
 		return;
 	}
@@ -217,7 +359,12 @@ void QDECL SV_SendServerCommand( client_t *cl, const char *fmt, ... ) {
 		Com_Printf( "broadcast: %s\n", SV_ExpandNewlines( message ) );
 	}
 
-	// send the data to all relevant clients
+	if ( len <= 1022 ) {
+		SV_DemoServerCommand( NULL, message );
+	}
+
+	// send the data to all relevant clients, sharing a single copy of the text
+	cmd = SV_AllocReliableCommand( message );
 	for ( j = 0, client = svs.clients; j < sv_maxclients->integer ; j++, client++ ) {
 		if ( currentGameMod == GAMEMOD_ETJUMP && client->state < CS_PRIMED ) {
 			continue;
@@ -228,9 +375,10 @@ void QDECL SV_SendServerCommand( client_t *cl, const char *fmt, ... ) {
 		}
 		// done.
 		if ( len <= 1022 || client->longstr ) {
-			SV_AddServerCommand( client, message );
+			SV_AddReliableCommand( client, cmd );
 		}
 	}
+	SV_ReleaseReliableCommand( cmd );
 }
 
 
@@ -782,6 +930,142 @@ qboolean SV_VerifyInfoChallenge( const char *challenge ) {
 }
 
 
+/*
+=============================================================================
+
+CACHED QUERY RESPONSES
+
+getinfo and getstatus bodies are rebuilt at most once per server frame,
+only the challenge echoed back differs between requesters
+
+=============================================================================
+*/
+
+#define OOB_HEADER_SIZE		4
+#define CHALLENGE_KEY		"\\challenge\\"
+#define CHALLENGE_KEY_LEN	11
+
+typedef struct {
+	int			statusFrame;
+	char		serverinfo[MAX_INFO_STRING];	// without challenge key
+	int			serverinfoLength;
+	char		players[MAX_CLIENTS*(MAX_NAME_LENGTH+32)];
+	int			playerEnd[MAX_CLIENTS];			// end offset of each player line
+	int			numPlayers;
+
+	int			infoFrame;
+	char		info[MAX_INFO_STRING];			// keys following challenge
+	int			infoLength;
+	qboolean	infoRefused;					// some key didn't fit or was invalid
+} queryCache_t;
+
+static queryCache_t queryCache;
+static int queryFrame = 1;
+
+
+/*
+================
+SV_InvalidateQueryCache
+================
+*/
+static void SV_InvalidateQueryCache( void ) {
+	queryFrame++;
+}
+
+
+/*
+================
+SVC_BuildStatusCache
+================
+*/
+static void SVC_BuildStatusCache( void ) {
+	const client_t	*cl;
+	const playerState_t	*ps;
+	char	*s;
+	int		i, ping, length;
+
+	Q_strncpyz( queryCache.serverinfo, Cvar_InfoString( CVAR_SERVERINFO | CVAR_SERVERINFO_NOUPDATE, NULL ), sizeof( queryCache.serverinfo ) );
+	Info_RemoveKey( queryCache.serverinfo, "challenge" );
+	queryCache.serverinfoLength = (int)strlen( queryCache.serverinfo );
+
+	s = queryCache.players;
+	length = 0;
+	queryCache.numPlayers = 0;
+
+	for ( i = 0 ; i < sv_maxclients->integer ; i++ ) {
+		cl = &svs.clients[i];
+		if ( cl->state >= CS_CONNECTED ) {
+			ps = SV_GameClientNum( i );
+			// report bots as always 0
+			// report players with always at least 1 ping
+			if ( cl->netchan.remoteAddress.type == NA_BOT )
+				ping = 0;
+			else
+				ping = MIN( 1, cl->ping );
+			length += Com_sprintf( s + length, sizeof( queryCache.players ) - length, "%i %i \"%s\"\n",
+				ps->persistant[ PERS_SCORE ], ping, cl->name );
+			queryCache.playerEnd[ queryCache.numPlayers++ ] = length;
+		}
+	}
+
+	queryCache.statusFrame = queryFrame;
+}
+
+
+/*
+================
+SVC_StatusPacket
+
+Assembles complete statusResponse datagram for given challenge,
+returns its length
+================
+*/
+static int SVC_StatusPacket( char *packet, const char *challenge ) {
+	int		infoLength, challengeLength, playersLength, i;
+	char	*s;
+
+	if ( queryCache.statusFrame != queryFrame ) {
+		SVC_BuildStatusCache();
+	}
+
+	// same outcome as Info_SetValueForKey( infostring, "challenge", challenge )
+	challengeLength = (int)strlen( challenge );
+	infoLength = queryCache.serverinfoLength;
+	if ( challengeLength && infoLength + CHALLENGE_KEY_LEN + challengeLength < MAX_INFO_STRING ) {
+		infoLength += CHALLENGE_KEY_LEN + challengeLength;
+	} else {
+		challengeLength = 0;
+	}
+
+	// player lines that fit, with space for "statusResponse\n\n"
+	playersLength = 0;
+	for ( i = 0; i < queryCache.numPlayers; i++ ) {
+		if ( infoLength + 16 + queryCache.playerEnd[i] >= MAX_PACKETLEN-4 )
+			break; // can't hold any more
+		playersLength = queryCache.playerEnd[i];
+	}
+
+	s = packet;
+	memset( s, 0xFF, OOB_HEADER_SIZE );
+	s += OOB_HEADER_SIZE;
+	memcpy( s, "statusResponse\n", 15 );
+	s += 15;
+	memcpy( s, queryCache.serverinfo, queryCache.serverinfoLength );
+	s += queryCache.serverinfoLength;
+	if ( challengeLength ) {
+		memcpy( s, CHALLENGE_KEY, CHALLENGE_KEY_LEN );
+		s += CHALLENGE_KEY_LEN;
+		memcpy( s, challenge, challengeLength );
+		s += challengeLength;
+	}
+	*s++ = '\n';
+	memcpy( s, queryCache.players, playersLength );
+	s += playersLength;
+
+	return s - packet;
+}
+
+
 /*
 ================
 SVC_Status
@@ -792,16 +1076,8 @@ the simple info query.
 ================
 */
 static void SVC_Status( const netadr_t *from ) {
-	char	player[MAX_NAME_LENGTH + 32]; // score + ping + name
-	char	status[MAX_PACKETLEN];
-	char	*s;
-	int		i;
-	const client_t	*cl;
-	const playerState_t	*ps;
-	int		statusLength;
-	int		playerLength;
-	char	infostring[MAX_INFO_STRING+160]; // add some space for challenge string
-	int		ping;
+	char	packet[MAX_PACKETLEN];
+	int		length;
 
 	// ignore if we are in single player
 	if ( SV_GameIsSinglePlayer() ) {
@@ -833,38 +1109,11 @@ static void SVC_Status( const netadr_t *from ) {
 		return;
 	}
 
-	Q_strncpyz( infostring, Cvar_InfoString( CVAR_SERVERINFO | CVAR_SERVERINFO_NOUPDATE, NULL ), sizeof( infostring ) );
-
 	// echo back the parameter to status. so master servers can use it as a challenge
 	// to prevent timed spoofed reply packets that add ghost servers
-	Info_SetValueForKey( infostring, "challenge", Cmd_Argv( 1 ) );
-
-	s = status;
-	status[0] = '\0';
-	statusLength = strlen( infostring ) + 16; // strlen( "statusResponse\n\n" )
-
-	for ( i = 0 ; i < sv_maxclients->integer ; i++ ) {
-		cl = &svs.clients[i];
-		if ( cl->state >= CS_CONNECTED ) {
-			ps = SV_GameClientNum( i );
-			// report bots as always 0
-			// report players with always at least 1 ping
-			if ( cl->netchan.remoteAddress.type == NA_BOT )
-				ping = 0;
-			else
-				ping = MIN( 1, cl->ping );
-			playerLength = Com_sprintf( player, sizeof( player ), "%i %i \"%s\"\n", 
-				ps->persistant[ PERS_SCORE ], ping, cl->name );
-			
-			if ( statusLength + playerLength >= MAX_PACKETLEN-4 )
-				break; // can't hold any more
-			
-			s = Q_stradd( s, player );
-			statusLength += playerLength;
-		}
-	}
+	length = SVC_StatusPacket( packet, Cmd_Argv( 1 ) );
 
-	NET_OutOfBandPrint( NS_SERVER, from, "statusResponse\n%s\n%s", infostring, status );
+	NET_SendPacket( NS_SERVER, length, packet, from );
 }
 
 
@@ -953,6 +1202,125 @@ void SVC_GameCompleteStatus( const netadr_t *from ) {
 }
 
 
+/*
+================
+SVC_BuildInfoString
+
+Returns qtrue if every key made it into infostring
+================
+*/
+static qboolean SVC_BuildInfoString( char *infostring, const char *challenge ) {
+	int		i, count, humans;
+	const char	*str;
+	qboolean	refused;
+
+	// don't count privateclients
+	count = humans = 0;
+	for ( i = sv_privateClients->integer ; i < sv_maxclients->integer ; i++ ) {
+		if ( svs.clients[i].state >= CS_CONNECTED ) {
+			count++;
+			if (svs.clients[i].netchan.remoteAddress.type != NA_BOT) {
+				humans++;
+			}
+		}
+	}
+
+	infostring[0] = '\0';
+
+	// echo back the parameter to status. so servers can use it as a challenge
+	// to prevent timed spoofed reply packets that add ghost servers
+	refused = !Info_SetValueForKey( infostring, "challenge", challenge );
+	refused |= !Info_SetValueForKey( infostring, "version", va( "%s %s %s", Q3_VERSION, PLATFORM_STRING, __DATE__ ) );
+	refused |= !Info_SetValueForKey( infostring, "protocol", va( "%i", com_protocol->integer ) );
+	refused |= !Info_SetValueForKey( infostring, "hostname", sv_hostname->string );
+	refused |= !Info_SetValueForKey( infostring, "serverload", va( "%i", svs.serverLoad ) );
+	refused |= !Info_SetValueForKey( infostring, "mapname", sv_mapname->string );
+	refused |= !Info_SetValueForKey( infostring, "clients", va("%i", count) );
+	refused |= !Info_SetValueForKey( infostring, "humans", va("%i", humans) );
+	refused |= !Info_SetValueForKey( infostring, "sv_maxclients", va( "%i", sv_maxclients->integer - sv_privateClients->integer ) );
+	refused |= !Info_SetValueForKey( infostring, "sv_privateclients", va( "%i", sv_privateClients->integer ) );
+	refused |= !Info_SetValueForKey( infostring, "gametype", Cvar_VariableString( "g_gametype" ) );
+	refused |= !Info_SetValueForKey( infostring, "pure", va( "%i", sv_pure->integer ) );
+
+	str = Cvar_VariableString( "fs_game" );
+	if ( *str ) {
+		refused |= !Info_SetValueForKey( infostring, "game", str );
+	}
+
+	refused |= !Info_SetValueForKey( infostring, "friendlyFire", va( "%i", sv_friendlyFire->integer ) );        // NERVE - SMF
+	refused |= !Info_SetValueForKey( infostring, "maxlives", va( "%i", sv_maxlives->integer ? 1 : 0 ) );        // NERVE - SMF
+	refused |= !Info_SetValueForKey( infostring, "needpass", va( "%i", sv_needpass->integer ? 1 : 0 ) );
+	refused |= !Info_SetValueForKey( infostring, "gamename", GAMENAME_STRING );                               // Arnout: to be able to filter out Quake servers
+
+	// TTimo
+	str = Cvar_VariableString( "g_antilag" );
+	if ( *str ) {
+		refused |= !Info_SetValueForKey( infostring, "g_antilag", str );
+	}
+
+	str = Cvar_VariableString( "g_heavyWeaponRestriction" );
+	if ( *str ) {
+		refused |= !Info_SetValueForKey( infostring, "weaprestrict", str );
+	}
+
+	str = Cvar_VariableString( "g_balancedteams" );
+	if ( *str ) {
+		refused |= !Info_SetValueForKey( infostring, "balancedteams", str );
+	}
+
+	str = Cvar_VariableString( "g_oss" );
+	if ( *str ) {
+		refused |= !Info_SetValueForKey( infostring, "oss", str );
+	}
+
+	return !refused;
+}
+
+
+/*
+================
+SVC_InfoPacket
+
+Assembles complete infoResponse datagram for given challenge,
+returns its length
+================
+*/
+static int SVC_InfoPacket( char *packet, const char *challenge ) {
+	int		challengeLength;
+	char	*s;
+
+	if ( queryCache.infoFrame != queryFrame ) {
+		queryCache.infoRefused = !SVC_BuildInfoString( queryCache.info, "" );
+		queryCache.infoLength = (int)strlen( queryCache.info );
+		queryCache.infoFrame = queryFrame;
+	}
+
+	s = packet;
+	memset( s, 0xFF, OOB_HEADER_SIZE );
+	s += OOB_HEADER_SIZE;
+	memcpy( s, "infoResponse\n", 13 );
+	s += 13;
+
+	challengeLength = (int)strlen( challenge );
+	if ( queryCache.infoRefused || CHALLENGE_KEY_LEN + challengeLength + queryCache.infoLength >= MAX_INFO_STRING ) {
+		// keys may be dropped differently with challenge in front, build it the slow way
+		SVC_BuildInfoString( s, challenge );
+		return s + strlen( s ) - packet;
+	}
+
+	if ( challengeLength ) {
+		memcpy( s, CHALLENGE_KEY, CHALLENGE_KEY_LEN );
+		s += CHALLENGE_KEY_LEN;
+		memcpy( s, challenge, challengeLength );
+		s += challengeLength;
+	}
+	memcpy( s, queryCache.info, queryCache.infoLength );
+	s += queryCache.infoLength;
+
+	return s - packet;
+}
+
+
 /*
 ================
 SVC_Info
@@ -962,9 +1330,8 @@ if a user is interested in a server to do a full status
 ================
 */
 static void SVC_Info( const netadr_t *from ) {
-	int		i, count, humans;
-	const char	*str;
-	char	infostring[MAX_INFO_STRING];
+	char	packet[MAX_PACKETLEN];
+	int		length;
 
 	// ignore if we are in single player
 	if ( SV_GameIsSinglePlayer() ) {
@@ -1001,66 +1368,103 @@ static void SVC_Info( const netadr_t *from ) {
 		return;
 	}
 
-	// don't count privateclients
-	count = humans = 0;
-	for ( i = sv_privateClients->integer ; i < sv_maxclients->integer ; i++ ) {
-		if ( svs.clients[i].state >= CS_CONNECTED ) {
-			count++;
-			if (svs.clients[i].netchan.remoteAddress.type != NA_BOT) {
-				humans++;
-			}
-		}
-	}
+	length = SVC_InfoPacket( packet, Cmd_Argv( 1 ) );
 
-	infostring[0] = '\0';
+	NET_SendPacket( NS_SERVER, length, packet, from );
+}
 
-	// echo back the parameter to status. so servers can use it as a challenge
-	// to prevent timed spoofed reply packets that add ghost servers
-	Info_SetValueForKey( infostring, "challenge", Cmd_Argv(1) );
-	Info_SetValueForKey( infostring, "version", va( "%s %s %s", Q3_VERSION, PLATFORM_STRING, __DATE__ ) );
-	Info_SetValueForKey( infostring, "protocol", va( "%i", com_protocol->integer ) );
-	Info_SetValueForKey( infostring, "hostname", sv_hostname->string );
-	Info_SetValueForKey( infostring, "serverload", va( "%i", svs.serverLoad ) );
-	Info_SetValueForKey( infostring, "mapname", sv_mapname->string );
-	Info_SetValueForKey( infostring, "clients", va("%i", count) );
-	Info_SetValueForKey( infostring, "humans", va("%i", humans) );
-	Info_SetValueForKey( infostring, "sv_maxclients", va( "%i", sv_maxclients->integer - sv_privateClients->integer ) );
-	Info_SetValueForKey( infostring, "sv_privateclients", va( "%i", sv_privateClients->integer ) );
-	Info_SetValueForKey( infostring, "gametype", Cvar_VariableString( "g_gametype" ) );
-	Info_SetValueForKey( infostring, "pure", va( "%i", sv_pure->integer ) );
 
-	str = Cvar_VariableString( "fs_game" );
-	if ( *str ) {
-		Info_SetValueForKey( infostring, "game", str );
-	}
+/*
+================
+SV_QueryBench_f
 
-	Info_SetValueForKey( infostring, "friendlyFire", va( "%i", sv_friendlyFire->integer ) );        // NERVE - SMF
-	Info_SetValueForKey( infostring, "maxlives", va( "%i", sv_maxlives->integer ? 1 : 0 ) );        // NERVE - SMF
-	Info_SetValueForKey( infostring, "needpass", va( "%i", sv_needpass->integer ? 1 : 0 ) );
-	Info_SetValueForKey( infostring, "gamename", GAMENAME_STRING );                               // Arnout: to be able to filter out Quake servers
+Answers synthetic getinfo and getstatus requests through the real packet
+builders, bypassing rate limits, and reports CPU time per 1000 requests
+with per-frame caching and with rebuilding for every request
+================
+*/
+void SV_QueryBench_f( void ) {
+	char	packet[MAX_PACKETLEN], reference[MAX_PACKETLEN];
+	char	challenge[16];
+	netadr_t	adr;
+	int64_t	start, cachedStatus, rebuiltStatus, cachedInfo, rebuiltInfo;
+	int		i, requests, length, mismatches;
 
-	// TTimo
-	str = Cvar_VariableString( "g_antilag" );
-	if ( *str ) {
-		Info_SetValueForKey( infostring, "g_antilag", str );
+	if ( !com_sv_running->integer ) {
+		Com_Printf( "Server is not running.\n" );
+		return;
 	}
 
-	str = Cvar_VariableString( "g_heavyWeaponRestriction" );
-	if ( *str ) {
-		Info_SetValueForKey( infostring, "weaprestrict", str );
+	requests = 10000;
+	if ( Cmd_Argc() > 1 ) {
+		requests = atoi( Cmd_Argv( 1 ) );
+		if ( requests < 1 ) {
+			requests = 1;
+		}
 	}
 
-	str = Cvar_VariableString( "g_balancedteams" );
-	if ( *str ) {
-		Info_SetValueForKey( infostring, "balancedteams", str );
+	// replies go into the loopback queue which nobody reads on a dedicated server
+	memset( &adr, 0, sizeof( adr ) );
+	adr.type = NA_LOOPBACK;
+
+	SV_InvalidateQueryCache();
+	start = Sys_Microseconds();
+	for ( i = 0; i < requests; i++ ) {
+		Com_sprintf( challenge, sizeof( challenge ), "%i", i );
+		length = SVC_StatusPacket( packet, challenge );
+		NET_SendPacket( NS_SERVER, length, packet, &adr );
+	}
+	cachedStatus = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	for ( i = 0; i < requests; i++ ) {
+		SV_InvalidateQueryCache();
+		Com_sprintf( challenge, sizeof( challenge ), "%i", i );
+		length = SVC_StatusPacket( packet, challenge );
+		NET_SendPacket( NS_SERVER, length, packet, &adr );
+	}
+	rebuiltStatus = Sys_Microseconds() - start;
+
+	SV_InvalidateQueryCache();
+	start = Sys_Microseconds();
+	for ( i = 0; i < requests; i++ ) {
+		Com_sprintf( challenge, sizeof( challenge ), "%i", i );
+		length = SVC_InfoPacket( packet, challenge );
+		NET_SendPacket( NS_SERVER, length, packet, &adr );
+	}
+	cachedInfo = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	for ( i = 0; i < requests; i++ ) {
+		SV_InvalidateQueryCache();
+		Com_sprintf( challenge, sizeof( challenge ), "%i", i );
+		length = SVC_InfoPacket( packet, challenge );
+		NET_SendPacket( NS_SERVER, length, packet, &adr );
+	}
+	rebuiltInfo = Sys_Microseconds() - start;
+
+	// spliced info response must match the one built with challenge in front
+	mismatches = 0;
+	for ( i = 0; i < 100; i++ ) {
+		Com_sprintf( challenge, sizeof( challenge ), "%i", i * 7919 );
+		length = SVC_InfoPacket( packet, challenge );
+		SVC_BuildInfoString( reference, challenge );
+		if ( length != OOB_HEADER_SIZE + 13 + (int)strlen( reference ) || memcmp( packet + OOB_HEADER_SIZE + 13, reference, strlen( reference ) ) ) {
+			mismatches++;
+		}
 	}
 
-	str = Cvar_VariableString( "g_oss" );
-	if ( *str ) {
-		Info_SetValueForKey( infostring, "oss", str );
+	Com_Printf( "%i requests, %i players, status %i bytes, info %i bytes\n", requests, queryCache.numPlayers,
+		SVC_StatusPacket( packet, "" ), SVC_InfoPacket( packet, "" ) );
+	Com_Printf( "getstatus: %.1f usec/1000 cached, %.1f usec/1000 rebuilt\n",
+		cachedStatus * 1000.0 / requests, rebuiltStatus * 1000.0 / requests );
+	Com_Printf( "getinfo:   %.1f usec/1000 cached, %.1f usec/1000 rebuilt\n",
+		cachedInfo * 1000.0 / requests, rebuiltInfo * 1000.0 / requests );
+	if ( mismatches ) {
+		Com_Printf( S_COLOR_RED "%i getinfo mismatches\n", mismatches );
 	}
 
-	NET_OutOfBandPrint( NS_SERVER, from, "infoResponse\n%s", infostring );
+	SV_InvalidateQueryCache();
 }
 
 
@@ -1230,10 +1634,10 @@ static void SV_ConnectionlessPacket( const netadr_t *from, msg_t *msg ) {
 
 /*
 =================
-SV_PacketEvent
+SV_ProcessPacket
 =================
 */
-void SV_PacketEvent( const netadr_t *from, msg_t *msg ) {
+static void SV_ProcessPacket( const netadr_t *from, msg_t *msg ) {
 	int			i;
 	client_t	*cl;
 	int			qport;
@@ -1297,6 +1701,30 @@ void SV_PacketEvent( const netadr_t *from, msg_t *msg ) {
 }
 
 
+/*
+=================
+SV_PacketEvent
+=================
+*/
+void SV_PacketEvent( const netadr_t *from, msg_t *msg ) {
+	int64_t start;
+
+	SV_JournalPacket( from, msg );
+
+	if ( !sv_telemetry->integer ) {
+		SV_ProcessPacket( from, msg );
+		return;
+	}
+
+	SV_TelemetryAdd( TM_PACKETS_IN, 1 );
+	SV_TelemetryAdd( TM_BYTES_IN, msg->cursize );
+
+	start = Sys_Microseconds();
+	SV_ProcessPacket( from, msg );
+	SV_TelemetryAdd( TM_PACKETS_USEC, Sys_Microseconds() - start );
+}
+
+
 /*
 ===================
 SV_CalcPings
@@ -1554,6 +1982,8 @@ void SV_Frame( int msec ) {
 	int		startTime;
 	int		i;
 	int		frameStartTime = 0, frameEndTime;
+	int64_t	telemetryStart = 0, gameStart = 0;
+	qboolean	gameFrame;
 
 	if ( Cvar_CheckGroup( CVG_SERVER ) )
 		SV_TrackCvarChanges(); // update rate settings, etc.
@@ -1576,6 +2006,11 @@ void SV_Frame( int msec ) {
 		return;
 	}
 
+	SV_JournalFrame( msec );
+
+	// getinfo/getstatus responses are rebuilt on first request in this frame
+	SV_InvalidateQueryCache();
+
 	// allow pause if only the local client is connected
 	if ( SV_CheckPaused() ) {
 		return;
@@ -1585,6 +2020,10 @@ void SV_Frame( int msec ) {
 		frameStartTime = Sys_Milliseconds();
 	}
 
+	if ( sv_telemetry->integer ) {
+		telemetryStart = Sys_Microseconds();
+	}
+
 	// if it isn't time for the next frame, do nothing
 
 	frameMsec = 1000 / sv_fps->integer * com_timescale->value;
@@ -1662,7 +2101,12 @@ void SV_Frame( int msec ) {
 
 	//if (com_dedicated->integer) SV_BotFrame (sv.time);
 
+	if ( sv_telemetry->integer ) {
+		gameStart = Sys_Microseconds();
+	}
+
 	// run the game simulation in chunks
+	gameFrame = ( sv.timeResidual >= frameMsec );
 	while ( sv.timeResidual >= frameMsec ) {
 		sv.timeResidual -= frameMsec;
 		svs.time += frameMsec;
@@ -1676,6 +2120,10 @@ void SV_Frame( int msec ) {
 		time_game = Sys_Milliseconds () - startTime;
 	}
 
+	if ( sv_telemetry->integer ) {
+		SV_TelemetryAdd( TM_GAME_USEC, Sys_Microseconds() - gameStart );
+	}
+
 	// check timeouts
 	SV_CheckTimeouts();
 
@@ -1685,9 +2133,19 @@ void SV_Frame( int msec ) {
 	// send messages back to the clients
 	SV_SendClientMessages();
 
+	SV_DemoFrame();
+
 	// send a heartbeat to the master if needed
 	SV_MasterHeartbeat(HEARTBEAT_FOR_MASTER);
 
+	if ( sv_telemetry->integer && telemetryStart ) {
+		SV_TelemetryAdd( TM_FRAME_USEC, Sys_Microseconds() - telemetryStart );
+		// calls without a game frame are merged into the next one
+		if ( gameFrame ) {
+			SV_TelemetryEndFrame();
+		}
+	}
+
 	if ( com_dedicated->integer ) {
 		frameEndTime = Sys_Milliseconds();
 
@@ -1788,10 +2246,24 @@ int SV_SendQueuedPackets( void )
 	int dlStart, deltaT, delayT;
 	static int dlNextRound = 0;
 	int timeVal = INT_MAX;
+	int64_t start = 0;
+
+	SV_JournalIdle();
+
+	if ( sv_telemetry->integer ) {
+		start = Sys_Microseconds();
+	}
+
+	NET_BeginSendBatch();
+
+	// Send out snapshots spread over the frame by sv_snapshotPacing
+	delayT = SV_SendPacedSnapshots();
+	if(delayT >= 0)
+		timeVal = delayT;
 
 	// Send out fragmented packets now that we're idle
 	delayT = SV_SendQueuedMessages();
-	if(delayT >= 0)
+	if(delayT >= 0 && delayT < timeVal)
 		timeVal = delayT;
 
 	if(sv_dl_maxRate->integer)//sv_dlRate
@@ -1850,6 +2322,16 @@ int SV_SendQueuedPackets( void )
 			timeVal = 0;
 	}
 
+	NET_EndSendBatch();
+
+	// keep polling while http downloads have data to send
+	if ( SV_HTTPFrame() && timeVal > 1 )
+		timeVal = 1;
+
+	if ( sv_telemetry->integer && start ) {
+		SV_TelemetryAdd( TM_DOWNLOAD_USEC, Sys_Microseconds() - start );
+	}
+
 	return timeVal;
 }
 
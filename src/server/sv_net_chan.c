@@ -116,7 +116,7 @@ static void SV_Netchan_Decode( client_t *client, msg_t *msg ) {
 	msg->bit = sbit;
 	msg->readcount = srdc;
 
-	string = (byte *)client->reliableCommands[ reliableAcknowledge & (MAX_RELIABLE_COMMANDS-1) ];
+	string = (byte *)SV_ReliableCommand( client, reliableAcknowledge );
 	index = 0;
 	//
 	key = client->challenge ^ serverId ^ messageAcknowledge;
@@ -172,6 +172,8 @@ static void SV_Netchan_TransmitNextInQueue(client_t *client)
 		SV_Netchan_Encode(client, &netbuf->msg, netbuf->clientCommandString);
 
 	Netchan_Transmit(&client->netchan, netbuf->msg.cursize, netbuf->msg.data);
+	SV_TelemetryAdd( TM_PACKETS_OUT, 1 );
+	SV_TelemetryAdd( TM_BYTES_OUT, netbuf->msg.cursize );
 
 	// pop from queue
 	client->netchan_start_queue = netbuf->next;
@@ -200,6 +202,7 @@ int SV_Netchan_TransmitNextFragment(client_t *client)
 	if(client->netchan.unsentFragments)
 	{
 		Netchan_TransmitNextFragment(&client->netchan);
+		SV_TelemetryAdd( TM_PACKETS_OUT, 1 );
 		return SV_RateMsec(client);
 	}
 	else if(client->netchan_start_queue)
@@ -271,6 +274,8 @@ void SV_Netchan_Transmit( client_t *client, msg_t *msg)
 		if ( client->compat && !SV_GameIsSinglePlayer() )
 			SV_Netchan_Encode(client, msg, client->lastClientCommandString);
 		Netchan_Transmit( &client->netchan, msg->cursize, msg->data );
+		SV_TelemetryAdd( TM_PACKETS_OUT, 1 );
+		SV_TelemetryAdd( TM_BYTES_OUT, msg->cursize );
 	}
 }
 
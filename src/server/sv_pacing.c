@@ -0,0 +1,391 @@
+/*
+===========================================================================
+
+Wolfenstein: Enemy Territory GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Wolfenstein: Enemy Territory GPL Source Code (Wolf ET Source Code).
+
+Wolf ET Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Wolf ET Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Wolf ET Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Wolf: ET Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Wolf ET Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+// sv_pacing.c -- spreads snapshot packets of the clients evenly over the
+// server frame interval instead of sending them in one burst, and keeps
+// per-client send jitter statistics reported by the "pacing" command
+
+#include "server.h"
+
+// one wheel slot per millisecond, must be a power of two
+// and longer than the longest server frame (sv_fps 10)
+#define PACING_SLOTS	128
+
+typedef struct {
+	// queued snapshot
+	qboolean	queued;
+	int			due;				// Sys_Milliseconds() to transmit at
+	int			sequence;			// netchan.outgoingSequence it was built for
+	int			snapshotTime;		// svs.time it was built at
+	int			next;				// next client number + 1 in the same slot
+	msg_t		msg;
+	byte		*data;				// MAX_MSGLEN_BUF, allocated on first use
+
+	int			offset;				// msec into the frame interval
+	int			lastSnapshotTime;	// svs.time of the last snapshot that went out
+
+	// send jitter statistics
+	int64_t		lastSent;			// Sys_Microseconds() of the last snapshot
+	int			lastInterval;
+	int			intervals;
+	int64_t		intervalSum;
+	double		jitter;				// smoothed interval change, as in RFC 3550
+	int			maxJitter;
+} pacedClient_t;
+
+static pacedClient_t	pacedClients[ MAX_CLIENTS ];
+
+// client number + 1 of the first snapshot due in each millisecond
+static int				pacingWheel[ PACING_SLOTS ];
+static int				pacingTime;			// next slot to visit
+static int				pacingQueued;
+
+// most snapshots transmitted within a single millisecond
+static int				burstTime;
+static int				burstPackets;
+static int				burstBytes;
+static int				maxBurstPackets;
+static int				maxBurstBytes;
+
+
+/*
+==================
+SV_PacingRecordSend
+==================
+*/
+static void SV_PacingRecordSend( pacedClient_t *pc, int size ) {
+	const int64_t now = Sys_Microseconds();
+	int interval, delta;
+
+	if ( pc->lastSent ) {
+		interval = (int)( now - pc->lastSent );
+		if ( pc->intervals ) {
+			delta = abs( interval - pc->lastInterval );
+			pc->jitter += ( delta - pc->jitter ) / 16.0;
+			if ( delta > pc->maxJitter ) {
+				pc->maxJitter = delta;
+			}
+		}
+		pc->lastInterval = interval;
+		pc->intervalSum += interval;
+		pc->intervals++;
+	}
+	pc->lastSent = now;
+
+	if ( burstTime != (int)( now / 1000 ) ) {
+		burstTime = (int)( now / 1000 );
+		burstPackets = 0;
+		burstBytes = 0;
+	}
+	burstPackets++;
+	burstBytes += size;
+	if ( burstPackets > maxBurstPackets ) {
+		maxBurstPackets = burstPackets;
+	}
+	if ( burstBytes > maxBurstBytes ) {
+		maxBurstBytes = burstBytes;
+	}
+}
+
+
+/*
+==================
+SV_PacingTransmit
+
+Sends a queued snapshot unless the client got another message since
+it was built, which the snapshot frame bookkeeping can't survive
+==================
+*/
+static void SV_PacingTransmit( client_t *client ) {
+	pacedClient_t *pc = &pacedClients[ client - svs.clients ];
+
+	pc->queued = qfalse;
+	pacingQueued--;
+
+	if ( client->state < CS_ZOMBIE || client->netchan.outgoingSequence != pc->sequence ) {
+		return;
+	}
+
+	// the bandwidth has been checked before building the snapshot
+	// and only more time passed since, unless something else went out
+	if ( SV_RateMsec( client ) > 0 || client->netchan.unsentFragments || client->netchan_start_queue ) {
+		// lastSnapshotTime was set when it was built, go back to the previous
+		// snapshot so the client gets the next one as soon as the line is free
+		// instead of a full snapshotMsec later
+		if ( pc->lastSnapshotTime - client->lastSnapshotTime < 0 ) {
+			client->lastSnapshotTime = pc->lastSnapshotTime;
+		}
+		client->rateDelayed = qtrue;
+		return;
+	}
+
+	pc->lastSnapshotTime = pc->snapshotTime;
+
+	// ping is measured from the real send time
+	svs.msgTime = Sys_Milliseconds();
+
+	SV_PacingRecordSend( pc, pc->msg.cursize );
+	SV_SendMessageToClient( &pc->msg, client );
+}
+
+
+/*
+==================
+SV_PaceSnapshot
+
+Called for each snapshot that is ready to be transmitted, returns qfalse
+if it should be sent right away
+==================
+*/
+qboolean SV_PaceSnapshot( client_t *client, const msg_t *msg ) {
+	const int clientNum = client - svs.clients;
+	pacedClient_t *pc = &pacedClients[ clientNum ];
+	int slot;
+
+	if ( !sv_snapshotPacing->integer || pc->offset <= 0 || pc->queued ) {
+		pc->lastSnapshotTime = svs.time;
+		SV_PacingRecordSend( pc, msg->cursize );
+		return qfalse;
+	}
+
+	if ( !pc->data ) {
+		pc->data = malloc( MAX_MSGLEN_BUF );
+		if ( !pc->data ) {
+			pc->lastSnapshotTime = svs.time;
+			SV_PacingRecordSend( pc, msg->cursize );
+			return qfalse;
+		}
+	}
+
+	// transmit appends to the message, so it gets a full buffer
+	MSG_Copy( &pc->msg, pc->data, MAX_MSGLEN_BUF, msg );
+	pc->msg.maxsize = MAX_MSGLEN;
+	pc->msg.maxbits = MAX_MSGLEN * 8;
+
+	if ( !pacingQueued ) {
+		pacingTime = Sys_Milliseconds();
+	}
+
+	pc->queued = qtrue;
+	pc->sequence = client->netchan.outgoingSequence;
+	pc->snapshotTime = svs.time;
+	pc->due = pacingTime + pc->offset;
+
+	slot = pc->due & ( PACING_SLOTS - 1 );
+	pc->next = pacingWheel[ slot ];
+	pacingWheel[ slot ] = clientNum + 1;
+	pacingQueued++;
+
+	return qtrue;
+}
+
+
+/*
+==================
+SV_SendPacedSnapshots
+
+Transmits the snapshots that are due, returns msec until the next
+one or -1 if none are queued
+==================
+*/
+int SV_SendPacedSnapshots( void ) {
+	const int now = Sys_Milliseconds();
+	int slot, n, t;
+
+	while ( pacingQueued && now - pacingTime >= 0 ) {
+		slot = pacingTime & ( PACING_SLOTS - 1 );
+		while ( ( n = pacingWheel[ slot ] ) != 0 ) {
+			pacingWheel[ slot ] = pacedClients[ n - 1 ].next;
+			SV_PacingTransmit( &svs.clients[ n - 1 ] );
+		}
+		pacingTime++;
+	}
+
+	if ( !pacingQueued ) {
+		return -1;
+	}
+
+	for ( t = pacingTime; t - pacingTime < PACING_SLOTS; t++ ) {
+		if ( pacingWheel[ t & ( PACING_SLOTS - 1 ) ] ) {
+			break;
+		}
+	}
+
+	return t - now;
+}
+
+
+/*
+==================
+SV_BeginPacing
+
+Sends whatever is still queued from the previous frame and assigns each
+remote client a fixed offset, so its snapshots keep the same phase as
+long as the set of connected clients does not change
+==================
+*/
+void SV_BeginPacing( void ) {
+	const client_t *cl;
+	int i, n, count, frameMsec, slot;
+
+	if ( pacingQueued ) {
+		for ( slot = 0; slot < PACING_SLOTS; slot++ ) {
+			while ( ( n = pacingWheel[ slot ] ) != 0 ) {
+				pacingWheel[ slot ] = pacedClients[ n - 1 ].next;
+				SV_PacingTransmit( &svs.clients[ n - 1 ] );
+			}
+		}
+	}
+
+	if ( !sv_snapshotPacing->integer ) {
+		return;
+	}
+
+	count = 0;
+	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ ) {
+		if ( cl->state >= CS_CONNECTED && cl->netchan.remoteAddress.type != NA_BOT && cl->netchan.remoteAddress.type != NA_LOOPBACK ) {
+			count++;
+		}
+	}
+
+	// the last millisecond is left for the next frame to start on time
+	frameMsec = 1000 / sv_fps->integer - 1;
+	if ( frameMsec > PACING_SLOTS - 1 ) {
+		frameMsec = PACING_SLOTS - 1;
+	}
+
+	n = 0;
+	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ ) {
+		if ( cl->state >= CS_CONNECTED && cl->netchan.remoteAddress.type != NA_BOT && cl->netchan.remoteAddress.type != NA_LOOPBACK ) {
+			pacedClients[ i ].offset = n * frameMsec / count;
+			n++;
+		} else {
+			pacedClients[ i ].offset = 0;
+		}
+	}
+}
+
+
+/*
+==================
+SV_PacingClear
+==================
+*/
+static void SV_PacingClear( void ) {
+	pacedClient_t *pc;
+	int i;
+
+	for ( i = 0, pc = pacedClients; i < MAX_CLIENTS; i++, pc++ ) {
+		pc->lastSent = 0;
+		pc->lastInterval = 0;
+		pc->intervals = 0;
+		pc->intervalSum = 0;
+		pc->jitter = 0.0;
+		pc->maxJitter = 0;
+	}
+
+	maxBurstPackets = 0;
+	maxBurstBytes = 0;
+}
+
+
+/*
+==================
+SV_ShutdownPacing
+==================
+*/
+void SV_ShutdownPacing( void ) {
+	int i;
+
+	for ( i = 0; i < MAX_CLIENTS; i++ ) {
+		free( pacedClients[ i ].data );
+	}
+
+	Com_Memset( pacedClients, 0, sizeof( pacedClients ) );
+	Com_Memset( pacingWheel, 0, sizeof( pacingWheel ) );
+	pacingQueued = 0;
+
+	SV_PacingClear();
+}
+
+
+/*
+==================
+SV_Pacing_f
+
+pacing [clear]
+
+Prints snapshot send intervals and jitter of every connected client as
+JSON, along with the largest number of snapshots sent within a millisecond
+==================
+*/
+void SV_Pacing_f( void ) {
+	const pacedClient_t *pc;
+	const client_t *cl;
+	int i, count;
+
+	if ( !com_sv_running->integer ) {
+		Com_Printf( "Server is not running.\n" );
+		return;
+	}
+
+	if ( Cmd_Argc() > 1 && !Q_stricmp( Cmd_Argv( 1 ), "clear" ) ) {
+		SV_PacingClear();
+		return;
+	}
+
+	count = 0;
+	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ ) {
+		if ( cl->state >= CS_CONNECTED ) {
+			count++;
+		}
+	}
+
+	Com_Printf( "{\n" );
+	Com_Printf( "  \"enabled\": %s,\n", sv_snapshotPacing->integer ? "true" : "false" );
+	Com_Printf( "  \"sv_fps\": %i,\n", sv_fps->integer );
+	Com_Printf( "  \"max_burst_packets\": %i,\n", maxBurstPackets );
+	Com_Printf( "  \"max_burst_bytes\": %i,\n", maxBurstBytes );
+	Com_Printf( "  \"clients\": [%s\n", count ? "" : " ]" );
+
+	for ( i = 0, cl = svs.clients, pc = pacedClients; i < sv_maxclients->integer; i++, cl++, pc++ ) {
+		if ( cl->state < CS_CONNECTED ) {
+			continue;
+		}
+		count--;
+		Com_Printf( "    { \"client\": %i, \"offset_msec\": %i, \"intervals\": %i, \"avg_interval_usec\": %i, \"jitter_usec\": %i, \"max_jitter_usec\": %i }%s\n",
+			i, pc->offset, pc->intervals, pc->intervals ? (int)( pc->intervalSum / pc->intervals ) : 0,
+			(int)pc->jitter, pc->maxJitter, count ? "," : "" );
+		if ( !count ) {
+			Com_Printf( "  ]\n" );
+		}
+	}
+
+	Com_Printf( "}\n" );
+}
@@ -52,6 +52,156 @@ A normal server packet will look like:
 =============================================================================
 */
 
+/*
+=============================================================================
+
+Delta entity cache
+
+Clients that delta from the same frame produce identical MSG_WriteDeltaEntity()
+output for an entity because they share the snapshot entity storage. Encoded
+bits are remembered per (from, to) pair until a new common snapshot is built
+and spliced into the next message that needs them. The huffman code of a
+symbol does not depend on its position, so a copy is bit exact.
+
+=============================================================================
+*/
+
+#define DELTA_CACHE_ENTRIES	4096				// direct mapped, power of two
+#define DELTA_CACHE_DATA	(256*1024)
+
+typedef struct {
+	const entityState_t	*from;
+	const entityState_t	*to;
+	int			generation;
+	int			offset;							// into deltaCache_t->data
+	int			numBits;
+	int			uncompsize;
+} deltaCacheEntry_t;
+
+typedef struct deltaCache_s {
+	int					generation;				// of the data
+	int					used;
+	int					hits;
+	int					lookups;
+	deltaCacheEntry_t	entries[ DELTA_CACHE_ENTRIES ];
+	byte				data[ DELTA_CACHE_DATA + 4 ];
+} deltaCache_t;
+
+static int deltaCacheGeneration = 1;			// bumped with each new common snapshot
+static qboolean deltaCacheDisabled;				// for verification by snapshotbench
+
+
+/*
+=============
+SV_DeltaCacheEntry
+=============
+*/
+static deltaCacheEntry_t *SV_DeltaCacheEntry( deltaCache_t *cache, const entityState_t *from, const entityState_t *to ) {
+	unsigned int hash;
+
+	hash = (unsigned int)( (intptr_t)from >> 2 ) * 0x9E3779B1U;
+	hash ^= (unsigned int)( (intptr_t)to >> 2 ) * 0x85EBCA77U;
+
+	return &cache->entries[ ( hash >> 16 ) & ( DELTA_CACHE_ENTRIES - 1 ) ];
+}
+
+
+/*
+=============
+SV_WriteCachedDeltaEntity
+
+Same output as MSG_WriteDeltaEntity(), from cache if possible
+=============
+*/
+static void SV_WriteCachedDeltaEntity( deltaCache_t *cache, msg_t *msg, const entityState_t *from, const entityState_t *to, qboolean force ) {
+	deltaCacheEntry_t	*entry;
+	const byte			*src;
+	byte				*dst;
+	int					startBit, numBits;
+	int					shift, i, n;
+
+	if ( !cache || deltaCacheDisabled || msg->oob || msg->overflowed ) {
+		MSG_WriteDeltaEntity( msg, from, to, force );
+		return;
+	}
+
+	if ( cache->generation != deltaCacheGeneration ) {
+		cache->generation = deltaCacheGeneration;
+		cache->used = 0;
+	}
+
+	cache->lookups++;
+
+	entry = SV_DeltaCacheEntry( cache, from, to );
+	if ( entry->generation == cache->generation && entry->from == from && entry->to == to ) {
+		cache->hits++;
+
+		numBits = entry->numBits;
+		msg->uncompsize += entry->uncompsize;
+		if ( !numBits ) {
+			return;
+		}
+		if ( msg->bit + numBits > msg->maxbits ) {
+			msg->overflowed = qtrue;
+			return;
+		}
+
+		// append at current bit position, bits above it are always zero
+		src = cache->data + entry->offset;
+		dst = msg->data + ( msg->bit >> 3 );
+		shift = msg->bit & 7;
+		n = ( numBits + 7 ) >> 3;
+		if ( shift ) {
+			for ( i = 0; i < n; i++ ) {
+				dst[i] |= src[i] << shift;
+				dst[i+1] = src[i] >> ( 8 - shift );
+			}
+		} else {
+			Com_Memcpy( dst, src, n );
+		}
+
+		msg->bit += numBits;
+		msg->cursize = ( msg->bit >> 3 ) + 1;
+		return;
+	}
+
+	startBit = msg->bit;
+	i = msg->uncompsize;
+
+	MSG_WriteDeltaEntity( msg, from, to, force );
+
+	numBits = msg->bit - startBit;
+	n = ( numBits + 7 ) >> 3;
+	if ( msg->overflowed || cache->used + n > DELTA_CACHE_DATA ) {
+		return;
+	}
+
+	entry->from = from;
+	entry->to = to;
+	entry->generation = cache->generation;
+	entry->offset = cache->used;
+	entry->numBits = numBits;
+	entry->uncompsize = msg->uncompsize - i;
+
+	// store aligned to the first bit
+	src = msg->data + ( startBit >> 3 );
+	dst = cache->data + cache->used;
+	shift = startBit & 7;
+	if ( shift ) {
+		for ( i = 0; i < n; i++ ) {
+			dst[i] = ( src[i] >> shift ) | ( src[i+1] << ( 8 - shift ) );
+		}
+	} else {
+		Com_Memcpy( dst, src, n );
+	}
+	if ( numBits & 7 ) {
+		dst[n-1] &= ( 1 << ( numBits & 7 ) ) - 1;
+	}
+
+	cache->used += n;
+}
+
+
 /*
 =============
 SV_EmitPacketEntities
@@ -59,7 +209,7 @@ SV_EmitPacketEntities
 Writes a delta update of an entityState_t list to the message.
 =============
 */
-static void SV_EmitPacketEntities( const clientSnapshot_t *from, const clientSnapshot_t *to, msg_t *msg ) {
+static void SV_EmitPacketEntities( deltaCache_t *cache, const clientSnapshot_t *from, const clientSnapshot_t *to, msg_t *msg ) {
 	entityState_t	*oldent, *newent;
 	int		oldindex, newindex;
 	int		oldnum, newnum;
@@ -95,7 +245,7 @@ static void SV_EmitPacketEntities( const clientSnapshot_t *from, const clientSna
 			// delta update from old position
 			// because the force parm is qfalse, this will not result
 			// in any bytes being emitted if the entity has not changed at all
-			MSG_WriteDeltaEntity (msg, oldent, newent, qfalse );
+			SV_WriteCachedDeltaEntity( cache, msg, oldent, newent, qfalse );
 			oldindex++;
 			newindex++;
 			continue;
@@ -103,14 +253,14 @@ static void SV_EmitPacketEntities( const clientSnapshot_t *from, const clientSna
 
 		if ( newnum < oldnum ) {
 			// this is a new entity, send it from the baseline
-			MSG_WriteDeltaEntity (msg, &sv.svEntities[newnum].baseline, newent, qtrue );
+			SV_WriteCachedDeltaEntity( cache, msg, &sv.svEntities[newnum].baseline, newent, qtrue );
 			newindex++;
 			continue;
 		}
 
 		if ( newnum > oldnum ) {
 			// the old entity isn't present in the new message
-			MSG_WriteDeltaEntity (msg, oldent, NULL, qtrue );
+			SV_WriteCachedDeltaEntity( cache, msg, oldent, NULL, qtrue );
 			oldindex++;
 			continue;
 		}
@@ -122,24 +272,21 @@ static void SV_EmitPacketEntities( const clientSnapshot_t *from, const clientSna
 
 /*
 ==================
-SV_WriteSnapshotToClient
+SV_GetDeltaFrame
+
+Selects a previous frame as the source for delta compressing the
+snapshot that is about to be written, NULL for a full update.
+Must be called after the current common snapshot has been built.
 ==================
 */
-static void SV_WriteSnapshotToClient( const client_t *client, msg_t *msg ) {
+static const clientSnapshot_t *SV_GetDeltaFrame( const client_t *client, int *lastframe ) {
 	const clientSnapshot_t	*oldframe;
-	const clientSnapshot_t	*frame;
-	int					lastframe;
-	int					i;
-	int					snapFlags;
-
-	// this is the snapshot we are creating
-	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
 
 	// try to use a previous frame as the source for delta compressing the snapshot
 	if ( /* client->deltaMessage <= 0 || */ client->state != CS_ACTIVE ) {
 		// client is asking for a retransmit
 		oldframe = NULL;
-		lastframe = 0;
+		*lastframe = 0;
 	} else if ( client->netchan.outgoingSequence - client->deltaMessage >= (PACKET_BACKUP - 3) ) {
 		// client hasn't gotten a good message through in a long time
 		if ( com_developer->integer ) {
@@ -148,19 +295,38 @@ static void SV_WriteSnapshotToClient( const client_t *client, msg_t *msg ) {
 			}
 		}
 		oldframe = NULL;
-		lastframe = 0;
+		*lastframe = 0;
 	} else {
 		// we have a valid snapshot to delta from
 		oldframe = &client->frames[ client->deltaMessage & PACKET_MASK ];
-		lastframe = client->netchan.outgoingSequence - client->deltaMessage;
+		*lastframe = client->netchan.outgoingSequence - client->deltaMessage;
 		// we may refer on outdated frame
 		if ( oldframe->frameNum - svs.lastValidFrame < 0 ) {
 			Com_DPrintf( "%s: Delta request from out of date frame.\n", client->name );
 			oldframe = NULL;
-			lastframe = 0;
+			*lastframe = 0;
 		}
 	}
 
+	return oldframe;
+}
+
+
+/*
+==================
+SV_WriteSnapshotToClient
+
+Doesn't touch any shared state so it can be called from worker threads
+==================
+*/
+static void SV_WriteSnapshotToClient( deltaCache_t *cache, const client_t *client, const clientSnapshot_t *oldframe, int lastframe, msg_t *msg ) {
+	const clientSnapshot_t	*frame;
+	int					i;
+	int					snapFlags;
+
+	// this is the snapshot we are creating
+	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+
 	MSG_WriteByte( msg, svc_snapshot );
 
 	// NOTE, MRE: now sent at the start of every message from server to client
@@ -223,7 +389,7 @@ static void SV_WriteSnapshotToClient( const client_t *client, msg_t *msg ) {
 	}
 
 	// delta encode the entities
-	SV_EmitPacketEntities (oldframe, frame, msg);
+	SV_EmitPacketEntities( cache, oldframe, frame, msg );
 
 	// padding for rate debugging
 	if ( sv_padPackets->integer ) {
@@ -251,7 +417,7 @@ void SV_UpdateServerCommandsToClient( client_t *client, msg_t *msg ) {
 		const int index = client->reliableAcknowledge + 1 + i;
 		MSG_WriteByte( msg, svc_serverCommand );
 		MSG_WriteLong( msg, index );
-		MSG_WriteString( msg, client->reliableCommands[ index & (MAX_RELIABLE_COMMANDS-1) ] );
+		MSG_WriteString( msg, SV_ReliableCommand( client, index ) );
 	}
 }
 
@@ -271,6 +437,58 @@ typedef struct {
 	qboolean unordered;
 } snapshotEntityNumbers_t;
 
+// per-thread state of the client snapshot builder, each worker owns one
+// so that client snapshots can be built in parallel
+typedef struct {
+	int			snapshotCounter;					// incremented for each snapshot built
+	int			entityCounters[ MAX_GENTITIES ];	// used to prevent double adding from portal views
+	const byte	*callbackDenied;					// precalculated game snapshot callbacks, NULL to call the vm
+	deltaCache_t *deltaCache;						// allocated on first use, NULL if that failed
+	char		error[ MAX_STRING_CHARS ];			// deferred Com_Error() from worker threads
+} snapshotContext_t;
+
+static snapshotContext_t snapshotContexts[ MAX_WORKER_THREADS ];
+
+
+/*
+=============
+SV_DeltaCache
+=============
+*/
+static deltaCache_t *SV_DeltaCache( snapshotContext_t *ctx ) {
+	if ( !ctx->deltaCache ) {
+		// RF, avoid trying to allocate large chunk on a fragmented zone
+		ctx->deltaCache = calloc( 1, sizeof( deltaCache_t ) );
+	}
+	return ctx->deltaCache;
+}
+
+
+/*
+=============
+SV_SnapshotError
+
+Worker threads must not longjmp, so remember the first error
+and let the main thread raise it once all jobs are finished
+=============
+*/
+static void FORMAT_PRINTF(2, 3) SV_SnapshotError( snapshotContext_t *ctx, const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[ MAX_STRING_CHARS ];
+
+	va_start( argptr, fmt );
+	Q_vsnprintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( !ctx->callbackDenied ) {
+		Com_Error( ERR_DROP, "%s", text );
+	}
+
+	if ( !ctx->error[0] ) {
+		Q_strncpyz( ctx->error, text, sizeof( ctx->error ) );
+	}
+}
+
 
 /*
 =============
@@ -279,7 +497,7 @@ SV_SortEntityNumbers
 Insertion sort is about 10 times faster than quicksort for our task
 =============
 */
-static void SV_SortEntityNumbers( entityNum_t *num, const int size ) {
+static void SV_SortEntityNumbers( snapshotContext_t *ctx, entityNum_t *num, const int size ) {
 	entityNum_t tmp;
 	int i, d;
 	for ( i = 1 ; i < size; i++ ) {
@@ -294,7 +512,8 @@ static void SV_SortEntityNumbers( entityNum_t *num, const int size ) {
 	// consistency check for delta encoding
 	for ( i = 1 ; i < size; i++ ) {
 		if ( num[i-1] >= num[i] ) {
-			Com_Error( ERR_DROP, "%s: invalid entity number %i", __func__, num[ i ] );
+			SV_SnapshotError( ctx, "%s: invalid entity number %i", __func__, num[ i ] );
+			return;
 		}
 	}
 }
@@ -322,9 +541,10 @@ static int SV_GetIndexByEntityNum( int num )
 SV_AddIndexToSnapshot
 ===============
 */
-static void SV_AddIndexToSnapshot( const sharedEntity_t *clientEnt, svEntity_t *svEnt, int index, snapshotEntityNumbers_t *eNums ) {
+static void SV_AddIndexToSnapshot( snapshotContext_t *ctx, const sharedEntity_t *clientEnt, svEntity_t *svEnt, int index, snapshotEntityNumbers_t *eNums ) {
+	const int num = svEnt - sv.svEntities;
 
-	svEnt->snapshotCounter = sv.snapshotCounter;
+	ctx->entityCounters[ num ] = ctx->snapshotCounter;
 
 	// if we are full, silently discard entities
 	if ( eNums->numSnapshotEntities >= MAX_SNAPSHOT_ENTITIES ) {
@@ -334,7 +554,11 @@ static void SV_AddIndexToSnapshot( const sharedEntity_t *clientEnt, svEntity_t *
 	{
 		sharedEntity_t *gEnt = SV_GEntityForSvEntity( svEnt );
 		if ( gEnt->r.snapshotCallback ) {
-			if ( !SV_GameSnapshotCallback( gEnt->s.number, clientEnt->s.number ) ) {
+			if ( ctx->callbackDenied ) {
+				if ( ctx->callbackDenied[ num >> 3 ] & ( 1 << ( num & 7 ) ) ) {
+					return;
+				}
+			} else if ( !SV_GameSnapshotCallback( gEnt->s.number, clientEnt->s.number ) ) {
 				return;
 			}
 		}
@@ -345,99 +569,241 @@ static void SV_AddIndexToSnapshot( const sharedEntity_t *clientEnt, svEntity_t *
 }
 
 
+/*
+=============================================================================
+
+Entity visibility
+
+Everything the PVS culling needs from the entities of the current
+common snapshot is gathered once per frame into compact arrays, so
+each client (and portal view) only has to walk them instead of the
+gentities and svEntities. The tests are the same as they always were.
+
+=============================================================================
+*/
+
+typedef enum {
+	VIS_NONE,				// not touching any cluster
+	VIS_BROADCAST,			// always sent
+	VIS_ORIGIN,				// SVF_IGNOREBMODELEXTENTS, only origin cluster is checked
+	VIS_CLUSTERS			// areas and clusters from linking
+} entityVisType_t;
+
+typedef struct {
+	entityVisType_t	type;
+	int				svFlags;
+	int				singleClient;
+	int				areanum, areanum2;
+	int				firstCluster;		// index into snapshotVis.clusters, originCluster for VIS_ORIGIN
+	int				numClusters;
+	int				lastCluster;		// if all the clusters don't fit in clusternums
+} entityVis_t;
+
+typedef struct {
+	const snapshotFrame_t *frame;		// frame the data was built for
+	int				maxArea;
+	entityVis_t		ents[ MAX_GENTITIES ];
+	int				clusters[ MAX_GENTITIES * MAX_ENT_CLUSTERS ];
+} snapshotVis_t;
+
+static snapshotVis_t snapshotVis;
+
+#define VIS_WORDS ( MAX_GENTITIES / 32 )
+
+
 /*
 ===============
-SV_AddEntitiesVisibleFromPoint
+SV_BuildSnapshotVis
+
+Called once for each new common snapshot, before any client snapshot is built
 ===============
 */
-static void SV_AddEntitiesVisibleFromPoint( const vec3_t origin, clientSnapshot_t *frame,
-//									snapshotEntityNumbers_t *eNums, qboolean portal, clientSnapshot_t *oldframe, qboolean localClient ) {
-//									snapshotEntityNumbers_t *eNums, qboolean portal ) {
-									snapshotEntityNumbers_t *eNums /*, qboolean portal, qboolean localClient*/  ) {
-	int e, i;
-	sharedEntity_t *ent, *playerEnt;
-	svEntity_t  *svEnt;
-	entityState_t  *es;
-	int l;
-	int clientarea, clientcluster;
-	int leafnum;
-	byte    *clientpvs;
-	byte    *bitvector;
+static void SV_BuildSnapshotVis( const snapshotFrame_t *sf ) {
+	const sharedEntity_t	*ent;
+	const svEntity_t		*svEnt;
+	entityVis_t				*ev;
+	int						numClusters;
+	int						e, num;
+
+	snapshotVis.frame = sf;
+	snapshotVis.maxArea = -1;
+
+	numClusters = 0;
+	for ( e = 0; e < sf->count; e++ ) {
+		num = sf->ents[ e ]->number;
+		ent = SV_GentityNum( num );
+		svEnt = &sv.svEntities[ num ];
+		ev = &snapshotVis.ents[ e ];
+
+		ev->svFlags = ent->r.svFlags;
+		ev->singleClient = ent->r.singleClient;
 
-	// during an error shutdown message we may need to transmit
-	// the shutdown message after the server has shutdown, so
-	// specfically check for it
-	if ( sv.state == SS_DEAD ) {
-		return;
+		if ( ent->r.svFlags & SVF_BROADCAST ) {
+			ev->type = VIS_BROADCAST;
+		} else if ( ent->r.svFlags & SVF_IGNOREBMODELEXTENTS ) {
+			ev->type = VIS_ORIGIN;
+			ev->firstCluster = svEnt->originCluster;
+		} else if ( svEnt->numClusters > 0 ) {
+			ev->type = VIS_CLUSTERS;
+			ev->areanum = svEnt->areanum;
+			ev->areanum2 = svEnt->areanum2;
+			ev->firstCluster = numClusters;
+			ev->numClusters = svEnt->numClusters;
+			ev->lastCluster = svEnt->lastCluster;
+			Com_Memcpy( snapshotVis.clusters + numClusters, svEnt->clusternums, svEnt->numClusters * sizeof( int ) );
+			numClusters += svEnt->numClusters;
+			if ( svEnt->areanum > snapshotVis.maxArea ) {
+				snapshotVis.maxArea = svEnt->areanum;
+			}
+			if ( svEnt->areanum2 > snapshotVis.maxArea ) {
+				snapshotVis.maxArea = svEnt->areanum2;
+			}
+		} else {
+			ev->type = VIS_NONE;
+		}
 	}
+}
 
-	leafnum = CM_PointLeafnum (origin);
-	clientarea = CM_LeafArea (leafnum);
-	clientcluster = CM_LeafCluster (leafnum);
-
-	// calculate the visible areas
-	frame->areabytes = CM_WriteAreaBits( frame->areabits, clientarea );
 
-	clientpvs = CM_ClusterPVS (clientcluster);
+/*
+===============
+SV_MarkVisibleEntities
 
-	playerEnt = SV_GentityNum( frame->ps.clientNum );
-	if ( playerEnt->r.svFlags & SVF_SELF_PORTAL ) {
-		eNums->unordered = qtrue;
-		SV_AddEntitiesVisibleFromPoint( playerEnt->s.origin2, frame, eNums );
+Sets bits of current frame entities that are in the pvs of clientcluster
+and not blocked by a door, does not depend on anything but the view
+===============
+*/
+static void SV_MarkVisibleEntities( int clientNum, int clientarea, const byte *bitvector, unsigned int *visible ) {
+	byte				areaConnected[ MAX_MAP_AREAS + 1 ];		// indexed by areanum + 1
+	const entityVis_t	*ev;
+	const int			*c;
+	int					e, i, l;
+
+	// each area is checked once instead of twice per entity
+	for ( i = 0; i <= snapshotVis.maxArea + 1; i++ ) {
+		areaConnected[ i ] = CM_AreasConnected( clientarea, i - 1 );
 	}
 
-	for ( e = 0 ; e < svs.currFrame->count; e++ ) {
-		es = svs.currFrame->ents[ e ];
-		ent = SV_GentityNum( es->number );
+	Com_Memset( visible, 0, VIS_WORDS * sizeof( visible[0] ) );
 
+	for ( e = 0, ev = snapshotVis.ents; e < snapshotVis.frame->count; e++, ev++ ) {
 		// entities can be flagged to be sent to only one client
-		if ( ent->r.svFlags & SVF_SINGLECLIENT ) {
-			if ( ent->r.singleClient != frame->ps.clientNum ) {
+		if ( ev->svFlags & SVF_SINGLECLIENT ) {
+			if ( ev->singleClient != clientNum ) {
 				continue;
 			}
 		}
 		// entities can be flagged to be sent to everyone but one client
-		if ( ent->r.svFlags & SVF_NOTSINGLECLIENT ) {
-			if ( ent->r.singleClient == frame->ps.clientNum ) {
+		if ( ev->svFlags & SVF_NOTSINGLECLIENT ) {
+			if ( ev->singleClient == clientNum ) {
 				continue;
 			}
 		}
 
-		svEnt = &sv.svEntities[ es->number ];
+		switch ( ev->type ) {
+		case VIS_BROADCAST:
+			break;
 
-		// don't double add an entity through portals
-		if ( svEnt->snapshotCounter == sv.snapshotCounter ) {
+		case VIS_ORIGIN:
+			// Gordon: just check origin for being in pvs, ignore bmodel extents
+			l = ev->firstCluster;
+			if ( !( bitvector[l >> 3] & ( 1 << ( l & 7 ) ) ) ) {
+				continue;
+			}
+			break;
+
+		case VIS_CLUSTERS:
+			// check area, doors can legally straddle two areas
+			if ( !areaConnected[ ev->areanum + 1 ] && !areaConnected[ ev->areanum2 + 1 ] ) {
+				continue; // blocked by a door
+			}
+
+			// check individual leafs
+			c = snapshotVis.clusters + ev->firstCluster;
+			l = 0;
+			for ( i = 0 ; i < ev->numClusters ; i++ ) {
+				l = c[i];
+				if ( bitvector[l >> 3] & ( 1 << ( l & 7 ) ) ) {
+					break;
+				}
+			}
+
+			// if we haven't found it to be visible,
+			// check overflow clusters that coudln't be stored
+			if ( i == ev->numClusters ) {
+				if ( !ev->lastCluster ) {
+					continue;
+				}
+				for ( ; l <= ev->lastCluster ; l++ ) {
+					if ( bitvector[l >> 3] & ( 1 << ( l & 7 ) ) ) {
+						break;
+					}
+				}
+				if ( l == ev->lastCluster ) {
+					continue;	// not visible
+				}
+			}
+			break;
+
+		default:
 			continue;
 		}
 
-		// broadcast entities are always sent
+		visible[ e >> 5 ] |= 1U << ( e & 31 );
+	}
+}
+
+
+/*
+===============
+SV_MarkVisibleEntitiesReference
+
+Per-entity culling as it was done before the visibility
+arrays, only used by snapshotbench to verify them
+===============
+*/
+static void SV_MarkVisibleEntitiesReference( int clientNum, int clientarea, const byte *bitvector, unsigned int *visible ) {
+	const sharedEntity_t	*ent;
+	const svEntity_t		*svEnt;
+	const entityState_t		*es;
+	int						e, i, l;
+
+	Com_Memset( visible, 0, VIS_WORDS * sizeof( visible[0] ) );
+
+	for ( e = 0 ; e < svs.currFrame->count; e++ ) {
+		es = svs.currFrame->ents[ e ];
+		ent = SV_GentityNum( es->number );
+		svEnt = &sv.svEntities[ es->number ];
+
+		if ( ent->r.svFlags & SVF_SINGLECLIENT ) {
+			if ( ent->r.singleClient != clientNum ) {
+				continue;
+			}
+		}
+		if ( ent->r.svFlags & SVF_NOTSINGLECLIENT ) {
+			if ( ent->r.singleClient == clientNum ) {
+				continue;
+			}
+		}
+
 		if ( ent->r.svFlags & SVF_BROADCAST ) {
-			SV_AddIndexToSnapshot( playerEnt, svEnt, e, eNums );
+			visible[ e >> 5 ] |= 1U << ( e & 31 );
 			continue;
 		}
 
-		bitvector = clientpvs;
-
-		// Gordon: just check origin for being in pvs, ignore bmodel extents
-		if (ent->r.svFlags & SVF_IGNOREBMODELEXTENTS) {
-			if (bitvector[svEnt->originCluster >> 3] & (1 << (svEnt->originCluster & 7))) {
-				//SV_AddEntToSnapshot( playerEnt, svEnt, ent, eNums );
-				SV_AddIndexToSnapshot(playerEnt, svEnt, e, eNums);
+		if ( ent->r.svFlags & SVF_IGNOREBMODELEXTENTS ) {
+			if ( bitvector[svEnt->originCluster >> 3] & ( 1 << ( svEnt->originCluster & 7 ) ) ) {
+				visible[ e >> 5 ] |= 1U << ( e & 31 );
 			}
 			continue;
 		}
 
-		// ignore if not touching a PV leaf
-		// check area
 		if ( !CM_AreasConnected( clientarea, svEnt->areanum ) ) {
-			// doors can legally straddle two areas, so
-			// we may need to check another one
 			if ( !CM_AreasConnected( clientarea, svEnt->areanum2 ) ) {
-				continue; // blocked by a door
+				continue;
 			}
 		}
 
-		// check individual leafs
 		if ( !svEnt->numClusters ) {
 			continue;
 		}
@@ -448,9 +814,6 @@ static void SV_AddEntitiesVisibleFromPoint( const vec3_t origin, clientSnapshot_
 				break;
 			}
 		}
-
-		// if we haven't found it to be visible,
-		// check overflow clusters that coudln't be stored
 		if ( i == svEnt->numClusters ) {
 			if ( svEnt->lastCluster ) {
 				for ( ; l <= svEnt->lastCluster ; l++ ) {
@@ -459,16 +822,89 @@ static void SV_AddEntitiesVisibleFromPoint( const vec3_t origin, clientSnapshot_
 					}
 				}
 				if ( l == svEnt->lastCluster ) {
-					continue;	// not visible
+					continue;
 				}
 			} else {
 				continue;
 			}
 		}
 
+		visible[ e >> 5 ] |= 1U << ( e & 31 );
+	}
+}
+
+
+/*
+===============
+SV_AddEntitiesVisibleFromPoint
+===============
+*/
+static void SV_AddEntitiesVisibleFromPoint( snapshotContext_t *ctx, const vec3_t origin, clientSnapshot_t *frame,
+//									snapshotEntityNumbers_t *eNums, qboolean portal, clientSnapshot_t *oldframe, qboolean localClient ) {
+//									snapshotEntityNumbers_t *eNums, qboolean portal ) {
+									snapshotEntityNumbers_t *eNums /*, qboolean portal, qboolean localClient*/  ) {
+	unsigned int visible[ VIS_WORDS ];
+	int e;
+	sharedEntity_t *ent, *playerEnt;
+	svEntity_t  *svEnt;
+	const entityVis_t *ev;
+	entityState_t  *es;
+	int clientarea, clientcluster;
+	int leafnum;
+	byte    *clientpvs;
+
+	// during an error shutdown message we may need to transmit
+	// the shutdown message after the server has shutdown, so
+	// specfically check for it
+	if ( sv.state == SS_DEAD ) {
+		return;
+	}
+
+	leafnum = CM_PointLeafnum (origin);
+	clientarea = CM_LeafArea (leafnum);
+	clientcluster = CM_LeafCluster (leafnum);
+
+	// calculate the visible areas
+	frame->areabytes = CM_WriteAreaBits( frame->areabits, clientarea );
+
+	clientpvs = CM_ClusterPVS (clientcluster);
+
+	playerEnt = SV_GentityNum( frame->ps.clientNum );
+	if ( playerEnt->r.svFlags & SVF_SELF_PORTAL ) {
+		eNums->unordered = qtrue;
+		SV_AddEntitiesVisibleFromPoint( ctx, playerEnt->s.origin2, frame, eNums );
+	}
+
+	SV_MarkVisibleEntities( frame->ps.clientNum, clientarea, clientpvs, visible );
+
+	for ( e = 0 ; e < svs.currFrame->count; e++ ) {
+		if ( !visible[ e >> 5 ] ) {
+			e |= 31;
+			continue;
+		}
+		if ( !( visible[ e >> 5 ] & ( 1U << ( e & 31 ) ) ) ) {
+			continue;
+		}
+
+		es = svs.currFrame->ents[ e ];
+		ev = &snapshotVis.ents[ e ];
+		svEnt = &sv.svEntities[ es->number ];
+
+		// don't double add an entity through portals
+		if ( ctx->entityCounters[ es->number ] == ctx->snapshotCounter ) {
+			continue;
+		}
+
+		// broadcast entities are always sent
+		if ( ev->type == VIS_BROADCAST || ev->type == VIS_ORIGIN ) {
+			SV_AddIndexToSnapshot( ctx, playerEnt, svEnt, e, eNums );
+			continue;
+		}
+
+		ent = SV_GentityNum( es->number );
 
 		//----(SA) added "visibility dummies"
-		if ( ent->r.svFlags & SVF_VISDUMMY ) {
+		if ( ev->svFlags & SVF_VISDUMMY ) {
 			sharedEntity_t *ment;
 
 			//find master;
@@ -478,21 +914,21 @@ static void SV_AddEntitiesVisibleFromPoint( const vec3_t origin, clientSnapshot_
 				int index;
 
 				master = SV_SvEntityForGentity( ment );
-				if ( master->snapshotCounter == sv.snapshotCounter || !ment->r.linked ) {
+				if ( ctx->entityCounters[ master - sv.svEntities ] == ctx->snapshotCounter || !ment->r.linked ) {
 					continue;
 				}
 
 				//SV_AddEntToSnapshot( playerEnt, master, ment, eNums );
 				index = SV_GetIndexByEntityNum( ment->s.number );
 				if ( index >= 0 ) {
-					SV_AddIndexToSnapshot( playerEnt, master, index, eNums );
+					SV_AddIndexToSnapshot( ctx, playerEnt, master, index, eNums );
 					eNums->unordered = qtrue;
 				}
 			}
 			continue;   // master needs to be added, but not this dummy ent
 		}
 		//----(SA) end
-		else if ( ent->r.svFlags & SVF_VISDUMMY_MULTIPLE ) {
+		else if ( ev->svFlags & SVF_VISDUMMY_MULTIPLE ) {
 			{
 				int h;
 				sharedEntity_t *ment = 0;
@@ -525,7 +961,7 @@ static void SV_AddEntitiesVisibleFromPoint( const vec3_t origin, clientSnapshot_
 						continue;
 					}
 
-					if ( master->snapshotCounter == sv.snapshotCounter ) {
+					if ( ctx->entityCounters[ master - sv.svEntities ] == ctx->snapshotCounter ) {
 						continue;
 					}
 
@@ -535,7 +971,7 @@ static void SV_AddEntitiesVisibleFromPoint( const vec3_t origin, clientSnapshot_
 						//SV_AddEntToSnapshot( playerEnt, master, ment, eNums );
 						index = SV_GetIndexByEntityNum( ment->s.number );
 						if ( index >= 0 ) {
-							SV_AddIndexToSnapshot( playerEnt, master, index, eNums );
+							SV_AddIndexToSnapshot( ctx, playerEnt, master, index, eNums );
 							eNums->unordered = qtrue;
 						}
 					}
@@ -545,13 +981,13 @@ static void SV_AddEntitiesVisibleFromPoint( const vec3_t origin, clientSnapshot_
 		}
 
 		// add it
-		SV_AddIndexToSnapshot( playerEnt, svEnt, e, eNums );
+		SV_AddIndexToSnapshot( ctx, playerEnt, svEnt, e, eNums );
 
 		// if it's a portal entity, add everything visible from its camera position
-		if ( ent->r.svFlags & SVF_PORTAL ) {
+		if ( ev->svFlags & SVF_PORTAL ) {
 //			SV_AddEntitiesVisibleFromPoint( ent->s.origin2, frame, eNums, qtrue, oldframe, localClient );
 			eNums->unordered = qtrue;
-			SV_AddEntitiesVisibleFromPoint( ent->s.origin2, frame, eNums /*, qtrue, localClient*/ );
+			SV_AddEntitiesVisibleFromPoint( ctx, ent->s.origin2, frame, eNums /*, qtrue, localClient*/ );
 		}
 	}
 }
@@ -644,12 +1080,9 @@ static void SV_BuildCommonSnapshot( void )
 			//}
 
 			list[ count++ ] = ent;
-			sv.svEntities[ num ].snapshotCounter = -1;
 		}
 	}
 
-	sv.snapshotCounter = -1;
-
 	sf = &svs.snapFrames[ svs.snapshotFrame % NUM_SNAPSHOT_FRAMES ];
 	
 	// track last valid frame
@@ -686,6 +1119,9 @@ static void SV_BuildCommonSnapshot( void )
 
 	svs.currFrame = sf; // clients can refer to this
 
+	// previous frames may be overwritten now
+	deltaCacheGeneration++;
+
 	// setup start index
 	index = sf->start;
 	for ( i = 0 ; i < count ; i++, index = (index+1) % svs.numSnapshotEntities ) {
@@ -693,6 +1129,8 @@ static void SV_BuildCommonSnapshot( void )
 		svs.snapshotEntities[ index ] = list[ i ]->s;
 		sf->ents[ i ] = &svs.snapshotEntities[ index ];
 	}
+
+	SV_BuildSnapshotVis( sf );
 }
 
 
@@ -709,20 +1147,16 @@ currently doesn't.
 For viewing through other player's eyes, clent can be something other than client->gentity
 =============
 */
-static void SV_BuildClientSnapshot( client_t *client ) {
+static void SV_BuildClientFrame( snapshotContext_t *ctx, client_t *client, clientSnapshot_t *frame ) {
 	vec3_t						org;
-	clientSnapshot_t			*frame;
 	snapshotEntityNumbers_t		entityNumbers;
 	int							i, cl;
 	//sharedEntity_t              *ent;
 	//entityState_t               *state;
-	svEntity_t                  *svEnt;
 	sharedEntity_t              *clent;
 	int							clientNum;
 	playerState_t				*ps;
 
-	// this is the frame we are creating
-	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
 	cl = client - svs.clients;
 
 	// clear everything in this snapshot
@@ -743,7 +1177,8 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 
 	clientNum = frame->ps.clientNum;
 	if ( clientNum < 0 || clientNum >= MAX_GENTITIES ) {
-		Com_Error( ERR_DROP, "SV_SvEntityForGentity: bad gEnt" );
+		SV_SnapshotError( ctx, "SV_SvEntityForGentity: bad gEnt" );
+		return;
 	}
 
 	// we set client->gentity only after sending gamestate
@@ -759,7 +1194,10 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 	}
 
 	// bump the counter used to prevent double adding
-	sv.snapshotCounter++;
+	if ( ++ctx->snapshotCounter == INT_MAX ) {
+		Com_Memset( ctx->entityCounters, 0, sizeof( ctx->entityCounters ) );
+		ctx->snapshotCounter = 1;
+	}
 
 	// empty entities before visibility check
 	entityNumbers.numSnapshotEntities = 0;
@@ -768,8 +1206,7 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 
 	// never send client's own entity, because it can
 	// be regenerated from the playerstate
-	svEnt = &sv.svEntities[ clientNum ];
-	svEnt->snapshotCounter = sv.snapshotCounter;
+	ctx->entityCounters[ clientNum ] = ctx->snapshotCounter;
 
 	if ( clent->r.svFlags & SVF_SELF_PORTAL_EXCLUSIVE ) {
 		// find the client's viewpoint
@@ -793,14 +1230,14 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 	// add all the entities directly visible to the eye, which
 	// may include portal entities that merge other viewpoints
 	entityNumbers.unordered = qfalse;
-	SV_AddEntitiesVisibleFromPoint( org, frame, &entityNumbers /*, qfalse, client->netchan.remoteAddress.type == NA_LOOPBACK*/ );
+	SV_AddEntitiesVisibleFromPoint( ctx, org, frame, &entityNumbers /*, qfalse, client->netchan.remoteAddress.type == NA_LOOPBACK*/ );
 
 	// if there were portals visible, there may be out of order entities
 	// in the list which will need to be resorted for the delta compression
 	// to work correctly.  This also catches the error condition
 	// of an entity being included twice.
 	if ( entityNumbers.unordered ) {
-		SV_SortEntityNumbers( &entityNumbers.snapshotEntities[0], 
+		SV_SortEntityNumbers( ctx, &entityNumbers.snapshotEntities[0],
 			entityNumbers.numSnapshotEntities );
 	}
 
@@ -818,6 +1255,45 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 }
 
 
+/*
+=============
+SV_BuildClientSnapshot
+=============
+*/
+static void SV_BuildClientSnapshot( snapshotContext_t *ctx, client_t *client ) {
+	// this is the frame we are creating
+	SV_BuildClientFrame( ctx, client, &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ] );
+}
+
+
+/*
+=============
+SV_BuildDemoFrame
+
+Same as client snapshot but into a frame that is never transmitted,
+must be called from the main thread
+=============
+*/
+void SV_BuildDemoFrame( client_t *client, clientSnapshot_t *frame ) {
+	SV_BuildClientFrame( &snapshotContexts[ 0 ], client, frame );
+}
+
+
+/*
+=============
+SV_GetCommonSnapshot
+
+Returns current common snapshot, builds it if no client did that yet
+=============
+*/
+const snapshotFrame_t *SV_GetCommonSnapshot( void ) {
+	if ( svs.currFrame == NULL ) {
+		SV_BuildCommonSnapshot();
+	}
+	return svs.currFrame;
+}
+
+
 /*
 =======================
 SV_SendMessageToClient
@@ -837,6 +1313,41 @@ void SV_SendMessageToClient( msg_t *msg, client_t *client )
 }
 
 
+// time spent transmitting snapshots in the current SV_SendClientMessages
+static int64_t snapshotSendTime;
+
+/*
+=======================
+SV_TransmitSnapshot
+
+Sends a snapshot or idle message and updates the net debugging and telemetry counters
+=======================
+*/
+static void SV_TransmitSnapshot( msg_t *msg, client_t *client, int numEntities )
+{
+	int64_t start;
+
+	SV_JournalSnapshot( client, msg );
+
+	if ( sv_telemetry->integer ) {
+		SV_TelemetryAdd( TM_CLIENT_ENTITIES, numEntities );
+	}
+
+	if ( SV_PaceSnapshot( client, msg ) ) {
+		// will be sent from the idle loop
+	} else if ( sv_telemetry->integer ) {
+		start = Sys_Microseconds();
+		SV_SendMessageToClient( msg, client );
+		snapshotSendTime += Sys_Microseconds() - start;
+	} else {
+		SV_SendMessageToClient( msg, client );
+	}
+
+	sv.bpsTotalBytes += msg->cursize;            // NERVE - SMF - net debugging
+	sv.ubpsTotalBytes += msg->uncompsize / 8;    // NERVE - SMF - net debugging
+}
+
+
 //bani
 /*
 =======================
@@ -863,7 +1374,7 @@ void SV_SendClientIdle( client_t *client ) {
 
 	// send over all the relevant entityState_t
 	// and the playerState_t
-//	SV_WriteSnapshotToClient( client, &msg );
+//	SV_WriteSnapshotToClient( client, oldframe, lastframe, &msg );
 
 	// check for overflow
 	if ( msg.overflowed ) {
@@ -874,10 +1385,7 @@ void SV_SendClientIdle( client_t *client ) {
 		return;
 	}
 
-	SV_SendMessageToClient( &msg, client );
-
-	sv.bpsTotalBytes += msg.cursize;            // NERVE - SMF - net debugging
-	sv.ubpsTotalBytes += msg.uncompsize / 8;    // NERVE - SMF - net debugging
+	SV_TransmitSnapshot( &msg, client, 0 );
 }
 
 /*
@@ -891,6 +1399,8 @@ Also called by SV_FinalCommand
 void SV_SendClientSnapshot( client_t *client ) {
 	byte		msg_buf[ MAX_MSGLEN_BUF ];
 	msg_t		msg;
+	const clientSnapshot_t *oldframe;
+	int			lastframe;
 
 	//bani
 	if ( client->state < CS_ACTIVE ) {
@@ -903,7 +1413,7 @@ void SV_SendClientSnapshot( client_t *client ) {
 	}
 
 	// build the snapshot
-	SV_BuildClientSnapshot( client );
+	SV_BuildClientSnapshot( &snapshotContexts[ 0 ], client );
 
 	// bots need to have their snapshots build, but
 	// the query them directly without needing to be sent
@@ -911,6 +1421,8 @@ void SV_SendClientSnapshot( client_t *client ) {
 		return;
 	}
 
+	oldframe = SV_GetDeltaFrame( client, &lastframe );
+
 	MSG_Init( &msg, msg_buf, MAX_MSGLEN );
 	msg.allowoverflow = qtrue;
 
@@ -923,7 +1435,7 @@ void SV_SendClientSnapshot( client_t *client ) {
 
 	// send over all the relevant entityState_t
 	// and the playerState_t
-	SV_WriteSnapshotToClient( client, &msg );
+	SV_WriteSnapshotToClient( SV_DeltaCache( &snapshotContexts[ 0 ] ), client, oldframe, lastframe, &msg );
 
 	// check for overflow
 	if ( msg.overflowed ) {
@@ -934,10 +1446,404 @@ void SV_SendClientSnapshot( client_t *client ) {
 		return;
 	}
 
-	SV_SendMessageToClient( &msg, client );
+	SV_TransmitSnapshot( &msg, client, client->frames[ client->netchan.outgoingSequence & PACKET_MASK ].num_entities );
+}
+
+
+/*
+=============================================================================
+
+Parallel client snapshots
+
+With sv_snapshotThreads > 1 visibility culling and delta encoding for all
+clients due this frame run on the worker pool, only transmit is serialized
+
+=============================================================================
+*/
+
+typedef struct {
+	client_t				*client;
+	const clientSnapshot_t	*oldframe;
+	int						lastframe;
+	byte					callbackDenied[ MAX_GENTITIES / 8 ];
+	msg_t					msg;
+	byte					msgBuf[ MAX_MSGLEN_BUF ];
+} snapshotJob_t;
+
+static snapshotJob_t *snapshotJobs;	// [MAX_CLIENTS]
+
+
+/*
+=======================
+SV_AllocSnapshotJobs
+=======================
+*/
+static void SV_AllocSnapshotJobs( void ) {
+	if ( snapshotJobs ) {
+		return;
+	}
+
+	// RF, avoid trying to allocate large chunk on a fragmented zone
+	snapshotJobs = calloc( MAX_CLIENTS, sizeof( snapshotJob_t ) );
+	if ( !snapshotJobs ) {
+		Com_Error( ERR_FATAL, "%s: unable to allocate snapshot jobs", __func__ );
+	}
+}
+
+
+/*
+=======================
+SV_ShutdownSnapshotWorkers
+=======================
+*/
+void SV_ShutdownSnapshotWorkers( void ) {
+	int		i;
+
+	Sys_ShutdownWorkers();
+
+	for ( i = 0; i < ARRAY_LEN( snapshotContexts ); i++ ) {
+		free( snapshotContexts[ i ].deltaCache );
+		snapshotContexts[ i ].deltaCache = NULL;
+	}
+
+	free( snapshotJobs );
+	snapshotJobs = NULL;
+}
+
+
+/*
+=======================
+SV_PrepareSnapshotJobs
+
+Everything that may print, raise errors or call into the game vm
+has to be done on the main thread before the jobs are started
+=======================
+*/
+static void SV_PrepareSnapshotJobs( int numJobs ) {
+	int				callbackEnts[ MAX_GENTITIES ];
+	int				numCallbackEnts;
+	snapshotJob_t	*job;
+	const sharedEntity_t *clientEnt;
+	int				clientNum;
+	int				i, n, num;
+
+	if ( svs.currFrame == NULL ) {
+		SV_BuildCommonSnapshot();
+	}
+
+	numCallbackEnts = 0;
+	for ( i = 0; i < svs.currFrame->count; i++ ) {
+		num = svs.currFrame->ents[ i ]->number;
+		if ( SV_GentityNum( num )->r.snapshotCallback ) {
+			callbackEnts[ numCallbackEnts++ ] = num;
+		}
+	}
+
+	for ( n = 0; n < numJobs; n++ ) {
+		job = &snapshotJobs[ n ];
+
+		Com_Memset( job->callbackDenied, 0, sizeof( job->callbackDenied ) );
+
+		if ( numCallbackEnts && job->client->gentity && job->client->state != CS_ZOMBIE ) {
+			clientNum = SV_GameClientNum( job->client - svs.clients )->clientNum;
+			if ( clientNum < 0 || clientNum >= MAX_GENTITIES ) {
+				Com_Error( ERR_DROP, "SV_SvEntityForGentity: bad gEnt" );
+			}
+			clientEnt = SV_GentityNum( clientNum );
+			for ( i = 0; i < numCallbackEnts; i++ ) {
+				num = callbackEnts[ i ];
+				if ( !SV_GameSnapshotCallback( num, clientEnt->s.number ) ) {
+					job->callbackDenied[ num >> 3 ] |= 1 << ( num & 7 );
+				}
+			}
+		}
+
+		job->oldframe = SV_GetDeltaFrame( job->client, &job->lastframe );
+	}
+}
+
+
+/*
+=======================
+SV_SnapshotJob
+
+Runs on worker threads
+=======================
+*/
+static void SV_SnapshotJob( void *data, int index, int worker ) {
+	snapshotJob_t		*job = (snapshotJob_t *)data + index;
+	snapshotContext_t	*ctx = &snapshotContexts[ worker ];
+	client_t			*client = job->client;
+
+	ctx->callbackDenied = job->callbackDenied;
+
+	SV_BuildClientSnapshot( ctx, client );
+
+	MSG_Init( &job->msg, job->msgBuf, MAX_MSGLEN );
+	job->msg.allowoverflow = qtrue;
+
+	// NOTE, MRE: all server->client messages now acknowledge
+	// let the client know which reliable clientCommands we have received
+	MSG_WriteLong( &job->msg, client->lastClientCommand );
+
+	// (re)send any reliable server commands
+	SV_UpdateServerCommandsToClient( client, &job->msg );
+
+	// send over all the relevant entityState_t
+	// and the playerState_t
+	SV_WriteSnapshotToClient( SV_DeltaCache( ctx ), client, job->oldframe, job->lastframe, &job->msg );
+
+	ctx->callbackDenied = NULL;
+}
+
+
+/*
+=======================
+SV_RunSnapshotJobs
+=======================
+*/
+static void SV_RunSnapshotJobs( int numJobs, int numWorkers ) {
+	char	error[ MAX_STRING_CHARS ];
+	int		i;
+
+	if ( numWorkers > 1 ) {
+		Sys_RunJobs( SV_SnapshotJob, snapshotJobs, numJobs );
+	} else {
+		for ( i = 0; i < numJobs; i++ ) {
+			SV_SnapshotJob( snapshotJobs, i, 0 );
+		}
+	}
+
+	for ( i = 0; i < ARRAY_LEN( snapshotContexts ); i++ ) {
+		if ( snapshotContexts[ i ].error[0] ) {
+			Q_strncpyz( error, snapshotContexts[ i ].error, sizeof( error ) );
+			snapshotContexts[ i ].error[0] = '\0';
+			Com_Error( ERR_DROP, "%s", error );
+		}
+	}
+}
+
+
+/*
+=======================
+SV_SendClientSnapshots
+
+Builds snapshots for all queued clients in parallel and transmits them
+=======================
+*/
+static void SV_SendClientSnapshots( int numJobs, int numWorkers ) {
+	snapshotJob_t	*job;
+	client_t		*client;
+	int				n;
+
+	SV_PrepareSnapshotJobs( numJobs );
+
+	SV_RunSnapshotJobs( numJobs, numWorkers );
+
+	for ( n = 0; n < numJobs; n++ ) {
+		job = &snapshotJobs[ n ];
+		client = job->client;
+
+		client->lastSnapshotTime = svs.time;
+		client->rateDelayed = qfalse;
+
+		// check for overflow
+		if ( job->msg.overflowed ) {
+			Com_Printf( "WARNING: msg overflowed for %s\n", client->name );
+			MSG_Clear( &job->msg );
+
+			SV_DropClient( client, "Msg overflowed" );
+			continue;
+		}
+
+		SV_TransmitSnapshot( &job->msg, client, client->frames[ client->netchan.outgoingSequence & PACKET_MASK ].num_entities );
+	}
+}
+
+
+/*
+=======================
+SV_SnapshotBench_f
+
+Builds and encodes snapshots for all active clients without sending
+them, first on the main thread and then on sv_snapshotThreads workers,
+verifies the delta entity cache against the plain encoder and measures the pvs culling of each client against the old per-entity checks
+=======================
+*/
+void SV_SnapshotBench_f( void ) {
+	int64_t		start, serialTime, parallelTime, visTime, refTime, plainTime;
+	int			frames, numJobs, numWorkers;
+	int			i, j, n, mismatches;
+	int			hits, lookups, bytes;
+	byte		*plain;
+	int			*plainSize;
+	client_t	*c;
+	const playerState_t *ps;
+	vec3_t		org;
+	int			leafnum;
+	int			clientareas[ MAX_CLIENTS ];
+	const byte	*clientpvs[ MAX_CLIENTS ];
+	unsigned int visible[ VIS_WORDS ], reference[ VIS_WORDS ];
+
+	if ( !com_sv_running->integer || sv.state != SS_GAME ) {
+		Com_Printf( "Server is not running.\n" );
+		return;
+	}
+
+	frames = 100;
+	if ( Cmd_Argc() > 1 ) {
+		frames = atoi( Cmd_Argv( 1 ) );
+		if ( frames < 1 ) {
+			frames = 1;
+		}
+	}
+
+	numWorkers = Sys_InitWorkers( sv_snapshotThreads->integer );
+	SV_AllocSnapshotJobs();
+
+	numJobs = 0;
+	for ( i = 0, c = svs.clients; i < sv_maxclients->integer; i++, c++ ) {
+		if ( c->state == CS_ACTIVE && c->gentity ) {
+			snapshotJobs[ numJobs++ ].client = c;
+		}
+	}
+
+	if ( !numJobs ) {
+		Com_Printf( "No active clients.\n" );
+		return;
+	}
+
+	// job results are never transmitted, only the current outgoing
+	// frame of each client is overwritten and will be rebuilt anyway
+	SV_PrepareSnapshotJobs( numJobs );
+
+	// each iteration invalidates the delta entity cache like a new frame would
+	start = Sys_Microseconds();
+	for ( i = 0; i < frames; i++ ) {
+		deltaCacheGeneration++;
+		SV_RunSnapshotJobs( numJobs, 1 );
+	}
+	serialTime = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	for ( i = 0; i < frames; i++ ) {
+		deltaCacheGeneration++;
+		SV_RunSnapshotJobs( numJobs, numWorkers );
+	}
+	parallelTime = Sys_Microseconds() - start;
+
+	Com_Printf( "%i clients, %i frames, %i entities\n", numJobs, frames, svs.currFrame->count );
+	Com_Printf( "1 thread: %.1f usec/frame\n", (double)serialTime / frames );
+	if ( numWorkers > 1 ) {
+		Com_Printf( "%i threads: %.1f usec/frame, %.2fx\n", numWorkers, (double)parallelTime / frames,
+			parallelTime ? (double)serialTime / parallelTime : 0.0 );
+	} else {
+		Com_Printf( "set sv_snapshotThreads > 1 to compare with the worker pool\n" );
+	}
+
+	// delta entity cache against the plain encoder, output must be identical
+	// RF, avoid trying to allocate large chunk on a fragmented zone
+	plain = calloc( numJobs, MAX_MSGLEN_BUF + sizeof( int ) );
+	if ( plain ) {
+		plainSize = (int *)( plain + numJobs * MAX_MSGLEN_BUF );
+
+		deltaCacheDisabled = qtrue;
+		start = Sys_Microseconds();
+		for ( i = 0; i < frames; i++ ) {
+			SV_RunSnapshotJobs( numJobs, 1 );
+		}
+		plainTime = Sys_Microseconds() - start;
+		deltaCacheDisabled = qfalse;
+
+		for ( j = 0; j < numJobs; j++ ) {
+			// the byte at cursize-1 may hold no bits at all and is not compared
+			plainSize[ j ] = snapshotJobs[ j ].msg.bit;
+			Com_Memcpy( plain + j * MAX_MSGLEN_BUF, snapshotJobs[ j ].msg.data, ( plainSize[ j ] + 7 ) >> 3 );
+		}
+
+		for ( i = 0; i < ARRAY_LEN( snapshotContexts ); i++ ) {
+			if ( snapshotContexts[ i ].deltaCache ) {
+				snapshotContexts[ i ].deltaCache->hits = 0;
+				snapshotContexts[ i ].deltaCache->lookups = 0;
+			}
+		}
+
+		deltaCacheGeneration++;
+		SV_RunSnapshotJobs( numJobs, numWorkers );
+
+		hits = lookups = 0;
+		for ( i = 0; i < ARRAY_LEN( snapshotContexts ); i++ ) {
+			if ( snapshotContexts[ i ].deltaCache ) {
+				hits += snapshotContexts[ i ].deltaCache->hits;
+				lookups += snapshotContexts[ i ].deltaCache->lookups;
+			}
+		}
+
+		mismatches = 0;
+		bytes = 0;
+		for ( j = 0; j < numJobs; j++ ) {
+			bytes += snapshotJobs[ j ].msg.cursize;
+			if ( snapshotJobs[ j ].msg.bit != plainSize[ j ]
+				|| memcmp( snapshotJobs[ j ].msg.data, plain + j * MAX_MSGLEN_BUF, ( plainSize[ j ] + 7 ) >> 3 ) ) {
+				mismatches++;
+			}
+		}
+
+		Com_Printf( "delta entity cache: %.1f%% hits (%i/%i), plain encoder %.1f usec/frame, %i bytes/frame\n",
+			lookups ? 100.0 * hits / lookups : 0.0, hits, lookups, (double)plainTime / frames, bytes );
+		if ( mismatches ) {
+			Com_Printf( S_COLOR_YELLOW "WARNING: cached encoding differs for %i clients\n", mismatches );
+		}
+
+		free( plain );
+	}
+
+	// pvs culling alone from each client's eye, against the per-entity reference
+	for ( j = 0; j < numJobs; j++ ) {
+		ps = SV_GameClientNum( snapshotJobs[ j ].client - svs.clients );
+		VectorCopy( ps->origin, org );
+		org[2] += ps->viewheight;
+		leafnum = CM_PointLeafnum( org );
+		clientareas[ j ] = CM_LeafArea( leafnum );
+		clientpvs[ j ] = CM_ClusterPVS( CM_LeafCluster( leafnum ) );
+	}
+
+	start = Sys_Microseconds();
+	for ( i = 0; i < frames; i++ ) {
+		for ( j = 0; j < numJobs; j++ ) {
+			ps = SV_GameClientNum( snapshotJobs[ j ].client - svs.clients );
+			SV_MarkVisibleEntities( ps->clientNum, clientareas[ j ], clientpvs[ j ], visible );
+		}
+	}
+	visTime = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	for ( i = 0; i < frames; i++ ) {
+		for ( j = 0; j < numJobs; j++ ) {
+			ps = SV_GameClientNum( snapshotJobs[ j ].client - svs.clients );
+			SV_MarkVisibleEntitiesReference( ps->clientNum, clientareas[ j ], clientpvs[ j ], reference );
+		}
+	}
+	refTime = Sys_Microseconds() - start;
+
+	mismatches = 0;
+	for ( j = 0; j < numJobs; j++ ) {
+		ps = SV_GameClientNum( snapshotJobs[ j ].client - svs.clients );
+		SV_MarkVisibleEntities( ps->clientNum, clientareas[ j ], clientpvs[ j ], visible );
+		SV_MarkVisibleEntitiesReference( ps->clientNum, clientareas[ j ], clientpvs[ j ], reference );
+		for ( n = 0; n < VIS_WORDS; n++ ) {
+			if ( visible[ n ] != reference[ n ] ) {
+				mismatches++;
+				break;
+			}
+		}
+	}
 
-	sv.bpsTotalBytes += msg.cursize;            // NERVE - SMF - net debugging
-	sv.ubpsTotalBytes += msg.uncompsize / 8;    // NERVE - SMF - net debugging
+	Com_Printf( "pvs culling: %.2f usec/client, per-entity reference %.2f usec/client\n",
+		(double)visTime / ( frames * numJobs ), (double)refTime / ( frames * numJobs ) );
+	if ( mismatches ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: visibility differs from reference for %i clients\n", mismatches );
+	}
 }
 
 
@@ -951,12 +1857,34 @@ void SV_SendClientMessages( void )
 	int		i;
 	client_t	*c;
 	int numclients = 0;         // NERVE - SMF - net debugging
+	int numJobs, numWorkers;
+	int64_t start = 0, flushStart;
 
 	svs.msgTime = Sys_Milliseconds();
 
+	if ( sv_telemetry->integer ) {
+		start = Sys_Microseconds();
+	}
+	snapshotSendTime = 0;
+
+	// send configstrings changed during the game frames
+	SV_FlushConfigstrings();
+
+	numJobs = 0;
+	numWorkers = Sys_InitWorkers( sv_snapshotThreads->integer );
+	if ( numWorkers > 1 ) {
+		SV_AllocSnapshotJobs();
+	}
+
 	sv.bpsTotalBytes = 0;       // NERVE - SMF - net debugging
 	sv.ubpsTotalBytes = 0;      // NERVE - SMF - net debugging
 
+	// collect datagrams and pass them to the kernel together
+	NET_BeginSendBatch();
+
+	// anything left from the previous frame goes out first
+	SV_BeginPacing();
+
 	// send a message to each connected client
 	for( i = 0; i < sv_maxclients->integer; i++ )
 	{
@@ -997,12 +1925,34 @@ void SV_SendClientMessages( void )
 
 		numclients++;		// NERVE - SMF - net debugging
 
+		// full snapshots are built in parallel and sent later
+		if ( numWorkers > 1 && ( c->state == CS_ACTIVE || c->state == CS_ZOMBIE ) && c->netchan.remoteAddress.type != NA_BOT ) {
+			snapshotJobs[ numJobs++ ].client = c;
+			continue;
+		}
+
 		// generate and send a new message
 		SV_SendClientSnapshot( c );
 		c->lastSnapshotTime = svs.time;
 		c->rateDelayed = qfalse;
 	}
 
+	if ( numJobs ) {
+		SV_SendClientSnapshots( numJobs, numWorkers );
+	}
+
+	if ( sv_telemetry->integer && start ) {
+		flushStart = Sys_Microseconds();
+		NET_EndSendBatch();
+		snapshotSendTime += Sys_Microseconds() - flushStart;
+
+		// everything but the transmit is snapshot building and encoding
+		SV_TelemetryAdd( TM_SEND_USEC, snapshotSendTime );
+		SV_TelemetryAdd( TM_SNAPSHOT_USEC, Sys_Microseconds() - start - snapshotSendTime );
+	} else {
+		NET_EndSendBatch();
+	}
+
 	// NERVE - SMF - net debugging
 	if ( sv_showAverageBPS->integer && numclients > 0 ) {
 		float ave = 0, uave = 0;
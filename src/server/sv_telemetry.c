@@ -0,0 +1,247 @@
+/*
+===========================================================================
+
+Wolfenstein: Enemy Territory GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Wolfenstein: Enemy Territory GPL Source Code (Wolf ET Source Code).
+
+Wolf ET Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Wolf ET Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Wolf ET Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Wolf: ET Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Wolf ET Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+// sv_telemetry.c -- per-frame server timings and counters kept in a ring
+// buffer, reported as percentiles in JSON by the "telemetry" command
+
+#include "server.h"
+
+// must be a power of two
+#define TELEMETRY_FRAMES	1024
+
+typedef struct {
+	int		time;
+	int		value[ TM_NUM_METRICS ];
+} telemetryFrame_t;
+
+// only the main thread records frames and the command also runs there,
+// so readers never see a slot that is being written
+static telemetryFrame_t	telemetryFrames[ TELEMETRY_FRAMES ];
+static unsigned int		telemetryHead;	// total number of recorded frames
+
+// values accumulated until the next recorded frame
+static int64_t			telemetryPending[ TM_NUM_METRICS ];
+
+// sums over every recorded frame since the last clear
+static int64_t			telemetryTotal[ TM_NUM_METRICS ];
+
+static const char *telemetryNames[ TM_NUM_METRICS ] = {
+	"packets_usec",
+	"game_usec",
+	"snapshot_usec",
+	"send_usec",
+	"download_usec",
+	"frame_usec",
+	"clients",
+	"active_clients",
+	"packets_in",
+	"bytes_in",
+	"packets_out",
+	"bytes_out",
+	"snapshot_entities",
+	"client_entities"
+};
+
+
+/*
+==================
+SV_TelemetryAdd
+==================
+*/
+void SV_TelemetryAdd( telemetryMetric_t metric, int64_t value ) {
+	if ( !sv_telemetry->integer ) {
+		return;
+	}
+
+	telemetryPending[ metric ] += value;
+}
+
+
+/*
+==================
+SV_TelemetryEndFrame
+
+Stores the values accumulated since the previous game frame
+==================
+*/
+void SV_TelemetryEndFrame( void ) {
+	telemetryFrame_t *frame;
+	const client_t *cl;
+	int i;
+
+	if ( !sv_telemetry->integer ) {
+		return;
+	}
+
+	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ ) {
+		if ( cl->state >= CS_CONNECTED ) {
+			telemetryPending[ TM_CLIENTS ]++;
+			if ( cl->state == CS_ACTIVE ) {
+				telemetryPending[ TM_ACTIVE_CLIENTS ]++;
+			}
+		}
+	}
+
+	if ( svs.currFrame ) {
+		telemetryPending[ TM_SNAPSHOT_ENTITIES ] = svs.currFrame->count;
+	}
+
+	frame = &telemetryFrames[ telemetryHead & ( TELEMETRY_FRAMES - 1 ) ];
+	frame->time = svs.time;
+	for ( i = 0; i < TM_NUM_METRICS; i++ ) {
+		telemetryTotal[ i ] += telemetryPending[ i ];
+		if ( telemetryPending[ i ] > INT_MAX ) {
+			frame->value[ i ] = INT_MAX;
+		} else {
+			frame->value[ i ] = (int)telemetryPending[ i ];
+		}
+	}
+	telemetryHead++;
+
+	Com_Memset( telemetryPending, 0, sizeof( telemetryPending ) );
+}
+
+
+/*
+==================
+SV_TelemetryTotal
+
+Sum of a metric over all frames recorded since the last clear
+==================
+*/
+int64_t SV_TelemetryTotal( telemetryMetric_t metric ) {
+	return telemetryTotal[ metric ];
+}
+
+
+/*
+==================
+SV_TelemetryClear
+==================
+*/
+void SV_TelemetryClear( void ) {
+	telemetryHead = 0;
+	Com_Memset( telemetryPending, 0, sizeof( telemetryPending ) );
+	Com_Memset( telemetryTotal, 0, sizeof( telemetryTotal ) );
+}
+
+
+static int QDECL SV_TelemetryCompare( const void *a, const void *b ) {
+	const int va = *(const int *)a;
+	const int vb = *(const int *)b;
+
+	return ( va > vb ) - ( va < vb );
+}
+
+
+/*
+==================
+SV_TelemetryPercentile
+
+Nearest-rank percentile of sorted values
+==================
+*/
+static int SV_TelemetryPercentile( const int *sorted, int count, int percent ) {
+	int rank;
+
+	rank = ( count * percent + 99 ) / 100;
+	if ( rank < 1 ) {
+		rank = 1;
+	}
+
+	return sorted[ rank - 1 ];
+}
+
+
+/*
+==================
+SV_Telemetry_f
+
+telemetry [frames|clear]
+
+Prints p50/p99/max/avg of every metric over the last recorded frames as a
+single JSON object, one line per metric so rcon redirection never splits one
+==================
+*/
+void SV_Telemetry_f( void ) {
+	static int values[ TELEMETRY_FRAMES ];
+	const telemetryFrame_t *frame;
+	unsigned int first;
+	int64_t sum;
+	int count, i, n;
+
+	if ( Cmd_Argc() > 1 && !Q_stricmp( Cmd_Argv( 1 ), "clear" ) ) {
+		SV_TelemetryClear();
+		return;
+	}
+
+	count = telemetryHead < TELEMETRY_FRAMES ? telemetryHead : TELEMETRY_FRAMES;
+	if ( Cmd_Argc() > 1 ) {
+		n = atoi( Cmd_Argv( 1 ) );
+		if ( n > 0 && n < count ) {
+			count = n;
+		}
+	}
+
+	first = telemetryHead - count;
+
+	Com_Printf( "{\n" );
+	Com_Printf( "  \"enabled\": %s,\n", sv_telemetry->integer ? "true" : "false" );
+	Com_Printf( "  \"frames\": %i,\n", count );
+	Com_Printf( "  \"sv_fps\": %i,\n", sv_fps->integer );
+	if ( count ) {
+		Com_Printf( "  \"first_time\": %i,\n", telemetryFrames[ first & ( TELEMETRY_FRAMES - 1 ) ].time );
+		Com_Printf( "  \"last_time\": %i,\n", telemetryFrames[ ( telemetryHead - 1 ) & ( TELEMETRY_FRAMES - 1 ) ].time );
+	}
+	Com_Printf( "  \"metrics\": {\n" );
+
+	for ( i = 0; i < TM_NUM_METRICS; i++ ) {
+		sum = 0;
+		for ( n = 0; n < count; n++ ) {
+			frame = &telemetryFrames[ ( first + n ) & ( TELEMETRY_FRAMES - 1 ) ];
+			values[ n ] = frame->value[ i ];
+			sum += frame->value[ i ];
+		}
+
+		if ( count ) {
+			qsort( values, count, sizeof( values[0] ), SV_TelemetryCompare );
+			Com_Printf( "    \"%s\": { \"p50\": %i, \"p99\": %i, \"max\": %i, \"avg\": %i }%s\n",
+				telemetryNames[ i ],
+				SV_TelemetryPercentile( values, count, 50 ),
+				SV_TelemetryPercentile( values, count, 99 ),
+				values[ count - 1 ], (int)( sum / count ),
+				i < TM_NUM_METRICS - 1 ? "," : "" );
+		} else {
+			Com_Printf( "    \"%s\": { \"p50\": 0, \"p99\": 0, \"max\": 0, \"avg\": 0 }%s\n",
+				telemetryNames[ i ], i < TM_NUM_METRICS - 1 ? "," : "" );
+		}
+	}
+
+	Com_Printf( "  }\n" );
+	Com_Printf( "}\n" );
+}
@@ -61,90 +61,203 @@ clipHandle_t SV_ClipHandleForEntity( const sharedEntity_t *ent ) {
 ENTITY CHECKING
 
 To avoid linearly searching through lists of entities during environment testing,
-the world is carved up with an evenly spaced, axially aligned bsp tree.  Entities
-are kept in chains either at the final leafs, or at the first node that splits
-them, which prevents having to deal with multiple fragments of a single entity.
+the world is covered by a loose octree.  Nodes are created as entities are linked
+and released when the last entity leaves them.  The bounds of each node are twice
+the size of its cell, so an entity is kept in a single node: the deepest one whose
+cell contains the center of the entity and is at least as large as the entity,
+which prevents having to deal with multiple fragments of a single entity.
 
 ===============================================================================
 */
 
 typedef struct worldSector_s {
-	int		axis;		// -1 = leaf node
-	float	dist;
-	struct worldSector_s	*children[2];
+	vec3_t	center;
+	float	size;		// half size of the cell, loose bounds are twice that
+	int		depth;
+	int		octant;		// index in parent
+	int		numEntities;
+	int		numChildren;
+	struct worldSector_s	*parent;
+	struct worldSector_s	*children[8];
 	svEntity_t	*entities;
 } worldSector_t;
 
-#define	AREA_DEPTH	4
-#define	AREA_NODES	64
+#define	AREA_DEPTH	8
+#define	AREA_NODES	4096
 
 static worldSector_t	sv_worldSectors[AREA_NODES];
+static worldSector_t	*sv_freeworldSectors;
 static int			sv_numworldSectors;
 
 
 /*
 ===============
 SV_SectorList_f
+
+Prints occupancy of the world sectors at each depth
 ===============
 */
 void SV_SectorList_f( void ) {
-	int				i, c;
-	worldSector_t	*sec;
-	svEntity_t		*ent;
-
+	int				nodes[AREA_DEPTH+1];
+	int				entities[AREA_DEPTH+1];
+	int				maxEntities[AREA_DEPTH+1];
+	int				i, total, deepest;
+	const worldSector_t	*sec, *busiest;
+
+	Com_Memset( nodes, 0, sizeof( nodes ) );
+	Com_Memset( entities, 0, sizeof( entities ) );
+	Com_Memset( maxEntities, 0, sizeof( maxEntities ) );
+
+	total = 0;
+	deepest = 0;
+	busiest = sv_worldSectors;
 	for ( i = 0 ; i < AREA_NODES ; i++ ) {
 		sec = &sv_worldSectors[i];
-
-		c = 0;
-		for ( ent = sec->entities ; ent ; ent = ent->nextEntityInWorldSector ) {
-			c++;
+		if ( sec != sv_worldSectors && !sec->parent ) {
+			continue;	// free
+		}
+		nodes[sec->depth]++;
+		entities[sec->depth] += sec->numEntities;
+		if ( sec->numEntities > maxEntities[sec->depth] ) {
+			maxEntities[sec->depth] = sec->numEntities;
+		}
+		if ( sec->numEntities > busiest->numEntities ) {
+			busiest = sec;
 		}
-		Com_Printf( "sector %i: %i entities\n", i, c );
+		if ( sec->depth > deepest ) {
+			deepest = sec->depth;
+		}
+		total += sec->numEntities;
+	}
+
+	Com_Printf( "depth  size  nodes  entities  max\n" );
+	for ( i = 0 ; i <= deepest ; i++ ) {
+		Com_Printf( "%5i %5i %6i %9i %4i\n", i, (int)( sv_worldSectors[0].size / (1 << i) ),
+			nodes[i], entities[i], maxEntities[i] );
 	}
+	Com_Printf( "%i entities in %i/%i sectors, %.1f per sector, busiest: %i at depth %i (%i %i %i)\n",
+		total, sv_numworldSectors, AREA_NODES, total ? (float)total / sv_numworldSectors : 0.0f,
+		busiest->numEntities, busiest->depth,
+		(int)busiest->center[0], (int)busiest->center[1], (int)busiest->center[2] );
 }
 
+
 /*
 ===============
-SV_CreateworldSector
+SV_AllocworldSector
 
-Builds a uniformly subdivided tree for the given world size
+Creates child node of the given octant, NULL if all nodes are in use
 ===============
 */
-static worldSector_t *SV_CreateworldSector( int depth, vec3_t mins, vec3_t maxs ) {
+static worldSector_t *SV_AllocworldSector( worldSector_t *parent, int octant ) {
 	worldSector_t	*anode;
-	vec3_t		size;
-	vec3_t		mins1, maxs1, mins2, maxs2;
+	int				i;
 
-	anode = &sv_worldSectors[sv_numworldSectors];
+	anode = sv_freeworldSectors;
+	if ( !anode ) {
+		return NULL;
+	}
+	sv_freeworldSectors = anode->children[0];
 	sv_numworldSectors++;
 
-	if (depth == AREA_DEPTH) {
-		anode->axis = -1;
-		anode->children[0] = anode->children[1] = NULL;
-		return anode;
+	Com_Memset( anode, 0, sizeof( *anode ) );
+	anode->size = parent->size * 0.5f;
+	for ( i = 0 ; i < 3 ; i++ ) {
+		if ( octant & ( 1 << i ) ) {
+			anode->center[i] = parent->center[i] + anode->size;
+		} else {
+			anode->center[i] = parent->center[i] - anode->size;
+		}
 	}
+	anode->depth = parent->depth + 1;
+	anode->octant = octant;
+	anode->parent = parent;
 
-	VectorSubtract (maxs, mins, size);
-	if (size[0] > size[1]) {
-		anode->axis = 0;
-	} else {
-		anode->axis = 1;
+	parent->children[octant] = anode;
+	parent->numChildren++;
+
+	return anode;
+}
+
+
+/*
+===============
+SV_FreeworldSectors
+
+Releases the node and its ancestors that became empty
+===============
+*/
+static void SV_FreeworldSectors( worldSector_t *node ) {
+	worldSector_t	*parent;
+
+	while ( node->parent && !node->numEntities && !node->numChildren ) {
+		parent = node->parent;
+		parent->children[node->octant] = NULL;
+		parent->numChildren--;
+
+		node->parent = NULL;
+		node->children[0] = sv_freeworldSectors;
+		sv_freeworldSectors = node;
+		sv_numworldSectors--;
+
+		node = parent;
 	}
+}
 
-	anode->dist = 0.5 * (maxs[anode->axis] + mins[anode->axis]);
-	VectorCopy (mins, mins1);
-	VectorCopy (mins, mins2);
-	VectorCopy (maxs, maxs1);
-	VectorCopy (maxs, maxs2);
 
-	maxs1[anode->axis] = mins2[anode->axis] = anode->dist;
+/*
+===============
+SV_WorldSectorForBounds
+
+Finds the deepest node which loose bounds fully contain the box
+===============
+*/
+static worldSector_t *SV_WorldSectorForBounds( const vec3_t absmin, const vec3_t absmax ) {
+	worldSector_t	*node, *child;
+	vec3_t			center;
+	float			radius, r;
+	int				i, octant;
+
+	radius = 0.0f;
+	for ( i = 0 ; i < 3 ; i++ ) {
+		center[i] = 0.5f * ( absmin[i] + absmax[i] );
+		r = 0.5f * ( absmax[i] - absmin[i] );
+		if ( r > radius ) {
+			radius = r;
+		}
+	}
 
-	anode->children[0] = SV_CreateworldSector (depth+1, mins2, maxs2);
-	anode->children[1] = SV_CreateworldSector (depth+1, mins1, maxs1);
+	node = sv_worldSectors;
 
-	return anode;
+	// anything outside of the world stays at the root
+	for ( i = 0 ; i < 3 ; i++ ) {
+		if ( fabs( center[i] - node->center[i] ) > node->size ) {
+			return node;
+		}
+	}
+
+	// descend while the entity fits into the cell of a child
+	while ( node->depth < AREA_DEPTH && radius <= node->size * 0.5f ) {
+		octant = 0;
+		for ( i = 0 ; i < 3 ; i++ ) {
+			if ( center[i] >= node->center[i] ) {
+				octant |= 1 << i;
+			}
+		}
+		child = node->children[octant];
+		if ( !child ) {
+			child = SV_AllocworldSector( node, octant );
+			if ( !child ) {
+				break;	// out of nodes, parent bounds contain the entity as well
+			}
+		}
+		node = child;
+	}
+
+	return node;
 }
 
+
 /*
 ===============
 SV_ClearWorld
@@ -154,14 +267,32 @@ SV_ClearWorld
 void SV_ClearWorld( void ) {
 	clipHandle_t	h;
 	vec3_t			mins, maxs;
+	worldSector_t	*root;
+	int				i;
 
 	Com_Memset( sv_worldSectors, 0, sizeof(sv_worldSectors) );
-	sv_numworldSectors = 0;
+
+	// all but the root are free
+	sv_freeworldSectors = NULL;
+	for ( i = AREA_NODES - 1 ; i > 0 ; i-- ) {
+		sv_worldSectors[i].children[0] = sv_freeworldSectors;
+		sv_freeworldSectors = &sv_worldSectors[i];
+	}
+	sv_numworldSectors = 1;
 
 	// get world map bounds
 	h = CM_InlineModel( 0 );
 	CM_ModelBounds( h, mins, maxs );
-	SV_CreateworldSector( 0, mins, maxs );
+
+	// root cell is a cube around the world
+	root = sv_worldSectors;
+	root->size = 1.0f;
+	for ( i = 0 ; i < 3 ; i++ ) {
+		root->center[i] = 0.5f * ( mins[i] + maxs[i] );
+		if ( 0.5f * ( maxs[i] - mins[i] ) + 1.0f > root->size ) {
+			root->size = 0.5f * ( maxs[i] - mins[i] ) + 1.0f;
+		}
+	}
 }
 
 
@@ -188,12 +319,16 @@ void SV_UnlinkEntity( sharedEntity_t *gEnt ) {
 
 	if ( ws->entities == ent ) {
 		ws->entities = ent->nextEntityInWorldSector;
+		ws->numEntities--;
+		SV_FreeworldSectors( ws );
 		return;
 	}
 
 	for ( scan = ws->entities ; scan ; scan = scan->nextEntityInWorldSector ) {
 		if ( scan->nextEntityInWorldSector == ent ) {
 			scan->nextEntityInWorldSector = ent->nextEntityInWorldSector;
+			ws->numEntities--;
+			SV_FreeworldSectors( ws );
 			return;
 		}
 	}
@@ -347,24 +482,14 @@ void SV_LinkEntity( sharedEntity_t *gEnt ) {
 
 	gEnt->r.linkcount++;
 
-	// find the first world sector node that the ent's box crosses
-	node = sv_worldSectors;
-	while (1)
-	{
-		if (node->axis == -1)
-			break;
-		if ( gEnt->r.absmin[node->axis] > node->dist)
-			node = node->children[0];
-		else if ( gEnt->r.absmax[node->axis] < node->dist)
-			node = node->children[1];
-		else
-			break;		// crosses the node
-	}
-	
+	// find the smallest world sector node that holds the ent's box
+	node = SV_WorldSectorForBounds( gEnt->r.absmin, gEnt->r.absmax );
+
 	// link it in
 	ent->worldSector = node;
 	ent->nextEntityInWorldSector = node->entities;
 	node->entities = ent;
+	node->numEntities++;
 
 	gEnt->r.linked = qtrue;
 }
@@ -393,9 +518,12 @@ SV_AreaEntities_r
 
 ====================
 */
-static void SV_AreaEntities_r( worldSector_t *node, areaParms_t *ap ) {
+static void SV_AreaEntities_r( const worldSector_t *node, areaParms_t *ap ) {
+	const worldSector_t *child;
 	svEntity_t	*check, *next;
 	sharedEntity_t *gcheck;
+	float		d;
+	int			i;
 
 	for ( check = node->entities  ; check ; check = next ) {
 		next = check->nextEntityInWorldSector;
@@ -424,16 +552,26 @@ static void SV_AreaEntities_r( worldSector_t *node, areaParms_t *ap ) {
 		ap->count++;
 	}
 
-	if (node->axis == -1) {
+	if ( !node->numChildren ) {
 		return;		// terminal node
 	}
 
-	// recurse down both sides
-	if ( ap->maxs[node->axis] > node->dist ) {
-		SV_AreaEntities_r ( node->children[0], ap );
-	}
-	if ( ap->mins[node->axis] < node->dist ) {
-		SV_AreaEntities_r ( node->children[1], ap );
+	// recurse into children which loose bounds touch the box
+	for ( i = 0 ; i < 8 ; i++ ) {
+		child = node->children[i];
+		if ( !child ) {
+			continue;
+		}
+		d = child->size * 2.0f;
+		if ( ap->mins[0] > child->center[0] + d
+		|| ap->mins[1] > child->center[1] + d
+		|| ap->mins[2] > child->center[2] + d
+		|| ap->maxs[0] < child->center[0] - d
+		|| ap->maxs[1] < child->center[1] - d
+		|| ap->maxs[2] < child->center[2] - d ) {
+			continue;
+		}
+		SV_AreaEntities_r( child, ap );
 	}
 }
 
@@ -742,3 +880,491 @@ int SV_PointContents( const vec3_t p, int passEntityNum ) {
 }
 
 
+/*
+============================================================================
+
+SECTOR BENCHMARK
+
+Area queries against the linked entities, compared with
+the uniform tree of AREA_DEPTH 4 that was used before
+============================================================================
+*/
+
+#define LEGACY_DEPTH	4
+#define LEGACY_NODES	64
+
+typedef struct {
+	int		axis;		// -1 = leaf node
+	float	dist;
+	int		children[2];
+	int		entities;	// first entity, -1 terminated
+} legacySector_t;
+
+typedef struct {
+	legacySector_t	nodes[LEGACY_NODES];
+	int				numNodes;
+	int				next[MAX_GENTITIES];
+} legacyWorld_t;
+
+
+/*
+===============
+SV_LegacyCreateSector
+===============
+*/
+static int SV_LegacyCreateSector( legacyWorld_t *w, int depth, vec3_t mins, vec3_t maxs ) {
+	legacySector_t	*anode;
+	vec3_t		size;
+	vec3_t		mins1, maxs1, mins2, maxs2;
+	int			n;
+
+	n = w->numNodes++;
+	anode = &w->nodes[n];
+	anode->entities = -1;
+
+	if ( depth == LEGACY_DEPTH ) {
+		anode->axis = -1;
+		return n;
+	}
+
+	VectorSubtract( maxs, mins, size );
+	anode->axis = ( size[0] > size[1] ) ? 0 : 1;
+	anode->dist = 0.5 * ( maxs[anode->axis] + mins[anode->axis] );
+
+	VectorCopy( mins, mins1 );
+	VectorCopy( mins, mins2 );
+	VectorCopy( maxs, maxs1 );
+	VectorCopy( maxs, maxs2 );
+	maxs1[anode->axis] = mins2[anode->axis] = anode->dist;
+
+	anode->children[0] = SV_LegacyCreateSector( w, depth + 1, mins2, maxs2 );
+	anode->children[1] = SV_LegacyCreateSector( w, depth + 1, mins1, maxs1 );
+
+	return n;
+}
+
+
+/*
+===============
+SV_LegacyAreaEntities_r
+===============
+*/
+static void SV_LegacyAreaEntities_r( const legacyWorld_t *w, int n, areaParms_t *ap ) {
+	const legacySector_t *node;
+	const sharedEntity_t *gcheck;
+	int			e;
+
+	node = &w->nodes[n];
+
+	for ( e = node->entities ; e != -1 ; e = w->next[e] ) {
+		gcheck = SV_GentityNum( e );
+		if ( !gcheck->r.linked ) {
+			continue;
+		}
+		if ( gcheck->r.absmin[0] > ap->maxs[0]
+		|| gcheck->r.absmin[1] > ap->maxs[1]
+		|| gcheck->r.absmin[2] > ap->maxs[2]
+		|| gcheck->r.absmax[0] < ap->mins[0]
+		|| gcheck->r.absmax[1] < ap->mins[1]
+		|| gcheck->r.absmax[2] < ap->mins[2] ) {
+			continue;
+		}
+		if ( ap->count == ap->maxcount ) {
+			return;
+		}
+		ap->list[ap->count++] = e;
+	}
+
+	if ( node->axis == -1 ) {
+		return;
+	}
+
+	if ( ap->maxs[node->axis] > node->dist ) {
+		SV_LegacyAreaEntities_r( w, node->children[0], ap );
+	}
+	if ( ap->mins[node->axis] < node->dist ) {
+		SV_LegacyAreaEntities_r( w, node->children[1], ap );
+	}
+}
+
+
+/*
+===============
+SV_LinkBenchEntities
+
+Links player sized boxes at random spots of the world into the free
+entity slots above sv.num_entities, saving what was in the slots
+===============
+*/
+static int SV_LinkBenchEntities( int count, const vec3_t mins, const vec3_t maxs, sharedEntity_t *savedEnts, svEntity_t *savedSvEnts ) {
+	sharedEntity_t	*gEnt;
+	int			i, j, n;
+
+	if ( count > ENTITYNUM_MAX_NORMAL - sv.num_entities ) {
+		count = ENTITYNUM_MAX_NORMAL - sv.num_entities;
+	}
+
+	for ( i = 0 ; i < count ; i++ ) {
+		n = sv.num_entities + i;
+		gEnt = SV_GentityNum( n );
+		savedEnts[i] = *gEnt;
+		savedSvEnts[i] = sv.svEntities[n];
+
+		Com_Memset( gEnt, 0, sizeof( *gEnt ) );
+		gEnt->s.number = n;
+		gEnt->r.contents = CONTENTS_BODY;
+		VectorSet( gEnt->r.mins, -15, -15, -24 );
+		VectorSet( gEnt->r.maxs, 15, 15, 32 );
+		for ( j = 0 ; j < 3 ; j++ ) {
+			gEnt->r.currentOrigin[j] = mins[j] + random() * ( maxs[j] - mins[j] );
+		}
+		SV_LinkEntity( gEnt );
+	}
+
+	return count;
+}
+
+
+/*
+===============
+SV_UnlinkBenchEntities
+===============
+*/
+static void SV_UnlinkBenchEntities( int count, const sharedEntity_t *savedEnts, const svEntity_t *savedSvEnts ) {
+	sharedEntity_t	*gEnt;
+	int			i, n;
+
+	for ( i = 0 ; i < count ; i++ ) {
+		n = sv.num_entities + i;
+		gEnt = SV_GentityNum( n );
+		SV_UnlinkEntity( gEnt );
+		*gEnt = savedEnts[i];
+		sv.svEntities[n] = savedSvEnts[i];
+	}
+}
+
+
+/*
+===============
+SV_SectorBench_f
+
+sectorbench [queries] [synthetic entities]
+
+Synthetic entities are linked over the world bounds for the run and
+unlinked afterwards, to see how both trees scale beyond what the map
+spawned
+===============
+*/
+void SV_SectorBench_f( void ) {
+	legacyWorld_t	*legacy;
+	legacySector_t	*node;
+	const sharedEntity_t *gEnt;
+	int			list[MAX_GENTITIES];
+	int			linked[MAX_GENTITIES];
+	vec3_t		mins, maxs, center, size;
+	vec3_t		*qmins, *qmaxs;
+	int64_t		start, octreeTime, legacyTime;
+	int64_t		octreeHits, legacyHits;
+	areaParms_t	ap;
+	sharedEntity_t	*savedEnts;
+	svEntity_t	*savedSvEnts;
+	int			numLinked, numQueries, numSynthetic;
+	int			i, j, n;
+
+	if ( sv.state != SS_GAME ) {
+		Com_Printf( "Server is not running.\n" );
+		return;
+	}
+
+	numQueries = 100000;
+	if ( Cmd_Argc() > 1 ) {
+		numQueries = atoi( Cmd_Argv( 1 ) );
+		if ( numQueries < 1 ) {
+			numQueries = 1;
+		}
+	}
+
+	CM_ModelBounds( CM_InlineModel( 0 ), mins, maxs );
+
+	numSynthetic = 0;
+	savedEnts = NULL;
+	savedSvEnts = NULL;
+	if ( Cmd_Argc() > 2 && atoi( Cmd_Argv( 2 ) ) > 0 ) {
+		numSynthetic = atoi( Cmd_Argv( 2 ) );
+		if ( numSynthetic > MAX_GENTITIES ) {
+			numSynthetic = MAX_GENTITIES;
+		}
+		savedEnts = malloc( numSynthetic * sizeof( *savedEnts ) );
+		savedSvEnts = malloc( numSynthetic * sizeof( *savedSvEnts ) );
+		if ( !savedEnts || !savedSvEnts ) {
+			Com_Printf( "Couldn't allocate sector benchmark.\n" );
+			free( savedEnts );
+			free( savedSvEnts );
+			return;
+		}
+		numSynthetic = SV_LinkBenchEntities( numSynthetic, mins, maxs, savedEnts, savedSvEnts );
+	}
+
+	numLinked = 0;
+	for ( i = 0 ; i < sv.num_entities + numSynthetic ; i++ ) {
+		if ( sv.svEntities[i].worldSector ) {
+			linked[numLinked++] = i;
+		}
+	}
+	if ( !numLinked ) {
+		Com_Printf( "No linked entities.\n" );
+		SV_UnlinkBenchEntities( numSynthetic, savedEnts, savedSvEnts );
+		free( savedEnts );
+		free( savedSvEnts );
+		return;
+	}
+
+	// RF, avoid trying to allocate large chunk on a fragmented zone
+	legacy = calloc( 1, sizeof( *legacy ) );
+	qmins = calloc( numQueries, sizeof( vec3_t ) );
+	qmaxs = calloc( numQueries, sizeof( vec3_t ) );
+	if ( !legacy || !qmins || !qmaxs ) {
+		Com_Printf( "Couldn't allocate sector benchmark.\n" );
+		SV_UnlinkBenchEntities( numSynthetic, savedEnts, savedSvEnts );
+		free( savedEnts );
+		free( savedSvEnts );
+		free( legacy );
+		free( qmins );
+		free( qmaxs );
+		return;
+	}
+
+	SV_LegacyCreateSector( legacy, 0, mins, maxs );
+
+	for ( j = 0 ; j < numLinked ; j++ ) {
+		n = linked[j];
+		gEnt = SV_GentityNum( n );
+		node = legacy->nodes;
+		while ( node->axis != -1 ) {
+			if ( gEnt->r.absmin[node->axis] > node->dist ) {
+				node = &legacy->nodes[node->children[0]];
+			} else if ( gEnt->r.absmax[node->axis] < node->dist ) {
+				node = &legacy->nodes[node->children[1]];
+			} else {
+				break;
+			}
+		}
+		legacy->next[n] = node->entities;
+		node->entities = n;
+	}
+
+	// trace sized boxes, half of them around entities and half anywhere in the world
+	VectorSubtract( maxs, mins, size );
+	for ( i = 0 ; i < numQueries ; i++ ) {
+		if ( i & 1 ) {
+			gEnt = SV_GentityNum( linked[ rand() % numLinked ] );
+			VectorAdd( gEnt->r.absmin, gEnt->r.absmax, center );
+			VectorScale( center, 0.5f, center );
+		} else {
+			for ( j = 0 ; j < 3 ; j++ ) {
+				center[j] = mins[j] + random() * size[j];
+			}
+		}
+		for ( j = 0 ; j < 3 ; j++ ) {
+			qmins[i][j] = center[j] - 16.0f - random() * 256.0f;
+			qmaxs[i][j] = center[j] + 16.0f + random() * 256.0f;
+		}
+	}
+
+	ap.list = list;
+	ap.maxcount = MAX_GENTITIES;
+
+	octreeHits = 0;
+	start = Sys_Microseconds();
+	for ( i = 0 ; i < numQueries ; i++ ) {
+		octreeHits += SV_AreaEntities( qmins[i], qmaxs[i], list, MAX_GENTITIES );
+	}
+	octreeTime = Sys_Microseconds() - start;
+
+	legacyHits = 0;
+	start = Sys_Microseconds();
+	for ( i = 0 ; i < numQueries ; i++ ) {
+		ap.mins = qmins[i];
+		ap.maxs = qmaxs[i];
+		ap.count = 0;
+		SV_LegacyAreaEntities_r( legacy, 0, &ap );
+		legacyHits += ap.count;
+	}
+	legacyTime = Sys_Microseconds() - start;
+
+	Com_Printf( "%i linked entities (%i synthetic), %i queries, %.1f entities per query\n", numLinked, numSynthetic,
+		numQueries, (double)octreeHits / numQueries );
+	Com_Printf( "octree: %.3f usec/query, %i sectors\n", (double)octreeTime / numQueries, sv_numworldSectors );
+	Com_Printf( "uniform tree: %.3f usec/query, %.2fx\n", (double)legacyTime / numQueries,
+		octreeTime ? (double)legacyTime / octreeTime : 0.0 );
+	if ( octreeHits != legacyHits ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: results differ, %lli != %lli\n", (long long)octreeHits, (long long)legacyHits );
+	}
+
+	SV_UnlinkBenchEntities( numSynthetic, savedEnts, savedSvEnts );
+	free( savedEnts );
+	free( savedSvEnts );
+	free( legacy );
+	free( qmins );
+	free( qmaxs );
+}
+
+
+/*
+===============
+SV_TracesDiffer
+===============
+*/
+static qboolean SV_TracesDiffer( const trace_t *a, const trace_t *b ) {
+	return a->fraction != b->fraction || a->allsolid != b->allsolid || a->startsolid != b->startsolid
+		|| !VectorCompare( a->endpos, b->endpos ) || !VectorCompare( a->plane.normal, b->plane.normal )
+		|| a->plane.dist != b->plane.dist || a->contents != b->contents || a->surfaceFlags != b->surfaceFlags;
+}
+
+
+/*
+===============
+SV_TraceBench_f
+
+tracebench [traces] [capsule]
+
+Times world traces done one by one against the same traces done by
+CM_BoxTraceBatch and with cm_packedBrushes off, and checks that all of
+them give the same results
+===============
+*/
+void SV_TraceBench_f( void ) {
+	const sharedEntity_t *gEnt;
+	cmRay_t		*rays;
+	trace_t		*traces, *scalar;
+	vec3_t		mins, maxs, size;
+	int64_t		start, time, serialTime, batchTime, scalarTime;
+	int			numTraces, numHits, batchDiffer, scalarDiffer;
+	int			i, j, seed, round;
+	qboolean	capsule;
+	char		packed[ MAX_CVAR_VALUE_STRING ];
+
+	if ( sv.state != SS_GAME ) {
+		Com_Printf( "Server is not running.\n" );
+		return;
+	}
+
+	numTraces = 20000;
+	if ( Cmd_Argc() > 1 ) {
+		numTraces = atoi( Cmd_Argv( 1 ) );
+		if ( numTraces < 1 ) {
+			numTraces = 1;
+		}
+	}
+	capsule = ( Cmd_Argc() > 2 && !Q_stricmp( Cmd_Argv( 2 ), "capsule" ) );
+
+	rays = calloc( numTraces, sizeof( *rays ) );
+	traces = calloc( numTraces, sizeof( *traces ) );
+	scalar = calloc( numTraces, sizeof( *scalar ) );
+	if ( !rays || !traces || !scalar ) {
+		Com_Printf( "Couldn't allocate trace benchmark.\n" );
+		free( rays );
+		free( traces );
+		free( scalar );
+		return;
+	}
+
+	// the same rays every time for comparable runs, half of them start at
+	// entities, which are mostly in the open, point traces and player sized
+	// boxes alternating
+	seed = 0x5eed;
+	CM_ModelBounds( CM_InlineModel( 0 ), mins, maxs );
+	VectorSubtract( maxs, mins, size );
+	for ( i = 0 ; i < numTraces ; i++ ) {
+		gEnt = SV_GentityNum( Q_rand( &seed ) % sv.num_entities );
+		VectorAdd( gEnt->r.absmin, gEnt->r.absmax, rays[i].start );
+		VectorScale( rays[i].start, 0.5f, rays[i].start );
+		for ( j = 0 ; j < 3 ; j++ ) {
+			// also catches the nan center of entities with infinite bounds
+			if ( !( rays[i].start[j] >= mins[j] && rays[i].start[j] <= maxs[j] ) ) {
+				break;
+			}
+		}
+		if ( !( i & 2 ) || !gEnt->r.linked || j != 3 ) {
+			for ( j = 0 ; j < 3 ; j++ ) {
+				rays[i].start[j] = mins[j] + Q_random( &seed ) * size[j];
+			}
+		}
+		for ( j = 0 ; j < 3 ; j++ ) {
+			rays[i].end[j] = rays[i].start[j] + Q_crandom( &seed ) * 2048.0f;
+		}
+		if ( i & 1 ) {
+			VectorSet( rays[i].mins, -18, -18, -24 );
+			VectorSet( rays[i].maxs, 18, 18, 48 );
+			rays[i].brushmask = MASK_PLAYERSOLID;
+		} else {
+			rays[i].brushmask = MASK_SHOT;
+		}
+	}
+
+	// best of a few rounds, the first one only warms up the caches
+	Cvar_VariableStringBuffer( "cm_packedBrushes", packed, sizeof( packed ) );
+	serialTime = batchTime = scalarTime = 0;
+	for ( round = 0 ; round < 3 ; round++ ) {
+		Cvar_Set( "cm_packedBrushes", packed );
+
+		start = Sys_Microseconds();
+		for ( i = 0 ; i < numTraces ; i++ ) {
+			CM_BoxTrace( &traces[i], rays[i].start, rays[i].end, rays[i].mins, rays[i].maxs, 0, rays[i].brushmask, capsule );
+		}
+		time = Sys_Microseconds() - start;
+		if ( !round || time < serialTime ) {
+			serialTime = time;
+		}
+
+		start = Sys_Microseconds();
+		CM_BoxTraceBatch( rays, numTraces, 0, capsule );
+		time = Sys_Microseconds() - start;
+		if ( !round || time < batchTime ) {
+			batchTime = time;
+		}
+
+		Cvar_Set( "cm_packedBrushes", "0" );
+
+		start = Sys_Microseconds();
+		for ( i = 0 ; i < numTraces ; i++ ) {
+			CM_BoxTrace( &scalar[i], rays[i].start, rays[i].end, rays[i].mins, rays[i].maxs, 0, rays[i].brushmask, capsule );
+		}
+		time = Sys_Microseconds() - start;
+		if ( !round || time < scalarTime ) {
+			scalarTime = time;
+		}
+	}
+	Cvar_Set( "cm_packedBrushes", packed );
+
+	numHits = batchDiffer = scalarDiffer = 0;
+	for ( i = 0 ; i < numTraces ; i++ ) {
+		if ( traces[i].fraction < 1.0f ) {
+			numHits++;
+		}
+		if ( SV_TracesDiffer( &rays[i].trace, &traces[i] ) ) {
+			batchDiffer++;
+		}
+		if ( SV_TracesDiffer( &scalar[i], &traces[i] ) ) {
+			scalarDiffer++;
+		}
+	}
+
+	Com_Printf( "%i %s traces, %i hit, %i threads\n", numTraces, capsule ? "capsule" : "box", numHits,
+		sv_snapshotThreads->integer );
+	Com_Printf( "serial: %.3f usec/trace\n", (double)serialTime / numTraces );
+	Com_Printf( "batch: %.3f usec/trace, %.2fx\n", (double)batchTime / numTraces,
+		batchTime ? (double)serialTime / batchTime : 0.0 );
+	Com_Printf( "cm_packedBrushes 0: %.3f usec/trace, %.2fx\n", (double)scalarTime / numTraces,
+		serialTime ? (double)scalarTime / serialTime : 0.0 );
+	if ( batchDiffer ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: %i batch results differ\n", batchDiffer );
+	}
+	if ( scalarDiffer ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: %i cm_packedBrushes 0 results differ\n", scalarDiffer );
+	}
+
+	free( rays );
+	free( traces );
+	free( scalar );
+}
@@ -0,0 +1,295 @@
+/*
+===========================================================================
+
+Wolfenstein: Enemy Territory GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Wolfenstein: Enemy Territory GPL Source Code (Wolf ET Source Code).  
+
+Wolf ET Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Wolf ET Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Wolf ET Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Wolf: ET Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Wolf ET Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+// huffbench.c -- standalone throughput and wire compatibility check of the
+// static huffman codec used by the non-oob msg_t path
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../qcommon/q_shared.h"
+#include "../qcommon/qcommon.h"
+
+#define BENCH_FIELDS	(1<<20)
+#define BENCH_BUFSIZE	(BENCH_FIELDS*6+8)
+
+static int		fieldBits[ BENCH_FIELDS ];
+static uint32_t	fieldValues[ BENCH_FIELDS ];
+static uint32_t	decoded[ BENCH_FIELDS ];
+
+
+/*
+=================
+Bench_Rand
+
+xorshift32, reproducible across platforms
+=================
+*/
+static uint32_t benchSeed = 0x1234567;
+
+static uint32_t Bench_Rand( void )
+{
+	benchSeed ^= benchSeed << 13;
+	benchSeed ^= benchSeed >> 17;
+	benchSeed ^= benchSeed << 5;
+	return benchSeed;
+}
+
+
+/*
+=================
+Bench_Seconds
+=================
+*/
+static double Bench_Seconds( void )
+{
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+
+/*
+=================
+Bench_GenerateFields
+
+Field widths and value distribution loosely follow entity and player state
+deltas: mostly small numbers, some full width ones.
+=================
+*/
+static int Bench_GenerateFields( void )
+{
+	static const int widths[] = { 1, 1, 1, 4, 6, 7, 8, 8, 10, 16, 16, 19, 24, 32 };
+	int i, bits, total;
+	uint32_t value;
+
+	total = 0;
+	for ( i = 0; i < BENCH_FIELDS; i++ ) {
+		bits = widths[ Bench_Rand() % ARRAY_LEN( widths ) ];
+		value = Bench_Rand();
+		if ( Bench_Rand() & 1 ) {
+			value &= 0xFF; // small values dominate real traffic
+		}
+		if ( bits < 32 ) {
+			value &= ( 1U << bits ) - 1;
+		}
+		fieldBits[ i ] = bits;
+		fieldValues[ i ] = value;
+		total += bits;
+	}
+
+	return total;
+}
+
+
+/*
+=================
+Bench_EncodeReference
+
+Bit by bit encoder that MSG_WriteBits used before HuffmanPutBits
+=================
+*/
+static int Bench_EncodeReference( byte *out )
+{
+	int i, n, bit, nbits;
+	uint32_t value;
+
+	bit = 0;
+	for ( i = 0; i < BENCH_FIELDS; i++ ) {
+		value = fieldValues[ i ];
+		nbits = fieldBits[ i ] & 7;
+		for ( n = 0; n < nbits; n++ ) {
+			HuffmanPutBit( out, bit, value & 1 );
+			bit++;
+			value >>= 1;
+		}
+		for ( n = nbits; n < fieldBits[ i ]; n += 8 ) {
+			bit += HuffmanPutSymbol( out, bit, value & 0xFF );
+			value >>= 8;
+		}
+	}
+
+	return bit;
+}
+
+
+/*
+=================
+Bench_EncodeFast
+=================
+*/
+static int Bench_EncodeFast( byte *out )
+{
+	int i, bit;
+
+	bit = 0;
+	for ( i = 0; i < BENCH_FIELDS; i++ ) {
+		bit += HuffmanPutBits( out, bit, fieldValues[ i ], fieldBits[ i ] );
+	}
+
+	return bit;
+}
+
+
+/*
+=================
+Bench_DecodeReference
+=================
+*/
+static int Bench_DecodeReference( const byte *in )
+{
+	int i, n, bit, nbits;
+	unsigned int sym;
+	uint32_t value;
+
+	bit = 0;
+	for ( i = 0; i < BENCH_FIELDS; i++ ) {
+		value = 0;
+		nbits = fieldBits[ i ] & 7;
+		for ( n = 0; n < nbits; n++ ) {
+			value |= HuffmanGetBit( in, bit ) << n;
+			bit++;
+		}
+		for ( n = nbits; n < fieldBits[ i ]; n += 8 ) {
+			bit += HuffmanGetSymbol( &sym, in, bit );
+			value |= sym << n;
+		}
+		decoded[ i ] = value;
+	}
+
+	return bit;
+}
+
+
+/*
+=================
+Bench_DecodeFast
+=================
+*/
+static int Bench_DecodeFast( const byte *in )
+{
+	int i, bit;
+
+	bit = 0;
+	for ( i = 0; i < BENCH_FIELDS; i++ ) {
+		decoded[ i ] = HuffmanGetBits( in, &bit, fieldBits[ i ] );
+	}
+
+	return bit;
+}
+
+
+/*
+=================
+Bench_Run
+
+Returns MB/s of uncompressed field data.
+=================
+*/
+static double Bench_Run( int (*func)( byte *buf ), byte *buf, int passes, int payloadBits )
+{
+	double start, elapsed;
+	int i;
+
+	start = Bench_Seconds();
+	for ( i = 0; i < passes; i++ ) {
+		func( buf );
+	}
+	elapsed = Bench_Seconds() - start;
+	if ( elapsed <= 0.0 ) {
+		elapsed = 1e-6;
+	}
+
+	return (double)payloadBits / 8.0 * passes / ( 1024.0 * 1024.0 ) / elapsed;
+}
+
+
+static int Bench_DecodeReferenceRW( byte *buf ) { return Bench_DecodeReference( buf ); }
+static int Bench_DecodeFastRW( byte *buf ) { return Bench_DecodeFast( buf ); }
+
+
+int main( int argc, char **argv )
+{
+	byte *reference, *fast;
+	int payloadBits, refBits, fastBits, passes, i;
+	double encRef, encFast, decRef, decFast;
+
+	passes = 20;
+	if ( argc > 1 ) {
+		passes = atoi( argv[1] );
+		if ( passes < 1 ) {
+			passes = 1;
+		}
+	}
+
+	// extra slack for unaligned decoder loads past the last symbol
+	reference = calloc( BENCH_BUFSIZE, 1 );
+	fast = calloc( BENCH_BUFSIZE, 1 );
+	if ( !reference || !fast ) {
+		fprintf( stderr, "huffbench: out of memory\n" );
+		return 1;
+	}
+
+	payloadBits = Bench_GenerateFields();
+
+	// wire compatibility: buffers start with garbage to catch missed byte stores
+	memset( reference, 0xA5, BENCH_BUFSIZE );
+	memset( fast, 0x5A, BENCH_BUFSIZE );
+	refBits = Bench_EncodeReference( reference );
+	fastBits = Bench_EncodeFast( fast );
+	if ( refBits != fastBits || memcmp( reference, fast, ( refBits + 7 ) >> 3 ) ) {
+		fprintf( stderr, "huffbench: encoder mismatch (%i vs %i bits)\n", refBits, fastBits );
+		return 1;
+	}
+
+	if ( Bench_DecodeFast( reference ) != refBits ) {
+		fprintf( stderr, "huffbench: decoder consumed wrong number of bits\n" );
+		return 1;
+	}
+	for ( i = 0; i < BENCH_FIELDS; i++ ) {
+		if ( decoded[ i ] != fieldValues[ i ] ) {
+			fprintf( stderr, "huffbench: decoder mismatch at field %i: %u != %u\n", i, decoded[ i ], fieldValues[ i ] );
+			return 1;
+		}
+	}
+
+	encRef = Bench_Run( Bench_EncodeReference, reference, passes, payloadBits );
+	encFast = Bench_Run( Bench_EncodeFast, fast, passes, payloadBits );
+	decRef = Bench_Run( Bench_DecodeReferenceRW, reference, passes, payloadBits );
+	decFast = Bench_Run( Bench_DecodeFastRW, reference, passes, payloadBits );
+
+	printf( "%i fields, %i payload bytes, %i encoded bytes, %i passes\n",
+		BENCH_FIELDS, payloadBits / 8, ( refBits + 7 ) >> 3, passes );
+	printf( "encode: %8.1f MB/s bitwise, %8.1f MB/s table (%.2fx)\n", encRef, encFast, encFast / encRef );
+	printf( "decode: %8.1f MB/s bitwise, %8.1f MB/s table (%.2fx)\n", decRef, decFast, decFast / decRef );
+
+	free( reference );
+	free( fast );
+
+	return 0;
+}
@@ -0,0 +1,1449 @@
+/*
+===========================================================================
+
+Wolfenstein: Enemy Territory GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Wolfenstein: Enemy Territory GPL Source Code (Wolf ET Source Code).
+
+Wolf ET Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Wolf ET Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Wolf ET Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Wolf: ET Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Wolf ET Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+// loadgen.c -- headless synthetic clients for server capacity tests: every
+// client runs the challenge/connect/gamestate handshake over the regular
+// netchan, acks snapshots and streams usercmds, snapshot rate, drop and
+// latency stats of all clients are written as a JSON report
+
+#include <errno.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "../qcommon/q_shared.h"
+#include "../qcommon/qcommon.h"
+
+#define LG_MAX_CLIENTS		256
+#define LG_HIST_BUCKETS		1000	// 1 msec buckets, the last one also counts everything above
+#define LG_RESEND_MSEC		1000	// challenge and connect retransmit
+#define LG_TIMEOUT_MSEC		10000	// drop a connection silent for this long
+#define LG_KEY_CHARS		33		// MSG_HashKey only hashes the first 32 characters
+#define LG_COMMAND_CHARS	256
+#define LG_MAX_STEPS		256
+
+// defined in net_chan.c, written into every client packet header
+extern cvar_t *qport;
+
+typedef enum {
+	LG_FREE,
+	LG_CHALLENGING,		// sending getchallenge
+	LG_CONNECTING,		// sending connect
+	LG_CONNECTED,		// netchan is up, waiting for the gamestate
+	LG_PRIMED,			// got a gamestate, sending usercmds
+	LG_ACTIVE,			// receiving snapshots
+	LG_DROPPED
+} lgState_t;
+
+static const char *lgStateNames[] = {
+	"free", "challenging", "connecting", "connected", "primed", "active", "dropped"
+};
+
+typedef struct {
+	int		bucket[ LG_HIST_BUCKETS ];
+	int		count;
+	int		max;
+	int64_t	sum;
+} lgHistogram_t;
+
+// one step of a usercmd script, a command step is sent as reliable command
+typedef struct {
+	int			msec;
+	int			forward, right, up;
+	int			yawSpeed;		// degrees per second
+	int			buttons;
+	char		command[ LG_COMMAND_CHARS ];
+} lgStep_t;
+
+typedef struct {
+	int			packetsIn, bytesIn;
+	int			packetsOut, bytesOut;
+	int			gamestates;
+	int			snapshots;
+	int			droppedPackets;		// netchan sequence gaps
+	int			deltaErrors;		// snapshots deltaed from a frame we don't have
+	int			connectMsec;		// start of handshake to first snapshot
+	int			activeTime;
+	int			lastSnapTime;
+	lgHistogram_t	ping;
+	lgHistogram_t	interval;		// snapshot inter-arrival time
+} lgStats_t;
+
+typedef struct {
+	int			index;
+	int			sock;
+	int			qport;
+	lgState_t	state;
+	int			startTime;
+	int			lastConnectPacket;
+	int			lastServerPacket;
+	int			challenge;
+
+	netchan_t	netchan;
+
+	int			serverId;
+	int			clientNum;
+	int			checksumFeed;
+	int			serverMessageSequence;
+	int			serverCommandSequence;
+	char		serverCommands[ MAX_RELIABLE_COMMANDS ][ LG_KEY_CHARS ];
+	char		bigConfigstring[ BIG_INFO_STRING ];
+
+	int			reliableSequence;
+	int			reliableAcknowledge;
+	char		reliableCommands[ MAX_RELIABLE_COMMANDS ][ LG_COMMAND_CHARS ];
+
+	// playerstates of recent snapshots for delta decoding
+	playerState_t	ps[ PACKET_BACKUP ];
+	int			psMessageNum[ PACKET_BACKUP ];
+	int			snapMessageNum;
+	int			snapServerTime;
+	int			snapRealTime;
+	int			weapon;
+
+	// outgoing packets for ping calculation
+	int			outRealTime[ PACKET_BACKUP ];
+	int			outServerTime[ PACKET_BACKUP ];
+	int			lastPacketTime;
+	int			lastCmdTime;
+	int			lastCmdServerTime;
+
+	// movement
+	usercmd_t	cmd;
+	float		yaw;
+	int			yawSpeed;
+	int			behaviorTime;
+	int			jumpTime;
+	int			step;
+	int			playerClass;
+	int			nextClassSwitch;
+
+	lgStats_t	stats;
+	char		reason[ 128 ];
+} lgClient_t;
+
+static lgClient_t	*lgClients;
+static int			lgNumClients = 16;
+static int			lgDuration = 60;
+static int			lgPacketRate = 60;
+static int			lgSnaps = 20;
+static int			lgRate = 90000;
+static int			lgRampMsec = 100;
+static int			lgClassSwitch = 30;
+static qboolean		lgBindLoopback = qtrue;
+static qboolean		lgVerbose;
+static const char	*lgReportPath;
+static const char	*lgServerName;
+static const char	*lgPassword = "";
+
+static struct sockaddr_in	lgServerAddr;
+static netadr_t		lgServer;
+
+static lgStep_t		lgSteps[ LG_MAX_STEPS ];
+static int			lgNumSteps;
+static const char	*lgScriptPath;
+
+static lgClient_t	*lgSendClient;		// owner of packets passed to Sys_SendPacket
+static jmp_buf		lgAbort;
+static qboolean		lgAbortSet;
+static char			lgErrorText[ 256 ];
+static volatile sig_atomic_t lgInterrupted;
+
+static uint32_t		lgSeed = 0x1234567;
+
+
+/*
+==============================================================================
+
+Engine functions needed by net_chan.c and msg.c
+
+==============================================================================
+*/
+
+cvar_t	*com_timescale;
+cvar_t	*sv_packetdelay;
+cvar_t	*sv_packetloss;
+
+
+void QDECL Com_Printf( const char *fmt, ... ) {
+	va_list	argptr;
+
+	if ( !lgVerbose ) {
+		return;
+	}
+
+	va_start( argptr, fmt );
+	vfprintf( stderr, fmt, argptr );
+	va_end( argptr );
+}
+
+
+/*
+=================
+Com_Error
+
+Aborts parsing of the current packet and drops the client it belongs to
+=================
+*/
+void NORETURN QDECL Com_Error( errorParm_t code, const char *fmt, ... ) {
+	va_list	argptr;
+
+	va_start( argptr, fmt );
+	Q_vsnprintf( lgErrorText, sizeof( lgErrorText ), fmt, argptr );
+	va_end( argptr );
+
+	if ( lgAbortSet ) {
+		longjmp( lgAbort, 1 );
+	}
+
+	fprintf( stderr, "ERROR: %s\n", lgErrorText );
+	exit( 1 );
+}
+
+
+cvar_t *Cvar_Get( const char *var_name, const char *value, int flags ) {
+	cvar_t *var;
+
+	var = calloc( 1, sizeof( *var ) );
+	var->name = strdup( var_name );
+	var->string = strdup( value );
+	var->flags = flags;
+	var->value = atof( value );
+	var->integer = atoi( value );
+
+	return var;
+}
+
+
+void Cvar_SetDescription( cvar_t *var, const char *var_description ) {
+}
+
+
+void *S_Malloc( int size ) {
+	return malloc( size );
+}
+
+
+void Z_Free( void *ptr ) {
+	free( ptr );
+}
+
+
+void NET_BeginSendBatch( void ) {
+}
+
+
+void NET_EndSendBatch( void ) {
+}
+
+
+const char *NET_AdrToString( const netadr_t *a ) {
+	static char s[ 64 ];
+
+	Com_sprintf( s, sizeof( s ), "%i.%i.%i.%i", a->ipv._4[0], a->ipv._4[1], a->ipv._4[2], a->ipv._4[3] );
+	return s;
+}
+
+
+qboolean Sys_IsLANAddress( const netadr_t *adr ) {
+	return qfalse;
+}
+
+
+/*
+=================
+Sys_StringToAdr
+
+IPv4 only, NET_StringToAdr strips the port before calling this
+=================
+*/
+qboolean Sys_StringToAdr( const char *s, netadr_t *a, netadrtype_t family ) {
+	struct addrinfo hints, *res;
+	const struct sockaddr_in *sin;
+
+	Com_Memset( &hints, 0, sizeof( hints ) );
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+
+	if ( getaddrinfo( s, NULL, &hints, &res ) != 0 ) {
+		return qfalse;
+	}
+
+	sin = (const struct sockaddr_in *)res->ai_addr;
+	a->type = NA_IP;
+	memcpy( a->ipv._4, &sin->sin_addr, 4 );
+	freeaddrinfo( res );
+
+	return qtrue;
+}
+
+
+int Sys_Milliseconds( void ) {
+	static time_t	base;
+	struct timespec	ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	if ( !base ) {
+		base = ts.tv_sec;
+	}
+
+	return ( ts.tv_sec - base ) * 1000 + ts.tv_nsec / 1000000;
+}
+
+
+/*
+=================
+Sys_SendPacket
+
+All packets go to the server through the socket of the current client
+=================
+*/
+void Sys_SendPacket( int length, const void *data, const netadr_t *to ) {
+	if ( !lgSendClient ) {
+		return;
+	}
+
+	if ( send( lgSendClient->sock, data, length, 0 ) == length ) {
+		lgSendClient->stats.packetsOut++;
+		lgSendClient->stats.bytesOut += length;
+	}
+}
+
+
+/*
+==============================================================================
+
+Statistics
+
+==============================================================================
+*/
+
+static uint32_t LG_Rand( void ) {
+	lgSeed ^= lgSeed << 13;
+	lgSeed ^= lgSeed >> 17;
+	lgSeed ^= lgSeed << 5;
+	return lgSeed;
+}
+
+
+static void LG_HistAdd( lgHistogram_t *hist, int msec ) {
+	if ( msec < 0 ) {
+		msec = 0;
+	}
+
+	hist->bucket[ msec < LG_HIST_BUCKETS ? msec : LG_HIST_BUCKETS - 1 ]++;
+	hist->count++;
+	hist->sum += msec;
+	if ( msec > hist->max ) {
+		hist->max = msec;
+	}
+}
+
+
+static void LG_HistMerge( lgHistogram_t *to, const lgHistogram_t *from ) {
+	int i;
+
+	for ( i = 0; i < LG_HIST_BUCKETS; i++ ) {
+		to->bucket[ i ] += from->bucket[ i ];
+	}
+	to->count += from->count;
+	to->sum += from->sum;
+	if ( from->max > to->max ) {
+		to->max = from->max;
+	}
+}
+
+
+/*
+=================
+LG_HistPercentile
+
+Nearest-rank percentile, values above the last bucket report the maximum
+=================
+*/
+static int LG_HistPercentile( const lgHistogram_t *hist, int percent ) {
+	int rank, seen, i;
+
+	if ( !hist->count ) {
+		return 0;
+	}
+
+	rank = ( hist->count * percent + 99 ) / 100;
+	if ( rank < 1 ) {
+		rank = 1;
+	}
+
+	for ( i = 0, seen = 0; i < LG_HIST_BUCKETS - 1; i++ ) {
+		seen += hist->bucket[ i ];
+		if ( seen >= rank ) {
+			return i;
+		}
+	}
+
+	return hist->max;
+}
+
+
+static void LG_WriteHist( FILE *f, const char *name, const lgHistogram_t *hist, const char *indent, qboolean last ) {
+	fprintf( f, "%s\"%s\": { \"count\": %i, \"p50\": %i, \"p99\": %i, \"max\": %i, \"avg\": %.1f }%s\n",
+		indent, name, hist->count, LG_HistPercentile( hist, 50 ), LG_HistPercentile( hist, 99 ), hist->max,
+		hist->count ? (double)hist->sum / hist->count : 0.0, last ? "" : "," );
+}
+
+
+static void LG_WriteString( FILE *f, const char *s ) {
+	fputc( '"', f );
+	for ( ; *s; s++ ) {
+		if ( *s == '"' || *s == '\\' ) {
+			fputc( '\\', f );
+			fputc( *s, f );
+		} else if ( (unsigned char)*s < ' ' ) {
+			fprintf( f, "\\u%04x", (unsigned char)*s );
+		} else {
+			fputc( *s, f );
+		}
+	}
+	fputc( '"', f );
+}
+
+
+/*
+==============================================================================
+
+Client connection
+
+==============================================================================
+*/
+
+static void LG_Drop( lgClient_t *cl, const char *reason ) {
+	if ( cl->state == LG_DROPPED ) {
+		return;
+	}
+
+	Q_strncpyz( cl->reason, reason, sizeof( cl->reason ) );
+	cl->state = LG_DROPPED;
+
+	if ( lgVerbose ) {
+		fprintf( stderr, "client %i dropped: %s\n", cl->index, reason );
+	}
+}
+
+
+/*
+=================
+LG_OpenSocket
+
+Loopback servers see every client from its own 127.x address so per-address
+connection and rate limits do not apply to the whole test
+=================
+*/
+static int LG_OpenSocket( int index ) {
+	struct sockaddr_in	local;
+	int					sock;
+
+	sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+	if ( sock < 0 ) {
+		return -1;
+	}
+
+	if ( lgBindLoopback && lgServer.ipv._4[0] == 127 ) {
+		Com_Memset( &local, 0, sizeof( local ) );
+		local.sin_family = AF_INET;
+		local.sin_addr.s_addr = htonl( ( 127 << 24 ) | ( 1 << 16 ) | ( ( index / 250 ) << 8 ) | ( index % 250 + 1 ) );
+		if ( bind( sock, (struct sockaddr *)&local, sizeof( local ) ) < 0 ) {
+			close( sock );
+			return -1;
+		}
+	}
+
+	if ( connect( sock, (struct sockaddr *)&lgServerAddr, sizeof( lgServerAddr ) ) < 0 ) {
+		close( sock );
+		return -1;
+	}
+
+	fcntl( sock, F_SETFL, fcntl( sock, F_GETFL ) | O_NONBLOCK );
+
+	return sock;
+}
+
+
+static void LG_StartClient( lgClient_t *cl, int index ) {
+	int i;
+
+	Com_Memset( cl, 0, sizeof( *cl ) );
+	cl->index = index;
+	cl->qport = ( LG_Rand() & 0x7fff ) | 1;
+	cl->challenge = LG_Rand() & 0x7fffffff;
+	cl->startTime = Sys_Milliseconds();
+	cl->lastConnectPacket = cl->startTime - LG_RESEND_MSEC;
+	cl->lastServerPacket = cl->startTime;
+	cl->snapMessageNum = -1;
+	cl->playerClass = index % 5;
+	for ( i = 0; i < PACKET_BACKUP; i++ ) {
+		cl->psMessageNum[ i ] = -1;
+	}
+
+	cl->sock = LG_OpenSocket( index );
+	if ( cl->sock < 0 ) {
+		cl->state = LG_FREE;
+		LG_Drop( cl, strerror( errno ) );
+		return;
+	}
+
+	cl->state = LG_CHALLENGING;
+}
+
+
+static void LG_AddReliableCommand( lgClient_t *cl, const char *cmd ) {
+	if ( cl->reliableSequence - cl->reliableAcknowledge >= MAX_RELIABLE_COMMANDS ) {
+		return;
+	}
+
+	cl->reliableSequence++;
+	Q_strncpyz( cl->reliableCommands[ cl->reliableSequence & ( MAX_RELIABLE_COMMANDS - 1 ) ], cmd, LG_COMMAND_CHARS );
+}
+
+
+static void LG_SendConnect( lgClient_t *cl ) {
+	char	info[ MAX_INFO_STRING ];
+	char	data[ MAX_INFO_STRING + 16 ];
+	int		len;
+
+	info[0] = '\0';
+	Info_SetValueForKey( info, "name", va( "loadgen%i", cl->index ) );
+	Info_SetValueForKey( info, "rate", va( "%i", lgRate ) );
+	Info_SetValueForKey( info, "snaps", va( "%i", lgSnaps ) );
+	Info_SetValueForKey( info, "cl_guid", va( "%032X", cl->index + 1 ) );
+	if ( *lgPassword ) {
+		Info_SetValueForKey( info, "password", lgPassword );
+	}
+	Info_SetValueForKey( info, "protocol", XSTRING( NEW_PROTOCOL_VERSION ) );
+	Info_SetValueForKey( info, "qport", va( "%i", cl->qport ) );
+	Info_SetValueForKey( info, "challenge", va( "%i", cl->challenge ) );
+	Info_SetValueForKey( info, "client", "ete-loadgen" );
+
+	len = Com_sprintf( data, sizeof( data ), "connect \"%s\"", info );
+	NET_OutOfBandCompress( NS_CLIENT, &lgServer, (byte *)data, len );
+}
+
+
+/*
+=================
+LG_Transmit
+=================
+*/
+static void LG_Transmit( lgClient_t *cl, msg_t *msg ) {
+	MSG_WriteByte( msg, clc_EOF );
+
+	qport->integer = cl->qport;
+	Netchan_Transmit( &cl->netchan, msg->cursize, msg->data );
+	while ( cl->netchan.unsentFragments ) {
+		Netchan_TransmitNextFragment( &cl->netchan );
+	}
+}
+
+
+/*
+=================
+LG_BuildCommand
+
+Follows the script if one was given, otherwise walks, turns, jumps and fires at random
+=================
+*/
+static void LG_BuildCommand( lgClient_t *cl, int now ) {
+	const lgStep_t *step;
+	int msec;
+
+	msec = now - cl->lastCmdTime;
+	if ( msec > 200 ) {
+		msec = 200;
+	}
+	cl->lastCmdTime = now;
+
+	if ( lgNumSteps ) {
+		while ( now - cl->behaviorTime >= 0 ) {
+			step = &lgSteps[ cl->step ];
+			cl->step = ( cl->step + 1 ) % lgNumSteps;
+			if ( step->command[0] ) {
+				LG_AddReliableCommand( cl, step->command );
+				if ( !step->msec ) {
+					continue;
+				}
+			}
+			cl->cmd.forwardmove = step->forward;
+			cl->cmd.rightmove = step->right;
+			cl->cmd.upmove = step->up;
+			cl->cmd.buttons = step->buttons;
+			cl->yawSpeed = step->yawSpeed;
+			cl->behaviorTime = now + step->msec;
+			break;
+		}
+	} else {
+		if ( now - cl->behaviorTime >= 0 ) {
+			static const signed char moves[] = { 127, 127, 0, -127 };
+			cl->cmd.forwardmove = moves[ LG_Rand() % ARRAY_LEN( moves ) ];
+			cl->cmd.rightmove = moves[ LG_Rand() % ARRAY_LEN( moves ) ] / ( ( LG_Rand() & 1 ) ? 1 : -1 );
+			cl->cmd.buttons = ( LG_Rand() % 4 == 0 ) ? BUTTON_ATTACK : 0;
+			cl->yawSpeed = (int)( LG_Rand() % 361 ) - 180;
+			if ( LG_Rand() % 8 == 0 ) {
+				cl->jumpTime = now + 100;
+			}
+			cl->behaviorTime = now + 500 + LG_Rand() % 1500;
+		}
+		cl->cmd.upmove = ( cl->jumpTime - now > 0 ) ? 127 : 0;
+
+		if ( lgClassSwitch && cl->state == LG_ACTIVE && now - cl->nextClassSwitch >= 0 ) {
+			cl->playerClass = ( cl->playerClass + 1 ) % 5;
+			LG_AddReliableCommand( cl, va( "team %s %i 0 0", ( cl->index & 1 ) ? "b" : "r", cl->playerClass ) );
+			cl->nextClassSwitch = now + lgClassSwitch * 1000;
+		}
+	}
+
+	cl->yaw = AngleNormalize360( cl->yaw + cl->yawSpeed * msec * 0.001f );
+	cl->cmd.angles[ YAW ] = ANGLE2SHORT( cl->yaw );
+	cl->cmd.weapon = cl->weapon;
+
+	// keep the server clock of the last snapshot running like a real client does
+	if ( cl->snapMessageNum >= 0 ) {
+		cl->cmd.serverTime = cl->snapServerTime + ( now - cl->snapRealTime );
+	} else {
+		cl->cmd.serverTime = cl->lastCmdServerTime + msec;
+	}
+	if ( cl->cmd.serverTime - cl->lastCmdServerTime <= 0 ) {
+		cl->cmd.serverTime = cl->lastCmdServerTime + 1;
+	}
+	cl->lastCmdServerTime = cl->cmd.serverTime;
+}
+
+
+/*
+=================
+LG_WritePacket
+
+Same layout as CL_WritePacket with a single usercmd per packet
+=================
+*/
+static void LG_WritePacket( lgClient_t *cl, int now ) {
+	static const usercmd_t nullcmd = { 0 };
+	msg_t	buf;
+	byte	data[ MAX_MSGLEN_BUF ];
+	int		i, index, key, packetNum;
+
+	MSG_Init( &buf, data, MAX_MSGLEN );
+	MSG_Bitstream( &buf );
+
+	MSG_WriteLong( &buf, cl->serverId );
+	MSG_WriteLong( &buf, cl->serverMessageSequence );
+	MSG_WriteLong( &buf, cl->serverCommandSequence );
+
+	for ( i = cl->reliableAcknowledge + 1; i - cl->reliableSequence <= 0; i++ ) {
+		index = i & ( MAX_RELIABLE_COMMANDS - 1 );
+		MSG_WriteByte( &buf, clc_clientCommand );
+		MSG_WriteLong( &buf, i );
+		MSG_WriteString( &buf, cl->reliableCommands[ index ] );
+	}
+
+	if ( cl->state >= LG_PRIMED ) {
+		LG_BuildCommand( cl, now );
+
+		if ( cl->snapMessageNum >= 0 && cl->snapMessageNum == cl->serverMessageSequence ) {
+			MSG_WriteByte( &buf, clc_move );
+		} else {
+			MSG_WriteByte( &buf, clc_moveNoDelta );
+		}
+		MSG_WriteByte( &buf, 1 );
+
+		key = cl->checksumFeed;
+		key ^= cl->serverMessageSequence;
+		key ^= MSG_HashKey( cl->serverCommands[ cl->serverCommandSequence & ( MAX_RELIABLE_COMMANDS - 1 ) ], 32 );
+		MSG_WriteDeltaUsercmdKey( &buf, key, &nullcmd, &cl->cmd );
+
+		packetNum = cl->netchan.outgoingSequence & PACKET_MASK;
+		cl->outRealTime[ packetNum ] = now;
+		cl->outServerTime[ packetNum ] = cl->cmd.serverTime;
+	}
+
+	if ( buf.overflowed ) {
+		LG_Drop( cl, "client message overflowed" );
+		return;
+	}
+
+	LG_Transmit( cl, &buf );
+	cl->lastPacketTime = now;
+}
+
+
+static void LG_Disconnect( lgClient_t *cl ) {
+	int i;
+
+	if ( cl->state < LG_CONNECTED || cl->state == LG_DROPPED ) {
+		return;
+	}
+
+	lgSendClient = cl;
+	LG_AddReliableCommand( cl, "disconnect" );
+	for ( i = 0; i < 2; i++ ) {
+		LG_WritePacket( cl, Sys_Milliseconds() );
+	}
+	lgSendClient = NULL;
+}
+
+
+/*
+==============================================================================
+
+Server messages
+
+==============================================================================
+*/
+
+static void LG_SystemInfo( lgClient_t *cl, const char *info ) {
+	cl->serverId = atoi( Info_ValueForKey( info, "sv_serverid" ) );
+}
+
+
+/*
+=================
+LG_Configstring
+
+Only systeminfo matters, it carries the serverId that changes on map_restart
+=================
+*/
+static void LG_Configstring( lgClient_t *cl, const char *cmd ) {
+	char		value[ BIG_INFO_STRING ];
+	const char	*s, *e;
+	int			index, part;
+
+	if ( !strncmp( cmd, "cs ", 3 ) ) {
+		part = -1;
+		index = atoi( cmd + 3 );
+	} else if ( !strncmp( cmd, "bcs", 3 ) && cmd[3] >= '0' && cmd[3] <= '2' && cmd[4] == ' ' ) {
+		part = cmd[3] - '0';
+		index = atoi( cmd + 5 );
+	} else {
+		return;
+	}
+
+	if ( index != CS_SYSTEMINFO ) {
+		return;
+	}
+
+	s = strchr( cmd, '"' );
+	e = strrchr( cmd, '"' );
+	if ( !s || e == s ) {
+		return;
+	}
+	s++;
+
+	Q_strncpyz( value, s, MIN( (int)sizeof( value ), (int)( e - s ) + 1 ) );
+
+	switch ( part ) {
+	case -1:
+		LG_SystemInfo( cl, value );
+		break;
+	case 0:
+		Q_strncpyz( cl->bigConfigstring, value, sizeof( cl->bigConfigstring ) );
+		break;
+	case 1:
+		Q_strcat( cl->bigConfigstring, sizeof( cl->bigConfigstring ), value );
+		break;
+	case 2:
+		Q_strcat( cl->bigConfigstring, sizeof( cl->bigConfigstring ), value );
+		LG_SystemInfo( cl, cl->bigConfigstring );
+		break;
+	}
+}
+
+
+static void LG_ParseCommandString( lgClient_t *cl, msg_t *msg ) {
+	const char	*s;
+	int			seq;
+
+	seq = MSG_ReadLong( msg );
+	s = MSG_ReadString( msg );
+
+	if ( cl->serverCommandSequence - seq >= 0 ) {
+		return;
+	}
+	cl->serverCommandSequence = seq;
+	Q_strncpyz( cl->serverCommands[ seq & ( MAX_RELIABLE_COMMANDS - 1 ) ], s, LG_KEY_CHARS );
+
+	if ( !strncmp( s, "disconnect", 10 ) ) {
+		LG_Drop( cl, s );
+		return;
+	}
+
+	LG_Configstring( cl, s );
+}
+
+
+static void LG_ParseGamestate( lgClient_t *cl, msg_t *msg ) {
+	entityState_t	nullstate, es;
+	const char		*s;
+	int				cmd, i, newnum;
+
+	Com_Memset( &nullstate, 0, sizeof( nullstate ) );
+
+	cl->serverCommandSequence = MSG_ReadLong( msg );
+
+	while ( 1 ) {
+		cmd = MSG_ReadByte( msg );
+		if ( cmd == svc_EOF ) {
+			break;
+		}
+
+		if ( cmd == svc_configstring ) {
+			i = MSG_ReadShort( msg );
+			if ( i < 0 || i >= MAX_CONFIGSTRINGS ) {
+				Com_Error( ERR_DROP, "configstring > MAX_CONFIGSTRINGS" );
+			}
+			s = MSG_ReadBigString( msg );
+			if ( i == CS_SYSTEMINFO ) {
+				LG_SystemInfo( cl, s );
+			}
+		} else if ( cmd == svc_baseline ) {
+			newnum = MSG_ReadBits( msg, GENTITYNUM_BITS );
+			if ( newnum < 0 || newnum >= MAX_GENTITIES ) {
+				Com_Error( ERR_DROP, "Baseline number out of range: %i", newnum );
+			}
+			MSG_ReadDeltaEntity( msg, &nullstate, &es, newnum );
+		} else {
+			Com_Error( ERR_DROP, "LG_ParseGamestate: bad command byte" );
+		}
+
+		if ( msg->readcount > msg->cursize ) {
+			Com_Error( ERR_DROP, "LG_ParseGamestate: read past end of gamestate" );
+		}
+	}
+
+	cl->clientNum = MSG_ReadLong( msg );
+	cl->checksumFeed = MSG_ReadLong( msg );
+
+	cl->snapMessageNum = -1;
+	for ( i = 0; i < PACKET_BACKUP; i++ ) {
+		cl->psMessageNum[ i ] = -1;
+	}
+
+	cl->stats.gamestates++;
+	if ( cl->state < LG_PRIMED ) {
+		cl->state = LG_PRIMED;
+	}
+}
+
+
+/*
+=================
+LG_ParseSnapshot
+
+Only the playerstate is decoded, it is needed for the next delta and gives
+the ping like in CL_ParseSnapshot, packet entities are skipped
+=================
+*/
+static void LG_ParseSnapshot( lgClient_t *cl, msg_t *msg, int now ) {
+	byte			areamask[ MAX_MAP_AREA_BYTES ];
+	playerState_t	ps;
+	const playerState_t *from;
+	int				serverTime, deltaNum, deltaMessage, areabytes;
+	int				i, packetNum;
+
+	serverTime = MSG_ReadLong( msg );
+	deltaNum = MSG_ReadByte( msg );
+	MSG_ReadByte( msg );	// snapFlags
+
+	areabytes = MSG_ReadByte( msg );
+	if ( areabytes > sizeof( areamask ) ) {
+		Com_Error( ERR_DROP, "LG_ParseSnapshot: invalid size %i for areamask", areabytes );
+	}
+	MSG_ReadData( msg, areamask, areabytes );
+
+	if ( !deltaNum ) {
+		from = NULL;
+	} else {
+		deltaMessage = cl->serverMessageSequence - deltaNum;
+		if ( deltaNum >= PACKET_BACKUP || cl->psMessageNum[ deltaMessage & PACKET_MASK ] != deltaMessage ) {
+			// can't decode, the next packet asks for a full snapshot
+			cl->stats.deltaErrors++;
+			return;
+		}
+		from = &cl->ps[ deltaMessage & PACKET_MASK ];
+	}
+
+	MSG_ReadDeltaPlayerstate( msg, from, &ps );
+	if ( msg->readcount > msg->cursize ) {
+		Com_Error( ERR_DROP, "LG_ParseSnapshot: read past end of server message" );
+	}
+
+	cl->ps[ cl->serverMessageSequence & PACKET_MASK ] = ps;
+	cl->psMessageNum[ cl->serverMessageSequence & PACKET_MASK ] = cl->serverMessageSequence;
+	cl->snapMessageNum = cl->serverMessageSequence;
+	cl->snapServerTime = serverTime;
+	cl->snapRealTime = now;
+	cl->weapon = ps.weapon;
+
+	cl->stats.snapshots++;
+	if ( cl->stats.lastSnapTime ) {
+		LG_HistAdd( &cl->stats.interval, now - cl->stats.lastSnapTime );
+	}
+	cl->stats.lastSnapTime = now;
+
+	for ( i = 0; i < PACKET_BACKUP; i++ ) {
+		packetNum = ( cl->netchan.outgoingSequence - 1 - i ) & PACKET_MASK;
+		if ( !cl->outRealTime[ packetNum ] ) {
+			break;
+		}
+		if ( ps.commandTime - cl->outServerTime[ packetNum ] >= 0 ) {
+			if ( cl->state == LG_ACTIVE ) {
+				LG_HistAdd( &cl->stats.ping, now - cl->outRealTime[ packetNum ] );
+			}
+			break;
+		}
+	}
+
+	if ( cl->state == LG_PRIMED ) {
+		cl->state = LG_ACTIVE;
+		cl->stats.activeTime = now;
+		cl->stats.connectMsec = now - cl->startTime;
+		LG_AddReliableCommand( cl, va( "team %s %i 0 0", ( cl->index & 1 ) ? "b" : "r", cl->playerClass ) );
+		cl->nextClassSwitch = now + lgClassSwitch * 1000;
+	}
+}
+
+
+static void LG_ParseServerMessage( lgClient_t *cl, msg_t *msg, int now ) {
+	int cmd;
+
+	MSG_Bitstream( msg );
+
+	cl->reliableAcknowledge = MSG_ReadLong( msg );
+	if ( cl->reliableSequence - cl->reliableAcknowledge > MAX_RELIABLE_COMMANDS
+		|| cl->reliableSequence - cl->reliableAcknowledge < 0 ) {
+		cl->reliableAcknowledge = cl->reliableSequence;
+	}
+
+	while ( cl->state != LG_DROPPED ) {
+		if ( msg->readcount > msg->cursize ) {
+			Com_Error( ERR_DROP, "LG_ParseServerMessage: read past end of server message" );
+		}
+
+		cmd = MSG_ReadByte( msg );
+		switch ( cmd ) {
+		case svc_EOF:
+			return;
+		case svc_nop:
+			break;
+		case svc_serverCommand:
+			LG_ParseCommandString( cl, msg );
+			break;
+		case svc_gamestate:
+			LG_ParseGamestate( cl, msg );
+			break;
+		case svc_snapshot:
+			// server commands come first, nothing after the entities is needed
+			LG_ParseSnapshot( cl, msg, now );
+			return;
+		default:
+			Com_Error( ERR_DROP, "LG_ParseServerMessage: Illegible server message %d", cmd );
+		}
+	}
+}
+
+
+/*
+=================
+LG_ConnectionlessPacket
+=================
+*/
+static void LG_ConnectionlessPacket( lgClient_t *cl, msg_t *msg ) {
+	char		line[ MAX_INFO_STRING ];
+	char		arg[ 4 ][ 32 ];
+	int			argc, protocol;
+
+	MSG_BeginReadingOOB( msg );
+	MSG_ReadLong( msg );
+	Q_strncpyz( line, MSG_ReadStringLine( msg ), sizeof( line ) );
+
+	argc = sscanf( line, "%31s %31s %31s %31s", arg[0], arg[1], arg[2], arg[3] );
+	if ( argc < 1 ) {
+		return;
+	}
+
+	if ( !Q_stricmp( arg[0], "challengeResponse" ) ) {
+		if ( cl->state != LG_CHALLENGING || argc < 2 ) {
+			return;
+		}
+		// newer servers echo our challenge back
+		if ( argc >= 4 && atoi( arg[3] ) != cl->challenge ) {
+			return;
+		}
+		cl->challenge = atoi( arg[1] );
+		cl->state = LG_CONNECTING;
+		cl->lastConnectPacket = Sys_Milliseconds() - LG_RESEND_MSEC;
+		return;
+	}
+
+	if ( !Q_stricmp( arg[0], "connectResponse" ) ) {
+		if ( cl->state != LG_CONNECTING || argc < 2 || atoi( arg[1] ) != cl->challenge ) {
+			return;
+		}
+		protocol = argc >= 3 ? atoi( arg[2] ) : 0;
+		if ( protocol != NEW_PROTOCOL_VERSION ) {
+			LG_Drop( cl, "server does not support protocol " XSTRING( NEW_PROTOCOL_VERSION ) );
+			return;
+		}
+		Netchan_Setup( NS_CLIENT, &cl->netchan, &lgServer, cl->qport, cl->challenge, qfalse );
+		cl->state = LG_CONNECTED;
+		return;
+	}
+
+	if ( !Q_stricmp( arg[0], "print" ) ) {
+		// rejection reasons, keep trying since most of them are temporary
+		Q_strncpyz( cl->reason, MSG_ReadString( msg ), sizeof( cl->reason ) );
+		Com_Printf( "client %i: %s", cl->index, cl->reason );
+		return;
+	}
+
+	if ( !Q_stricmp( arg[0], "disconnect" ) && cl->state >= LG_CONNECTED ) {
+		LG_Drop( cl, "server disconnected" );
+	}
+}
+
+
+static void LG_PacketEvent( lgClient_t *cl, byte *data, int length, int now ) {
+	msg_t msg;
+
+	cl->stats.packetsIn++;
+	cl->stats.bytesIn += length;
+	cl->lastServerPacket = now;
+
+	MSG_Init( &msg, data, MAX_MSGLEN );
+	msg.cursize = length;
+
+	lgSendClient = cl;
+	lgAbortSet = qtrue;
+	if ( setjmp( lgAbort ) ) {
+		lgAbortSet = qfalse;
+		LG_Drop( cl, lgErrorText );
+		return;
+	}
+
+	if ( length >= 4 && *(int32_t *)data == -1 ) {
+		LG_ConnectionlessPacket( cl, &msg );
+	} else if ( length >= 4 && cl->state >= LG_CONNECTED && cl->state != LG_DROPPED ) {
+		if ( Netchan_Process( &cl->netchan, &msg ) ) {
+			if ( cl->netchan.dropped > 0 ) {
+				cl->stats.droppedPackets += cl->netchan.dropped;
+			}
+			cl->serverMessageSequence = LittleLong( *(int32_t *)msg.data );
+			LG_ParseServerMessage( cl, &msg, now );
+		}
+	}
+
+	lgAbortSet = qfalse;
+}
+
+
+/*
+=================
+LG_ClientFrame
+=================
+*/
+static void LG_ClientFrame( lgClient_t *cl, int now ) {
+	lgSendClient = cl;
+
+	switch ( cl->state ) {
+	case LG_CHALLENGING:
+		if ( now - cl->lastConnectPacket >= LG_RESEND_MSEC ) {
+			NET_OutOfBandPrint( NS_CLIENT, &lgServer, "getchallenge %d %s", cl->challenge, GAMENAME_FOR_MASTER );
+			cl->lastConnectPacket = now;
+		}
+		break;
+	case LG_CONNECTING:
+		if ( now - cl->lastConnectPacket >= LG_RESEND_MSEC ) {
+			LG_SendConnect( cl );
+			cl->lastConnectPacket = now;
+		}
+		break;
+	case LG_CONNECTED:
+	case LG_PRIMED:
+	case LG_ACTIVE:
+		if ( now - cl->lastServerPacket > LG_TIMEOUT_MSEC ) {
+			LG_Drop( cl, "server connection timed out" );
+			break;
+		}
+		if ( now - cl->lastPacketTime >= 1000 / lgPacketRate ) {
+			LG_WritePacket( cl, now );
+		}
+		break;
+	default:
+		break;
+	}
+
+	lgSendClient = NULL;
+}
+
+
+/*
+==============================================================================
+
+Main
+
+==============================================================================
+*/
+
+/*
+=================
+LG_LoadScript
+
+One step per line: msec forward right up yawspeed buttons
+or "cmd <text>" to send a client command, steps loop until the test ends
+=================
+*/
+static void LG_LoadScript( const char *path ) {
+	char		line[ 512 ];
+	lgStep_t	*step;
+	FILE		*f;
+
+	f = fopen( path, "r" );
+	if ( !f ) {
+		Com_Error( ERR_FATAL, "couldn't open script %s", path );
+	}
+
+	while ( fgets( line, sizeof( line ), f ) && lgNumSteps < LG_MAX_STEPS ) {
+		step = &lgSteps[ lgNumSteps ];
+		Com_Memset( step, 0, sizeof( *step ) );
+		if ( !strncmp( line, "cmd ", 4 ) ) {
+			Q_strncpyz( step->command, line + 4, sizeof( step->command ) );
+			step->command[ strcspn( step->command, "\r\n" ) ] = '\0';
+			lgNumSteps++;
+		} else if ( sscanf( line, "%i %i %i %i %i %i", &step->msec, &step->forward, &step->right,
+			&step->up, &step->yawSpeed, &step->buttons ) == 6 && step->msec > 0 ) {
+			lgNumSteps++;
+		}
+	}
+
+	fclose( f );
+
+	if ( !lgNumSteps ) {
+		Com_Error( ERR_FATAL, "no steps in script %s", path );
+	}
+}
+
+
+static void LG_WriteReport( int elapsed ) {
+	lgHistogram_t	ping, interval, connect;
+	const lgClient_t *cl;
+	int				i, active, snapshots, dropped, deltaErrors;
+	int64_t			packetsIn, bytesIn, packetsOut, bytesOut;
+	double			rate;
+	FILE			*f;
+
+	f = stdout;
+	if ( lgReportPath ) {
+		f = fopen( lgReportPath, "w" );
+		if ( !f ) {
+			fprintf( stderr, "couldn't write %s\n", lgReportPath );
+			f = stdout;
+		}
+	}
+
+	Com_Memset( &ping, 0, sizeof( ping ) );
+	Com_Memset( &interval, 0, sizeof( interval ) );
+	Com_Memset( &connect, 0, sizeof( connect ) );
+	active = snapshots = dropped = deltaErrors = 0;
+	packetsIn = bytesIn = packetsOut = bytesOut = 0;
+
+	for ( i = 0, cl = lgClients; i < lgNumClients; i++, cl++ ) {
+		if ( cl->state == LG_ACTIVE ) {
+			active++;
+		}
+		if ( cl->stats.activeTime ) {
+			LG_HistAdd( &connect, cl->stats.connectMsec );
+		}
+		snapshots += cl->stats.snapshots;
+		dropped += cl->stats.droppedPackets;
+		deltaErrors += cl->stats.deltaErrors;
+		packetsIn += cl->stats.packetsIn;
+		bytesIn += cl->stats.bytesIn;
+		packetsOut += cl->stats.packetsOut;
+		bytesOut += cl->stats.bytesOut;
+		LG_HistMerge( &ping, &cl->stats.ping );
+		LG_HistMerge( &interval, &cl->stats.interval );
+	}
+
+	fprintf( f, "{\n" );
+	fprintf( f, "  \"server\": " );
+	LG_WriteString( f, lgServerName );
+	fprintf( f, ",\n" );
+	fprintf( f, "  \"clients\": %i,\n", lgNumClients );
+	fprintf( f, "  \"duration_msec\": %i,\n", elapsed );
+	fprintf( f, "  \"packet_rate\": %i,\n", lgPacketRate );
+	fprintf( f, "  \"snaps\": %i,\n", lgSnaps );
+	fprintf( f, "  \"mode\": \"%s\",\n", lgNumSteps ? "script" : "random" );
+	fprintf( f, "  \"totals\": {\n" );
+	fprintf( f, "    \"active\": %i,\n", active );
+	fprintf( f, "    \"snapshots\": %i,\n", snapshots );
+	fprintf( f, "    \"dropped_packets\": %i,\n", dropped );
+	fprintf( f, "    \"delta_errors\": %i,\n", deltaErrors );
+	fprintf( f, "    \"packets_in\": %lli,\n", (long long)packetsIn );
+	fprintf( f, "    \"bytes_in\": %lli,\n", (long long)bytesIn );
+	fprintf( f, "    \"packets_out\": %lli,\n", (long long)packetsOut );
+	fprintf( f, "    \"bytes_out\": %lli,\n", (long long)bytesOut );
+	LG_WriteHist( f, "connect_msec", &connect, "    ", qfalse );
+	LG_WriteHist( f, "ping_msec", &ping, "    ", qfalse );
+	LG_WriteHist( f, "snapshot_interval_msec", &interval, "    ", qtrue );
+	fprintf( f, "  },\n" );
+	fprintf( f, "  \"per_client\": [\n" );
+
+	for ( i = 0, cl = lgClients; i < lgNumClients; i++, cl++ ) {
+		rate = 0.0;
+		if ( cl->stats.activeTime && cl->stats.lastSnapTime - cl->stats.activeTime > 0 ) {
+			rate = ( cl->stats.snapshots - 1 ) * 1000.0 / ( cl->stats.lastSnapTime - cl->stats.activeTime );
+		}
+		fprintf( f, "    {\n" );
+		fprintf( f, "      \"index\": %i,\n", cl->index );
+		fprintf( f, "      \"state\": \"%s\",\n", lgStateNames[ cl->state ] );
+		fprintf( f, "      \"reason\": " );
+		LG_WriteString( f, cl->reason );
+		fprintf( f, ",\n" );
+		fprintf( f, "      \"client_num\": %i,\n", cl->state >= LG_PRIMED ? cl->clientNum : -1 );
+		fprintf( f, "      \"connect_msec\": %i,\n", cl->stats.connectMsec );
+		fprintf( f, "      \"gamestates\": %i,\n", cl->stats.gamestates );
+		fprintf( f, "      \"snapshots\": %i,\n", cl->stats.snapshots );
+		fprintf( f, "      \"snapshot_rate\": %.2f,\n", rate );
+		fprintf( f, "      \"dropped_packets\": %i,\n", cl->stats.droppedPackets );
+		fprintf( f, "      \"delta_errors\": %i,\n", cl->stats.deltaErrors );
+		fprintf( f, "      \"packets_in\": %i,\n", cl->stats.packetsIn );
+		fprintf( f, "      \"bytes_in\": %i,\n", cl->stats.bytesIn );
+		fprintf( f, "      \"packets_out\": %i,\n", cl->stats.packetsOut );
+		fprintf( f, "      \"bytes_out\": %i,\n", cl->stats.bytesOut );
+		LG_WriteHist( f, "ping_msec", &cl->stats.ping, "      ", qfalse );
+		LG_WriteHist( f, "snapshot_interval_msec", &cl->stats.interval, "      ", qtrue );
+		fprintf( f, "    }%s\n", i < lgNumClients - 1 ? "," : "" );
+	}
+
+	fprintf( f, "  ]\n" );
+	fprintf( f, "}\n" );
+
+	if ( f != stdout ) {
+		fclose( f );
+	}
+}
+
+
+static void LG_Interrupt( int signum ) {
+	lgInterrupted = 1;
+}
+
+
+static void LG_Usage( void ) {
+	fprintf( stderr,
+		"usage: ete-loadgen [options] host[:port]\n"
+		"  -n <clients>      number of clients, default 16\n"
+		"  -d <seconds>      test duration, default 60\n"
+		"  -p <packets>      packets per second and client, default 60\n"
+		"  -s <snaps>        requested snapshots per second, default 20\n"
+		"  -r <rate>         client rate, default 90000\n"
+		"  -ramp <msec>      delay between client connects, default 100\n"
+		"  -class <seconds>  class switch interval of random clients, 0 disables, default 30\n"
+		"  -script <file>    usercmd script instead of random movement\n"
+		"  -password <pass>  server password\n"
+		"  -noloopbind       don't give every client its own 127.1.x.y address\n"
+		"  -seed <n>         random seed\n"
+		"  -o <file>         JSON report, default stdout\n"
+		"  -v                verbose\n" );
+	exit( 1 );
+}
+
+
+int main( int argc, char **argv )
+{
+	struct pollfd	*fds;
+	lgClient_t		*cl;
+	byte			data[ MAX_MSGLEN_BUF ];
+	int				start, now, nextConnect, nextStatus, started;
+	int				i, n, len, active;
+
+	for ( i = 1; i < argc; i++ ) {
+		if ( !strcmp( argv[i], "-v" ) ) {
+			lgVerbose = qtrue;
+		} else if ( !strcmp( argv[i], "-noloopbind" ) ) {
+			lgBindLoopback = qfalse;
+		} else if ( argv[i][0] == '-' && i + 1 < argc ) {
+			const char *opt = argv[i++];
+			if ( !strcmp( opt, "-n" ) ) {
+				lgNumClients = atoi( argv[i] );
+			} else if ( !strcmp( opt, "-d" ) ) {
+				lgDuration = atoi( argv[i] );
+			} else if ( !strcmp( opt, "-p" ) ) {
+				lgPacketRate = atoi( argv[i] );
+			} else if ( !strcmp( opt, "-s" ) ) {
+				lgSnaps = atoi( argv[i] );
+			} else if ( !strcmp( opt, "-r" ) ) {
+				lgRate = atoi( argv[i] );
+			} else if ( !strcmp( opt, "-ramp" ) ) {
+				lgRampMsec = atoi( argv[i] );
+			} else if ( !strcmp( opt, "-class" ) ) {
+				lgClassSwitch = atoi( argv[i] );
+			} else if ( !strcmp( opt, "-script" ) ) {
+				lgScriptPath = argv[i];
+			} else if ( !strcmp( opt, "-password" ) ) {
+				lgPassword = argv[i];
+			} else if ( !strcmp( opt, "-seed" ) ) {
+				lgSeed = strtoul( argv[i], NULL, 0 ) | 1;
+			} else if ( !strcmp( opt, "-o" ) ) {
+				lgReportPath = argv[i];
+			} else {
+				LG_Usage();
+			}
+		} else if ( argv[i][0] != '-' && !lgServerName ) {
+			lgServerName = argv[i];
+		} else {
+			LG_Usage();
+		}
+	}
+
+	if ( !lgServerName || lgNumClients < 1 || lgNumClients > LG_MAX_CLIENTS || lgDuration < 1
+		|| lgPacketRate < 1 || lgPacketRate > 1000 || lgSnaps < 1 ) {
+		LG_Usage();
+	}
+
+	com_timescale = Cvar_Get( "timescale", "1", 0 );
+	sv_packetdelay = Cvar_Get( "sv_packetdelay", "0", 0 );
+	sv_packetloss = Cvar_Get( "sv_packetloss", "0", 0 );
+	Netchan_Init( 0 );
+
+	if ( lgScriptPath ) {
+		LG_LoadScript( lgScriptPath );
+	}
+
+	switch ( NET_StringToAdr( lgServerName, &lgServer, NA_IP ) ) {
+	case 0:
+		fprintf( stderr, "couldn't resolve %s\n", lgServerName );
+		return 1;
+	case 2:
+		lgServer.port = BigShort( PORT_SERVER );
+		break;
+	}
+	if ( lgServer.type != NA_IP ) {
+		fprintf( stderr, "%s is not an IPv4 address\n", lgServerName );
+		return 1;
+	}
+
+	Com_Memset( &lgServerAddr, 0, sizeof( lgServerAddr ) );
+	lgServerAddr.sin_family = AF_INET;
+	lgServerAddr.sin_port = lgServer.port;
+	memcpy( &lgServerAddr.sin_addr, lgServer.ipv._4, 4 );
+
+	signal( SIGINT, LG_Interrupt );
+	signal( SIGTERM, LG_Interrupt );
+
+	lgClients = calloc( lgNumClients, sizeof( *lgClients ) );
+	fds = calloc( lgNumClients, sizeof( *fds ) );
+	if ( !lgClients || !fds ) {
+		fprintf( stderr, "out of memory\n" );
+		return 1;
+	}
+
+	start = Sys_Milliseconds();
+	nextConnect = start;
+	nextStatus = start + 5000;
+	started = 0;
+
+	while ( !lgInterrupted ) {
+		now = Sys_Milliseconds();
+		if ( now - start >= lgDuration * 1000 ) {
+			break;
+		}
+
+		while ( started < lgNumClients && now - nextConnect >= 0 ) {
+			LG_StartClient( &lgClients[ started ], started );
+			started++;
+			nextConnect += lgRampMsec;
+		}
+
+		for ( i = 0; i < started; i++ ) {
+			fds[i].fd = lgClients[i].state == LG_DROPPED ? -1 : lgClients[i].sock;
+			fds[i].events = POLLIN;
+			fds[i].revents = 0;
+		}
+
+		poll( fds, started, 1 );
+
+		now = Sys_Milliseconds();
+		for ( i = 0; i < started; i++ ) {
+			cl = &lgClients[i];
+			if ( fds[i].revents & POLLIN ) {
+				while ( cl->state != LG_DROPPED ) {
+					len = recv( cl->sock, data, MAX_MSGLEN, 0 );
+					if ( len < 0 ) {
+						break;
+					}
+					LG_PacketEvent( cl, data, len, now );
+				}
+			}
+			LG_ClientFrame( cl, now );
+		}
+
+		if ( now - nextStatus >= 0 ) {
+			for ( i = 0, n = 0, active = 0; i < started; i++ ) {
+				n += lgClients[i].stats.snapshots;
+				if ( lgClients[i].state == LG_ACTIVE ) {
+					active++;
+				}
+			}
+			fprintf( stderr, "%3is: %i/%i clients active, %i snapshots\n", ( now - start ) / 1000, active, lgNumClients, n );
+			nextStatus += 5000;
+		}
+	}
+
+	for ( i = 0; i < started; i++ ) {
+		LG_Disconnect( &lgClients[i] );
+	}
+
+	LG_WriteReport( Sys_Milliseconds() - start );
+
+	for ( i = 0; i < started; i++ ) {
+		if ( lgClients[i].sock >= 0 ) {
+			close( lgClients[i].sock );
+		}
+	}
+
+	return 0;
+}
@@ -38,6 +38,8 @@ If you have questions concerning this license or the applicable additional terms
 #include <pwd.h>
 #include <dlfcn.h>
 #include <libgen.h>
+#include <pthread.h>
+#include <signal.h>
 
 #include "../qcommon/q_shared.h"
 #include "../qcommon/qcommon.h"
@@ -63,6 +65,10 @@ int Sys_Milliseconds( void )
 {
 	int curtime;
 	struct timespec ts;
+
+	if ( com_replay ) {
+		return com_replayTime;
+	}
 	
 #ifdef CLOCK_MONOTONIC_RAW
 	clock_gettime( CLOCK_MONOTONIC_RAW, &ts );
@@ -673,3 +679,405 @@ void Sys_SetAffinityMask( int mask )
 	}
 }
 #endif // USE_AFFINITY_MASK
+
+
+/*
+==============================================================================
+
+WORKER THREADS
+
+==============================================================================
+*/
+
+typedef struct {
+	pthread_mutex_t	lock;
+	pthread_cond_t	wake;			// signaled when a new batch is issued
+	pthread_cond_t	done;			// signaled when the last thread leaves a batch
+	pthread_t		threads[ MAX_WORKER_THREADS ];
+	int				numThreads;		// spawned threads, not including the caller
+	int				requested;		// count of the last Sys_InitWorkers() call, 0 after a shutdown
+	int				batch;			// incremented for each Sys_RunJobs() call
+	int				running;		// threads that didn't finish current batch yet
+	qboolean		quit;
+
+	sysJob_t		func;
+	void			*data;
+	int				numJobs;
+	int				nextJob;
+
+	sigset_t		termSignals;	// held back by the caller while a batch runs
+} workerPool_t;
+
+static workerPool_t workers = {
+	PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER
+};
+
+
+/*
+=================
+Sys_TakeJobs
+
+Must be called with workers.lock held
+=================
+*/
+static void Sys_TakeJobs( int worker )
+{
+	int job;
+
+	while ( workers.nextJob < workers.numJobs )
+	{
+		job = workers.nextJob++;
+		pthread_mutex_unlock( &workers.lock );
+		workers.func( workers.data, job, worker );
+		pthread_mutex_lock( &workers.lock );
+	}
+}
+
+
+/*
+=================
+Sys_CreateThread
+
+Starts a helper thread with every signal blocked, so signals are left to the
+main thread. The shutdown handler would otherwise wait for the very thread it
+runs on. The mask is set in the creating thread around pthread_create, the
+new thread inherits it before it runs a single instruction.
+=================
+*/
+static int Sys_CreateThread( pthread_t *thread, void *(*func)( void * ), void *arg )
+{
+	sigset_t set, oldSet;
+	int err;
+
+	sigfillset( &set );
+	pthread_sigmask( SIG_BLOCK, &set, &oldSet );
+
+	err = pthread_create( thread, NULL, func, arg );
+
+	pthread_sigmask( SIG_SETMASK, &oldSet, NULL );
+
+	return err;
+}
+
+
+static void *Sys_WorkerThread( void *arg )
+{
+	const int worker = (intptr_t)arg;
+	int batch = 0;
+
+	pthread_mutex_lock( &workers.lock );
+
+	for ( ;; )
+	{
+		while ( !workers.quit && workers.batch == batch )
+			pthread_cond_wait( &workers.wake, &workers.lock );
+
+		if ( workers.quit )
+			break;
+
+		batch = workers.batch;
+
+		Sys_TakeJobs( worker );
+
+		if ( --workers.running == 0 )
+			pthread_cond_signal( &workers.done );
+	}
+
+	pthread_mutex_unlock( &workers.lock );
+
+	return NULL;
+}
+
+
+/*
+=================
+Sys_ShutdownWorkers
+=================
+*/
+void Sys_ShutdownWorkers( void )
+{
+	int i;
+
+	workers.requested = 0;
+
+	if ( !workers.numThreads )
+		return;
+
+	pthread_mutex_lock( &workers.lock );
+	workers.quit = qtrue;
+	pthread_cond_broadcast( &workers.wake );
+	pthread_mutex_unlock( &workers.lock );
+
+	for ( i = 0; i < workers.numThreads; i++ )
+		pthread_join( workers.threads[ i ], NULL );
+
+	workers.numThreads = 0;
+	workers.quit = qfalse;
+}
+
+
+/*
+=================
+Sys_InitWorkers
+=================
+*/
+int Sys_InitWorkers( int count )
+{
+	int i;
+
+	if ( count > MAX_WORKER_THREADS )
+		count = MAX_WORKER_THREADS;
+	else if ( count < 1 )
+		count = 1;
+
+	// a pool that came up short stays as it is, rather than being torn down
+	// and respawned on every call, until a different count is asked for
+	if ( count == workers.requested )
+		return workers.numThreads + 1;
+
+	Sys_ShutdownWorkers();
+	workers.requested = count;
+
+	// threads must start waiting for the next batch
+	workers.batch = 0;
+
+	// the handlers of these shut the server down, which takes workers.lock
+	sigemptyset( &workers.termSignals );
+	sigaddset( &workers.termSignals, SIGHUP );
+	sigaddset( &workers.termSignals, SIGQUIT );
+	sigaddset( &workers.termSignals, SIGTERM );
+
+	for ( i = 1; i < count; i++ )
+	{
+		if ( Sys_CreateThread( &workers.threads[ workers.numThreads ], Sys_WorkerThread, (void *)(intptr_t)i ) != 0 )
+		{
+			Com_Printf( S_COLOR_YELLOW "pthread_create() failed, using %i worker threads\n", workers.numThreads + 1 );
+			break;
+		}
+		workers.numThreads++;
+	}
+
+	return workers.numThreads + 1;
+}
+
+
+/*
+=================
+Sys_RunJobs
+
+Termination signals are delivered after the batch, when the calling
+thread no longer holds workers.lock
+=================
+*/
+void Sys_RunJobs( sysJob_t func, void *data, int numJobs )
+{
+	sigset_t oldSignals;
+	int i;
+
+	if ( !workers.numThreads || numJobs <= 1 )
+	{
+		for ( i = 0; i < numJobs; i++ )
+			func( data, i, 0 );
+		return;
+	}
+
+	pthread_sigmask( SIG_BLOCK, &workers.termSignals, &oldSignals );
+	pthread_mutex_lock( &workers.lock );
+
+	workers.func = func;
+	workers.data = data;
+	workers.numJobs = numJobs;
+	workers.nextJob = 0;
+	workers.running = workers.numThreads;
+	workers.batch++;
+	pthread_cond_broadcast( &workers.wake );
+
+	Sys_TakeJobs( 0 );
+
+	while ( workers.running > 0 )
+		pthread_cond_wait( &workers.done, &workers.lock );
+
+	pthread_mutex_unlock( &workers.lock );
+	pthread_sigmask( SIG_SETMASK, &oldSignals, NULL );
+}
+
+
+/*
+==============================================================================
+
+ASYNC FILE WRITER
+
+==============================================================================
+*/
+
+typedef struct asyncBlock_s {
+	struct asyncBlock_s	*next;
+	int					size;
+	byte				data[1];
+} asyncBlock_t;
+
+struct asyncFile_s {
+	FILE			*f;
+	pthread_t		thread;
+	pthread_mutex_t	lock;
+	pthread_cond_t	wake;			// signaled when a block is queued or file is closing
+	asyncBlock_t	*head;
+	asyncBlock_t	*tail;
+	int				pending;		// queued bytes not written yet
+	qboolean		closing;
+	qboolean		failed;			// write error, no more data accepted
+};
+
+
+/*
+=================
+Sys_AsyncWriterThread
+=================
+*/
+static void *Sys_AsyncWriterThread( void *arg )
+{
+	asyncFile_t *file = (asyncFile_t *)arg;
+	asyncBlock_t *block;
+	qboolean failed;
+
+	pthread_mutex_lock( &file->lock );
+
+	for ( ;; )
+	{
+		while ( !file->head && !file->closing )
+			pthread_cond_wait( &file->wake, &file->lock );
+
+		block = file->head;
+		if ( !block )
+			break;
+
+		file->head = block->next;
+		if ( !file->head )
+			file->tail = NULL;
+
+		pthread_mutex_unlock( &file->lock );
+
+		failed = ( fwrite( block->data, 1, block->size, file->f ) != (size_t)block->size );
+
+		pthread_mutex_lock( &file->lock );
+
+		file->pending -= block->size;
+		if ( failed )
+			file->failed = qtrue;
+		free( block );
+	}
+
+	pthread_mutex_unlock( &file->lock );
+
+	return NULL;
+}
+
+
+/*
+=================
+Sys_AsyncOpen
+=================
+*/
+asyncFile_t *Sys_AsyncOpen( const char *ospath )
+{
+	asyncFile_t *file;
+
+	file = calloc( 1, sizeof( *file ) );
+	if ( !file )
+		return NULL;
+
+	file->f = Sys_FOpen( ospath, "wb" );
+	if ( !file->f )
+	{
+		free( file );
+		return NULL;
+	}
+
+	pthread_mutex_init( &file->lock, NULL );
+	pthread_cond_init( &file->wake, NULL );
+
+	if ( Sys_CreateThread( &file->thread, Sys_AsyncWriterThread, file ) != 0 )
+	{
+		pthread_cond_destroy( &file->wake );
+		pthread_mutex_destroy( &file->lock );
+		fclose( file->f );
+		free( file );
+		return NULL;
+	}
+
+	return file;
+}
+
+
+/*
+=================
+Sys_AsyncWrite
+=================
+*/
+qboolean Sys_AsyncWrite( asyncFile_t *file, const void *data, int len )
+{
+	asyncBlock_t *block;
+	qboolean ok;
+
+	if ( len <= 0 )
+		return qtrue;
+
+	pthread_mutex_lock( &file->lock );
+	ok = !file->failed && file->pending + len <= MAX_ASYNC_PENDING;
+	pthread_mutex_unlock( &file->lock );
+
+	if ( !ok )
+		return qfalse;
+
+	block = malloc( sizeof( *block ) - sizeof( block->data ) + len );
+	if ( !block )
+		return qfalse;
+
+	block->next = NULL;
+	block->size = len;
+	memcpy( block->data, data, len );
+
+	pthread_mutex_lock( &file->lock );
+
+	if ( file->tail )
+		file->tail->next = block;
+	else
+		file->head = block;
+	file->tail = block;
+	file->pending += len;
+
+	pthread_cond_signal( &file->wake );
+	pthread_mutex_unlock( &file->lock );
+
+	return qtrue;
+}
+
+
+/*
+=================
+Sys_AsyncClose
+
+Waits until all queued data is written
+=================
+*/
+qboolean Sys_AsyncClose( asyncFile_t *file )
+{
+	qboolean failed;
+
+	pthread_mutex_lock( &file->lock );
+	file->closing = qtrue;
+	pthread_cond_signal( &file->wake );
+	pthread_mutex_unlock( &file->lock );
+
+	pthread_join( file->thread, NULL );
+
+	failed = file->failed;
+	if ( fclose( file->f ) != 0 )
+		failed = qtrue;
+
+	pthread_cond_destroy( &file->wake );
+	pthread_mutex_destroy( &file->lock );
+	free( file );
+
+	return failed ? qfalse : qtrue;
+}
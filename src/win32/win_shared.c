@@ -49,6 +49,10 @@ int Sys_Milliseconds( void )
 	static DWORD sys_timeBase;
 	int	sys_curtime;
 
+	if ( com_replay ) {
+		return com_replayTime;
+	}
+
 	if ( !initialized ) {
 		sys_timeBase = timeGetTime();
 		initialized = qtrue;
@@ -286,3 +290,354 @@ void Sys_SetAffinityMask( int mask )
 	}
 }
 #endif // USE_AFFINITY_MASK
+
+
+/*
+==============================================================================
+
+WORKER THREADS
+
+==============================================================================
+*/
+
+typedef struct {
+	HANDLE			wake;			// semaphore, released once per thread for each batch
+	HANDLE			done;			// event, set when the last thread leaves a batch
+	HANDLE			threads[ MAX_WORKER_THREADS ];
+	int				numThreads;		// spawned threads, not including the caller
+	int				requested;		// count of the last Sys_InitWorkers() call, 0 after a shutdown
+	volatile LONG	running;		// threads that didn't finish current batch yet
+	volatile LONG	nextJob;
+	qboolean		quit;
+
+	sysJob_t		func;
+	void			*data;
+	int				numJobs;
+} workerPool_t;
+
+static workerPool_t workers;
+
+
+static void Sys_TakeJobs( int worker )
+{
+	LONG job;
+
+	while ( ( job = InterlockedIncrement( &workers.nextJob ) - 1 ) < workers.numJobs )
+	{
+		workers.func( workers.data, job, worker );
+	}
+}
+
+
+static DWORD WINAPI Sys_WorkerThread( LPVOID arg )
+{
+	const int worker = (int)(intptr_t)arg;
+
+	for ( ;; )
+	{
+		WaitForSingleObject( workers.wake, INFINITE );
+
+		if ( workers.quit )
+			break;
+
+		Sys_TakeJobs( worker );
+
+		if ( InterlockedDecrement( &workers.running ) == 0 )
+			SetEvent( workers.done );
+	}
+
+	return 0;
+}
+
+
+/*
+=================
+Sys_ShutdownWorkers
+=================
+*/
+void Sys_ShutdownWorkers( void )
+{
+	int i;
+
+	workers.requested = 0;
+
+	if ( !workers.numThreads )
+		return;
+
+	workers.quit = qtrue;
+	ReleaseSemaphore( workers.wake, workers.numThreads, NULL );
+	WaitForMultipleObjects( workers.numThreads, workers.threads, TRUE, INFINITE );
+
+	for ( i = 0; i < workers.numThreads; i++ )
+		CloseHandle( workers.threads[ i ] );
+
+	CloseHandle( workers.wake );
+	CloseHandle( workers.done );
+
+	workers.numThreads = 0;
+	workers.quit = qfalse;
+}
+
+
+/*
+=================
+Sys_InitWorkers
+=================
+*/
+int Sys_InitWorkers( int count )
+{
+	int i;
+
+	if ( count > MAX_WORKER_THREADS )
+		count = MAX_WORKER_THREADS;
+	else if ( count < 1 )
+		count = 1;
+
+	// a pool that came up short stays as it is, rather than being torn down
+	// and respawned on every call, until a different count is asked for
+	if ( count == workers.requested )
+		return workers.numThreads + 1;
+
+	Sys_ShutdownWorkers();
+	workers.requested = count;
+
+	if ( count == 1 )
+		return 1;
+
+	workers.wake = CreateSemaphore( NULL, 0, MAX_WORKER_THREADS, NULL );
+	workers.done = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+	for ( i = 1; i < count; i++ )
+	{
+		workers.threads[ workers.numThreads ] = CreateThread( NULL, 0, Sys_WorkerThread, (LPVOID)(intptr_t)i, 0, NULL );
+		if ( !workers.threads[ workers.numThreads ] )
+		{
+			Com_Printf( S_COLOR_YELLOW "CreateThread() failed, using %i worker threads\n", workers.numThreads + 1 );
+			break;
+		}
+		workers.numThreads++;
+	}
+
+	if ( !workers.numThreads )
+	{
+		CloseHandle( workers.wake );
+		CloseHandle( workers.done );
+	}
+
+	return workers.numThreads + 1;
+}
+
+
+/*
+=================
+Sys_RunJobs
+=================
+*/
+void Sys_RunJobs( sysJob_t func, void *data, int numJobs )
+{
+	int i;
+
+	if ( !workers.numThreads || numJobs <= 1 )
+	{
+		for ( i = 0; i < numJobs; i++ )
+			func( data, i, 0 );
+		return;
+	}
+
+	workers.func = func;
+	workers.data = data;
+	workers.numJobs = numJobs;
+	workers.nextJob = 0;
+	workers.running = workers.numThreads;
+
+	ReleaseSemaphore( workers.wake, workers.numThreads, NULL );
+
+	Sys_TakeJobs( 0 );
+
+	WaitForSingleObject( workers.done, INFINITE );
+}
+
+
+/*
+==============================================================================
+
+ASYNC FILE WRITER
+
+==============================================================================
+*/
+
+typedef struct asyncBlock_s {
+	struct asyncBlock_s	*next;
+	int					size;
+	byte				data[1];
+} asyncBlock_t;
+
+struct asyncFile_s {
+	FILE				*f;
+	HANDLE				thread;
+	CRITICAL_SECTION	lock;
+	HANDLE				wake;		// auto-reset, set when a block is queued or file is closing
+	asyncBlock_t		*head;
+	asyncBlock_t		*tail;
+	int					pending;	// queued bytes not written yet
+	qboolean			closing;
+	qboolean			failed;		// write error, no more data accepted
+};
+
+
+/*
+=================
+Sys_AsyncWriterThread
+=================
+*/
+static DWORD WINAPI Sys_AsyncWriterThread( LPVOID arg )
+{
+	asyncFile_t *file = (asyncFile_t *)arg;
+	asyncBlock_t *block;
+	qboolean failed, closing;
+
+	for ( ;; )
+	{
+		EnterCriticalSection( &file->lock );
+		block = file->head;
+		if ( block )
+		{
+			file->head = block->next;
+			if ( !file->head )
+				file->tail = NULL;
+		}
+		closing = file->closing;
+		LeaveCriticalSection( &file->lock );
+
+		if ( !block )
+		{
+			if ( closing )
+				break;
+			WaitForSingleObject( file->wake, INFINITE );
+			continue;
+		}
+
+		failed = ( fwrite( block->data, 1, block->size, file->f ) != (size_t)block->size );
+
+		EnterCriticalSection( &file->lock );
+		file->pending -= block->size;
+		if ( failed )
+			file->failed = qtrue;
+		LeaveCriticalSection( &file->lock );
+
+		free( block );
+	}
+
+	return 0;
+}
+
+
+/*
+=================
+Sys_AsyncOpen
+=================
+*/
+asyncFile_t *Sys_AsyncOpen( const char *ospath )
+{
+	asyncFile_t *file;
+
+	file = calloc( 1, sizeof( *file ) );
+	if ( !file )
+		return NULL;
+
+	file->f = Sys_FOpen( ospath, "wb" );
+	if ( !file->f )
+	{
+		free( file );
+		return NULL;
+	}
+
+	InitializeCriticalSection( &file->lock );
+	file->wake = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+	file->thread = CreateThread( NULL, 0, Sys_AsyncWriterThread, file, 0, NULL );
+	if ( !file->thread )
+	{
+		CloseHandle( file->wake );
+		DeleteCriticalSection( &file->lock );
+		fclose( file->f );
+		free( file );
+		return NULL;
+	}
+
+	return file;
+}
+
+
+/*
+=================
+Sys_AsyncWrite
+=================
+*/
+qboolean Sys_AsyncWrite( asyncFile_t *file, const void *data, int len )
+{
+	asyncBlock_t *block;
+	qboolean ok;
+
+	if ( len <= 0 )
+		return qtrue;
+
+	EnterCriticalSection( &file->lock );
+	ok = !file->failed && file->pending + len <= MAX_ASYNC_PENDING;
+	LeaveCriticalSection( &file->lock );
+
+	if ( !ok )
+		return qfalse;
+
+	block = malloc( sizeof( *block ) - sizeof( block->data ) + len );
+	if ( !block )
+		return qfalse;
+
+	block->next = NULL;
+	block->size = len;
+	memcpy( block->data, data, len );
+
+	EnterCriticalSection( &file->lock );
+	if ( file->tail )
+		file->tail->next = block;
+	else
+		file->head = block;
+	file->tail = block;
+	file->pending += len;
+	LeaveCriticalSection( &file->lock );
+
+	SetEvent( file->wake );
+
+	return qtrue;
+}
+
+
+/*
+=================
+Sys_AsyncClose
+
+Waits until all queued data is written
+=================
+*/
+qboolean Sys_AsyncClose( asyncFile_t *file )
+{
+	qboolean failed;
+
+	EnterCriticalSection( &file->lock );
+	file->closing = qtrue;
+	LeaveCriticalSection( &file->lock );
+	SetEvent( file->wake );
+
+	WaitForSingleObject( file->thread, INFINITE );
+	CloseHandle( file->thread );
+
+	failed = file->failed;
+	if ( fclose( file->f ) != 0 )
+		failed = qtrue;
+
+	CloseHandle( file->wake );
+	DeleteCriticalSection( &file->lock );
+	free( file );
+
+	return failed ? qfalse : qtrue;
+}